@@ -0,0 +1,255 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Fast parser for drawings in the CSV export format.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (fast CSV import)
+ */
+
+#include "CsvReader.h"
+#include <cctype>
+
+namespace {
+	// Powers of ten exactly representable as double
+	const double POW10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	const int MAX_POW10 = 22;
+	const int MAX_MANTISSA_DIGITS = 19;	// Significant digits fitting into 64 bits
+	const int MAX_EXPONENT = 400;		// Beyond the range of float anyway
+
+	inline bool isDigit(char ch)
+	{
+		return (unsigned char)(ch - '0') < 10;
+	}
+
+	inline bool isLineEnd(char ch)
+	{
+		return ch == '\n' || ch == '\r';
+	}
+
+	// Returns the value of a hex digit or -1
+	inline int hexValue(char ch)
+	{
+		if (isDigit(ch)) {
+			return ch - '0';
+		}
+		ch |= 0x20;		// to lower case
+		if (ch >= 'a' && ch <= 'f') {
+			return ch - 'a' + 10;
+		}
+		return -1;
+	}
+}
+
+CsvReader::CsvReader(const char* text, size_t length)
+	: text(text)
+	, end(text + length)
+	, separator(0)
+	, nRows(0)
+	, errorLine(0)
+	, bounds(SegmentBounds::empty())
+	, batch(BATCH_SIZE)
+{
+}
+
+bool CsvReader::read(const Consumer& consumer)
+{
+	const char* p = this->detectFormat();
+	const char sep = this->separator;
+	const char* const end = this->end;
+	Segment* const segs = this->batch.data();
+	SegmentBounds bounds = this->bounds;
+	size_t nBatch = 0;
+	size_t line = (p > this->text) ? 2 : 1;
+	bool ok = true;
+	while (p < end) {
+		if (isLineEnd(*p)) {
+			// Empty line (or the second half of a CR LF pair)
+			if (*p++ == '\n') {
+				line++;
+			}
+			continue;
+		}
+		Segment& seg = segs[nBatch];
+		float* coords[] = { &seg.x1, &seg.y1, &seg.x2, &seg.y2 };
+		for (int i = 0; i < 4 && p != nullptr; i++) {
+			p = parseNumber(p, end, *coords[i]);
+			if (p != nullptr && (p >= end || *p++ != sep)) {
+				p = nullptr;
+			}
+		}
+		if (p != nullptr) {
+			p = parseColour(p, end, seg.argb);
+		}
+		if (p != nullptr && p < end && !isLineEnd(*p)) {
+			if (*p != sep) {
+				p = nullptr;
+			}
+			else {
+				// Skip additional columns
+				while (p < end && *p != '\n') {
+					p++;
+				}
+			}
+		}
+		if (p == nullptr) {
+			this->errorLine = line;
+			ok = false;
+			break;
+		}
+		bounds.include(seg);
+		if (++nBatch == BATCH_SIZE) {
+			consumer(segs, nBatch);
+			this->nRows += nBatch;
+			nBatch = 0;
+		}
+	}
+	if (nBatch > 0) {
+		consumer(segs, nBatch);
+		this->nRows += nBatch;
+	}
+	this->bounds = bounds;
+	return ok;
+}
+
+const char* CsvReader::detectFormat()
+{
+	const char* p = this->text;
+	// Skip leading empty lines
+	while (p < this->end && isLineEnd(*p)) {
+		p++;
+	}
+	if (p >= this->end) {
+		return p;
+	}
+	const char* q = p;
+	bool isHeader = !isDigit(*q) && *q != '-' && *q != '+' && *q != '.';
+	if (isHeader) {
+		// The separator follows the first column name
+		while (q < this->end && (isalnum((unsigned char)*q) || *q == '_')) {
+			q++;
+		}
+	}
+	else {
+		// The separator follows the first number
+		float value = 0;
+		q = parseNumber(p, this->end, value);
+		if (q == nullptr) {
+			return p;
+		}
+	}
+	if (q < this->end && !isLineEnd(*q)) {
+		this->separator = *q;
+	}
+	if (isHeader) {
+		while (q < this->end && *q != '\n') {
+			q++;
+		}
+		if (q < this->end) {
+			q++;
+		}
+		return q;
+	}
+	return p;
+}
+
+const char* CsvReader::parseNumber(const char* p, const char* end, float& value)
+{
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p++ == '-';
+	}
+	uint64_t mantissa = 0;
+	int nDigits = 0;		// Significant digits in mantissa
+	int exponent = 0;		// Decimal exponent to be applied to mantissa
+	const char* start = p;
+	for (; p < end && isDigit(*p); p++) {
+		if (nDigits < MAX_MANTISSA_DIGITS) {
+			mantissa = mantissa * 10 + (unsigned)(*p - '0');
+			if (mantissa != 0) {
+				nDigits++;
+			}
+		}
+		else {
+			exponent++;
+		}
+	}
+	bool hasDigits = p > start;
+	if (p < end && *p == '.') {
+		start = ++p;
+		for (; p < end && isDigit(*p); p++) {
+			if (nDigits < MAX_MANTISSA_DIGITS) {
+				mantissa = mantissa * 10 + (unsigned)(*p - '0');
+				if (mantissa != 0) {
+					nDigits++;
+				}
+				exponent--;
+			}
+		}
+		hasDigits = hasDigits || p > start;
+	}
+	if (!hasDigits) {
+		return nullptr;
+	}
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool negExp = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negExp = *p++ == '-';
+		}
+		if (p >= end || !isDigit(*p)) {
+			return nullptr;
+		}
+		int exp = 0;
+		for (; p < end && isDigit(*p); p++) {
+			if (exp < MAX_EXPONENT) {
+				exp = exp * 10 + (*p - '0');
+			}
+		}
+		exponent += negExp ? -exp : exp;
+	}
+	double result = (double)mantissa;
+	if (mantissa != 0) {
+		while (exponent > MAX_POW10) {
+			result *= POW10[MAX_POW10];
+			exponent -= MAX_POW10;
+		}
+		while (exponent < -MAX_POW10) {
+			result /= POW10[MAX_POW10];
+			exponent += MAX_POW10;
+		}
+		// Division by an exact power keeps the result correctly rounded
+		result = (exponent < 0) ? result / POW10[-exponent] : result * POW10[exponent];
+	}
+	value = (float)(negative ? -result : result);
+	return p;
+}
+
+const char* CsvReader::parseColour(const char* p, const char* end, uint32_t& argb)
+{
+	uint32_t value = 0;
+	int nDigits = 0;
+	int digit = 0;
+	while (p < end && nDigits < 8 && (digit = hexValue(*p)) >= 0) {
+		value = (value << 4) | (uint32_t)digit;
+		nDigits++;
+		p++;
+	}
+	if (nDigits == 6) {
+		value |= 0xFF000000;
+	}
+	else if (nDigits != 8) {
+		return nullptr;
+	}
+	argb = value;
+	return p;
+}
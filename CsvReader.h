@@ -0,0 +1,76 @@
+#pragma once
+#ifndef CSVREADER_H
+#define CSVREADER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Fast parser for drawings in the CSV format written by the CsvWriter (i.e. the
+ * CSV export of the Turtleizer): rows of xFrom, yFrom, xTo, yTo, and color
+ * (hex "aarrggbb" or "rrggbb"), possibly followed by further columns (turtle,
+ * index), which are ignored. The separator is derived from the first row, which
+ * is skipped if it is a header row.
+ * The text is parsed in place (e.g. from a MappedFile) by hand-written number
+ * parsers that neither allocate nor depend on the locale. The segments are
+ * passed on in batches, and their bounds are gathered in the same pass.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (fast CSV import)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "SegmentStore.h"
+
+class CsvReader
+{
+public:
+	static const size_t BATCH_SIZE = SegmentStore::CHUNK_SIZE;	// Maximum number of segments per batch
+	// Receives a batch of parsed segments (the array is reused for the next batch)
+	typedef std::function<void(const Segment*, size_t)> Consumer;
+
+	// Prepares the parsing of the given text of length bytes (which is not copied)
+	CsvReader(const char* text, size_t length);
+
+	/* Parses all rows and passes the segments in batches to consumer. Stops at
+	 * the first malformed row and returns false then (the rows before will
+	 * have been passed on) */
+	bool read(const Consumer& consumer);
+
+	// Returns the detected column separator (0 if there was no row)
+	inline char getSeparator() const { return this->separator; }
+	// Returns the number of segments parsed so far
+	inline size_t getRowCount() const { return this->nRows; }
+	// Returns the (1-based) line number of the malformed row, or 0
+	inline size_t getErrorLine() const { return this->errorLine; }
+	// Returns the bounds of the segments parsed so far
+	inline const SegmentBounds& getBounds() const { return this->bounds; }
+
+private:
+	const char* const text;		// Start of the text
+	const char* const end;		// End of the text
+	char separator;				// Column separator
+	size_t nRows;				// Number of parsed segments
+	size_t errorLine;			// Line number of the first malformed row
+	SegmentBounds bounds;		// Bounds of the parsed segments
+	std::vector<Segment> batch;	// Reused batch buffer
+
+	// Derives the separator from the first row, returns the start of the first data row
+	const char* detectFormat();
+	/* Parses a decimal number (optionally signed, with fraction and exponent)
+	 * starting at p into value, returns the position behind it or nullptr */
+	static const char* parseNumber(const char* p, const char* end, float& value);
+	/* Parses six or eight hex digits starting at p into argb (adding an opaque
+	 * alpha to six digits), returns the position behind them or nullptr */
+	static const char* parseColour(const char* p, const char* end, uint32_t& argb);
+};
+
+#endif /*CSVREADER_H*/
@@ -0,0 +1,173 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Block-buffered emitter for the CSV export of turtle drawings.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (fast CSV export)
+ */
+
+#include "CsvWriter.h"
+#include <charconv>
+#include <cstring>
+
+const char* const CsvWriter::COLUMN_HEADERS[] = {
+	"xFrom", "yFrom", "xTo", "yTo", "color", "turtle", "index"
+};
+
+CsvWriter::CsvWriter(std::ostream& out, char separator, int precision, unsigned int columns)
+	: out(out)
+	, separator(separator)
+	, precision(precision < 0 ? PRECISION_INTEGRAL : (precision > MAX_PRECISION ? MAX_PRECISION : precision))
+	, columns(columns)
+	, gridUnit(1)
+	, gridFactor(1.0)
+	, buffer(BUFFER_SIZE)
+	, nRows(0)
+{
+	for (int i = 0; i < this->precision; i++) {
+		this->gridUnit *= 10;
+	}
+	this->gridFactor = (double)this->gridUnit;
+	this->pos = this->buffer.data();
+	this->limit = this->buffer.data() + BUFFER_SIZE - MAX_ROW_SIZE;
+}
+
+CsvWriter::~CsvWriter()
+{
+	this->flush();
+}
+
+bool CsvWriter::flush()
+{
+	if (this->pos > this->buffer.data()) {
+		this->out.write(this->buffer.data(), this->pos - this->buffer.data());
+		this->pos = this->buffer.data();
+	}
+	return this->out.good();
+}
+
+uint64_t CsvWriter::getRowCount() const
+{
+	return this->nRows;
+}
+
+void CsvWriter::writeHeader()
+{
+	std::string header;
+	for (unsigned int col = 0; col < N_BASIC_COLUMNS; col++) {
+		if (col > 0) {
+			header += this->separator;
+		}
+		header += COLUMN_HEADERS[col];
+	}
+	if (this->columns & COL_TURTLE) {
+		header += this->separator;
+		header += COLUMN_HEADERS[N_BASIC_COLUMNS];
+	}
+	if (this->columns & COL_INDEX) {
+		header += this->separator;
+		header += COLUMN_HEADERS[N_BASIC_COLUMNS + 1];
+	}
+	header += '\n';
+	this->writeText(header.data(), header.size());
+}
+
+void CsvWriter::writeText(const char* text, size_t length)
+{
+	while (length > 0) {
+		if (this->pos >= this->limit) {
+			this->flush();
+		}
+		size_t n = this->buffer.data() + BUFFER_SIZE - this->pos;
+		if (n > length) {
+			n = length;
+		}
+		memcpy(this->pos, text, n);
+		this->pos += n;
+		text += n;
+		length -= n;
+	}
+}
+
+void CsvWriter::writeRows(const Segment* segments, size_t count, size_t firstIndex, unsigned int turtleNo)
+{
+	for (size_t i = 0; i < count; i++) {
+		if (this->pos >= this->limit) {
+			this->flush();
+		}
+		this->pos = this->formatRow(this->pos, segments[i], firstIndex + i, turtleNo);
+	}
+	this->nRows += count;
+}
+
+void CsvWriter::formatRows(const Segment* segments, size_t count, size_t firstIndex, unsigned int turtleNo,
+	std::string& text) const
+{
+	char row[MAX_ROW_SIZE];
+	for (size_t i = 0; i < count; i++) {
+		char* end = this->formatRow(row, segments[i], firstIndex + i, turtleNo);
+		text.append(row, end - row);
+	}
+	this->nRows += count;
+}
+
+char* CsvWriter::formatCoord(char* dest, float coord) const
+{
+	if (this->precision == PRECISION_INTEGRAL) {
+		return std::to_chars(dest, dest + 16, (int)coord).ptr;
+	}
+	double scaled = coord * this->gridFactor;
+	if (scaled <= -1e15 || scaled >= 1e15) {
+		// Beyond the exact integer range, so leave it to the (much slower) library
+		return std::to_chars(dest, dest + 48, coord, std::chars_format::fixed, this->precision).ptr;
+	}
+	long long value = (long long)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+	if (value < 0) {
+		*dest++ = '-';
+		value = -value;
+	}
+	dest = std::to_chars(dest, dest + 24, value / this->gridUnit).ptr;
+	if (this->precision > 0) {
+		long long fraction = value % this->gridUnit;
+		*dest++ = '.';
+		for (int i = this->precision - 1; i >= 0; i--) {
+			dest[i] = (char)('0' + fraction % 10);
+			fraction /= 10;
+		}
+		dest += this->precision;
+	}
+	return dest;
+}
+
+char* CsvWriter::formatRow(char* dest, const Segment& seg, size_t index, unsigned int turtleNo) const
+{
+	static const char HEX_DIGITS[] = "0123456789abcdef";
+	const float coords[4] = { seg.x1, seg.y1, seg.x2, seg.y2 };
+	for (int i = 0; i < 4; i++) {
+		dest = this->formatCoord(dest, coords[i]);
+		*dest++ = this->separator;
+	}
+	// The colour is always written as opaque ("ff" alpha), as it used to be
+	*dest++ = 'f';
+	*dest++ = 'f';
+	for (int shift = 20; shift >= 0; shift -= 4) {
+		*dest++ = HEX_DIGITS[(seg.argb >> shift) & 0xF];
+	}
+	if (this->columns & COL_TURTLE) {
+		*dest++ = this->separator;
+		dest = std::to_chars(dest, dest + 16, turtleNo).ptr;
+	}
+	if (this->columns & COL_INDEX) {
+		*dest++ = this->separator;
+		dest = std::to_chars(dest, dest + 24, (unsigned long long)index).ptr;
+	}
+	*dest++ = '\n';
+	return dest;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Block-buffered emitter for the CSV export of turtle drawings. Rows are
+ * formatted with std::to_chars into a large reusable buffer, which is passed
+ * to the output stream in big blocks (no flushing per row).
+ * The coordinates are either truncated to integers (PRECISION_INTEGRAL, the
+ * former format) or rounded to a fixed number of decimals (half away from zero,
+ * via integer arithmetic on the decimal grid). Optionally, the
+ * number of the turtle and the index of the element within the turtle's
+ * elements are appended as additional columns.
+ * formatRows() is thread-safe and allows concurrent formatting of chunks.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (fast CSV export)
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "SegmentStore.h"
+
+class CsvWriter
+{
+public:
+	static const size_t BUFFER_SIZE = 1 << 20;	// Size of the output buffer
+	static const int PRECISION_INTEGRAL = -1;	// Precision value for truncated coordinates
+	static const int MAX_PRECISION = 6;			// Maximum number of decimals
+	// Flags for optional columns
+	static const unsigned int COL_TURTLE = 1;	// Number of the turtle
+	static const unsigned int COL_INDEX = 2;	// Index of the element within the turtle's elements
+	static const unsigned int N_BASIC_COLUMNS = 5;
+	static const char* const COLUMN_HEADERS[];	// Basic column headers followed by the optional ones
+
+	/* Prepares the emission to the stream out with the given separator, coordinate
+	 * precision (number of decimals or PRECISION_INTEGRAL) and optional columns
+	 * (combination of COL_TURTLE and COL_INDEX) */
+	CsvWriter(std::ostream& out, char separator, int precision = PRECISION_INTEGRAL,
+		unsigned int columns = 0);
+	// Flushes the buffer
+	~CsvWriter();
+
+	// Writes the header row (column names)
+	void writeHeader();
+	/* Writes the rows for the given count segments, the first of which has index
+	 * firstIndex among the elements of turtle number turtleNo */
+	void writeRows(const Segment* segments, size_t count, size_t firstIndex, unsigned int turtleNo);
+	// Appends the rows writeRows() would produce to text (thread-safe)
+	void formatRows(const Segment* segments, size_t count, size_t firstIndex, unsigned int turtleNo,
+		std::string& text) const;
+	// Appends already formatted text (e.g. from formatRows())
+	void writeText(const char* text, size_t length);
+
+	// Passes the buffered text to the stream, returns false if the stream failed
+	bool flush();
+	// Returns the number of rows written or formatted so far (without header)
+	uint64_t getRowCount() const;
+
+private:
+	static const size_t MAX_ROW_SIZE = 256;		// Upper bound for the length of a row
+
+	std::ostream& out;
+	const char separator;
+	const int precision;
+	const unsigned int columns;
+	long long gridUnit;		// 10 ^ precision
+	double gridFactor;		// gridUnit as floating-point number
+	std::vector<char> buffer;
+	char* pos;				// Current write position in buffer
+	char* limit;			// Flush threshold (leaves MAX_ROW_SIZE bytes)
+	mutable std::atomic<uint64_t> nRows;	// Number of rows produced
+
+	// Formats the row for segment seg at dest (at least MAX_ROW_SIZE bytes), returns the end
+	char* formatRow(char* dest, const Segment& seg, size_t index, unsigned int turtleNo) const;
+	// Formats a coordinate according to the precision
+	char* formatCoord(char* dest, float coord) const;
+
+	CsvWriter(const CsvWriter&) = delete;
+	CsvWriter& operator=(const CsvWriter&) = delete;
+};
+
+#endif /*CSVWRITER_H*/
@@ -0,0 +1,106 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Thread-safe collector of damaged rectangles with bounded coalescing.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (dirty-rectangle coalescing)
+ */
+
+#include "DamageAccumulator.h"
+
+DamageAccumulator::DamageAccumulator(size_t maxRects)
+	: maxRects(maxRects > 0 ? maxRects : 1)
+	, stats{ 0, 0, 0, 0 }
+{
+	this->rects.reserve(this->maxRects + 1);
+}
+
+float DamageAccumulator::area(const SegmentBounds& rect)
+{
+	return (rect.right - rect.left) * (rect.bottom - rect.top);
+}
+
+bool DamageAccumulator::worthMerging(const SegmentBounds& r1, const SegmentBounds& r2)
+{
+	if (!r1.intersects(r2)) {
+		return false;
+	}
+	// Overlapping rectangles are merged unless the union adds more area than
+	// the two already cover (e.g. two thin strokes crossing each other)
+	SegmentBounds merged = r1;
+	merged.include(r2);
+	return area(merged) <= 2 * (area(r1) + area(r2));
+}
+
+void DamageAccumulator::add(const SegmentBounds& rect)
+{
+	if (rect.isEmpty()) {
+		return;
+	}
+	std::lock_guard<std::mutex> guard(this->mutex);
+	this->stats.nRaw++;
+	SegmentBounds current = rect;
+	// Absorb all rectangles the growing one overlaps with (repeatedly, as the
+	// union may reach further ones)
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		for (size_t i = 0; i < this->rects.size(); i++) {
+			if (worthMerging(this->rects[i], current)) {
+				current.include(this->rects[i]);
+				this->rects[i] = this->rects.back();
+				this->rects.pop_back();
+				merged = true;
+				break;
+			}
+		}
+	}
+	this->rects.push_back(current);
+	if (this->rects.size() > this->maxRects) {
+		// Too many fragments - a single union is cheaper to handle
+		for (size_t i = 1; i < this->rects.size(); i++) {
+			this->rects[0].include(this->rects[i]);
+		}
+		this->rects.resize(1);
+		this->stats.nCollapsed++;
+	}
+}
+
+void DamageAccumulator::clear()
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	this->rects.clear();
+}
+
+bool DamageAccumulator::take(std::vector<SegmentBounds>& rects)
+{
+	rects.clear();
+	std::lock_guard<std::mutex> guard(this->mutex);
+	if (this->rects.empty()) {
+		return false;
+	}
+	rects.swap(this->rects);
+	this->rects.reserve(this->maxRects + 1);
+	this->stats.nCoalesced += rects.size();
+	this->stats.nFrames++;
+	return true;
+}
+
+bool DamageAccumulator::hasDamage() const
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	return !this->rects.empty();
+}
+
+DamageAccumulator::Stats DamageAccumulator::getStats() const
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	return this->stats;
+}
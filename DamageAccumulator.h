@@ -0,0 +1,69 @@
+#pragma once
+#ifndef DAMAGEACCUMULATOR_H
+#define DAMAGEACCUMULATOR_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Thread-safe collector of damaged rectangles (in turtle coordinates) between
+ * two frames. Overlapping rectangles are merged on insertion, such that only a
+ * small bounded set of rectangles remains; if the set would exceed its limit,
+ * it collapses to the union of all. The counters tell how many rectangles came
+ * in (raw) and how many were handed out (coalesced).
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (dirty-rectangle coalescing)
+ */
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "SegmentStore.h"
+
+class DamageAccumulator
+{
+public:
+	// Default limit of separately kept rectangles
+	static const size_t DEFAULT_MAX_RECTS = 8;
+
+	// Statistics of the accumulator since construction
+	struct Stats {
+		uint64_t nRaw;			// Number of rectangles added
+		uint64_t nCoalesced;	// Number of rectangles handed out by take()
+		uint64_t nFrames;		// Number of take() calls that delivered damage
+		uint64_t nCollapsed;	// Number of times the set collapsed into the union
+	};
+
+	explicit DamageAccumulator(size_t maxRects = DEFAULT_MAX_RECTS);
+
+	// Adds a damaged rectangle, merging it with the rectangles it overlaps
+	void add(const SegmentBounds& rect);
+	// Drops all collected damage (e.g. if the entire area is going to be repainted)
+	void clear();
+	// Moves the collected rectangles to rects (replacing its content) and resets
+	// the set, returns false if there was no damage
+	bool take(std::vector<SegmentBounds>& rects);
+	// Returns true if some damage has been collected
+	bool hasDamage() const;
+	// Returns a snapshot of the counters
+	Stats getStats() const;
+
+private:
+	const size_t maxRects;				// Limit of the set size
+	mutable std::mutex mutex;			// Guards all other members
+	std::vector<SegmentBounds> rects;	// The collected (merged) damage rectangles
+	Stats stats;
+
+	// Returns the area of the given bounds
+	static float area(const SegmentBounds& rect);
+	// Checks whether merging r1 and r2 does not cover much more than both
+	static bool worthMerging(const SegmentBounds& r1, const SegmentBounds& r2);
+};
+
+#endif /*DAMAGEACCUMULATOR_H*/
@@ -0,0 +1,871 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Self-contained streaming compressor for the DEFLATE format (RFC 1951), with
+ * optional zlib (RFC 1950) or gzip (RFC 1952) framing.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (streaming PNG export)
+ */
+
+#include "Deflate.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+	const int LITLEN_CODES = 286;
+	const int DIST_CODES = 30;
+	const int CODELEN_CODES = 19;
+	const int END_OF_BLOCK = 256;
+	const int MAX_BITS = 15;
+	const int MAX_CL_BITS = 7;
+
+	const uint16_t LENGTH_BASE[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+	};
+	const uint8_t LENGTH_EXTRA[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+	};
+	const uint16_t DIST_BASE[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+	};
+	const uint8_t DIST_EXTRA[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+	};
+	// Transmission order of the code length code lengths
+	const uint8_t CODELEN_ORDER[CODELEN_CODES] = {
+		16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+	};
+
+	// Lookup tables derived from the ones above (and the CRC table)
+	struct Tables {
+		uint8_t lengthCode[256];	// (length - 3) -> length code - 257
+		uint8_t distCodeLow[256];	// (distance - 1) -> distance code for distances <= 256
+		uint8_t distCodeHigh[256];	// (distance - 1) >> 7 -> distance code for greater distances
+		uint32_t crc[256];
+		uint16_t fixedLitCodes[288];
+		uint8_t fixedLitLens[288];
+		uint16_t fixedDistCodes[DIST_CODES];
+		uint8_t fixedDistLens[DIST_CODES];
+		Tables();
+	};
+
+	// Computes bit-reversed canonical Huffman codes from the given code lengths
+	void makeCodes(const uint8_t* lengths, int n, uint16_t* codes)
+	{
+		int blCount[MAX_BITS + 1] = { 0 };
+		for (int i = 0; i < n; i++) {
+			blCount[lengths[i]]++;
+		}
+		blCount[0] = 0;
+		int nextCode[MAX_BITS + 2] = { 0 };
+		int code = 0;
+		for (int bits = 1; bits <= MAX_BITS; bits++) {
+			code = (code + blCount[bits - 1]) << 1;
+			nextCode[bits] = code;
+		}
+		for (int i = 0; i < n; i++) {
+			int len = lengths[i];
+			if (len != 0) {
+				int c = nextCode[len]++;
+				int rev = 0;
+				for (int b = 0; b < len; b++) {
+					rev = (rev << 1) | (c & 1);
+					c >>= 1;
+				}
+				codes[i] = (uint16_t)rev;
+			}
+			else {
+				codes[i] = 0;
+			}
+		}
+	}
+
+	Tables::Tables()
+	{
+		for (int code = 0; code < 28; code++) {
+			for (int l = LENGTH_BASE[code] - 3; l < LENGTH_BASE[code] - 3 + (1 << LENGTH_EXTRA[code]); l++) {
+				lengthCode[l] = (uint8_t)code;
+			}
+		}
+		lengthCode[255] = 28;
+		for (int code = 0; code < DIST_CODES; code++) {
+			for (int d = DIST_BASE[code] - 1; d < DIST_BASE[code] - 1 + (1 << DIST_EXTRA[code]); d++) {
+				if (d < 256) {
+					distCodeLow[d] = (uint8_t)code;
+				}
+				else {
+					distCodeHigh[d >> 7] = (uint8_t)code;
+				}
+			}
+		}
+		for (uint32_t n = 0; n < 256; n++) {
+			uint32_t c = n;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			}
+			crc[n] = c;
+		}
+		for (int i = 0; i < 288; i++) {
+			fixedLitLens[i] = (i < 144) ? 8 : (i < 256) ? 9 : (i < 280) ? 7 : 8;
+		}
+		makeCodes(fixedLitLens, 288, fixedLitCodes);
+		for (int i = 0; i < DIST_CODES; i++) {
+			fixedDistLens[i] = 5;
+		}
+		makeCodes(fixedDistLens, DIST_CODES, fixedDistCodes);
+	}
+
+	const Tables& tables()
+	{
+		static const Tables theTables;
+		return theTables;
+	}
+
+	inline int distCode(int dist)
+	{
+		const Tables& tab = tables();
+		return (dist <= 256) ? tab.distCodeLow[dist - 1] : tab.distCodeHigh[(dist - 1) >> 7];
+	}
+
+	struct SymFreq {
+		uint32_t key;		// frequency, later the code length
+		uint16_t symbol;
+	};
+
+	/* Computes the code lengths for the n symbols (sorted by ascending frequency)
+	 * in place, following Moffat & Katajainen ("In-place calculation of minimum-
+	 * redundancy codes", 1995). */
+	void calcMinRedundancy(SymFreq* a, int n)
+	{
+		if (n == 0) {
+			return;
+		}
+		if (n == 1) {
+			a[0].key = 1;
+			return;
+		}
+		a[0].key += a[1].key;
+		int root = 0, leaf = 2;
+		for (int next = 1; next < n - 1; next++) {
+			if (leaf >= n || a[root].key < a[leaf].key) {
+				a[next].key = a[root].key;
+				a[root++].key = (uint32_t)next;
+			}
+			else {
+				a[next].key = a[leaf++].key;
+			}
+			if (leaf >= n || (root < next && a[root].key < a[leaf].key)) {
+				a[next].key += a[root].key;
+				a[root++].key = (uint32_t)next;
+			}
+			else {
+				a[next].key += a[leaf++].key;
+			}
+		}
+		a[n - 2].key = 0;
+		for (int next = n - 3; next >= 0; next--) {
+			a[next].key = a[a[next].key].key + 1;
+		}
+		int avbl = 1, used = 0, depth = 0;
+		root = n - 2;
+		int next = n - 1;
+		while (avbl > 0) {
+			while (root >= 0 && (int)a[root].key == depth) {
+				used++;
+				root--;
+			}
+			while (avbl > used) {
+				a[next--].key = (uint32_t)depth;
+				avbl--;
+			}
+			avbl = 2 * used;
+			depth++;
+			used = 0;
+		}
+	}
+
+	/* Derives length-limited (maxBits) Huffman code lengths for the n symbols
+	 * with frequencies freqs. Symbols without occurrence get length 0. */
+	void buildLengths(const uint32_t* freqs, int n, int maxBits, uint8_t* lengths)
+	{
+		SymFreq syms[LITLEN_CODES];
+		int nUsed = 0;
+		for (int i = 0; i < n; i++) {
+			lengths[i] = 0;
+			if (freqs[i] != 0) {
+				syms[nUsed].key = freqs[i];
+				syms[nUsed].symbol = (uint16_t)i;
+				nUsed++;
+			}
+		}
+		std::stable_sort(syms, syms + nUsed,
+			[](const SymFreq& s1, const SymFreq& s2) { return s1.key < s2.key; });
+		calcMinRedundancy(syms, nUsed);
+		// Count the codes per length and enforce the length limit (keeping the Kraft sum)
+		int numCodes[33] = { 0 };
+		for (int i = 0; i < nUsed; i++) {
+			numCodes[(std::min)(syms[i].key, (uint32_t)32)]++;
+		}
+		if (nUsed > 1) {
+			for (int i = maxBits + 1; i <= 32; i++) {
+				numCodes[maxBits] += numCodes[i];
+				numCodes[i] = 0;
+			}
+			uint32_t total = 0;
+			for (int i = maxBits; i > 0; i--) {
+				total += (uint32_t)numCodes[i] << (maxBits - i);
+			}
+			while (total != (1u << maxBits)) {
+				numCodes[maxBits]--;
+				for (int i = maxBits - 1; i > 0; i--) {
+					if (numCodes[i] != 0) {
+						numCodes[i]--;
+						numCodes[i + 1] += 2;
+						break;
+					}
+				}
+				total--;
+			}
+		}
+		// The most frequent symbols get the shortest codes
+		int k = nUsed;
+		for (int len = 1; len <= maxBits; len++) {
+			for (int j = numCodes[len]; j > 0; j--) {
+				lengths[syms[--k].symbol] = (uint8_t)len;
+			}
+		}
+	}
+
+	// Run-length encoded code length sequence element
+	struct CodeLenItem {
+		uint8_t symbol;		// 0..18
+		uint8_t extra;		// repeat count bits
+	};
+
+	/* Run-length encodes the concatenated code lengths of literal/length and
+	 * distance alphabet into items and counts the symbol frequencies. */
+	void encodeCodeLengths(const uint8_t* lens, int n, std::vector<CodeLenItem>& items, uint32_t* freqs)
+	{
+		int i = 0;
+		while (i < n) {
+			uint8_t len = lens[i];
+			int run = 1;
+			while (i + run < n && lens[i + run] == len) {
+				run++;
+			}
+			i += run;
+			if (len == 0) {
+				while (run >= 11) {
+					int r = (std::min)(run, 138);
+					items.push_back(CodeLenItem{ 18, (uint8_t)(r - 11) });
+					freqs[18]++;
+					run -= r;
+				}
+				if (run >= 3) {
+					items.push_back(CodeLenItem{ 17, (uint8_t)(run - 3) });
+					freqs[17]++;
+					run = 0;
+				}
+			}
+			else {
+				items.push_back(CodeLenItem{ len, 0 });
+				freqs[len]++;
+				run--;
+				while (run >= 3) {
+					int r = (std::min)(run, 6);
+					items.push_back(CodeLenItem{ 16, (uint8_t)(r - 3) });
+					freqs[16]++;
+					run -= r;
+				}
+			}
+			while (run-- > 0) {
+				items.push_back(CodeLenItem{ len, 0 });
+				freqs[len]++;
+			}
+		}
+	}
+
+}
+
+Deflater::Deflater(ByteSink& sink, int level, Format format)
+	: sink(sink)
+	, format(format)
+	, level((std::max)(0, (std::min)(9, level)))
+	, window(2 * WSIZE)
+	, head(HASH_SIZE, -1)
+	, prev(WSIZE, -1)
+	, strStart(0)
+	, lookahead(0)
+	, blockStart(0)
+	, blockLength(0)
+	, matchAvailable(0)
+	, prevLength(MIN_MATCH - 1)
+	, prevMatch(0)
+	, bitBuf(0)
+	, bitCount(0)
+	, checksum(format == ZLIB ? 1 : 0)
+	, totalIn(0)
+	, totalOut(0)
+	, headerDone(false)
+	, finished(false)
+{
+	// good, lazy, nice, chain per level as established by zlib
+	static const int CONFIG[10][4] = {
+		{ 0, 0, 0, 0 },
+		{ 4, 4, 8, 4 }, { 4, 5, 16, 8 }, { 4, 6, 32, 32 },
+		{ 4, 4, 16, 16 }, { 8, 16, 32, 32 }, { 8, 16, 128, 128 },
+		{ 8, 32, 128, 256 }, { 32, 128, 258, 1024 }, { 32, 258, 258, 4096 }
+	};
+	this->goodMatch = CONFIG[this->level][0];
+	this->lazyMatch = CONFIG[this->level][1];
+	this->niceMatch = CONFIG[this->level][2];
+	this->maxChain = CONFIG[this->level][3];
+	this->symbols.reserve(SYM_BUF_SIZE);
+	this->outBuf.reserve(OUT_BUF_SIZE + 8);
+}
+
+Deflater::~Deflater()
+{
+}
+
+uint32_t Deflater::crc32(uint32_t crc, const void* data, size_t length)
+{
+	const uint32_t* table = tables().crc;
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	crc = ~crc;
+	for (size_t i = 0; i < length; i++) {
+		crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+uint32_t Deflater::adler32(uint32_t adler, const void* data, size_t length)
+{
+	const uint32_t BASE = 65521;
+	const size_t NMAX = 5552;	// Max. bytes before the sums may overflow
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint32_t a = adler & 0xFFFF, b = adler >> 16;
+	while (length > 0) {
+		size_t n = (std::min)(length, NMAX);
+		length -= n;
+		while (n-- > 0) {
+			a += *bytes++;
+			b += a;
+		}
+		a %= BASE;
+		b %= BASE;
+	}
+	return (b << 16) | a;
+}
+
+uint32_t Deflater::adler32Combine(uint32_t adler1, uint32_t adler2, uint64_t length2)
+{
+	// As in zlib: the sums of the second part are shifted by the first part
+	const uint32_t BASE = 65521;
+	uint32_t rem = (uint32_t)(length2 % BASE);
+	uint32_t sum1 = adler1 & 0xFFFF;
+	uint32_t sum2 = (rem * sum1) % BASE;
+	sum1 += (adler2 & 0xFFFF) + BASE - 1;
+	sum2 += (adler1 >> 16) + (adler2 >> 16) + BASE - rem;
+	if (sum1 >= BASE) {
+		sum1 -= BASE;
+	}
+	if (sum1 >= BASE) {
+		sum1 -= BASE;
+	}
+	if (sum2 >= 2 * BASE) {
+		sum2 -= 2 * BASE;
+	}
+	if (sum2 >= BASE) {
+		sum2 -= BASE;
+	}
+	return (sum2 << 16) | sum1;
+}
+
+void Deflater::getZlibHeader(int level, unsigned char header[2])
+{
+	// CMF: deflate with 32K window; FLG: level hint, check bits
+	int levelHint = (level < 2) ? 0 : (level < 6) ? 1 : (level == 6) ? 2 : 3;
+	unsigned int value = (0x78 << 8) | (levelHint << 6);
+	value += 31 - value % 31;
+	header[0] = (unsigned char)(value >> 8);
+	header[1] = (unsigned char)value;
+}
+
+void Deflater::writeHeader()
+{
+	if (this->format == ZLIB) {
+		unsigned char header[2];
+		getZlibHeader(this->level, header);
+		this->putByte(header[0]);
+		this->putByte(header[1]);
+	}
+	else if (this->format == GZIP) {
+		const unsigned char header[10] = {
+			0x1F, 0x8B, 8, 0, 0, 0, 0, 0,
+			(unsigned char)(this->level == 9 ? 2 : this->level == 1 ? 4 : 0),
+			0xFF	// unknown OS
+		};
+		for (int i = 0; i < 10; i++) {
+			this->putByte(header[i]);
+		}
+	}
+	this->headerDone = true;
+}
+
+void Deflater::write(const void* data, size_t length)
+{
+	if (this->finished) {
+		return;
+	}
+	if (!this->headerDone) {
+		this->writeHeader();
+	}
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	if (this->format == ZLIB) {
+		this->checksum = adler32(this->checksum, bytes, length);
+	}
+	else if (this->format == GZIP) {
+		this->checksum = crc32(this->checksum, bytes, length);
+	}
+	this->totalIn += length;
+	while (length > 0) {
+		if (this->strStart >= 2 * WSIZE - MIN_LOOKAHEAD) {
+			this->slideWindow();
+		}
+		int space = 2 * WSIZE - (this->strStart + this->lookahead);
+		int n = (int)(std::min)(length, (size_t)space);
+		memcpy(&this->window[this->strStart + this->lookahead], bytes, n);
+		this->lookahead += n;
+		bytes += n;
+		length -= n;
+		this->process(false);
+	}
+	this->flushOutput(false);
+}
+
+void Deflater::finish()
+{
+	if (this->finished) {
+		return;
+	}
+	if (!this->headerDone) {
+		this->writeHeader();
+	}
+	this->process(true);
+	this->flushBlock(true);
+	this->alignToByte();
+	if (this->format == ZLIB) {
+		for (int shift = 24; shift >= 0; shift -= 8) {
+			this->putByte((unsigned char)(this->checksum >> shift));
+		}
+	}
+	else if (this->format == GZIP) {
+		uint32_t size = (uint32_t)this->totalIn;
+		for (int shift = 0; shift < 32; shift += 8) {
+			this->putByte((unsigned char)(this->checksum >> shift));
+		}
+		for (int shift = 0; shift < 32; shift += 8) {
+			this->putByte((unsigned char)(size >> shift));
+		}
+	}
+	this->flushOutput(true);
+	this->finished = true;
+}
+
+void Deflater::flush()
+{
+	if (this->finished) {
+		return;
+	}
+	if (!this->headerDone) {
+		this->writeHeader();
+	}
+	this->process(true);
+	if (this->strStart > this->blockStart) {
+		this->flushBlock(false);
+	}
+	this->writeStored(nullptr, 0, false);
+	this->flushOutput(true);
+}
+
+void Deflater::setDictionary(const void* data, size_t length)
+{
+	if (this->finished || this->totalIn > 0) {
+		return;
+	}
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	if (length > MAX_DICTIONARY) {
+		bytes += length - MAX_DICTIONARY;
+		length = MAX_DICTIONARY;
+	}
+	if (length > 0) {
+		memcpy(&this->window[0], bytes, length);
+	}
+	this->strStart = this->blockStart = (int)length;
+	for (int pos = 0; pos + MIN_MATCH <= (int)length; pos++) {
+		this->insertString(pos);
+	}
+}
+
+void Deflater::slideWindow()
+{
+	memmove(&this->window[0], &this->window[WSIZE], WSIZE);
+	this->strStart -= WSIZE;
+	this->blockStart -= WSIZE;
+	this->prevMatch -= WSIZE;
+	for (int& pos : this->head) {
+		pos = (pos >= WSIZE) ? pos - WSIZE : -1;
+	}
+	for (int& pos : this->prev) {
+		pos = (pos >= WSIZE) ? pos - WSIZE : -1;
+	}
+}
+
+int Deflater::longestMatch(int curMatch, int& matchStart)
+{
+	int chain = this->maxChain;
+	int bestLen = this->prevLength;
+	if (this->prevLength >= this->goodMatch) {
+		chain >>= 2;
+	}
+	const int limit = (this->strStart > MAX_DIST) ? this->strStart - MAX_DIST : 0;
+	const int maxLen = (std::min)(MAX_MATCH, this->lookahead);
+	const int nice = (std::min)(this->niceMatch, maxLen);
+	const unsigned char* win = this->window.data();
+	const unsigned char* scan = win + this->strStart;
+	if (bestLen >= maxLen) {
+		return bestLen;
+	}
+	do {
+		const unsigned char* match = win + curMatch;
+		if (match[bestLen] != scan[bestLen] || match[0] != scan[0] || match[1] != scan[1]) {
+			continue;
+		}
+		int len = 2;
+		while (len < maxLen && match[len] == scan[len]) {
+			len++;
+		}
+		if (len > bestLen) {
+			matchStart = curMatch;
+			bestLen = len;
+			if (len >= nice) {
+				break;
+			}
+		}
+	} while ((curMatch = this->prev[curMatch & WMASK]) >= limit && curMatch >= 0 && --chain != 0);
+	return bestLen;
+}
+
+void Deflater::process(bool flush)
+{
+	const int minAhead = flush ? 0 : MIN_LOOKAHEAD;
+	if (this->level == 0) {
+		// Stored blocks only - just collect the bytes (as literals) in the window
+		while (this->lookahead > minAhead) {
+			int n = (std::min)(this->lookahead - minAhead, 65535 - (this->strStart - this->blockStart));
+			this->strStart += n;
+			this->lookahead -= n;
+			if (this->strStart - this->blockStart >= 65535 || this->strStart >= 2 * WSIZE - MIN_LOOKAHEAD) {
+				this->flushBlock(false);
+			}
+		}
+		return;
+	}
+	const bool lazy = this->level >= 4;
+	while (this->lookahead > minAhead) {
+		int hashHead = -1;
+		if (this->lookahead >= MIN_MATCH) {
+			hashHead = this->head[this->hashAt(this->strStart)];
+			this->insertString(this->strStart);
+		}
+		if (!lazy) {
+			int matchLen = 0, matchStart = 0;
+			this->prevLength = MIN_MATCH - 1;
+			if (hashHead >= 0 && this->strStart - hashHead <= MAX_DIST) {
+				matchLen = this->longestMatch(hashHead, matchStart);
+			}
+			if (matchLen >= MIN_MATCH) {
+				int maxInsert = this->strStart + this->lookahead - MIN_MATCH;
+				this->emitMatch(matchLen, this->strStart - matchStart);
+				this->lookahead -= matchLen;
+				if (matchLen <= this->lazyMatch) {
+					// Insert the skipped strings as well (the first one is already in)
+					for (int pos = this->strStart + 1; pos < this->strStart + matchLen && pos <= maxInsert; pos++) {
+						this->insertString(pos);
+					}
+				}
+				this->strStart += matchLen;
+			}
+			else {
+				this->emitLiteral(this->window[this->strStart]);
+				this->strStart++;
+				this->lookahead--;
+			}
+		}
+		else {
+			int prevLen = this->prevLength;
+			int prevStart = this->prevMatch;
+			int matchLen = MIN_MATCH - 1, matchStart = 0;
+			if (hashHead >= 0 && prevLen < this->lazyMatch && this->strStart - hashHead <= MAX_DIST) {
+				matchLen = this->longestMatch(hashHead, matchStart);
+				if (matchLen <= this->prevLength) {
+					matchLen = MIN_MATCH - 1;
+				}
+				if (matchLen == MIN_MATCH && this->strStart - matchStart > 4096) {
+					// A short far match costs more than literals
+					matchLen = MIN_MATCH - 1;
+				}
+			}
+			if (prevLen >= MIN_MATCH && matchLen <= prevLen) {
+				// The previous match is better - emit it
+				int matchEnd = this->strStart - 1 + prevLen;
+				int maxInsert = this->strStart + this->lookahead - MIN_MATCH;
+				this->emitMatch(prevLen, this->strStart - 1 - prevStart);
+				// The strings up to strStart are already inserted
+				this->lookahead -= prevLen - 1;
+				for (int pos = this->strStart + 1; pos < matchEnd && pos <= maxInsert; pos++) {
+					this->insertString(pos);
+				}
+				this->strStart = matchEnd;
+				this->matchAvailable = 0;
+				this->prevLength = MIN_MATCH - 1;
+			}
+			else {
+				if (this->matchAvailable) {
+					// Emit the pending literal, keep the current match for comparison
+					this->emitLiteral(this->window[this->strStart - 1]);
+				}
+				this->matchAvailable = 1;
+				this->prevLength = matchLen;
+				this->prevMatch = matchStart;
+				this->strStart++;
+				this->lookahead--;
+			}
+		}
+		if (this->strStart >= 2 * WSIZE - MIN_LOOKAHEAD && !flush) {
+			return;	// The caller has to slide the window
+		}
+	}
+	if (flush && lazy && this->matchAvailable) {
+		this->emitLiteral(this->window[this->strStart - 1]);
+		this->matchAvailable = 0;
+		this->prevLength = MIN_MATCH - 1;
+	}
+}
+
+void Deflater::emitLiteral(unsigned char c)
+{
+	this->symbols.push_back(Symbol{ c, 0 });
+	this->blockLength++;
+	if (this->symbols.size() >= SYM_BUF_SIZE) {
+		this->flushBlock(false);
+	}
+}
+
+void Deflater::emitMatch(int length, int distance)
+{
+	this->symbols.push_back(Symbol{ (uint16_t)(length - MIN_MATCH), (uint16_t)distance });
+	this->blockLength += length;
+	if (this->symbols.size() >= SYM_BUF_SIZE) {
+		this->flushBlock(false);
+	}
+}
+
+void Deflater::flushBlock(bool last)
+{
+	const Tables& tab = tables();
+	// Level 0 just collects the bytes, otherwise the block ends with the last symbol
+	int blockEnd = (this->level == 0) ? this->strStart : this->blockStart + this->blockLength;
+	size_t storedLen = (size_t)(blockEnd - this->blockStart);
+	this->blockLength = 0;
+	if (this->level == 0) {
+		this->writeStored(&this->window[this->blockStart], storedLen, last);
+		this->blockStart = blockEnd;
+		return;
+	}
+	uint32_t litFreq[LITLEN_CODES] = { 0 };
+	uint32_t distFreq[DIST_CODES] = { 0 };
+	for (const Symbol& sym : this->symbols) {
+		if (sym.dist == 0) {
+			litFreq[sym.litLen]++;
+		}
+		else {
+			litFreq[257 + tab.lengthCode[sym.litLen]]++;
+			distFreq[distCode(sym.dist)]++;
+		}
+	}
+	litFreq[END_OF_BLOCK] = 1;
+	// Bit costs of the symbol data with fixed codes
+	uint64_t extraBits = 0, fixedBits = 3;
+	for (int i = 0; i < LITLEN_CODES; i++) {
+		fixedBits += (uint64_t)litFreq[i] * tab.fixedLitLens[i];
+		if (i > 256) {
+			extraBits += (uint64_t)litFreq[i] * LENGTH_EXTRA[i - 257];
+		}
+	}
+	for (int i = 0; i < DIST_CODES; i++) {
+		fixedBits += (uint64_t)distFreq[i] * 5;
+		extraBits += (uint64_t)distFreq[i] * DIST_EXTRA[i];
+	}
+	fixedBits += extraBits;
+	// Make sure both trees are complete codes (some decoders insist on it)
+	int nLitUsed = 0, nDistUsed = 0;
+	for (int i = 0; i < LITLEN_CODES; i++) { if (litFreq[i]) nLitUsed++; }
+	for (int i = 0; i < DIST_CODES; i++) { if (distFreq[i]) nDistUsed++; }
+	uint32_t treeLitFreq[LITLEN_CODES], treeDistFreq[DIST_CODES];
+	std::copy(litFreq, litFreq + LITLEN_CODES, treeLitFreq);
+	std::copy(distFreq, distFreq + DIST_CODES, treeDistFreq);
+	if (nLitUsed < 2) { treeLitFreq[treeLitFreq[0] ? 1 : 0]++; }
+	for (int i = 0; nDistUsed < 2; i++) {
+		if (treeDistFreq[i] == 0) {
+			treeDistFreq[i] = 1;
+			nDistUsed++;
+		}
+	}
+	uint8_t litLens[LITLEN_CODES], distLens[DIST_CODES];
+	buildLengths(treeLitFreq, LITLEN_CODES, MAX_BITS, litLens);
+	buildLengths(treeDistFreq, DIST_CODES, MAX_BITS, distLens);
+	int hlit = LITLEN_CODES, hdist = DIST_CODES;
+	while (hlit > 257 && litLens[hlit - 1] == 0) { hlit--; }
+	while (hdist > 1 && distLens[hdist - 1] == 0) { hdist--; }
+	uint8_t allLens[LITLEN_CODES + DIST_CODES];
+	std::copy(litLens, litLens + hlit, allLens);
+	std::copy(distLens, distLens + hdist, allLens + hlit);
+	std::vector<CodeLenItem> clItems;
+	uint32_t clFreq[CODELEN_CODES] = { 0 };
+	encodeCodeLengths(allLens, hlit + hdist, clItems, clFreq);
+	uint8_t clLens[CODELEN_CODES];
+	buildLengths(clFreq, CODELEN_CODES, MAX_CL_BITS, clLens);
+	int hclen = CODELEN_CODES;
+	while (hclen > 4 && clLens[CODELEN_ORDER[hclen - 1]] == 0) { hclen--; }
+	uint64_t dynBits = 3 + 5 + 5 + 4 + 3 * (uint64_t)hclen + extraBits;
+	for (int i = 0; i < CODELEN_CODES; i++) {
+		dynBits += (uint64_t)clFreq[i] * clLens[i];
+	}
+	dynBits += (uint64_t)clFreq[16] * 2 + (uint64_t)clFreq[17] * 3 + (uint64_t)clFreq[18] * 7;
+	for (int i = 0; i < LITLEN_CODES; i++) {
+		dynBits += (uint64_t)litFreq[i] * litLens[i];
+	}
+	for (int i = 0; i < DIST_CODES; i++) {
+		dynBits += (uint64_t)distFreq[i] * distLens[i];
+	}
+	// Stored blocks are only possible while the block data is still in the window
+	uint64_t storedBits = UINT64_MAX;
+	if (this->blockStart >= 0) {
+		storedBits = (storedLen / 65535 + 1) * (3 + 7 + 32) + 8 * (uint64_t)storedLen;
+	}
+
+	if (storedBits <= fixedBits && storedBits <= dynBits) {
+		this->writeStored(&this->window[this->blockStart], storedLen, last);
+	}
+	else if (fixedBits <= dynBits) {
+		this->putBits((last ? 1 : 0) | (1 << 1), 3);
+		this->writeSymbols(tab.fixedLitCodes, tab.fixedLitLens, tab.fixedDistCodes, tab.fixedDistLens);
+	}
+	else {
+		uint16_t litCodes[LITLEN_CODES], distCodes[DIST_CODES], clCodes[CODELEN_CODES];
+		makeCodes(litLens, LITLEN_CODES, litCodes);
+		makeCodes(distLens, DIST_CODES, distCodes);
+		makeCodes(clLens, CODELEN_CODES, clCodes);
+		this->putBits((last ? 1 : 0) | (2 << 1), 3);
+		this->putBits(hlit - 257, 5);
+		this->putBits(hdist - 1, 5);
+		this->putBits(hclen - 4, 4);
+		for (int i = 0; i < hclen; i++) {
+			this->putBits(clLens[CODELEN_ORDER[i]], 3);
+		}
+		for (const CodeLenItem& item : clItems) {
+			this->putBits(clCodes[item.symbol], clLens[item.symbol]);
+			switch (item.symbol) {
+			case 16: this->putBits(item.extra, 2); break;
+			case 17: this->putBits(item.extra, 3); break;
+			case 18: this->putBits(item.extra, 7); break;
+			}
+		}
+		this->writeSymbols(litCodes, litLens, distCodes, distLens);
+	}
+	this->symbols.clear();
+	this->blockStart = blockEnd;
+}
+
+void Deflater::writeSymbols(const uint16_t* litCodes, const uint8_t* litLens,
+	const uint16_t* distCodes, const uint8_t* distLens)
+{
+	const Tables& tab = tables();
+	for (const Symbol& sym : this->symbols) {
+		if (sym.dist == 0) {
+			this->putBits(litCodes[sym.litLen], litLens[sym.litLen]);
+		}
+		else {
+			int lc = tab.lengthCode[sym.litLen];
+			this->putBits(litCodes[257 + lc], litLens[257 + lc]);
+			if (LENGTH_EXTRA[lc] != 0) {
+				this->putBits(sym.litLen + MIN_MATCH - LENGTH_BASE[lc], LENGTH_EXTRA[lc]);
+			}
+			int dc = distCode(sym.dist);
+			this->putBits(distCodes[dc], distLens[dc]);
+			if (DIST_EXTRA[dc] != 0) {
+				this->putBits(sym.dist - DIST_BASE[dc], DIST_EXTRA[dc]);
+			}
+		}
+	}
+	this->putBits(litCodes[END_OF_BLOCK], litLens[END_OF_BLOCK]);
+	this->flushOutput(false);
+}
+
+void Deflater::writeStored(const unsigned char* data, size_t length, bool last)
+{
+	do {
+		size_t n = (std::min)(length, (size_t)65535);
+		length -= n;
+		this->putBits((last && length == 0) ? 1 : 0, 3);
+		this->alignToByte();
+		this->putByte((unsigned char)n);
+		this->putByte((unsigned char)(n >> 8));
+		this->putByte((unsigned char)~n);
+		this->putByte((unsigned char)(~n >> 8));
+		this->outBuf.insert(this->outBuf.end(), data, data + n);
+		data += n;
+		this->flushOutput(false);
+	} while (length > 0);
+}
+
+void Deflater::alignToByte()
+{
+	while (this->bitCount > 0) {
+		this->outBuf.push_back((unsigned char)this->bitBuf);
+		this->bitBuf >>= 8;
+		this->bitCount = (std::max)(0, this->bitCount - 8);
+	}
+	this->bitBuf = 0;
+}
+
+void Deflater::putByte(unsigned char b)
+{
+	// Only to be used on byte boundaries
+	this->outBuf.push_back(b);
+}
+
+void Deflater::flushOutput(bool all)
+{
+	if (all || this->outBuf.size() >= OUT_BUF_SIZE) {
+		if (!this->outBuf.empty()) {
+			this->sink.put(this->outBuf.data(), this->outBuf.size());
+			this->totalOut += this->outBuf.size();
+			this->outBuf.clear();
+		}
+	}
+}
@@ -0,0 +1,207 @@
+#pragma once
+#ifndef DEFLATE_H
+#define DEFLATE_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Self-contained streaming compressor for the DEFLATE format (RFC 1951), with
+ * optional zlib (RFC 1950) or gzip (RFC 1952) framing, as needed for PNG (and
+ * other) exports without any third-party library.
+ * LZ77 matching via hash chains (greedy for the low, lazy for the higher levels),
+ * each block is emitted as stored, fixed or dynamic Huffman block, whichever is
+ * the shortest.
+ * For a parallel compression (pigz-style), separate RAW deflaters may compress
+ * consecutive pieces of the data, each primed with the tail of its predecessor
+ * as dictionary and ended with a sync flush, such that their outputs can simply
+ * be concatenated (the checksums being combined via adler32Combine()).
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Sync flush, preset dictionary, StringSink, and Adler-32 combination
+ *              (parallel PNG compression)
+ * 2026-10-18   StreamSink added (compressed SVG export)
+ * 2026-10-18   Created for VERSION 11.1.0 (streaming PNG export)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Receiver of the compressed (or otherwise produced) byte stream
+class ByteSink
+{
+public:
+	virtual ~ByteSink() {}
+	// Consumes the given length bytes at data
+	virtual void put(const unsigned char* data, size_t length) = 0;
+};
+
+// Byte sink passing everything to an output stream (which should be binary)
+class StreamSink : public ByteSink
+{
+public:
+	explicit StreamSink(std::ostream& out) : out(out) {}
+	virtual void put(const unsigned char* data, size_t length)
+	{
+		out.write(reinterpret_cast<const char*>(data), length);
+	}
+private:
+	std::ostream& out;
+};
+
+// Byte sink appending everything to a string
+class StringSink : public ByteSink
+{
+public:
+	explicit StringSink(std::string& text) : text(text) {}
+	virtual void put(const unsigned char* data, size_t length)
+	{
+		text.append(reinterpret_cast<const char*>(data), length);
+	}
+private:
+	std::string& text;
+};
+
+class Deflater
+{
+public:
+	// Framing of the compressed data
+	enum Format {
+		RAW,	// bare DEFLATE stream
+		ZLIB,	// zlib header and Adler-32 trailer
+		GZIP	// gzip header and CRC-32 trailer
+	};
+	static const int DEFAULT_LEVEL = 6;		// Compression level (0 = stored ... 9 = best)
+	static const size_t MAX_DICTIONARY = 32768;	// Maximum useful dictionary length
+
+	// Prepares a compressor passing its output to sink
+	Deflater(ByteSink& sink, int level = DEFAULT_LEVEL, Format format = ZLIB);
+	~Deflater();
+
+	// Compresses the given length bytes at data
+	void write(const void* data, size_t length);
+	// Compresses all pending data, terminates the stream and writes the trailer
+	// (no further writes allowed afterwards)
+	void finish();
+	// Compresses all pending data and ends the current block with an empty stored
+	// block, such that the output so far ends on a byte boundary (sync flush)
+	void flush();
+	// Primes the window with (the last MAX_DICTIONARY bytes of) the given data before
+	// the first write, such that matches may refer to it (meant for RAW streams, the
+	// headers don't announce a dictionary)
+	void setDictionary(const void* data, size_t length);
+
+	// Returns the number of uncompressed bytes consumed so far
+	inline uint64_t getTotalIn() const { return totalIn; }
+	// Returns the number of bytes passed to the sink so far
+	inline uint64_t getTotalOut() const { return totalOut; }
+
+	// Updates the CRC-32 checksum crc (start with 0) by the given bytes
+	static uint32_t crc32(uint32_t crc, const void* data, size_t length);
+	// Updates the Adler-32 checksum adler (start with 1) by the given bytes
+	static uint32_t adler32(uint32_t adler, const void* data, size_t length);
+	// Returns the Adler-32 checksum of the concatenation of two byte sequences with the
+	// checksums adler1 and adler2, the second one having length2 bytes
+	static uint32_t adler32Combine(uint32_t adler1, uint32_t adler2, uint64_t length2);
+	// Puts the zlib header for the given compression level into header
+	static void getZlibHeader(int level, unsigned char header[2]);
+
+private:
+	static const int WSIZE = 32768;			// Window size (maximum distance)
+	static const int WMASK = WSIZE - 1;
+	static const int HASH_BITS = 15;
+	static const int HASH_SIZE = 1 << HASH_BITS;
+	static const int HASH_MASK = HASH_SIZE - 1;
+	static const int MIN_MATCH = 3;
+	static const int MAX_MATCH = 258;
+	static const int MIN_LOOKAHEAD = MAX_MATCH + MIN_MATCH + 1;
+	static const int MAX_DIST = WSIZE - MIN_LOOKAHEAD;
+	static const size_t SYM_BUF_SIZE = 16384;	// Symbols per block
+	static const size_t OUT_BUF_SIZE = 16384;	// Output bytes buffered before passing them on
+
+	// Symbol of the LZ77 stage: a literal (dist == 0) or a match
+	struct Symbol {
+		uint16_t litLen;	// literal byte or match length - MIN_MATCH
+		uint16_t dist;		// match distance or 0
+	};
+
+	ByteSink& sink;
+	const Format format;
+	const int level;
+	int goodMatch, lazyMatch, niceMatch, maxChain;	// Level-dependent parameters
+	std::vector<unsigned char> window;		// Sliding window (2 * WSIZE)
+	std::vector<int> head;					// Hash chain heads (-1 = none)
+	std::vector<int> prev;					// Hash chain links
+	int strStart;							// Current position in the window
+	int lookahead;							// Number of valid bytes from strStart
+	int blockStart;							// Window position of the current block start
+	int blockLength;						// Number of bytes covered by the block symbols
+	int matchAvailable;						// Lazy evaluation: a literal is still pending
+	int prevLength, prevMatch;				// Lazy evaluation: previous match
+	std::vector<Symbol> symbols;			// Symbols of the current block
+	std::vector<unsigned char> outBuf;		// Buffered output
+	uint64_t bitBuf;						// Bits not yet written
+	int bitCount;							// Number of bits in bitBuf
+	uint32_t checksum;						// Running Adler-32 or CRC-32
+	uint64_t totalIn, totalOut;
+	bool headerDone, finished;
+
+	// Writes the zlib or gzip header if necessary
+	void writeHeader();
+	// Runs the LZ77 stage on the window contents (keeping MIN_LOOKAHEAD unless flushing)
+	void process(bool flush);
+	// Computes the hash of the 3 bytes at window position pos
+	inline int hashAt(int pos) const
+	{
+		return ((window[pos] << 10) ^ (window[pos + 1] << 5) ^ window[pos + 2]) & HASH_MASK;
+	}
+	// Inserts the string at pos into the hash chains
+	inline void insertString(int pos)
+	{
+		int h = hashAt(pos);
+		prev[pos & WMASK] = head[h];
+		head[h] = pos;
+	}
+	// Finds the longest match for strStart along the chain starting at curMatch
+	int longestMatch(int curMatch, int& matchStart);
+	// Shifts the upper half of the window down
+	void slideWindow();
+	// Appends a symbol, flushes the block if the symbol buffer is full
+	void emitLiteral(unsigned char c);
+	void emitMatch(int length, int distance);
+	// Emits the current block (as stored, fixed or dynamic block)
+	void flushBlock(bool last);
+	void writeStored(const unsigned char* data, size_t length, bool last);
+	void writeSymbols(const uint16_t* litCodes, const uint8_t* litLens,
+		const uint16_t* distCodes, const uint8_t* distLens);
+	// Bit output (LSB first)
+	inline void putBits(uint32_t value, int n)
+	{
+		bitBuf |= (uint64_t)value << bitCount;
+		bitCount += n;
+		if (bitCount >= 32) {
+			unsigned char bytes[4] = {
+				(unsigned char)bitBuf, (unsigned char)(bitBuf >> 8),
+				(unsigned char)(bitBuf >> 16), (unsigned char)(bitBuf >> 24) };
+			outBuf.insert(outBuf.end(), bytes, bytes + 4);
+			bitBuf >>= 32;
+			bitCount -= 32;
+		}
+	}
+	void alignToByte();
+	void putByte(unsigned char b);
+	void flushOutput(bool all);
+
+	Deflater(const Deflater&) = delete;
+	Deflater& operator=(const Deflater&) = delete;
+};
+
+#endif /*DEFLATE_H*/
@@ -0,0 +1,172 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Animated export of the drawing progress as APNG, see DrawingAnimation.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (animated drawing export)
+ */
+
+#include "DrawingAnimation.h"
+#include "Turtle.h"
+#include "PngEncoder.h"
+#include <climits>
+#include <cmath>
+
+DrawingAnimation::DrawingAnimation(const RectF& bounds, Color background, float scale)
+	: bounds(bounds)
+	, background(background)
+	, scale(scale)
+	, nFrames(0)
+	, nEncodedPixels(0)
+{
+}
+
+void DrawingAnimation::addLayer(const std::vector<SegmentChunkView>& chunks)
+{
+	this->layers.push_back(chunks);
+}
+
+size_t DrawingAnimation::getStepFor(unsigned int nFrames) const
+{
+	// The longest layer determines the number of steps
+	size_t maxCount = 0;
+	for (const std::vector<SegmentChunkView>& chunks : this->layers) {
+		size_t count = 0;
+		for (const SegmentChunkView& chunk : chunks) {
+			count += chunk.count;
+		}
+		maxCount = (std::max)(maxCount, count);
+	}
+	if (nFrames < 2) {
+		return (std::max)(maxCount, (size_t)1);
+	}
+	// The first frame shows the empty canvas
+	return (std::max)((maxCount + nFrames - 2) / (nFrames - 1), (size_t)1);
+}
+
+void DrawingAnimation::advance(size_t ix, Cursor& cursor, size_t count, std::vector<SegmentChunkView>& slices,
+	SegmentBounds& dirty) const
+{
+	const std::vector<SegmentChunkView>& chunks = this->layers[ix];
+	while (count > 0 && cursor.chunk < chunks.size()) {
+		const SegmentChunkView& chunk = chunks[cursor.chunk];
+		size_t n = (std::min)(count, chunk.count - cursor.offset);
+		SegmentChunkView slice = { chunk.segments + cursor.offset, n, chunk.firstIndex + cursor.offset,
+			SegmentBounds::empty() };
+		for (size_t i = 0; i < n; i++) {
+			slice.bounds.include(slice.segments[i]);
+		}
+		if (n > 0) {
+			dirty.include(slice.bounds);
+			slices.push_back(slice);
+		}
+		count -= n;
+		cursor.offset += n;
+		if (cursor.offset >= chunk.count) {
+			cursor.chunk++;
+			cursor.offset = 0;
+		}
+	}
+}
+
+bool DrawingAnimation::write(std::ostream& out, size_t segmentsPerStep, uint16_t delayMs)
+{
+	this->nFrames = 0;
+	this->nEncodedPixels = 0;
+	double dWidth = ceil(this->bounds.Width * this->scale);
+	double dHeight = ceil(this->bounds.Height * this->scale);
+	if (this->scale <= 0 || segmentsPerStep == 0 || dWidth < 1 || dHeight < 1
+		|| dWidth * dHeight * 4 > MAX_CANVAS_BYTES) {
+		return false;
+	}
+	const UINT width = (UINT)dWidth, height = (UINT)dHeight;
+	Bitmap canvas((INT)width, (INT)height, PixelFormat32bppRGB);
+	if (canvas.GetLastStatus() != Ok) {
+		return false;
+	}
+	Graphics gr(&canvas);
+	gr.Clear(this->background);
+	gr.ScaleTransform(this->scale, this->scale);
+	gr.TranslateTransform(-this->bounds.X, -this->bounds.Y);
+
+	// One frame for the empty canvas and one per step of the longest layer
+	size_t nSteps = 0;
+	for (const std::vector<SegmentChunkView>& chunks : this->layers) {
+		size_t count = 0;
+		for (const SegmentChunkView& chunk : chunks) {
+			count += chunk.count;
+		}
+		nSteps = (std::max)(nSteps, (count + segmentsPerStep - 1) / segmentsPerStep);
+	}
+	if (nSteps >= UINT_MAX) {
+		return false;
+	}
+	const uint32_t nTotal = (uint32_t)nSteps + 1;
+	ApngWriter apng(out, width, height, nTotal);
+	std::vector<unsigned char> row((size_t)width * 3);
+
+	// Encodes the given canvas region as next frame
+	auto writeFrame = [&](UINT x, UINT y, UINT w, UINT h, uint16_t delay) -> bool {
+		BitmapData data;
+		Gdiplus::Rect rect((INT)x, (INT)y, (INT)w, (INT)h);
+		if (!apng.beginFrame(x, y, w, h, delay)
+			|| canvas.LockBits(&rect, ImageLockModeRead, PixelFormat32bppRGB, &data) != Ok) {
+			return false;
+		}
+		bool okay = true;
+		for (UINT iy = 0; okay && iy < h; iy++) {
+			// Convert the BGRX pixels into RGB samples
+			const unsigned char* pSrc = static_cast<const unsigned char*>(data.Scan0) + (size_t)iy * data.Stride;
+			unsigned char* pDest = row.data();
+			for (UINT ix = 0; ix < w; ix++, pSrc += 4) {
+				*pDest++ = pSrc[2];
+				*pDest++ = pSrc[1];
+				*pDest++ = pSrc[0];
+			}
+			okay = apng.writeRow(row.data());
+		}
+		canvas.UnlockBits(&data);
+		this->nFrames++;
+		this->nEncodedPixels += (uint64_t)w * h;
+		return okay && apng.endFrame();
+	};
+
+	bool okay = writeFrame(0, 0, width, height, nSteps == 0 ? FINAL_DELAY_MS : delayMs);
+	std::vector<Cursor> cursors(this->layers.size(), Cursor{ 0, 0 });
+	std::vector<SegmentChunkView> slices;
+	for (size_t step = 1; okay && step <= nSteps; step++) {
+		// Only the segments of this step are drawn (onto the previous state)
+		slices.clear();
+		SegmentBounds dirty = SegmentBounds::empty();
+		for (size_t ix = 0; ix < this->layers.size(); ix++) {
+			this->advance(ix, cursors[ix], segmentsPerStep, slices, dirty);
+		}
+		Turtle::drawChunks(gr, slices);
+		gr.Flush(FlushIntentionSync);
+		// Pixel region of the new segments (some pixels more for the pen width)
+		double x0 = floor((dirty.left - this->bounds.X) * this->scale) - MARGIN;
+		double x1 = ceil((dirty.right - this->bounds.X) * this->scale) + MARGIN;
+		double y0 = floor((dirty.top - this->bounds.Y) * this->scale) - MARGIN;
+		double y1 = ceil((dirty.bottom - this->bounds.Y) * this->scale) + MARGIN;
+		x0 = (std::max)(x0, 0.0);
+		y0 = (std::max)(y0, 0.0);
+		x1 = (std::min)(x1, (double)width);
+		y1 = (std::min)(y1, (double)height);
+		uint16_t delay = step == nSteps ? FINAL_DELAY_MS : delayMs;
+		if (x1 <= x0 || y1 <= y0) {
+			// Nothing visible has changed, but the frame still takes its time
+			okay = writeFrame(0, 0, 1, 1, delay);
+		}
+		else {
+			okay = writeFrame((UINT)x0, (UINT)y0, (UINT)(x1 - x0), (UINT)(y1 - y0), delay);
+		}
+	}
+	return apng.finish() && okay;
+}
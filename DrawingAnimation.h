@@ -0,0 +1,82 @@
+#pragma once
+#ifndef DRAWINGANIMATION_H
+#define DRAWINGANIMATION_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Animated export of the drawing progress as APNG: the segment chunks of one
+ * or more layers (turtles) are replayed in steps of a fixed number of segments
+ * per layer. Like the incremental drawing of the Turtleizer window (nDrawn),
+ * every step only draws its new segments onto a persistent canvas bitmap, and
+ * only the bounding box of these segments is encoded as frame (disposal NONE,
+ * blend SOURCE), so the total cost stays linear in the number of segments.
+ * The first frame shows the empty canvas, the last one is held a bit longer.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (animated drawing export)
+ */
+
+#include <Windows.h>
+#include <gdiplus.h>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "SegmentStore.h"
+using namespace Gdiplus;
+
+class DrawingAnimation
+{
+public:
+	static const unsigned int DEFAULT_FRAMES = 200;		// Frame count aimed at by default
+	static const uint16_t DEFAULT_DELAY_MS = 40;		// Display time per frame
+	static const uint16_t FINAL_DELAY_MS = 2000;		// Display time of the completed drawing
+	static const size_t MAX_CANVAS_BYTES = 256 << 20;	// Maximum size of the canvas bitmap
+
+	/* Prepares an animation of the drawing area bounds (turtle coordinates), rendered
+	 * at scale on the given background */
+	DrawingAnimation(const RectF& bounds, Color background, float scale = 1.0f);
+
+	/* Adds the chunks of a layer (replayed alongside the other layers); the views
+	 * must stay valid until write() has returned */
+	void addLayer(const std::vector<SegmentChunkView>& chunks);
+	// Returns the number of segments per step resulting in about nFrames frames
+	size_t getStepFor(unsigned int nFrames = DEFAULT_FRAMES) const;
+
+	/* Writes the animation with segmentsPerStep segments per layer and frame to
+	 * the (binary) stream out. Returns false if the canvas would be empty or too
+	 * large or if the stream failed */
+	bool write(std::ostream& out, size_t segmentsPerStep, uint16_t delayMs = DEFAULT_DELAY_MS);
+	// Returns the number of frames written by the last write()
+	inline uint32_t getFrameCount() const { return this->nFrames; }
+	// Returns the number of pixels encoded by the last write() (all frame regions)
+	inline uint64_t getEncodedPixels() const { return this->nEncodedPixels; }
+
+private:
+	static const int MARGIN = 2;	// Pixels added around the bounds of the new segments
+
+	// Replay position within a layer
+	struct Cursor {
+		size_t chunk;		// Index of the current chunk view
+		size_t offset;		// Index of the next segment within the chunk
+	};
+
+	const RectF bounds;				// Drawing area in turtle coordinates
+	const Color background;
+	const float scale;
+	std::vector<std::vector<SegmentChunkView>> layers;
+	uint32_t nFrames;				// Statistics of the last write()
+	uint64_t nEncodedPixels;
+
+	/* Appends views of the next (at most) count segments of layer ix behind cursor
+	 * to slices and includes their bounds into dirty */
+	void advance(size_t ix, Cursor& cursor, size_t count, std::vector<SegmentChunkView>& slices,
+		SegmentBounds& dirty) const;
+};
+
+#endif /*DRAWINGANIMATION_H*/
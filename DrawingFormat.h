@@ -0,0 +1,107 @@
+#pragma once
+#ifndef DRAWINGFORMAT_H
+#define DRAWINGFORMAT_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Record layout of the binary drawing format (".tzd" files), which holds the
+ * turtles of a Turtleizer drawing with their state and their line segments in
+ * the very memory layout of the SegmentStore, such that a mapped file can be
+ * used in place (zero-copy). All values are little-endian, all records are
+ * 8-byte aligned:
+ *
+ *   FileHeader
+ *   per turtle: its chunks, each a ChunkHeader followed by count Segments
+ *               (padded to the alignment)
+ *   Directory
+ *   palette: Directory::nColours ARGB values (padded to the alignment)
+ *   Directory::nTurtles TurtleRecords (Directory::recordSize bytes each)
+ *   Trailer
+ *
+ * The directory is written behind the chunks (its offset is found in the
+ * trailer), so the file can be written in one pass directly from the stores.
+ * Readers must reject files with a higher version and skip header and record
+ * parts beyond the sizes they know (for additions in compatible versions).
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   TurtleRecord defined as DrawingTurtleRecord outside (may be forward-declared)
+ * 2026-10-18   Created for VERSION 11.1.0 (binary drawing format)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "SegmentStore.h"
+
+// State and chunk range of a turtle (DrawingFormat::TurtleRecord, declared here, such
+// that headers like Turtle.h may do with a forward declaration)
+struct DrawingTurtleRecord {
+	double orientation;			// Orientation in degrees
+	float posX, posY;			// Position
+	float boundsX, boundsY;		// Drawing bounds (as Turtle::getBounds())
+	float boundsWidth, boundsHeight;
+	uint32_t penARGB;			// Default pen colour
+	uint8_t penDown;			// Whether the pen is down (0 or 1)
+	uint8_t visible;			// Whether the turtle symbol is visible (0 or 1)
+	uint16_t reserved;
+	uint64_t nSegments;			// Number of segments of the turtle
+	uint64_t firstChunk;		// File offset of the first chunk (if any)
+	uint32_t nChunks;			// Number of consecutive chunks
+	uint32_t reserved2;
+};
+
+struct DrawingFormat {
+	static const char MAGIC[8];				// File signature (also ending the trailer)
+	static const uint16_t VERSION = 1;		// Current format version
+	static const size_t ALIGNMENT = 8;		// Alignment of all records
+
+	// Start of the file
+	struct FileHeader {
+		char magic[8];			// MAGIC
+		uint16_t version;		// Format version
+		uint16_t headerSize;	// Size of this header in bytes
+		uint32_t flags;			// Reserved (0)
+	};
+	// Start of a chunk, followed by count segments
+	struct ChunkHeader {
+		uint32_t turtleIndex;	// Index of the owning turtle (for consistency checks)
+		uint32_t count;			// Number of segments in the chunk
+		SegmentBounds bounds;	// Bounds of the segments in the chunk
+	};
+	// Global drawing data, followed by the palette and the turtle records
+	struct Directory {
+		uint32_t backgroundARGB;	// Background colour
+		uint32_t nColours;			// Number of palette entries (distinct segment colours)
+		uint32_t nTurtles;			// Number of turtle records
+		uint32_t recordSize;		// Size of a turtle record in bytes
+		uint64_t nSegments;			// Total number of segments
+	};
+	// State and chunk range of a turtle
+	typedef DrawingTurtleRecord TurtleRecord;
+	// End of the file
+	struct Trailer {
+		uint64_t directoryOffset;	// File offset of the Directory
+		char magic[8];				// MAGIC
+	};
+
+	// Rounds size up to the alignment
+	static inline uint64_t align(uint64_t size)
+	{
+		return (size + ALIGNMENT - 1) & ~(uint64_t)(ALIGNMENT - 1);
+	}
+};
+
+static_assert(sizeof(Segment) == 20, "Segment layout is part of the drawing format");
+static_assert(sizeof(DrawingFormat::FileHeader) == 16, "Unexpected FileHeader layout");
+static_assert(sizeof(DrawingFormat::ChunkHeader) == 24, "Unexpected ChunkHeader layout");
+static_assert(sizeof(DrawingFormat::Directory) == 24, "Unexpected Directory layout");
+static_assert(sizeof(DrawingFormat::TurtleRecord) == 64, "Unexpected TurtleRecord layout");
+static_assert(sizeof(DrawingFormat::Trailer) == 16, "Unexpected Trailer layout");
+
+#endif /*DRAWINGFORMAT_H*/
@@ -0,0 +1,125 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Zero-copy reader of the binary drawing format.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Chunk count checked against the file size before reserving the views
+ * 2026-10-18   Created for VERSION 11.1.0 (binary drawing format)
+ */
+
+#include "DrawingReader.h"
+#include <cstring>
+
+const DrawingFormat::Directory DrawingReader::EMPTY_DIRECTORY = {};
+
+DrawingReader::DrawingReader(const char* data, size_t size)
+	: data(data)
+	, size(size)
+	, error(nullptr)
+	, pDirectory(&EMPTY_DIRECTORY)
+	, pPalette(nullptr)
+{
+	this->error = this->load();
+	if (this->error != nullptr) {
+		this->pDirectory = &EMPTY_DIRECTORY;
+		this->pPalette = nullptr;
+		this->turtles.clear();
+	}
+}
+
+const char* DrawingReader::load()
+{
+	using Format = DrawingFormat;
+	if (((uintptr_t)this->data % Format::ALIGNMENT) != 0) {
+		return "misaligned data";
+	}
+	if (!this->contains(0, sizeof(Format::FileHeader) + sizeof(Format::Trailer))) {
+		return "too short for a drawing";
+	}
+	const Format::FileHeader* pHeader = (const Format::FileHeader*)this->data;
+	if (memcmp(pHeader->magic, Format::MAGIC, sizeof(pHeader->magic)) != 0) {
+		return "not a drawing file";
+	}
+	if (pHeader->version > Format::VERSION) {
+		return "unsupported format version";
+	}
+	const Format::Trailer* pTrailer =
+		(const Format::Trailer*)(this->data + this->size - sizeof(Format::Trailer));
+	if (this->size % Format::ALIGNMENT != 0
+		|| memcmp(pTrailer->magic, Format::MAGIC, sizeof(pTrailer->magic)) != 0) {
+		return "truncated drawing file";
+	}
+	// The directory
+	uint64_t offset = pTrailer->directoryOffset;
+	if (offset % Format::ALIGNMENT != 0 || !this->contains(offset, sizeof(Format::Directory))) {
+		return "bad directory offset";
+	}
+	const Format::Directory* pDir = (const Format::Directory*)(this->data + offset);
+	offset += Format::align(sizeof(Format::Directory));
+	uint64_t paletteSize = Format::align((uint64_t)pDir->nColours * sizeof(uint32_t));
+	if (!this->contains(offset, paletteSize)) {
+		return "bad palette size";
+	}
+	const uint32_t* pPalette = (const uint32_t*)(this->data + offset);
+	offset += paletteSize;
+	if (pDir->recordSize < sizeof(Format::TurtleRecord) || pDir->recordSize % Format::ALIGNMENT != 0
+		|| !this->contains(offset, (uint64_t)pDir->nTurtles * pDir->recordSize)) {
+		return "bad turtle records";
+	}
+	// The turtles and their chunks
+	const uint64_t chunksEnd = pTrailer->directoryOffset;
+	std::vector<TurtleView> views(pDir->nTurtles);
+	uint64_t nTotal = 0;
+	for (uint32_t ix = 0; ix < pDir->nTurtles; ix++) {
+		TurtleView& view = views[ix];
+		view.pRecord = (const Format::TurtleRecord*)(this->data + offset + (uint64_t)ix * pDir->recordSize);
+		uint64_t chunkOffset = view.pRecord->firstChunk;
+		size_t nSegments = 0;
+		// Each chunk takes at least a header, so the count must fit into the chunk area
+		// (a corrupt count mustn't provoke a huge allocation)
+		if (view.pRecord->nChunks > 0 && (chunkOffset > chunksEnd
+			|| view.pRecord->nChunks > (chunksEnd - chunkOffset) / sizeof(Format::ChunkHeader))) {
+			return "bad chunk count";
+		}
+		view.chunks.reserve(view.pRecord->nChunks);
+		for (uint32_t i = 0; i < view.pRecord->nChunks; i++) {
+			if (chunkOffset % Format::ALIGNMENT != 0 || chunkOffset > chunksEnd
+				|| chunksEnd - chunkOffset < sizeof(Format::ChunkHeader)) {
+				return "bad chunk offset";
+			}
+			const Format::ChunkHeader* pChunk = (const Format::ChunkHeader*)(this->data + chunkOffset);
+			uint64_t length = (uint64_t)pChunk->count * sizeof(Segment);
+			chunkOffset += sizeof(Format::ChunkHeader);
+			if (pChunk->turtleIndex != ix || pChunk->count == 0 || length > chunksEnd - chunkOffset) {
+				return "inconsistent chunk";
+			}
+			SegmentChunkView chunk = {
+				(const Segment*)(this->data + chunkOffset),
+				pChunk->count,
+				nSegments,
+				pChunk->bounds
+			};
+			view.chunks.push_back(chunk);
+			nSegments += pChunk->count;
+			chunkOffset += Format::align(length);
+		}
+		if (nSegments != view.pRecord->nSegments) {
+			return "inconsistent segment count";
+		}
+		nTotal += nSegments;
+	}
+	if (nTotal != pDir->nSegments) {
+		return "inconsistent segment count";
+	}
+	this->pDirectory = pDir;
+	this->pPalette = pPalette;
+	this->turtles.swap(views);
+	return nullptr;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef DRAWINGREADER_H
+#define DRAWINGREADER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Zero-copy reader of the binary drawing format (see DrawingFormat.h): checks
+ * the structure of a drawing held in memory (e.g. a MappedFile) and provides
+ * the turtle records and segment chunks as views into it, such that they can
+ * be drawn or exported like the content of a SegmentStore.
+ * The memory must stay valid (and unchanged) as long as the reader is used.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (binary drawing format)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DrawingFormat.h"
+
+class DrawingReader
+{
+public:
+	// A turtle of the drawing
+	struct TurtleView {
+		const DrawingFormat::TurtleRecord* pRecord;	// State of the turtle (within the data)
+		std::vector<SegmentChunkView> chunks;		// Segment chunks (within the data)
+	};
+
+	/* Checks the drawing held by the size bytes at data (which must be 8-byte
+	 * aligned) and sets up the views (check isValid() for success) */
+	DrawingReader(const char* data, size_t size);
+
+	// Returns true if the data holds a consistent drawing
+	inline bool isValid() const { return this->error == nullptr; }
+	// Returns the description of the first detected defect (or nullptr)
+	inline const char* getError() const { return this->error; }
+
+	// Returns the background colour
+	inline uint32_t getBackground() const { return this->pDirectory->backgroundARGB; }
+	// Returns the number of distinct segment colours
+	inline size_t getPaletteSize() const { return this->pDirectory->nColours; }
+	// Returns the distinct segment colours (in order of first use)
+	inline const uint32_t* getPalette() const { return this->pPalette; }
+	// Returns the total number of segments
+	inline uint64_t getSegmentCount() const { return this->pDirectory->nSegments; }
+	// Returns the number of turtles
+	inline size_t getTurtleCount() const { return this->turtles.size(); }
+	// Returns the turtle with index ix
+	inline const TurtleView& getTurtle(size_t ix) const { return this->turtles[ix]; }
+
+private:
+	static const DrawingFormat::Directory EMPTY_DIRECTORY;	// Placeholder for invalid data
+	const char* const data;
+	const size_t size;
+	const char* error;							// Description of the first defect
+	const DrawingFormat::Directory* pDirectory;	// Directory within the data
+	const uint32_t* pPalette;					// Palette within the data
+	std::vector<TurtleView> turtles;			// Turtle views
+
+	// Checks the data and builds the views, returns the defect description or nullptr
+	const char* load();
+	// Returns true if the range of length bytes at offset lies within the data
+	inline bool contains(uint64_t offset, uint64_t length) const
+	{
+		return offset <= this->size && length <= this->size - offset;
+	}
+};
+
+#endif /*DRAWINGREADER_H*/
@@ -0,0 +1,103 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Writer of the binary drawing format.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (binary drawing format)
+ */
+
+#include "DrawingWriter.h"
+#include <cstring>
+
+const char DrawingFormat::MAGIC[8] = { 'T', 'Z', 'D', 'R', 'A', 'W', '\r', '\n' };
+
+DrawingWriter::DrawingWriter(std::ostream& out)
+	: out(out)
+	, offset(0)
+	, nSegments(0)
+{
+	DrawingFormat::FileHeader header = {};
+	memcpy(header.magic, DrawingFormat::MAGIC, sizeof(header.magic));
+	header.version = DrawingFormat::VERSION;
+	header.headerSize = sizeof(header);
+	this->write(&header, sizeof(header));
+}
+
+void DrawingWriter::addTurtle(const DrawingFormat::TurtleRecord& record, const std::vector<SegmentChunkView>& chunks)
+{
+	DrawingFormat::TurtleRecord rec = record;
+	rec.nSegments = 0;
+	rec.firstChunk = this->offset;
+	rec.nChunks = 0;
+	DrawingFormat::ChunkHeader header = {};
+	header.turtleIndex = (uint32_t)this->turtles.size();
+	for (const SegmentChunkView& chunk : chunks) {
+		if (chunk.count == 0) {
+			continue;
+		}
+		header.count = (uint32_t)chunk.count;
+		header.bounds = chunk.bounds;
+		this->write(&header, sizeof(header));
+		this->write(chunk.segments, chunk.count * sizeof(Segment));
+		this->registerColours(chunk.segments, chunk.count);
+		rec.nSegments += chunk.count;
+		rec.nChunks++;
+	}
+	this->nSegments += rec.nSegments;
+	this->turtles.push_back(rec);
+}
+
+bool DrawingWriter::finish(uint32_t backgroundARGB)
+{
+	DrawingFormat::Trailer trailer = {};
+	trailer.directoryOffset = this->offset;
+	memcpy(trailer.magic, DrawingFormat::MAGIC, sizeof(trailer.magic));
+	DrawingFormat::Directory dir = {};
+	dir.backgroundARGB = backgroundARGB;
+	dir.nColours = (uint32_t)this->palette.size();
+	dir.nTurtles = (uint32_t)this->turtles.size();
+	dir.recordSize = sizeof(DrawingFormat::TurtleRecord);
+	dir.nSegments = this->nSegments;
+	this->write(&dir, sizeof(dir));
+	this->write(this->palette.data(), this->palette.size() * sizeof(uint32_t));
+	this->write(this->turtles.data(), this->turtles.size() * sizeof(DrawingFormat::TurtleRecord));
+	this->write(&trailer, sizeof(trailer));
+	this->out.flush();
+	return this->out.good();
+}
+
+void DrawingWriter::write(const void* data, size_t length)
+{
+	static const char PADDING[DrawingFormat::ALIGNMENT] = {};
+	this->out.write((const char*)data, length);
+	size_t padding = (size_t)(DrawingFormat::align(length) - length);
+	if (padding > 0) {
+		this->out.write(PADDING, padding);
+	}
+	this->offset += length + padding;
+}
+
+void DrawingWriter::registerColours(const Segment* segments, size_t count)
+{
+	// Consecutive segments mostly share their colour, so a hash look-up is rarely needed
+	uint32_t lastARGB = 0;
+	bool hasLast = false;
+	for (size_t i = 0; i < count; i++) {
+		uint32_t argb = segments[i].argb;
+		if (hasLast && argb == lastARGB) {
+			continue;
+		}
+		if (this->knownColours.insert(argb).second) {
+			this->palette.push_back(argb);
+		}
+		lastARGB = argb;
+		hasLast = true;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef DRAWINGWRITER_H
+#define DRAWINGWRITER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Writer of the binary drawing format (see DrawingFormat.h). The segment chunks
+ * of the turtles are passed to the stream as they are (one write per chunk,
+ * no formatting at all), the palette of the colours in use is gathered on the
+ * way. The stream must be binary.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (binary drawing format)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <unordered_set>
+#include <vector>
+#include "DrawingFormat.h"
+
+class DrawingWriter
+{
+public:
+	// Prepares the output to the (binary) stream out and writes the file header
+	explicit DrawingWriter(std::ostream& out);
+
+	/* Writes the given chunks (e.g. from SegmentStore::getChunks()) as the segments
+	 * of the next turtle, whose state is taken from record (the chunk fields of
+	 * which are filled in here) */
+	void addTurtle(const DrawingFormat::TurtleRecord& record, const std::vector<SegmentChunkView>& chunks);
+	/* Writes the directory with the given background colour, the palette, the
+	 * turtle records and the trailer, returns false if the stream failed */
+	bool finish(uint32_t backgroundARGB);
+
+	// Returns the number of bytes written so far
+	inline uint64_t getBytesWritten() const { return this->offset; }
+
+private:
+	std::ostream& out;
+	uint64_t offset;			// Current file offset
+	uint64_t nSegments;			// Number of segments written
+	std::vector<DrawingFormat::TurtleRecord> turtles;	// Records of the added turtles
+	std::vector<uint32_t> palette;	// Colours in order of their first occurrence
+	std::unordered_set<uint32_t> knownColours;	// Colours in the palette
+
+	// Writes length bytes and pads them to the alignment
+	void write(const void* data, size_t length);
+	// Adds the colours of the given segments to the palette
+	void registerColours(const Segment* segments, size_t count);
+
+	DrawingWriter(const DrawingWriter&) = delete;
+	DrawingWriter& operator=(const DrawingWriter&) = delete;
+};
+
+#endif /*DRAWINGWRITER_H*/
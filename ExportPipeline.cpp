@@ -0,0 +1,107 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Ordered parallel formatting for text exports.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (parallel SVG and CSV export)
+ */
+
+#include "ExportPipeline.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+ExportPipeline::ExportPipeline(unsigned int nThreads)
+	: nThreads(nThreads)
+{
+	if (this->nThreads == 0) {
+		this->nThreads = std::thread::hardware_concurrency();
+		if (this->nThreads == 0) {
+			this->nThreads = 1;
+		}
+	}
+}
+
+bool ExportPipeline::run(size_t nItems, const Formatter& formatter, const Consumer& consumer) const
+{
+	if (this->nThreads <= 1 || nItems <= 1) {
+		std::string text;
+		for (size_t ix = 0; ix < nItems; ix++) {
+			text.clear();
+			formatter(ix, text);
+			if (!consumer(text.data(), text.size())) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Ring of result slots; item ix occupies slot ix % nSlots until consumed
+	const size_t nSlots = (size_t)this->nThreads * SLOTS_PER_THREAD;
+	std::vector<std::string> texts(nSlots);
+	std::vector<bool> isReady(nSlots, false);
+	std::mutex mutex;
+	std::condition_variable cvReady;	// An item has been formatted
+	std::condition_variable cvFree;		// A slot has been consumed (or the run ends)
+	size_t nextItem = 0;				// Next item to be claimed by a worker
+	size_t nConsumed = 0;				// Number of items passed to the consumer
+	bool isAborted = false;
+
+	auto work = [&]() {
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			cvFree.wait(lock, [&]() {
+				return isAborted || nextItem >= nItems || nextItem < nConsumed + nSlots;
+			});
+			if (isAborted || nextItem >= nItems) {
+				break;
+			}
+			size_t ix = nextItem++;
+			std::string& text = texts[ix % nSlots];
+			lock.unlock();
+			text.clear();
+			formatter(ix, text);
+			lock.lock();
+			isReady[ix % nSlots] = true;
+			cvReady.notify_all();
+		}
+	};
+
+	size_t nWorkers = (nItems < this->nThreads) ? nItems : this->nThreads;
+	std::vector<std::thread> workers;
+	workers.reserve(nWorkers);
+	for (size_t i = 0; i < nWorkers; i++) {
+		workers.emplace_back(work);
+	}
+
+	bool ok = true;
+	for (size_t ix = 0; ix < nItems && ok; ix++) {
+		std::unique_lock<std::mutex> lock(mutex);
+		cvReady.wait(lock, [&]() { return isReady[ix % nSlots]; });
+		lock.unlock();
+		// The slot is not touched by the workers before it is released
+		const std::string& text = texts[ix % nSlots];
+		ok = consumer(text.data(), text.size());
+		lock.lock();
+		isReady[ix % nSlots] = false;
+		nConsumed++;
+		cvFree.notify_all();
+	}
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		isAborted = true;
+	}
+	cvFree.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	return ok;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef EXPORTPIPELINE_H
+#define EXPORTPIPELINE_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Ordered parallel formatting for text exports: a number of work items (e.g.
+ * the segment chunks of a turtle) is formatted into per-item text buffers by a
+ * set of worker threads, while the calling thread passes the finished texts to
+ * the consumer strictly in item order. So the result is the same as that of a
+ * serial run. The number of buffered items is bounded (a few per worker), which
+ * keeps the memory demand independent of the drawing size.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (parallel SVG and CSV export)
+ */
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+class ExportPipeline
+{
+public:
+	// Formats the work item with the given index into text (which is empty on call)
+	typedef std::function<void(size_t index, std::string& text)> Formatter;
+	// Takes the text of the next item, returns false if the export is to be aborted
+	typedef std::function<bool(const char* text, size_t length)> Consumer;
+
+	static const unsigned int SLOTS_PER_THREAD = 4;	// Buffered items per worker thread
+
+	// Prepares a pipeline with nThreads workers (0 = as many as there are cores)
+	explicit ExportPipeline(unsigned int nThreads = 0);
+
+	// Returns the number of worker threads
+	inline unsigned int getThreadCount() const { return nThreads; }
+
+	/* Formats the nItems work items via formatter (concurrently unless there is
+	 * only one worker or item) and passes the results in order to consumer.
+	 * Returns false if the consumer aborted */
+	bool run(size_t nItems, const Formatter& formatter, const Consumer& consumer) const;
+
+private:
+	unsigned int nThreads;
+};
+
+#endif /*EXPORTPIPELINE_H*/
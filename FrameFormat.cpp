@@ -0,0 +1,103 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Frame layouts, pixel conversion, and frame cadence, see FrameFormat.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (moved out of FrameSink for tests)
+ */
+
+#include "FrameFormat.h"
+#include <cstdint>
+
+size_t FrameConverter::getFrameSize(FrameFormat format, uint32_t width, uint32_t height)
+{
+	return format == FRAME_I420
+		? (size_t)width * height * 3 / 2
+		: (size_t)width * height * 4;
+}
+
+void FrameConverter::convert(FrameFormat format, const unsigned char* pixels, ptrdiff_t stride,
+	uint32_t width, uint32_t height, unsigned char* frame)
+{
+	if (format == FRAME_RGBA) {
+		for (uint32_t y = 0; y < height; y++) {
+			const unsigned char* pSrc = pixels + (ptrdiff_t)y * stride;
+			for (uint32_t x = 0; x < width; x++, pSrc += 4) {
+				*frame++ = pSrc[2];
+				*frame++ = pSrc[1];
+				*frame++ = pSrc[0];
+				*frame++ = 0xFF;
+			}
+		}
+		return;
+	}
+	// I420 (BT.601, limited range), chroma from the mean of 2 x 2 pixels
+	unsigned char* pY = frame;
+	unsigned char* pU = frame + (size_t)width * height;
+	unsigned char* pV = pU + (size_t)(width / 2) * (height / 2);
+	for (uint32_t y = 0; y < height; y += 2) {
+		const unsigned char* pRow0 = pixels + (ptrdiff_t)y * stride;
+		const unsigned char* pRow1 = pRow0 + stride;
+		unsigned char* pY0 = pY + (size_t)y * width;
+		unsigned char* pY1 = pY0 + width;
+		for (uint32_t x = 0; x < width; x += 2) {
+			int sumR = 0, sumG = 0, sumB = 0;
+			const unsigned char* quad[4] = { pRow0 + 4 * x, pRow0 + 4 * x + 4, pRow1 + 4 * x, pRow1 + 4 * x + 4 };
+			unsigned char* lumas[4] = { pY0 + x, pY0 + x + 1, pY1 + x, pY1 + x + 1 };
+			for (int i = 0; i < 4; i++) {
+				int b = quad[i][0], g = quad[i][1], r = quad[i][2];
+				*lumas[i] = (unsigned char)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+				sumR += r;
+				sumG += g;
+				sumB += b;
+			}
+			int r = (sumR + 2) >> 2, g = (sumG + 2) >> 2, b = (sumB + 2) >> 2;
+			// Offset by 128 << 8 before the shift, so it never applies to negative values
+			*pU++ = (unsigned char)((-38 * r - 74 * g + 112 * b + 128 + (128 << 8)) >> 8);
+			*pV++ = (unsigned char)((112 * r - 94 * g - 18 * b + 128 + (128 << 8)) >> 8);
+		}
+	}
+}
+
+FrameCadence::FrameCadence(size_t segmentsPerFrame, std::chrono::milliseconds interval)
+	: segmentsPerFrame(segmentsPerFrame)
+	, interval(interval)
+	, nPending(0)
+{
+}
+
+void FrameCadence::start(Clock::time_point now)
+{
+	this->nextDue = now + this->interval;
+}
+
+size_t FrameCadence::getRoom() const
+{
+	return this->segmentsPerFrame > 0 ? this->segmentsPerFrame - this->nPending : SIZE_MAX;
+}
+
+bool FrameCadence::addSegments(size_t count)
+{
+	this->nPending += count;
+	return this->segmentsPerFrame > 0 && this->nPending >= this->segmentsPerFrame;
+}
+
+size_t FrameCadence::takeDueFrames(Clock::time_point now)
+{
+	// A frame per elapsed interval, even if rendering or writing lagged behind
+	size_t nDue = 0;
+	if (this->interval.count() > 0) {
+		while (now >= this->nextDue) {
+			nDue++;
+			this->nextDue += this->interval;
+		}
+	}
+	return nDue;
+}
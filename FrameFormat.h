@@ -0,0 +1,74 @@
+#pragma once
+#ifndef FRAMEFORMAT_H
+#define FRAMEFORMAT_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Sample layouts of the raw video frames streamed by the FrameSink, the
+ * conversion of canvas pixels into them, and the frame cadence (when a frame
+ * is due: after a number of new segments and/or a time interval).
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (moved out of FrameSink for tests)
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Sample layouts of the frames (declared with a fixed type, such that headers
+// like Turtleizer.h may do with a forward declaration)
+enum FrameFormat : int {
+	FRAME_RGBA,			// R, G, B, A bytes per pixel, rows top-down
+	FRAME_I420			// Y plane, then U and V planes of half width and height
+};
+
+class FrameConverter
+{
+public:
+	// Returns the size in bytes of a width x height frame in the given format
+	static size_t getFrameSize(FrameFormat format, uint32_t width, uint32_t height);
+	/* Converts width x height pixels as B, G, R, X bytes (rows stride bytes apart,
+	 * top-down) into frame in the given format; for FRAME_I420, the chroma is the
+	 * mean of 2 x 2 pixels (BT.601, limited range), width and height must be even */
+	static void convert(FrameFormat format, const unsigned char* pixels, ptrdiff_t stride,
+		uint32_t width, uint32_t height, unsigned char* frame);
+};
+
+class FrameCadence
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	/* Prepares the cadence of a frame after every segmentsPerFrame new segments
+	 * (0: none) and every interval (0: none) */
+	FrameCadence(size_t segmentsPerFrame, std::chrono::milliseconds interval);
+
+	// Sets the time the intervals count from
+	void start(Clock::time_point now);
+	// Returns how many new segments may be drawn before the next frame is due (SIZE_MAX: any)
+	size_t getRoom() const;
+	// Counts count new segments drawn, returns true if a frame is due now
+	bool addSegments(size_t count);
+	// Returns the number of frames due by time at now and advances the schedule accordingly
+	size_t takeDueFrames(Clock::time_point now);
+	// Resets the count of the segments drawn since the last frame (when one is taken)
+	inline void frameTaken() { this->nPending = 0; }
+	// Returns the number of new segments drawn since the last frame
+	inline size_t getPending() const { return this->nPending; }
+
+private:
+	const size_t segmentsPerFrame;
+	const std::chrono::milliseconds interval;
+	size_t nPending;			// Segments drawn since the last frame
+	Clock::time_point nextDue;	// Time of the next timed frame
+};
+
+#endif /*FRAMEFORMAT_H*/
@@ -0,0 +1,315 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Stream of raw video frames of a drawing (in progress), see FrameSink.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Drawing and frame taking deferred until the source returns (no wait under a store lock)
+ * 2026-10-18   Created for VERSION 11.1.0 (raw frame streaming)
+ */
+
+#include "FrameSink.h"
+#include "Turtle.h"
+
+FrameSink::FrameSink(HANDLE hOutput, UINT width, UINT height, FrameFormat format, size_t segmentsPerFrame,
+	unsigned int intervalMs, unsigned int queueDepth)
+	: hOutput(hOutput)
+	, width(format == FRAME_I420 ? (width + 1) & ~1u : width)
+	, height(format == FRAME_I420 ? (height + 1) & ~1u : height)
+	, format(format)
+	, frameSize(FrameConverter::getFrameSize(format, this->width, this->height))
+	, background(Color::White)
+	, cadence(segmentsPerFrame, std::chrono::milliseconds(intervalMs))
+	, deferring(false)
+	, nFrames(0)
+	, nStalls(0)
+	, good(true)
+	, closing(false)
+	, stopping(false)
+{
+	this->pCanvas.reset(new Bitmap((INT)this->width, (INT)this->height, PixelFormat32bppRGB));
+	this->pGraphics.reset(new Graphics(this->pCanvas.get()));
+	this->pGraphics->Clear(this->background);
+	queueDepth = (std::max)(queueDepth, MIN_QUEUE_DEPTH);
+	this->buffers.resize(queueDepth);
+	for (size_t ix = 0; ix < queueDepth; ix++) {
+		this->buffers[ix].resize(this->frameSize);
+		this->freeBuffers.push_back(ix);
+	}
+	// Start the writer only now that all members are set up
+	this->writer = std::thread(&FrameSink::write, this);
+}
+
+FrameSink::~FrameSink()
+{
+	this->finish();
+}
+
+void FrameSink::setView(const PointF& origin, float scale)
+{
+	this->pGraphics->ResetTransform();
+	this->pGraphics->ScaleTransform(scale, scale);
+	this->pGraphics->TranslateTransform(-origin.X, -origin.Y);
+	this->redrawAll();
+}
+
+void FrameSink::start(const Source& source)
+{
+	if (this->renderer.joinable() || this->closing) {
+		return;
+	}
+	this->source = source;
+	this->cadence.start(FrameCadence::Clock::now());
+	this->renderer = std::thread(&FrameSink::render, this);
+}
+
+bool FrameSink::finish()
+{
+	if (this->renderer.joinable()) {
+		{
+			std::lock_guard<std::mutex> guard(this->mutex);
+			this->stopping = true;
+		}
+		this->stopRequest.notify_one();
+		this->renderer.join();
+	}
+	if (this->writer.joinable()) {
+		// The last frame shows the complete drawing
+		if (this->cadence.getPending() > 0 || this->getFrameCount() == 0) {
+			this->takeFrame();
+			this->cadence.frameTaken();
+		}
+		{
+			std::lock_guard<std::mutex> guard(this->mutex);
+			this->closing = true;
+		}
+		this->frameQueued.notify_one();
+		this->writer.join();
+	}
+	return this->isGood();
+}
+
+size_t FrameSink::beginLayer(uint32_t layerNo, unsigned int generation)
+{
+	if (layerNo >= this->layers.size()) {
+		LayerProgress progress = {};
+		progress.generation = generation;
+		this->layers.resize(layerNo + 1, progress);
+	}
+	LayerProgress& progress = this->layers[layerNo];
+	if (progress.generation != generation) {
+		progress.generation = generation;
+		progress.nCounted = 0;
+		this->redrawAll();
+	}
+	return progress.nDrawn;
+}
+
+void FrameSink::addSegments(uint32_t layerNo, const std::vector<SegmentChunkView>& chunks)
+{
+	LayerProgress& progress = this->layers[layerNo];
+	for (const SegmentChunkView& chunk : chunks) {
+		size_t ix = 0;
+		while (ix < chunk.count) {
+			size_t first = chunk.firstIndex + ix;
+			size_t n = chunk.count - ix;
+			bool isNew = first >= progress.nCounted;
+			if (!isNew) {
+				// Redrawn segments (after a clear or background change) don't count
+				n = (std::min)(n, progress.nCounted - first);
+			}
+			else {
+				n = (std::min)(n, this->cadence.getRoom());
+			}
+			// The chunk bounds are good enough for the slice (no clipping here)
+			SegmentChunkView slice = { chunk.segments + ix, n, first, chunk.bounds };
+			ix += n;
+			progress.nDrawn = first + n;
+			bool frameDue = false;
+			if (isNew) {
+				progress.nCounted = progress.nDrawn;
+				frameDue = this->cadence.addSegments(n);
+				if (frameDue) {
+					// Counted from here, even if the frame itself is taken after the poll
+					this->cadence.frameTaken();
+				}
+			}
+			this->addSlice(slice, frameDue);
+		}
+	}
+}
+
+void FrameSink::setBackground(Color background)
+{
+	if (background.GetValue() != this->background.GetValue()) {
+		this->background = background;
+		this->redrawAll();
+	}
+}
+
+uint64_t FrameSink::getFrameCount() const
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	return this->nFrames;
+}
+
+uint64_t FrameSink::getStallCount() const
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	return this->nStalls;
+}
+
+bool FrameSink::isGood() const
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	return this->good;
+}
+
+void FrameSink::render()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	bool stop = false;
+	do {
+		stop = this->stopRequest.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL_MS),
+			[this] { return this->stopping; });
+		// The source must not be polled while holding the mutex
+		lock.unlock();
+		this->poll();
+		lock.lock();
+	} while (!stop);
+}
+
+void FrameSink::poll()
+{
+	// The source holds the read locks of the stores while reporting, so nothing
+	// must wait for the writer before it has returned
+	this->deferring = true;
+	this->source(*this);
+	this->deferring = false;
+	this->runSteps();
+	for (size_t nDue = this->cadence.takeDueFrames(FrameCadence::Clock::now()); nDue > 0; nDue--) {
+		this->takeFrame();
+		this->cadence.frameTaken();
+	}
+}
+
+void FrameSink::write()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	for (;;) {
+		this->frameQueued.wait(lock, [this] { return !this->queue.empty() || this->closing; });
+		if (this->queue.empty()) {
+			break;
+		}
+		size_t ix = this->queue.front();
+		this->queue.pop_front();
+		bool okay = this->good;
+		lock.unlock();
+		// After a failure the frames are discarded, such that the rendering never gets stuck
+		const unsigned char* pData = this->buffers[ix].data();
+		size_t rest = this->frameSize;
+		while (okay && rest > 0) {
+			DWORD nWritten = 0;
+			DWORD nToWrite = (DWORD)(std::min)(rest, (size_t)1 << 30);
+			okay = WriteFile(this->hOutput, pData, nToWrite, &nWritten, NULL) && nWritten > 0;
+			pData += nWritten;
+			rest -= nWritten;
+		}
+		lock.lock();
+		this->good = this->good && okay;
+		this->freeBuffers.push_back(ix);
+		this->bufferFreed.notify_one();
+	}
+}
+
+void FrameSink::redrawAll()
+{
+	if (this->deferring) {
+		Step step = { Step::CLEAR, 0, 0, SegmentBounds::empty() };
+		this->steps.push_back(step);
+	}
+	else {
+		this->pGraphics->Clear(this->background);
+	}
+	for (LayerProgress& progress : this->layers) {
+		progress.nDrawn = 0;
+	}
+}
+
+void FrameSink::addSlice(const SegmentChunkView& slice, bool frameDue)
+{
+	if (this->deferring) {
+		// The chunk views are only valid during the poll, so the segments are copied
+		Step step = { Step::DRAW, this->copies.size(), slice.count, slice.bounds };
+		this->copies.insert(this->copies.end(), slice.segments, slice.segments + slice.count);
+		this->steps.push_back(step);
+		if (frameDue) {
+			step.kind = Step::FRAME;
+			this->steps.push_back(step);
+		}
+		return;
+	}
+	std::vector<SegmentChunkView> slices(1, slice);
+	Turtle::drawChunks(*this->pGraphics, slices);
+	if (frameDue) {
+		this->takeFrame();
+	}
+}
+
+void FrameSink::runSteps()
+{
+	std::vector<SegmentChunkView> slices;
+	for (const Step& step : this->steps) {
+		switch (step.kind) {
+		case Step::CLEAR:
+			this->pGraphics->Clear(this->background);
+			break;
+		case Step::DRAW: {
+			SegmentChunkView slice = { this->copies.data() + step.first, step.count, step.first, step.bounds };
+			slices.assign(1, slice);
+			Turtle::drawChunks(*this->pGraphics, slices);
+			break;
+		}
+		case Step::FRAME:
+			this->takeFrame();
+			break;
+		}
+	}
+	this->steps.clear();
+	this->copies.clear();
+}
+
+void FrameSink::takeFrame()
+{
+	size_t ix = 0;
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		if (this->freeBuffers.empty()) {
+			// The consumer is slower than the drawing
+			this->nStalls++;
+			this->bufferFreed.wait(lock, [this] { return !this->freeBuffers.empty(); });
+		}
+		ix = this->freeBuffers.back();
+		this->freeBuffers.pop_back();
+	}
+	this->pGraphics->Flush(FlushIntentionSync);
+	Gdiplus::Rect rect(0, 0, (INT)this->width, (INT)this->height);
+	BitmapData data;
+	if (this->pCanvas->LockBits(&rect, ImageLockModeRead, PixelFormat32bppRGB, &data) == Ok) {
+		FrameConverter::convert(this->format, static_cast<const unsigned char*>(data.Scan0), data.Stride,
+			this->width, this->height, this->buffers[ix].data());
+		this->pCanvas->UnlockBits(&data);
+	}
+	{
+		std::lock_guard<std::mutex> guard(this->mutex);
+		this->queue.push_back(ix);
+		this->nFrames++;
+	}
+	this->frameQueued.notify_one();
+}
@@ -0,0 +1,174 @@
+#pragma once
+#ifndef FRAMESINK_H
+#define FRAMESINK_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Stream of raw video frames of a drawing (in progress) to a file, pipe, or the
+ * standard output handle, e.g. to be piped into an external video encoder:
+ *     turtleprog.exe | ffmpeg -f rawvideo -pix_fmt rgba -s 500x500 -r 25 -i - out.mp4
+ * Frames have a fixed size and are written without any header, either as RGBA
+ * (4 bytes per pixel) or as planar YUV 4:2:0 (I420, BT.601 limited range).
+ * A frame is taken after every segmentsPerFrame new segments and/or every
+ * intervalMs milliseconds of program time (further frames repeat the canvas if
+ * the rendering lagged behind, such that the video keeps pace with the program).
+ * Like the window, the sink draws only the new segments onto a persistent canvas
+ * (a cleared turtle or a changed background make it redraw all).
+ * A render thread polls the drawing source every POLL_INTERVAL_MS (like the
+ * Journal, so the turtle moves aren't slowed down by any hook), and a writer
+ * thread passes the finished frames to the output. Only queueDepth frames may
+ * be pending; if the consumer is slower, the render thread waits for a free
+ * frame buffer while the turtle program goes on unhindered. As the source
+ * reports the segments under the read lock of the turtle stores, the render
+ * thread only copies them and notes the frame boundaries there; it draws and
+ * waits after the source has returned, such that a clear() never waits for
+ * the consumer.
+ * Without start(), the sink is fed by the calling thread (e.g. for a drawing
+ * file), which then waits for free frame buffers itself.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Drawing and frame taking deferred until the source returns (no wait under a store lock)
+ * 2026-10-18   Sample layout enum moved out of the class (FrameFormat, may be forward-declared)
+ * 2026-10-18   Created for VERSION 11.1.0 (raw frame streaming)
+ */
+
+#include <Windows.h>
+#include <gdiplus.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "FrameFormat.h"
+#include "SegmentStore.h"
+using namespace Gdiplus;
+
+class FrameSink
+{
+public:
+	static const unsigned int POLL_INTERVAL_MS = 10;	// Polling interval of the render thread
+	static const unsigned int MIN_QUEUE_DEPTH = 2;		// Minimum number of frame buffers
+	static const unsigned int DEFAULT_QUEUE_DEPTH = 4;	// Default number of frame buffers
+
+	// Called by the render thread to report the drawing via the add methods
+	typedef std::function<void(FrameSink&)> Source;
+
+	/* Prepares a stream of width x height frames in the given format to hOutput
+	 * (which is neither flushed nor closed here), taking a frame after every
+	 * segmentsPerFrame new segments (0: none) and every intervalMs milliseconds
+	 * (0: none), with at most queueDepth frames pending. For FRAME_I420, odd
+	 * sizes are rounded up. Starts the writer thread */
+	FrameSink(HANDLE hOutput, UINT width, UINT height, FrameFormat format, size_t segmentsPerFrame,
+		unsigned int intervalMs = 0, unsigned int queueDepth = DEFAULT_QUEUE_DEPTH);
+	// Completes the stream (see finish())
+	~FrameSink();
+
+	/* Places the turtle coordinate origin at the left top corner of the frames,
+	 * magnified by scale (to be done before anything is added) */
+	void setView(const PointF& origin, float scale = 1.0f);
+	// Starts the render thread, which polls source every POLL_INTERVAL_MS
+	void start(const Source& source);
+	/* Stops the render thread (after a final poll), takes a last frame of what
+	 * was drawn since the previous frame, and waits until all frames have been
+	 * written. Returns false if writing failed */
+	bool finish();
+
+	/* To be called by the source for layer (turtle) number layerNo with the current
+	 * generation of its store, returns the index of the first element not drawn yet
+	 * (0 after a clear, which makes all layers be redrawn) */
+	size_t beginLayer(uint32_t layerNo, unsigned int generation);
+	// To be called by the source with the new elements of layer number layerNo
+	void addSegments(uint32_t layerNo, const std::vector<SegmentChunkView>& chunks);
+	// To be called by the source with the background colour (a change redraws all)
+	void setBackground(Color background);
+
+	// Returns the frame width in pixels
+	inline UINT getWidth() const { return this->width; }
+	// Returns the frame height in pixels
+	inline UINT getHeight() const { return this->height; }
+	// Returns the size of a frame in bytes
+	inline size_t getFrameSize() const { return this->frameSize; }
+	// Returns the number of frames taken so far
+	uint64_t getFrameCount() const;
+	// Returns how often the rendering had to wait for a free frame buffer
+	uint64_t getStallCount() const;
+	// Returns true unless writing to the output failed
+	bool isGood() const;
+
+private:
+	// Drawing progress of a layer
+	struct LayerProgress {
+		size_t nDrawn;				// Number of elements drawn onto the canvas
+		size_t nCounted;			// Number of elements counted for frames so far
+		unsigned int generation;	// Store generation of these elements
+	};
+	// A canvas operation deferred until the source has returned
+	struct Step {
+		enum Kind { CLEAR, DRAW, FRAME } kind;
+		size_t first, count;		// Range of the copied segments to draw (DRAW)
+		SegmentBounds bounds;		// Bounds of the chunk the segments came from (DRAW)
+	};
+
+	const HANDLE hOutput;
+	const UINT width, height;
+	const FrameFormat format;
+	const size_t frameSize;
+	Source source;
+
+	// Render side (render thread or calling thread)
+	std::unique_ptr<Bitmap> pCanvas;	// Persistent canvas with the drawn segments
+	std::unique_ptr<Graphics> pGraphics;	// Transformed graphics of the canvas
+	Color background;
+	std::vector<LayerProgress> layers;
+	FrameCadence cadence;
+	bool deferring;						// Whether the source is being polled (steps deferred)
+	std::vector<Segment> copies;		// Segments reported during the current poll
+	std::vector<Step> steps;			// Canvas operations of the current poll
+
+	// Frame queue (guarded by mutex)
+	std::vector<std::vector<unsigned char>> buffers;	// Frame buffers
+	std::vector<size_t> freeBuffers;	// Indices of the buffers available for rendering
+	std::deque<size_t> queue;			// Indices of the buffers to be written, in order
+	uint64_t nFrames, nStalls;
+	bool good;
+	bool closing;						// Whether the writer is to stop when the queue is empty
+	mutable std::mutex mutex;
+	std::condition_variable bufferFreed;	// Signalled by the writer thread
+	std::condition_variable frameQueued;	// Signalled on new frames and on closing
+	std::thread writer;					// The writer thread
+
+	// Render thread control
+	bool stopping;						// Whether the render thread is to stop (guarded by mutex)
+	std::condition_variable stopRequest;
+	std::thread renderer;				// The render thread (if started)
+
+	// Body of the render thread
+	void render();
+	// Polls the source and takes the frames due by time
+	void poll();
+	// Body of the writer thread
+	void write();
+	// Clears the canvas and restarts all layers (on clear or background change)
+	void redrawAll();
+	// Draws slice (and takes a frame if frameDue) or defers both while polling
+	void addSlice(const SegmentChunkView& slice, bool frameDue);
+	// Performs the canvas operations deferred during the poll
+	void runSteps();
+	// Converts the canvas into a free frame buffer (waiting for one) and queues it
+	void takeFrame();
+
+	FrameSink(const FrameSink&) = delete;
+	FrameSink& operator=(const FrameSink&) = delete;
+};
+
+#endif /*FRAMESINK_H*/
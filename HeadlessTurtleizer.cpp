@@ -0,0 +1,200 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Window-less counterpart of the Turtleizer for binary drawing files.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   writeSVG() returns whether the document was written completely
+ * 2026-10-18   writeSVG() and writeCSV() may simplify the lines (Simplifier)
+ * 2026-10-18   writeSVG() and writeImage() may be restricted to a region
+ * 2026-10-18   New method writeFrames() (raw frame streaming)
+ * 2026-10-18   New method writeAnimation() (animated PNG of the drawing progress)
+ * 2026-10-18   New method writeTiles() (deep-zoom tile pyramid export)
+ * 2026-10-18   New method writeImage() (raster export via the ImageWriterRegistry)
+ * 2026-10-18   Created for VERSION 11.1.0 (binary drawing format)
+ */
+
+#include "HeadlessTurtleizer.h"
+#include "DrawingAnimation.h"
+#include "FrameSink.h"
+#include "Simplifier.h"
+#include "Turtle.h"
+#include "TilePyramid.h"
+#include <climits>
+#include <cmath>
+#include <memory>
+
+HeadlessTurtleizer::HeadlessTurtleizer(LPCWSTR filePath)
+	: file(filePath)
+	, reader(file.data(), file.size())
+{
+}
+
+bool HeadlessTurtleizer::isLoaded() const
+{
+	return this->file.isOpen() && this->reader.isValid();
+}
+
+const char* HeadlessTurtleizer::getError() const
+{
+	if (!this->file.isOpen()) {
+		return "file could not be opened";
+	}
+	return this->reader.getError();
+}
+
+Color HeadlessTurtleizer::getBackground() const
+{
+	return Color(this->reader.getBackground());
+}
+
+RectF HeadlessTurtleizer::getBounds() const
+{
+	// Combined in the same way as by Turtleizer::getBounds()
+	RectF bounds;
+	for (size_t ix = 0; ix < this->reader.getTurtleCount(); ix++) {
+		const DrawingFormat::TurtleRecord* pRecord = this->reader.getTurtle(ix).pRecord;
+		RectF turtleBounds(pRecord->boundsX, pRecord->boundsY, pRecord->boundsWidth, pRecord->boundsHeight);
+		RectF::Union(bounds, bounds, turtleBounds);
+	}
+	return bounds;
+}
+
+void HeadlessTurtleizer::draw(Graphics& gr, const RectF* pClip) const
+{
+	for (size_t ix = 0; ix < this->reader.getTurtleCount(); ix++) {
+		Turtle::drawChunks(gr, this->reader.getTurtle(ix).chunks, pClip);
+	}
+}
+
+bool HeadlessTurtleizer::writeSVG(SvgWriter& svg, const char* title, float scale,
+	const ExportPipeline* pPipeline, const RectF* pRegion, Simplifier* pSimplifier) const
+{
+	// Same frame as with the SVG export of the Turtleizer window
+	RectF bounds = pRegion != nullptr ? *pRegion : this->getBounds();
+	PointF offset(-bounds.X, -bounds.Y);
+	svg.writeDocumentStart(bounds.Width, bounds.Height, scale, title,
+		this->reader.getBackground() & 0xFFFFFF);
+	SegmentBounds clip = SegmentBounds::empty();
+	clip.include(bounds.X, bounds.Y);
+	clip.include(bounds.GetRight(), bounds.GetBottom());
+	for (size_t ix = 0; ix < this->reader.getTurtleCount(); ix++) {
+		const std::vector<SegmentChunkView>* pChunks = &this->reader.getTurtle(ix).chunks;
+		std::vector<SegmentChunkView> clipped, simplified;
+		std::vector<std::vector<Segment>> storage;
+		if (pRegion != nullptr) {
+			clipChunks(*pChunks, clip, clipped, storage);
+			pChunks = &clipped;
+		}
+		if (pSimplifier != nullptr) {
+			pSimplifier->simplifyChunks(*pChunks, simplified, storage, pPipeline);
+			pChunks = &simplified;
+		}
+		Turtle::writeChunksSVG(svg, offset, *pChunks, pPipeline);
+	}
+	return svg.writeDocumentEnd();
+}
+
+void HeadlessTurtleizer::writeCSV(CsvWriter& csv, const ExportPipeline* pPipeline, Simplifier* pSimplifier) const
+{
+	csv.writeHeader();
+	for (size_t ix = 0; ix < this->reader.getTurtleCount(); ix++) {
+		const std::vector<SegmentChunkView>& chunks = this->reader.getTurtle(ix).chunks;
+		if (pSimplifier == nullptr) {
+			Turtle::writeChunksCSV(csv, (unsigned int)ix, chunks, pPipeline);
+			continue;
+		}
+		std::vector<SegmentChunkView> simplified;
+		std::vector<std::vector<Segment>> storage;
+		pSimplifier->simplifyChunks(chunks, simplified, storage, pPipeline);
+		Turtle::writeChunksCSV(csv, (unsigned int)ix, simplified, pPipeline);
+	}
+	csv.flush();
+}
+
+bool HeadlessTurtleizer::writeImage(std::ostream& out, const ImageWriterRegistry::Format& format,
+	float scale, const RectF* pRegion) const
+{
+	// Same frame and banding as with the image export of the Turtleizer window
+	RectF bounds = pRegion != nullptr ? *pRegion : this->getBounds();
+	double dWidth = ceil(bounds.Width * scale);
+	double dHeight = ceil(bounds.Height * scale);
+	if (scale <= 0 || dWidth < 1 || dHeight < 1 || dWidth > INT_MAX || dHeight > INT_MAX) {
+		return false;
+	}
+	UINT width = (UINT)dWidth, height = (UINT)dHeight;
+	UINT bandHeight = (UINT)(std::max)((size_t)1, (std::min)((size_t)height, BAND_BYTES / ((size_t)width * 4)));
+	Bitmap band((INT)width, (INT)bandHeight, PixelFormat32bppRGB);
+	if (band.GetLastStatus() != Ok) {
+		return false;
+	}
+	Graphics gr(&band);
+	Color bgColour = this->getBackground();
+	std::unique_ptr<ImageWriter> pWriter = format.create(out, width, height, false);
+	bool okay = out.good();
+	for (UINT y0 = 0; okay && y0 < height; y0 += bandHeight) {
+		UINT nRows = (std::min)(bandHeight, height - y0);
+		gr.ResetTransform();
+		gr.Clear(bgColour);
+		gr.TranslateTransform(0, -(REAL)y0);
+		gr.ScaleTransform(scale, scale);
+		gr.TranslateTransform(-bounds.X, -bounds.Y);
+		// Only lines touching the band (with some tolerance for the pen width) matter
+		REAL margin = 1.0f + 1.0f / scale;
+		RectF clip(bounds.X - margin, bounds.Y + y0 / scale - margin,
+			bounds.Width + 2 * margin, nRows / scale + 2 * margin);
+		this->draw(gr, &clip);
+		gr.Flush(FlushIntentionSync);
+
+		Gdiplus::Rect rect(0, 0, (INT)width, (INT)nRows);
+		BitmapData data;
+		if (band.LockBits(&rect, ImageLockModeRead, PixelFormat32bppRGB, &data) != Ok) {
+			okay = false;
+			break;
+		}
+		for (UINT y = 0; okay && y < nRows; y++) {
+			okay = pWriter->writeRow(reinterpret_cast<const uint32_t*>(
+				static_cast<const unsigned char*>(data.Scan0) + (size_t)y * data.Stride));
+		}
+		band.UnlockBits(&data);
+	}
+	return pWriter->finish() && okay;
+}
+
+bool HeadlessTurtleizer::writeTiles(LPCWSTR basePath, float scale, const ExportPipeline* pPipeline) const
+{
+	// The chunk views point into the mapping, so they stay valid throughout
+	TilePyramid pyramid(this->getBounds(), this->getBackground(), scale);
+	for (size_t ix = 0; ix < this->reader.getTurtleCount(); ix++) {
+		pyramid.addLayer(this->reader.getTurtle(ix).chunks);
+	}
+	return pyramid.write(basePath, pPipeline);
+}
+
+bool HeadlessTurtleizer::writeAnimation(std::ostream& out, size_t segmentsPerStep, float scale) const
+{
+	DrawingAnimation animation(this->getBounds(), this->getBackground(), scale);
+	for (size_t ix = 0; ix < this->reader.getTurtleCount(); ix++) {
+		animation.addLayer(this->reader.getTurtle(ix).chunks);
+	}
+	if (segmentsPerStep == 0) {
+		segmentsPerStep = animation.getStepFor();
+	}
+	return animation.write(out, segmentsPerStep);
+}
+
+bool HeadlessTurtleizer::writeFrames(FrameSink& sink) const
+{
+	sink.setBackground(this->getBackground());
+	for (size_t ix = 0; ix < this->reader.getTurtleCount(); ix++) {
+		sink.beginLayer((uint32_t)ix, 0);
+		sink.addSegments((uint32_t)ix, this->reader.getTurtle(ix).chunks);
+	}
+	return sink.finish();
+}
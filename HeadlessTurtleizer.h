@@ -0,0 +1,108 @@
+#pragma once
+#ifndef HEADLESSTURTLEIZER_H
+#define HEADLESSTURTLEIZER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Window-less counterpart of the Turtleizer for drawings saved in the binary
+ * drawing format (see DrawingFormat.h, "Export drawing as binary file" in the
+ * context menu). The file is mapped into memory and its segments are used in
+ * place (zero-copy), for rendering into any GDI+ graphics or a re-export via
+ * SvgWriter or CsvWriter or a raster image export via an ImageWriter (in
+ * horizontal bands) or as deep-zoom tile pyramid, without a turtle program
+ * and without a window.
+ * The turtle symbols are not rendered.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   writeSVG() returns whether the document was written completely
+ * 2026-10-18   writeSVG() and writeCSV() may simplify the lines (Simplifier)
+ * 2026-10-18   writeSVG() and writeImage() may be restricted to a region
+ * 2026-10-18   New method writeFrames() (raw frame streaming)
+ * 2026-10-18   New method writeAnimation() (animated PNG of the drawing progress)
+ * 2026-10-18   New method writeTiles() (deep-zoom tile pyramid export)
+ * 2026-10-18   New method writeImage() (raster export via the ImageWriterRegistry)
+ * 2026-10-18   Created for VERSION 11.1.0 (binary drawing format)
+ */
+
+#include <Windows.h>
+#include <gdiplus.h>
+#include "MappedFile.h"
+#include "DrawingReader.h"
+#include "SvgWriter.h"
+#include "CsvWriter.h"
+#include "ImageWriters.h"
+using namespace Gdiplus;
+
+class ExportPipeline;
+class FrameSink;
+class Simplifier;
+
+class HeadlessTurtleizer
+{
+public:
+	// Maps and checks the drawing file filePath (check isLoaded() for success)
+	explicit HeadlessTurtleizer(LPCWSTR filePath);
+
+	// Returns true if the file could be mapped and holds a consistent drawing
+	bool isLoaded() const;
+	// Returns a description of the reason why the drawing couldn't be loaded (or NULL)
+	const char* getError() const;
+	// Returns the drawing data (turtle records, chunk views, palette)
+	inline const DrawingReader& getDrawing() const { return this->reader; }
+
+	// Returns the background colour
+	Color getBackground() const;
+	// Returns the combined drawing bounds of all turtles
+	RectF getBounds() const;
+	/* Draws the segments of all turtles (or only those touching the clip rectangle,
+	 * if given) in 2D graphics gr, without background */
+	void draw(Graphics& gr, const RectF* pClip = NULL) const;
+	/* Writes the drawing (or only the parts of the lines within region, if given) as
+	 * complete SVG document with the given title (UTF-8) to the given writer
+	 * (formatting the chunks concurrently if a pipeline is given), with the lines
+	 * reduced by the simplifier if given; returns false if the stream failed */
+	bool writeSVG(SvgWriter& svg, const char* title, float scale = 1.0f,
+		const ExportPipeline* pPipeline = nullptr, const RectF* pRegion = nullptr,
+		Simplifier* pSimplifier = nullptr) const;
+	/* Writes header and rows for the segments of all turtles to the given CSV writer
+	 * (formatting the chunks concurrently if a pipeline is given), with the lines
+	 * reduced by the simplifier if given */
+	void writeCSV(CsvWriter& csv, const ExportPipeline* pPipeline = nullptr,
+		Simplifier* pSimplifier = nullptr) const;
+	/* Renders the drawing (or only region, if given) scaled by scale on its background
+	 * in horizontal bands and streams the rows as image of the given format (see
+	 * ImageWriterRegistry) to the (binary) stream out. Returns false if the image would
+	 * be too large or empty or if the stream failed */
+	bool writeImage(std::ostream& out, const ImageWriterRegistry::Format& format,
+		float scale = 1.0f, const RectF* pRegion = nullptr) const;
+	/* Writes the drawing scaled by scale as deep-zoom tile pyramid (manifest basePath
+	 * + ".dzi", see TilePyramid), rendering the tiles concurrently if a pipeline is
+	 * given. Returns false if the pyramid would be empty or too large or if a file
+	 * couldn't be written */
+	bool writeTiles(LPCWSTR basePath, float scale = 1.0f, const ExportPipeline* pPipeline = nullptr) const;
+	/* Writes the drawing progress scaled by scale as animated PNG (see DrawingAnimation)
+	 * to the (binary) stream out, with segmentsPerStep elements per turtle and frame
+	 * (0: about DrawingAnimation::DEFAULT_FRAMES frames). Returns false if the canvas
+	 * would be empty or too large or if the stream failed */
+	bool writeAnimation(std::ostream& out, size_t segmentsPerStep = 0, float scale = 1.0f) const;
+	/* Replays the drawing turtle by turtle into the given frame sink (with its view set
+	 * up by the caller) and completes the stream. Returns false if writing failed */
+	bool writeFrames(FrameSink& sink) const;
+
+private:
+	static const size_t BAND_BYTES = 16 << 20;	// Maximum size of the band bitmap in writeImage()
+
+	MappedFile file;		// The mapped drawing file
+	DrawingReader reader;	// Views into the mapped file
+
+	HeadlessTurtleizer(const HeadlessTurtleizer&) = delete;
+	HeadlessTurtleizer& operator=(const HeadlessTurtleizer&) = delete;
+};
+
+#endif /*HEADLESSTURTLEIZER_H*/
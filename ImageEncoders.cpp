@@ -9,15 +9,21 @@
  *
  * @author William Sherif
  * @author Kay Grtzig
- * Version: 11.0.1 (covering capabilities of Structorizer 3.30-12, functional GUI)
+ * Version: 11.1.0 (covering capabilities of Structorizer 3.30-12, functional GUI)
  *
  * History (add on top):
  * --------------------------------------------------------
+ * 2026-10-18   VERSION 11.1.0: CLSID cache per extension, shared instance for Save(),
+ *              portable fallback via ImageWriterRegistry
  * 2024-10-04   wcstok signature adapted, STATUS_TEXTS initialisation updated
  * 2021-04-21   Converted into a class (h+cpp), UNICODE adaptation fixed
  * 2016-04-20   created by William Sherif (https://gist.github.com/superwills/2f98fc72f07e61f9c04e56036a29f4b3)
  */
 
+#include <fstream>
+#include <memory>
+#include <cwctype>
+
 const TCHAR* ImageEncoders::STATUS_TEXTS[] = {
   TEXT("Ok: The method call was successful."),
   TEXT("GenericError: There was an error on the method call, which is identified as something other than those defined by the other elements of this enumeration."),
@@ -125,6 +131,18 @@ bool ImageEncoders::InFileTypesList(const TCHAR* ext, const TCHAR* filetypesList
 
 CLSID ImageEncoders::GetCLSIDForExtension(const TCHAR* ext)
 {
+    // START KGU 2026-10-18: Each extension is resolved only once
+    std::basic_string<TCHAR> key(ext);
+    for (TCHAR& ch : key) {
+        ch = (TCHAR)towlower(ch);
+    }
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    auto cached = clsidCache.find(key);
+    if (cached != clsidCache.end()) {
+        return cached->second;
+    }
+    // END KGU 2026-10-18
+
     CLSID clsid = CLSID_NULL; // Start with assuming invalid clsid.
 
     // Use a case-insensitive comparison
@@ -138,6 +156,7 @@ CLSID ImageEncoders::GetCLSIDForExtension(const TCHAR* ext)
         }
     }
 
+    clsidCache[key] = clsid;    // KGU 2026-10-18: Failures are remembered as well
     return clsid;
 }
 
@@ -156,9 +175,18 @@ CLSID ImageEncoders::GetCLSIDByMime(const TCHAR* mimetype)
     return clsid;
 }
 
+ImageEncoders& ImageEncoders::getShared()
+{
+    static ImageEncoders encoders;
+    return encoders;
+}
+
 bool ImageEncoders::Save(Gdiplus::Image* im, TCHAR* filename)
 {
-    ImageEncoders encoders;
+    // START KGU 2026-10-18: The codecs are enumerated only once
+    //ImageEncoders encoders;
+    ImageEncoders& encoders = getShared();
+    // END KGU 2026-10-18
 
     // Extract the extension
     TCHAR* dotLocation = wcsrchr(filename, TEXT('.'));
@@ -180,12 +208,61 @@ bool ImageEncoders::Save(Gdiplus::Image* im, TCHAR* filename)
 #endif /*DEBUG_PRINT*/
             return 1;
         }
+        // START KGU 2026-10-18: Formats without GDI+ codec (e.g. QOI, PPM)
+        const ImageWriterRegistry::Format* pFormat = ImageWriterRegistry::findByExtension(dotLocation + 1);
+        if (pFormat != nullptr)
+        {
+            if (!SaveWithWriter(im, filename, *pFormat))
+            {
+                error(TEXT("ImageEncoders::Save( %s ): Failed to save"), filename);
+                return 0;
+            }
+            return 1;
+        }
+        // END KGU 2026-10-18
     }
 
     error(TEXT("ImageEncoders::Save( %s ): Failed to save; invalid extension"), filename);
     return 0;
 }
 
+bool ImageEncoders::SaveWithWriter(Gdiplus::Image* im, const TCHAR* filename,
+    const ImageWriterRegistry::Format& format)
+{
+    UINT width = im->GetWidth();
+    UINT height = im->GetHeight();
+    // Convert the image into 32 bit pixels (0xAARRGGBB)
+    Gdiplus::Bitmap bitmap((INT)width, (INT)height, PixelFormat32bppARGB);
+    if (bitmap.GetLastStatus() != Gdiplus::Ok)
+    {
+        return false;
+    }
+    {
+        Gdiplus::Graphics gr(&bitmap);
+        gr.DrawImage(im, 0, 0, (INT)width, (INT)height);
+    }
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.good())
+    {
+        return false;
+    }
+    Gdiplus::Rect rect(0, 0, (INT)width, (INT)height);
+    Gdiplus::BitmapData data;
+    if (bitmap.LockBits(&rect, Gdiplus::ImageLockModeRead, PixelFormat32bppARGB, &data) != Gdiplus::Ok)
+    {
+        return false;
+    }
+    std::unique_ptr<ImageWriter> pWriter = format.create(out, width, height, true);
+    bool okay = true;
+    for (UINT y = 0; okay && y < height; y++)
+    {
+        okay = pWriter->writeRow(reinterpret_cast<const uint32_t*>(
+            static_cast<const BYTE*>(data.Scan0) + (size_t)y * data.Stride));
+    }
+    bitmap.UnlockBits(&data);
+    return pWriter->finish() && okay;
+}
+
 
 void ImageEncoders::showMessage(const TCHAR* fmt, const TCHAR* title, int options, va_list args)
 {
@@ -11,10 +11,12 @@
  *
  * @author William Sherif
  * @author Kay Grtzig
- * Version: 11.0.1 (covering capabilities of Structorizer 3.30-12, functional GUI)
+ * Version: 11.1.0 (covering capabilities of Structorizer 3.30-12, functional GUI)
  *
  * History (add on top):
  * --------------------------------------------------------
+ * 2026-10-18   VERSION 11.1.0: Codecs enumerated once (shared instance), CLSID lookup cached
+ *              per extension, Save() falls back to the portable ImageWriterRegistry (e.g. QOI)
  * 2024-10-04   String types declared const where necessary for initialisation with literals
  * 2021-04-21   Converted into a class (h+cpp), UNICODE adaptation fixed
  * 2016-04-20   created by William Sherif (https://gist.github.com/superwills/2f98fc72f07e61f9c04e56036a29f4b3)
@@ -23,6 +25,10 @@
 #include <windows.h>
 #include <gdiplus.h>
 #include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "ImageWriters.h"
 
 #define DEBUG_PRINT 0
 
@@ -41,6 +47,7 @@ public:
     bool InFileTypesList(const TCHAR* ext, const TCHAR* filetypesList);
 
     // Retrieves the guid of the codec for the given file type extension ext
+    // (the result is cached per extension)
     // 
     // @param ext - a file type extension
     CLSID GetCLSIDForExtension(const TCHAR* ext);
@@ -49,7 +56,8 @@ public:
     CLSID GetCLSIDByMime(const TCHAR* mimetype);
 
     // Saves the given image to the file with given filename using the code
-    // associated to filename's extension
+    // associated to filename's extension (a GDI+ codec or else a portable
+    // image writer)
     //
     // @param im - pointer to the Image to be saved
     // @param filename - the target file path
@@ -60,6 +68,19 @@ private:
     UINT byteSize;  // byteSize of encoders on system
     UINT NumberOfEncoders; // number of encoders on system
     Gdiplus::ImageCodecInfo* imageCodecs;   // singleton
+    std::mutex cacheMutex;  // Guards clsidCache
+    std::unordered_map<std::basic_string<TCHAR>, CLSID> clsidCache;    // CLSID per lower-case extension
+
+    // Returns the instance shared by all Save() calls (codecs enumerated once)
+    static ImageEncoders& getShared();
+
+    // Saves the given image via the portable image writer of the given format
+    //
+    // @param im - pointer to the Image to be saved
+    // @param filename - the target file path
+    // @param format - the image format found for the extension of filename
+    static bool SaveWithWriter(Gdiplus::Image* im, const TCHAR* filename,
+        const ImageWriterRegistry::Format& format);
 
     // Adapter method showing a message box with text composed from format string and the
     // value arguments args, regarding the given options (like MB_OKCANCEL | MB_ICONWARNING)
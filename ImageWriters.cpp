@@ -0,0 +1,461 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Portable row-streaming raster image writers and their registry.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (portable image encoder registry)
+ */
+
+#include "ImageWriters.h"
+#include "PngEncoder.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace {
+	inline void putUInt16LE(unsigned char* dest, uint32_t value)
+	{
+		dest[0] = (unsigned char)value;
+		dest[1] = (unsigned char)(value >> 8);
+	}
+
+	inline void putUInt32LE(unsigned char* dest, uint32_t value)
+	{
+		putUInt16LE(dest, value);
+		putUInt16LE(dest + 2, value >> 16);
+	}
+
+	inline void putUInt32BE(unsigned char* dest, uint32_t value)
+	{
+		dest[0] = (unsigned char)(value >> 24);
+		dest[1] = (unsigned char)(value >> 16);
+		dest[2] = (unsigned char)(value >> 8);
+		dest[3] = (unsigned char)value;
+	}
+
+	// Adapter of the PngWriter to the ImageWriter interface
+	class PngImageWriter : public ImageWriter
+	{
+	public:
+		PngImageWriter(std::ostream& out, uint32_t width, uint32_t height, bool withAlpha)
+			: png(out, width, height, withAlpha ? PngWriter::RGBA : PngWriter::RGB)
+			, width(width)
+			, withAlpha(withAlpha)
+			, row(png.getRowSize())
+		{
+		}
+		bool writeRow(const uint32_t* pixels) override
+		{
+			unsigned char* pDest = this->row.data();
+			for (uint32_t x = 0; x < this->width; x++) {
+				uint32_t argb = pixels[x];
+				*pDest++ = (unsigned char)(argb >> 16);
+				*pDest++ = (unsigned char)(argb >> 8);
+				*pDest++ = (unsigned char)argb;
+				if (this->withAlpha) {
+					*pDest++ = (unsigned char)(argb >> 24);
+				}
+			}
+			return this->png.writeRow(this->row.data());
+		}
+		bool finish() override
+		{
+			return this->png.finish();
+		}
+	private:
+		PngWriter png;
+		const uint32_t width;
+		const bool withAlpha;
+		std::vector<unsigned char> row;
+	};
+
+	template<class Writer>
+	std::unique_ptr<ImageWriter> createWriter(std::ostream& out, uint32_t width, uint32_t height, bool withAlpha)
+	{
+		return std::unique_ptr<ImageWriter>(new Writer(out, width, height, withAlpha));
+	}
+}
+
+/*======== ImageWriterRegistry ========*/
+
+ImageWriterRegistry::ImageWriterRegistry()
+{
+	const Format builtIns[] = {
+		{ "PNG", "png", createWriter<PngImageWriter> },
+		{ "BMP", "bmp;dib", createWriter<BmpWriter> },
+		{ "PPM", "ppm;pnm",
+			[](std::ostream& out, uint32_t width, uint32_t height, bool withAlpha) {
+				return std::unique_ptr<ImageWriter>(new PnmWriter(out, width, height, false, withAlpha));
+			} },
+		{ "PAM", "pam",
+			[](std::ostream& out, uint32_t width, uint32_t height, bool withAlpha) {
+				return std::unique_ptr<ImageWriter>(new PnmWriter(out, width, height, true, withAlpha));
+			} },
+		{ "QOI", "qoi", createWriter<QoiWriter> }
+	};
+	for (const Format& format : builtIns) {
+		this->add(format);
+	}
+}
+
+ImageWriterRegistry& ImageWriterRegistry::getInstance()
+{
+	static ImageWriterRegistry instance;
+	return instance;
+}
+
+void ImageWriterRegistry::addFormat(const Format& format)
+{
+	ImageWriterRegistry& registry = getInstance();
+	std::lock_guard<std::mutex> guard(registry.mutex);
+	registry.add(format);
+}
+
+void ImageWriterRegistry::add(const Format& format)
+{
+	this->formats.push_back(format);
+	const std::string& exts = format.extensions;
+	size_t start = 0;
+	while (start <= exts.size()) {
+		size_t end = exts.find(';', start);
+		if (end == std::string::npos) {
+			end = exts.size();
+		}
+		std::string ext = exts.substr(start, end - start);
+		for (char& ch : ext) {
+			if (ch >= 'A' && ch <= 'Z') {
+				ch += 'a' - 'A';
+			}
+		}
+		if (!ext.empty()) {
+			this->byExtension[ext] = &this->formats.back();
+		}
+		start = end + 1;
+	}
+}
+
+const ImageWriterRegistry::Format* ImageWriterRegistry::find(const std::string& ext)
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	auto it = this->byExtension.find(ext);
+	return (it != this->byExtension.end()) ? it->second : nullptr;
+}
+
+const ImageWriterRegistry::Format* ImageWriterRegistry::findByExtension(const char* ext)
+{
+	std::string key;
+	for (; *ext != '\0'; ext++) {
+		char ch = *ext;
+		key += (ch >= 'A' && ch <= 'Z') ? (char)(ch + ('a' - 'A')) : ch;
+	}
+	return getInstance().find(key);
+}
+
+const ImageWriterRegistry::Format* ImageWriterRegistry::findByExtension(const wchar_t* ext)
+{
+	std::string key;
+	for (; *ext != L'\0'; ext++) {
+		wchar_t ch = *ext;
+		if (ch > 0x7F) {
+			return nullptr;	// All registered extensions are ASCII
+		}
+		key += (ch >= L'A' && ch <= L'Z') ? (char)(ch + (L'a' - L'A')) : (char)ch;
+	}
+	return getInstance().find(key);
+}
+
+const ImageWriterRegistry::Format* ImageWriterRegistry::findForFile(const wchar_t* path)
+{
+	const wchar_t* pDot = nullptr;
+	for (const wchar_t* pCh = path; *pCh != L'\0'; pCh++) {
+		if (*pCh == L'.') {
+			pDot = pCh;
+		}
+		else if (*pCh == L'\\' || *pCh == L'/') {
+			pDot = nullptr;	// A dot in a directory name doesn't count
+		}
+	}
+	return (pDot != nullptr) ? findByExtension(pDot + 1) : nullptr;
+}
+
+std::vector<std::string> ImageWriterRegistry::getFormatNames()
+{
+	ImageWriterRegistry& registry = getInstance();
+	std::lock_guard<std::mutex> guard(registry.mutex);
+	std::vector<std::string> names;
+	for (const Format& format : registry.formats) {
+		names.push_back(format.name);
+	}
+	return names;
+}
+
+/*======== BmpWriter ========*/
+
+BmpWriter::BmpWriter(std::ostream& out, uint32_t width, uint32_t height, bool withAlpha)
+	: out(out)
+	, width(width)
+	, height(height)
+	, withAlpha(withAlpha)
+	, nRows(0)
+	, row(((size_t)width * (withAlpha ? 4 : 3) + 3) & ~(size_t)3, 0)
+{
+	// File header (14 bytes) and BITMAPINFOHEADER (40) or BITMAPV4HEADER (108)
+	const uint32_t infoSize = withAlpha ? 108 : 40;
+	const uint64_t dataSize = (uint64_t)this->row.size() * height;
+	if (14 + infoSize + dataSize > UINT32_MAX || width > INT32_MAX || height > INT32_MAX) {
+		this->out.setstate(std::ios::failbit);	// Beyond the limits of the format
+		return;
+	}
+	unsigned char header[14 + 108] = { 'B', 'M' };
+	putUInt32LE(header + 2, (uint32_t)(14 + infoSize + dataSize));
+	putUInt32LE(header + 10, 14 + infoSize);
+	unsigned char* info = header + 14;
+	putUInt32LE(info, infoSize);
+	putUInt32LE(info + 4, width);
+	putUInt32LE(info + 8, (uint32_t)-(int32_t)height);	// negative: top-down
+	putUInt16LE(info + 12, 1);							// planes
+	putUInt16LE(info + 14, withAlpha ? 32 : 24);		// bits per pixel
+	putUInt32LE(info + 16, withAlpha ? 3 : 0);			// BI_BITFIELDS or BI_RGB
+	putUInt32LE(info + 20, (uint32_t)dataSize);
+	putUInt32LE(info + 24, 2835);						// 72 dpi
+	putUInt32LE(info + 28, 2835);
+	if (withAlpha) {
+		putUInt32LE(info + 40, 0x00FF0000);				// red mask
+		putUInt32LE(info + 44, 0x0000FF00);				// green mask
+		putUInt32LE(info + 48, 0x000000FF);				// blue mask
+		putUInt32LE(info + 52, 0xFF000000);				// alpha mask
+		putUInt32LE(info + 56, 0x73524742);				// LCS_sRGB ('sRGB')
+	}
+	this->out.write(reinterpret_cast<const char*>(header), 14 + infoSize);
+}
+
+bool BmpWriter::writeRow(const uint32_t* pixels)
+{
+	if (this->nRows >= this->height || !this->out.good()) {
+		return false;
+	}
+	if (this->withAlpha) {
+		// BGRA in memory, i.e. the little-endian layout of 0xAARRGGBB
+		unsigned char* pDest = this->row.data();
+		for (uint32_t x = 0; x < this->width; x++, pDest += 4) {
+			putUInt32LE(pDest, pixels[x]);
+		}
+	}
+	else {
+		unsigned char* pDest = this->row.data();
+		for (uint32_t x = 0; x < this->width; x++) {
+			uint32_t argb = pixels[x];
+			*pDest++ = (unsigned char)argb;
+			*pDest++ = (unsigned char)(argb >> 8);
+			*pDest++ = (unsigned char)(argb >> 16);
+		}
+	}
+	this->out.write(reinterpret_cast<const char*>(this->row.data()), this->row.size());
+	this->nRows++;
+	return this->out.good();
+}
+
+bool BmpWriter::finish()
+{
+	std::fill(this->row.begin(), this->row.end(), 0);
+	for (; this->nRows < this->height && this->out.good(); this->nRows++) {
+		this->out.write(reinterpret_cast<const char*>(this->row.data()), this->row.size());
+	}
+	this->out.flush();
+	return this->out.good();
+}
+
+/*======== PnmWriter ========*/
+
+PnmWriter::PnmWriter(std::ostream& out, uint32_t width, uint32_t height, bool asPAM, bool withAlpha)
+	: out(out)
+	, width(width)
+	, height(height)
+	, withAlpha(asPAM && withAlpha)
+	, nRows(0)
+	, row((size_t)width * (asPAM && withAlpha ? 4 : 3), 0)
+{
+	std::string header;
+	if (asPAM) {
+		header = "P7\nWIDTH " + std::to_string(width) + "\nHEIGHT " + std::to_string(height)
+			+ (this->withAlpha ? "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n"
+				: "\nDEPTH 3\nMAXVAL 255\nTUPLTYPE RGB\nENDHDR\n");
+	}
+	else {
+		header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+	}
+	this->out.write(header.data(), header.size());
+}
+
+bool PnmWriter::writeRow(const uint32_t* pixels)
+{
+	if (this->nRows >= this->height || !this->out.good()) {
+		return false;
+	}
+	unsigned char* pDest = this->row.data();
+	for (uint32_t x = 0; x < this->width; x++) {
+		uint32_t argb = pixels[x];
+		*pDest++ = (unsigned char)(argb >> 16);
+		*pDest++ = (unsigned char)(argb >> 8);
+		*pDest++ = (unsigned char)argb;
+		if (this->withAlpha) {
+			*pDest++ = (unsigned char)(argb >> 24);
+		}
+	}
+	this->out.write(reinterpret_cast<const char*>(this->row.data()), this->row.size());
+	this->nRows++;
+	return this->out.good();
+}
+
+bool PnmWriter::finish()
+{
+	std::fill(this->row.begin(), this->row.end(), 0);
+	for (; this->nRows < this->height && this->out.good(); this->nRows++) {
+		this->out.write(reinterpret_cast<const char*>(this->row.data()), this->row.size());
+	}
+	this->out.flush();
+	return this->out.good();
+}
+
+/*======== QoiWriter ========*/
+
+namespace {
+	const unsigned char QOI_OP_INDEX = 0x00;
+	const unsigned char QOI_OP_DIFF = 0x40;
+	const unsigned char QOI_OP_LUMA = 0x80;
+	const unsigned char QOI_OP_RUN = 0xC0;
+	const unsigned char QOI_OP_RGB = 0xFE;
+	const unsigned char QOI_OP_RGBA = 0xFF;
+	const unsigned int QOI_MAX_RUN = 62;
+	const size_t QOI_MAX_PIXEL_SIZE = 5;	// QOI_OP_RGBA
+
+	inline unsigned int qoiHash(uint32_t argb)
+	{
+		return ((argb >> 16 & 0xFF) * 3 + (argb >> 8 & 0xFF) * 5 + (argb & 0xFF) * 7 + (argb >> 24) * 11) % 64;
+	}
+}
+
+QoiWriter::QoiWriter(std::ostream& out, uint32_t width, uint32_t height, bool withAlpha)
+	: out(out)
+	, width(width)
+	, height(height)
+	, alphaMask(withAlpha ? 0 : 0xFF000000)
+	, nRows(0)
+	, previous(0xFF000000)
+	, run(0)
+	, finished(false)
+{
+	memset(this->index, 0, sizeof(this->index));
+	this->buffer.reserve(BUFFER_SIZE + width * QOI_MAX_PIXEL_SIZE);
+	unsigned char header[14] = { 'q', 'o', 'i', 'f' };
+	putUInt32BE(header + 4, width);
+	putUInt32BE(header + 8, height);
+	header[12] = withAlpha ? 4 : 3;		// channels
+	header[13] = 0;						// sRGB with linear alpha
+	this->buffer.insert(this->buffer.end(), header, header + sizeof(header));
+}
+
+bool QoiWriter::writeRow(const uint32_t* pixels)
+{
+	if (this->finished || this->nRows >= this->height) {
+		return false;
+	}
+	size_t used = this->buffer.size();
+	this->buffer.resize(used + (size_t)this->width * QOI_MAX_PIXEL_SIZE);
+	unsigned char* pDest = this->buffer.data() + used;
+	uint32_t prev = this->previous;
+	unsigned int runLength = this->run;
+	for (uint32_t x = 0; x < this->width; x++) {
+		uint32_t px = pixels[x] | this->alphaMask;
+		if (px == prev) {
+			// Runs may continue across rows
+			if (++runLength == QOI_MAX_RUN) {
+				*pDest++ = QOI_OP_RUN | (unsigned char)(runLength - 1);
+				runLength = 0;
+			}
+			continue;
+		}
+		if (runLength > 0) {
+			*pDest++ = QOI_OP_RUN | (unsigned char)(runLength - 1);
+			runLength = 0;
+		}
+		unsigned int hash = qoiHash(px);
+		if (this->index[hash] == px) {
+			*pDest++ = QOI_OP_INDEX | (unsigned char)hash;
+		}
+		else {
+			this->index[hash] = px;
+			if ((px ^ prev) >> 24 == 0) {
+				signed char dr = (signed char)((px >> 16) - (prev >> 16));
+				signed char dg = (signed char)((px >> 8) - (prev >> 8));
+				signed char db = (signed char)(px - prev);
+				signed char drg = (signed char)(dr - dg);
+				signed char dbg = (signed char)(db - dg);
+				if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+					*pDest++ = QOI_OP_DIFF | (unsigned char)((dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+				}
+				else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+					*pDest++ = QOI_OP_LUMA | (unsigned char)(dg + 32);
+					*pDest++ = (unsigned char)((drg + 8) << 4 | (dbg + 8));
+				}
+				else {
+					*pDest++ = QOI_OP_RGB;
+					*pDest++ = (unsigned char)(px >> 16);
+					*pDest++ = (unsigned char)(px >> 8);
+					*pDest++ = (unsigned char)px;
+				}
+			}
+			else {
+				*pDest++ = QOI_OP_RGBA;
+				*pDest++ = (unsigned char)(px >> 16);
+				*pDest++ = (unsigned char)(px >> 8);
+				*pDest++ = (unsigned char)px;
+				*pDest++ = (unsigned char)(px >> 24);
+			}
+		}
+		prev = px;
+	}
+	this->buffer.resize(pDest - this->buffer.data());
+	this->previous = prev;
+	this->run = runLength;
+	this->nRows++;
+	if (this->buffer.size() >= BUFFER_SIZE) {
+		this->flush();
+	}
+	return this->out.good();
+}
+
+bool QoiWriter::finish()
+{
+	if (!this->finished) {
+		std::vector<uint32_t> empty(this->width, 0);
+		while (this->nRows < this->height) {
+			this->writeRow(empty.data());
+		}
+		if (this->run > 0) {
+			this->buffer.push_back(QOI_OP_RUN | (unsigned char)(this->run - 1));
+			this->run = 0;
+		}
+		static const unsigned char END_MARKER[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+		this->buffer.insert(this->buffer.end(), END_MARKER, END_MARKER + sizeof(END_MARKER));
+		this->flush();
+		this->out.flush();
+		this->finished = true;
+	}
+	return this->out.good();
+}
+
+void QoiWriter::flush()
+{
+	if (!this->buffer.empty()) {
+		this->out.write(reinterpret_cast<const char*>(this->buffer.data()), this->buffer.size());
+		this->buffer.clear();
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#ifndef IMAGEWRITERS_H
+#define IMAGEWRITERS_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Portable row-streaming raster image writers with a common interface and a
+ * registry resolving file name extensions to writer factories. The rows are
+ * passed as 32-bit pixels 0xAARRGGBB (i.e. the memory layout of 32bpp GDI+
+ * bitmaps on little-endian machines), so locked bitmap rows may be passed as
+ * they are. Built-in formats:
+ * - PNG (via PngWriter, RGB or RGBA)
+ * - BMP (top-down, 24 bit, or 32 bit with alpha mask)
+ * - PPM (binary P6, the alpha is dropped) and PAM (P7, RGB or RGB_ALPHA)
+ * - QOI ("Quite OK Image" format, lossless and very fast to write)
+ * Every extension is resolved once on registration, so a lookup is a single
+ * hash access. Further formats may be registered by the application.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (portable image encoder registry)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Common interface of the row-streaming image writers
+class ImageWriter
+{
+public:
+	virtual ~ImageWriter() {}
+	// Encodes the next image row (width pixels 0xAARRGGBB, top-down), returns false
+	// if the stream failed
+	virtual bool writeRow(const uint32_t* pixels) = 0;
+	// Completes the image (missing rows are filled with zeros), returns false if
+	// the stream failed
+	virtual bool finish() = 0;
+};
+
+class ImageWriterRegistry
+{
+public:
+	/* Creates a writer for a width x height image to the (binary) stream out; if
+	 * withAlpha is false then the alpha bytes of the pixels are ignored */
+	typedef std::function<std::unique_ptr<ImageWriter>(std::ostream& out,
+		uint32_t width, uint32_t height, bool withAlpha)> Factory;
+
+	// Description of an image format
+	struct Format {
+		std::string name;			// Format name, e.g. "PNG"
+		std::string extensions;		// Semicolon-separated extensions, e.g. "ppm;pnm"
+		Factory create;				// Writer factory
+	};
+
+	/* Adds the given format, its extensions (case-insensitive, without dot) then
+	 * refer to it (overriding former registrations) */
+	static void addFormat(const Format& format);
+	// Returns the format registered for extension ext (without dot) or nullptr
+	static const Format* findByExtension(const char* ext);
+	static const Format* findByExtension(const wchar_t* ext);
+	// Returns the format registered for the extension of the file path or nullptr
+	static const Format* findForFile(const wchar_t* path);
+	// Returns the names of the registered formats in order of registration
+	static std::vector<std::string> getFormatNames();
+
+private:
+	std::mutex mutex;
+	std::deque<Format> formats;		// Registered formats (stable addresses)
+	std::unordered_map<std::string, const Format*> byExtension;	// Lower-case extensions
+
+	// Registers the built-in formats
+	ImageWriterRegistry();
+	// Returns the singleton
+	static ImageWriterRegistry& getInstance();
+	// Appends format and maps its extensions to it (the caller holds the mutex)
+	void add(const Format& format);
+	// Looks up the extension ext (ASCII, converted to lower case)
+	const Format* find(const std::string& ext);
+};
+
+// BMP writer (rows stored top-down, 24 bits per pixel or 32 bits with alpha)
+class BmpWriter : public ImageWriter
+{
+public:
+	BmpWriter(std::ostream& out, uint32_t width, uint32_t height, bool withAlpha);
+	bool writeRow(const uint32_t* pixels) override;
+	bool finish() override;
+private:
+	std::ostream& out;
+	const uint32_t width, height;
+	const bool withAlpha;
+	uint32_t nRows;
+	std::vector<unsigned char> row;	// Row buffer (padded to a multiple of 4 bytes)
+};
+
+// Netpbm writer: PPM (P6) or PAM (P7, with alpha if wanted)
+class PnmWriter : public ImageWriter
+{
+public:
+	PnmWriter(std::ostream& out, uint32_t width, uint32_t height, bool asPAM, bool withAlpha);
+	bool writeRow(const uint32_t* pixels) override;
+	bool finish() override;
+private:
+	std::ostream& out;
+	const uint32_t width, height;
+	const bool withAlpha;
+	uint32_t nRows;
+	std::vector<unsigned char> row;
+};
+
+// QOI writer (see https://qoiformat.org/qoi-specification.pdf)
+class QoiWriter : public ImageWriter
+{
+public:
+	QoiWriter(std::ostream& out, uint32_t width, uint32_t height, bool withAlpha);
+	bool writeRow(const uint32_t* pixels) override;
+	bool finish() override;
+private:
+	static const size_t BUFFER_SIZE = 1 << 16;	// Output bytes buffered before writing
+
+	std::ostream& out;
+	const uint32_t width, height;
+	const uint32_t alphaMask;		// 0xFF000000 if the alpha bytes are to be ignored
+	uint32_t nRows;
+	uint32_t index[64];				// Recently seen pixels by hash
+	uint32_t previous;				// Previous pixel (0xAARRGGBB)
+	unsigned int run;				// Length of the current run of the previous pixel
+	std::vector<unsigned char> buffer;
+	bool finished;
+
+	// Passes the buffer to the stream
+	void flush();
+};
+
+#endif /*IMAGEWRITERS_H*/
@@ -0,0 +1,208 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Incremental export of a drawing in progress, see IncrementalExport.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (incremental re-export)
+ */
+
+#include "IncrementalExport.h"
+#include "Turtle.h"
+#include <cstdio>
+#include <cwchar>
+
+const wchar_t IncrementalExport::SIDE_FILE_SUFFIX[] = L".parts";
+
+IncrementalExport::IncrementalExport(LPCWSTR filePath, Format format, int precision, bool resume)
+	: filePath(filePath)
+	, format(format)
+	, precision(precision)
+	, resume(resume && format == FORMAT_CSV)
+	, separator(',')
+	, columns(0)
+	, compression(SvgWriter::NO_COMPRESSION)
+	, started(false)
+	, restartDue(false)
+	, nLast(0)
+	, nTotal(0)
+{
+}
+
+void IncrementalExport::setCsvLayout(char separator, unsigned int columns)
+{
+	this->separator = separator;
+	this->columns = columns;
+}
+
+void IncrementalExport::setCompression(int compression)
+{
+	this->compression = compression;
+}
+
+bool IncrementalExport::beginSnapshot()
+{
+	this->nLast = 0;
+	if (this->started) {
+		return this->file.is_open();
+	}
+	this->started = true;
+	return this->open(this->resume);
+}
+
+size_t IncrementalExport::beginTurtle(uint32_t turtleNo, unsigned int generation)
+{
+	if (turtleNo >= this->turtles.size()) {
+		TurtleProgress progress = {};
+		progress.generation = generation;
+		this->turtles.resize(turtleNo + 1, progress);
+	}
+	TurtleProgress& progress = this->turtles[turtleNo];
+	if (progress.generation != generation) {
+		this->restartDue = true;
+	}
+	return progress.nExported;
+}
+
+void IncrementalExport::addSegments(uint32_t turtleNo, const std::vector<SegmentChunkView>& chunks)
+{
+	if (this->restartDue || chunks.empty()) {
+		return;
+	}
+	size_t count = 0;
+	for (const SegmentChunkView& chunk : chunks) {
+		count += chunk.count;
+	}
+	if (!this->resume) {
+		// (Unless resuming, where the file holds these elements already)
+		if (this->format == FORMAT_CSV) {
+			Turtle::writeChunksCSV(*this->pCsv, turtleNo, chunks);
+		}
+		else {
+			Turtle::writeChunksSVG(*this->pSvg, PointF(0.0f, 0.0f), chunks);
+		}
+		this->nLast += count;
+	}
+	this->turtles[turtleNo].nExported = chunks.back().firstIndex + chunks.back().count;
+	this->nTotal += count;
+}
+
+bool IncrementalExport::restart()
+{
+	this->turtles.clear();
+	this->restartDue = false;
+	this->resume = false;
+	this->nLast = 0;
+	this->nTotal = 0;
+	return this->open(false);
+}
+
+bool IncrementalExport::endSnapshot()
+{
+	this->resume = false;
+	bool okay = this->file.is_open();
+	if (okay) {
+		okay = this->pCsv ? this->pCsv->flush() : this->pSvg->flush();
+		this->file.flush();
+		okay = okay && this->file.good();
+	}
+	if (!okay) {
+		// The file state is unknown, so the next snapshot writes everything anew
+		this->restartDue = false;
+		this->turtles.clear();
+		this->nTotal = 0;
+		this->started = false;
+	}
+	return okay;
+}
+
+bool IncrementalExport::finish(const RectF& bounds, Color background)
+{
+	if (this->format != FORMAT_SVG) {
+		return this->file.is_open() && this->file.good();
+	}
+	// Complete the side file (a snapshot must have been taken)
+	if (!this->file.is_open()) {
+		return false;
+	}
+	this->pSvg->flush();
+	this->file.close();
+	std::wstring sidePath = this->getSnapshotPath();
+	std::ifstream side(sidePath, std::ios::in | std::ios::binary);
+	std::ofstream ostr(this->filePath, this->compression != SvgWriter::NO_COMPRESSION
+		? std::ios::out | std::ios::binary : std::ios::out);
+	if (!side.is_open() || !ostr.is_open()) {
+		return false;
+	}
+	// The title is the file name (UTF-8 encoded)
+	size_t ixName = this->filePath.find_last_of(L"\\/");
+	std::wstring name = this->filePath.substr(ixName == std::wstring::npos ? 0 : ixName + 1);
+	char title[3 * _MAX_PATH + 1] = { 0 };
+	WideCharToMultiByte(CP_UTF8, 0, name.c_str(), -1, title, sizeof(title), NULL, NULL);
+
+	SvgWriter svg(ostr, this->precision, this->compression);
+	svg.adoptColours(*this->pSvg);
+	svg.writeDocumentStart(bounds.Width, bounds.Height, 1.0f, title, background.GetValue() & 0xFFFFFF);
+	// The paths were written with turtle coordinates, the group shifts them into the picture
+	char groupStart[96];
+	int length = snprintf(groupStart, sizeof(groupStart), "  <g transform=\"translate(%g,%g)\">\n",
+		-bounds.X, -bounds.Y);
+	svg.writeText(groupStart, (size_t)length);
+	std::vector<char> block(SvgWriter::BUFFER_SIZE);
+	while (side.read(block.data(), block.size()) || side.gcount() > 0) {
+		svg.writeText(block.data(), (size_t)side.gcount());
+	}
+	svg.writeText("  </g>\n", 7);
+	bool okay = svg.writeDocumentEnd() && side.eof();
+	side.close();
+	this->pSvg.reset();
+	if (okay) {
+		_wremove(sidePath.c_str());
+	}
+	// Another snapshot would start all over
+	this->started = false;
+	this->turtles.clear();
+	this->nTotal = 0;
+	return okay;
+}
+
+std::wstring IncrementalExport::getSnapshotPath() const
+{
+	return this->format == FORMAT_SVG ? this->filePath + SIDE_FILE_SUFFIX : this->filePath;
+}
+
+bool IncrementalExport::open(bool append)
+{
+	// The writers must be gone before their stream is reopened
+	this->pCsv.reset();
+	this->pSvg.reset();
+	if (this->file.is_open()) {
+		this->file.close();
+	}
+	this->file.clear();
+	// (The side file is binary, its line ends get converted when it is merged)
+	std::ios::openmode mode = this->format == FORMAT_CSV ? std::ios::out : std::ios::out | std::ios::binary;
+	this->file.open(this->getSnapshotPath(), append ? mode | std::ios::app : mode | std::ios::trunc);
+	if (!this->file.is_open()) {
+		return false;
+	}
+	if (this->format == FORMAT_CSV) {
+		this->pCsv.reset(new CsvWriter(this->file, this->separator, this->precision, this->columns));
+		// An empty file needs the header (and there is nothing to be adopted)
+		this->file.seekp(0, std::ios::end);
+		if (this->file.tellp() == std::streampos(0)) {
+			this->pCsv->writeHeader();
+			this->resume = false;
+		}
+	}
+	else {
+		this->pSvg.reset(new SvgWriter(this->file, this->precision));
+	}
+	return true;
+}
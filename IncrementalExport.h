@@ -0,0 +1,126 @@
+#pragma once
+#ifndef INCREMENTALEXPORT_H
+#define INCREMENTALEXPORT_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Incremental export of a drawing in progress (e.g. periodic snapshots of a
+ * long-running turtle program), the cost of a snapshot being proportional to
+ * the lines drawn since the previous one. A cursor holds the number of elements
+ * already exported per turtle (with the store generation, like the Journal), so
+ * each snapshot appends only the newer ones:
+ *   FORMAT_CSV: rows are appended to the CSV file (which may also be an existing
+ *               one, already holding the current drawing, with resume)
+ *   FORMAT_SVG: path groups are appended to a side file (file name plus
+ *               SIDE_FILE_SUFFIX), whose text is merged into the SVG document by
+ *               finish(), when the final extent of the drawing is known
+ * As the lines of a cleared turtle can't be withdrawn from an append-only file,
+ * a clear makes the next snapshot start the file all over (restart()).
+ * (The binary drawing format keeps the chunks of a turtle together and can't be
+ * appended to, its appendable counterpart is the resumable Journal.)
+ * The snapshots are driven by Turtleizer::exportIncrement().
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (incremental re-export)
+ */
+
+#include <Windows.h>
+#include <gdiplus.h>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CsvWriter.h"
+#include "SegmentStore.h"
+#include "SvgWriter.h"
+using namespace Gdiplus;
+
+class IncrementalExport
+{
+public:
+	// Target file formats
+	enum Format {
+		FORMAT_CSV,			// Comma-separated values (rows appended)
+		FORMAT_SVG			// Scalable vector graphics (paths gathered in a side file)
+	};
+	static const wchar_t SIDE_FILE_SUFFIX[];	// Appended to the file name for the side file
+
+	/* Prepares the incremental export into the file filePath in the given format,
+	 * with precision as for CsvWriter or SvgWriter, respectively. With resume, an
+	 * existing CSV file is taken to hold the drawing reported by the first snapshot
+	 * (e.g. just restored by Turtleizer::replayJournal()), so nothing of it is
+	 * written again; for SVG, resume has no effect */
+	IncrementalExport(LPCWSTR filePath, Format format, int precision = -1, bool resume = false);
+
+	// Sets separator and optional columns of the CSV rows (before the first snapshot)
+	void setCsvLayout(char separator, unsigned int columns);
+	// Sets the gzip compression level of the finished SVG document (before finish())
+	void setCompression(int compression);
+
+	/* Prepares a snapshot (the first one creates or opens the file, which then
+	 * stays open), returns false if the file isn't available */
+	bool beginSnapshot();
+	/* To be called for turtle number turtleNo with the current generation of its
+	 * store, returns the index of the first element not exported yet (if the
+	 * turtle was cleared meanwhile, a restart is due and nothing gets added) */
+	size_t beginTurtle(uint32_t turtleNo, unsigned int generation);
+	// To be called with the new elements of turtle number turtleNo
+	void addSegments(uint32_t turtleNo, const std::vector<SegmentChunkView>& chunks);
+	// Returns true if a cleared turtle requires to write the drawing all over
+	inline bool isRestartDue() const { return this->restartDue; }
+	/* Empties the file(s) and resets the cursor, such that the following turtle
+	 * reports pass the entire drawing; returns false if the files fail */
+	bool restart();
+	/* Passes the snapshot to the file(s), returns false if writing failed
+	 * (then the next snapshot starts all over) */
+	bool endSnapshot();
+
+	/* Completes the export: merges the side file into the SVG document for the
+	 * drawing extent bounds with the given background and removes the side file;
+	 * returns false if this fails. A CSV file is complete after every snapshot */
+	bool finish(const RectF& bounds, Color background);
+
+	// Returns the number of elements exported by the most recent snapshot
+	inline uint64_t getLastCount() const { return this->nLast; }
+	// Returns the number of elements in the export file(s)
+	inline uint64_t getTotalCount() const { return this->nTotal; }
+
+private:
+	// Export progress of a turtle
+	struct TurtleProgress {
+		size_t nExported;				// Number of elements exported
+		unsigned int generation;		// Store generation of these elements
+	};
+
+	const std::wstring filePath;
+	const Format format;
+	const int precision;
+	bool resume;						// Whether the first snapshot only adopts the drawing
+	char separator;						// CSV separator
+	unsigned int columns;				// Optional CSV columns
+	int compression;					// SVG compression level
+	bool started;						// Whether the file has been created (or resumed)
+	bool restartDue;					// Whether a turtle was cleared since its last export
+	std::vector<TurtleProgress> turtles;	// The cursor
+	uint64_t nLast, nTotal;
+	std::ofstream file;					// The CSV file or the SVG side file
+	std::unique_ptr<CsvWriter> pCsv;	// Row writer (lives across the snapshots)
+	std::unique_ptr<SvgWriter> pSvg;	// Path writer for the side file (holds the colour classes)
+
+	// Returns the path of the file written by the snapshots
+	std::wstring getSnapshotPath() const;
+	// Opens the snapshot file, either empty or for appending
+	bool open(bool append);
+
+	IncrementalExport(const IncrementalExport&) = delete;
+	IncrementalExport& operator=(const IncrementalExport&) = delete;
+};
+
+#endif /*INCREMENTALEXPORT_H*/
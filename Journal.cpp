@@ -0,0 +1,213 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Append-only journal of a drawing in progress.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Resumption of an existing journal (incremental re-export)
+ * 2026-10-18   Created for VERSION 11.1.0 (drawing journal)
+ */
+
+#include "Journal.h"
+#include <chrono>
+#include <cstring>
+
+const char Journal::JOURNAL_MAGIC[8] = { 'T', 'Z', 'J', 'R', 'N', 'L', '\r', '\n' };
+
+Journal::Journal(std::ostream& out, const Source& source, bool resume)
+	: out(out)
+	, source(source)
+	, hasBackground(false)
+	, adopting(false)
+	, background(0)
+	, nWritten(0)
+	, good(true)
+	, stopping(false)
+{
+	if (resume) {
+		// The drawing reported now is in the journal already
+		this->adopting = true;
+		this->poll();
+		this->adopting = false;
+	}
+	else {
+		DrawingFormat::FileHeader header = {};
+		memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+		header.version = VERSION;
+		header.headerSize = sizeof(header);
+		this->out.write((const char*)&header, sizeof(header));
+		this->out.flush();
+		this->nWritten = sizeof(header);
+	}
+	this->good = this->out.good();
+	// Start the writer only now that all members are set up
+	this->writer = std::thread(&Journal::run, this);
+}
+
+Journal::~Journal()
+{
+	{
+		std::lock_guard<std::mutex> guard(this->mutex);
+		this->stopping = true;
+	}
+	this->stopRequest.notify_one();
+	this->writer.join();
+}
+
+void Journal::run()
+{
+	std::unique_lock<std::mutex> lock(this->mutex);
+	bool stop = false;
+	do {
+		stop = this->stopRequest.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+			[this] { return this->stopping; });
+		// The source must not be polled while holding the mutex
+		lock.unlock();
+		this->poll();
+		lock.lock();
+	} while (!stop);
+}
+
+void Journal::poll()
+{
+	this->source(*this);
+	if (!this->buffer.empty()) {
+		this->out.write(this->buffer.data(), this->buffer.size());
+		this->out.flush();
+		std::lock_guard<std::mutex> guard(this->mutex);
+		this->nWritten += this->buffer.size();
+		this->good = this->out.good();
+	}
+	this->buffer.clear();
+}
+
+size_t Journal::beginTurtle(uint32_t turtleNo, unsigned int generation)
+{
+	if (turtleNo >= this->turtles.size()) {
+		TurtleProgress progress = {};
+		progress.generation = generation;
+		this->turtles.resize(turtleNo + 1, progress);
+	}
+	TurtleProgress& progress = this->turtles[turtleNo];
+	if (progress.generation != generation) {
+		this->addRecord(RT_CLEAR, turtleNo, nullptr, 0);
+		progress.generation = generation;
+		progress.nJournaled = 0;
+	}
+	return progress.nJournaled;
+}
+
+void Journal::addSegments(uint32_t turtleNo, const std::vector<SegmentChunkView>& chunks)
+{
+	TurtleProgress& progress = this->turtles[turtleNo];
+	for (const SegmentChunkView& chunk : chunks) {
+		if (chunk.count > 0) {
+			this->addRecord(RT_SEGMENTS, turtleNo, chunk.segments, chunk.count * sizeof(Segment));
+			progress.nJournaled = chunk.firstIndex + chunk.count;
+		}
+	}
+}
+
+void Journal::addState(uint32_t turtleNo, const DrawingFormat::TurtleRecord& state)
+{
+	TurtleProgress& progress = this->turtles[turtleNo];
+	if (!progress.hasState || memcmp(&progress.state, &state, sizeof(state)) != 0) {
+		this->addRecord(RT_STATE, turtleNo, &state, sizeof(state));
+		progress.state = state;
+		progress.hasState = true;
+	}
+}
+
+void Journal::addBackground(uint32_t argb)
+{
+	if (!this->hasBackground || argb != this->background) {
+		this->addRecord(RT_BACKGROUND, 0, &argb, sizeof(argb));
+		this->background = argb;
+		this->hasBackground = true;
+	}
+}
+
+uint64_t Journal::getBytesWritten() const
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	return this->nWritten;
+}
+
+bool Journal::isGood() const
+{
+	std::lock_guard<std::mutex> guard(this->mutex);
+	return this->good;
+}
+
+void Journal::addRecord(RecordType type, uint32_t turtle, const void* payload, size_t size)
+{
+	if (this->adopting) {
+		return;
+	}
+	RecordHeader header = {};
+	header.type = (uint16_t)type;
+	header.turtle = turtle;
+	header.size = size;
+	size_t start = this->buffer.size();
+	// Header and padding are zero-filled by the resize
+	this->buffer.resize(start + sizeof(header) + (size_t)DrawingFormat::align(size));
+	memcpy(&this->buffer[start], &header, sizeof(header));
+	if (size > 0) {
+		memcpy(&this->buffer[start + sizeof(header)], payload, size);
+	}
+}
+
+bool Journal::replay(const char* data, size_t size, Player& player, size_t* pComplete)
+{
+	const DrawingFormat::FileHeader* pHeader = (const DrawingFormat::FileHeader*)data;
+	if (size < sizeof(DrawingFormat::FileHeader) || ((uintptr_t)data % DrawingFormat::ALIGNMENT) != 0
+		|| memcmp(pHeader->magic, JOURNAL_MAGIC, sizeof(pHeader->magic)) != 0
+		|| pHeader->version > VERSION || pHeader->headerSize % DrawingFormat::ALIGNMENT != 0) {
+		return false;
+	}
+	size_t offset = pHeader->headerSize;
+	while (offset <= size && size - offset >= sizeof(RecordHeader)) {
+		const RecordHeader* pRecord = (const RecordHeader*)(data + offset);
+		const char* payload = data + offset + sizeof(RecordHeader);
+		size_t available = size - offset - sizeof(RecordHeader);
+		if (pRecord->size > available) {
+			// Torn record at the end
+			break;
+		}
+		switch (pRecord->type) {
+		case RT_SEGMENTS:
+			if (pRecord->size > 0) {
+				player.onSegments(pRecord->turtle, (const Segment*)payload, (size_t)(pRecord->size / sizeof(Segment)));
+			}
+			break;
+		case RT_STATE:
+			if (pRecord->size >= sizeof(DrawingFormat::TurtleRecord)) {
+				player.onState(pRecord->turtle, *(const DrawingFormat::TurtleRecord*)payload);
+			}
+			break;
+		case RT_CLEAR:
+			player.onClear(pRecord->turtle);
+			break;
+		case RT_BACKGROUND:
+			if (pRecord->size >= sizeof(uint32_t)) {
+				player.onBackground(*(const uint32_t*)payload);
+			}
+			break;
+		default:
+			// Unknown record types of later versions are skipped
+			break;
+		}
+		offset += sizeof(RecordHeader) + (size_t)DrawingFormat::align(pRecord->size);
+	}
+	if (pComplete != nullptr) {
+		// (May exceed size by the padding of a last record torn within it)
+		*pComplete = offset;
+	}
+	return true;
+}
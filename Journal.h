@@ -0,0 +1,141 @@
+#pragma once
+#ifndef JOURNAL_H
+#define JOURNAL_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Append-only journal of a drawing in progress, such that the drawing survives
+ * a crash or kill of the turtle program and needn't be exported in one burst.
+ * A background thread polls the drawing source every FLUSH_INTERVAL_MS (like
+ * the window thread, it reads the segment stores concurrently, so the turtle
+ * moves aren't slowed down by any hook) and appends the new segments and the
+ * changes of turtle state, store generation (clear) and background as records
+ * to the stream, one buffered write and flush per poll.
+ * A journal file consists of a DrawingFormat::FileHeader (with JOURNAL_MAGIC)
+ * followed by records, each a RecordHeader and size payload bytes (padded to
+ * DrawingFormat::ALIGNMENT):
+ *   RT_SEGMENTS:   Segments appended to the turtle's elements
+ *   RT_STATE:      DrawingFormat::TurtleRecord (without chunk data)
+ *   RT_CLEAR:      no payload, the turtle's elements were cleared
+ *   RT_BACKGROUND: the ARGB value of the background colour
+ * A torn record at the end (e.g. after a crash) is ignored on replay.
+ * A resumed journal appends to the complete records of an existing journal file,
+ * taking the drawing as already journaled that its source reports first (i.e.
+ * the drawing just restored by replay), so only what follows is recorded.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Resumption of an existing journal (incremental re-export)
+ * 2026-10-18   Created for VERSION 11.1.0 (drawing journal)
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "DrawingFormat.h"
+
+class Journal
+{
+public:
+	static const char JOURNAL_MAGIC[8];				// File signature
+	static const uint16_t VERSION = 1;				// Current journal version
+	static const unsigned int FLUSH_INTERVAL_MS = 50;	// Polling interval of the writer thread
+
+	enum RecordType { RT_SEGMENTS = 1, RT_STATE = 2, RT_CLEAR = 3, RT_BACKGROUND = 4 };
+	// Start of a record
+	struct RecordHeader {
+		uint16_t type;			// RecordType
+		uint16_t reserved;
+		uint32_t turtle;		// Index of the turtle (0 for RT_BACKGROUND)
+		uint64_t size;			// Payload size in bytes (without padding)
+	};
+
+	// Called by the writer thread to report the current drawing via the add methods
+	typedef std::function<void(Journal&)> Source;
+
+	// Receiver of the records on replay
+	class Player {
+	public:
+		virtual ~Player() {}
+		virtual void onSegments(uint32_t turtle, const Segment* segments, size_t count) = 0;
+		virtual void onState(uint32_t turtle, const DrawingFormat::TurtleRecord& state) = 0;
+		virtual void onClear(uint32_t turtle) = 0;
+		virtual void onBackground(uint32_t argb) = 0;
+	};
+
+	/* Writes the journal header to the (binary) stream out and starts the writer
+	 * thread, which polls source every FLUSH_INTERVAL_MS. With resume, out appends
+	 * to an existing journal instead: no header is written and a first poll adopts
+	 * the drawing reported by source as journaled, without recording anything */
+	Journal(std::ostream& out, const Source& source, bool resume = false);
+	// Performs a final poll and stops the writer thread
+	~Journal();
+
+	/* To be called by the source for turtle number turtleNo with the current
+	 * generation of its store, returns the index of the first element not
+	 * journaled yet (0 after a clear, which is recorded then) */
+	size_t beginTurtle(uint32_t turtleNo, unsigned int generation);
+	// To be called by the source with the new elements of turtle number turtleNo
+	void addSegments(uint32_t turtleNo, const std::vector<SegmentChunkView>& chunks);
+	// To be called by the source with the state of turtle number turtleNo (recorded if modified)
+	void addState(uint32_t turtleNo, const DrawingFormat::TurtleRecord& state);
+	// To be called by the source with the background colour (recorded if modified)
+	void addBackground(uint32_t argb);
+
+	// Returns the number of bytes written to the stream so far
+	uint64_t getBytesWritten() const;
+	// Returns true unless writing to the stream failed
+	bool isGood() const;
+
+	/* Passes the complete records of the journal held in the size bytes at data
+	 * (8-byte aligned) to player, returns false if data isn't a journal. If given,
+	 * *pComplete is set to the (aligned) length of the header and the complete
+	 * records, where a resumed journal has to continue */
+	static bool replay(const char* data, size_t size, Player& player, size_t* pComplete = nullptr);
+
+private:
+	// Journal progress of a turtle
+	struct TurtleProgress {
+		size_t nJournaled;				// Number of elements journaled
+		unsigned int generation;		// Store generation of these elements
+		bool hasState;					// Whether a state has been journaled
+		DrawingFormat::TurtleRecord state;	// The state last journaled
+	};
+
+	std::ostream& out;
+	const Source source;
+	std::vector<char> buffer;			// Records of the current poll
+	std::vector<TurtleProgress> turtles;
+	bool hasBackground;					// Whether a background has been journaled
+	bool adopting;						// Whether records are suppressed (first poll on resume)
+	uint32_t background;				// The background colour last journaled
+	uint64_t nWritten;					// Bytes passed to the stream (guarded by mutex)
+	bool good;							// Stream state (guarded by mutex)
+	mutable std::mutex mutex;			// Guards stopping, nWritten, good
+	std::condition_variable stopRequest;	// Signalled by the destructor
+	bool stopping;						// Whether the writer thread is to stop
+	std::thread writer;					// The writer thread
+
+	// Body of the writer thread
+	void run();
+	// Polls the source and writes the gathered records
+	void poll();
+	// Appends a record with given type, turtle, and payload to the buffer
+	void addRecord(RecordType type, uint32_t turtle, const void* payload, size_t size);
+
+	Journal(const Journal&) = delete;
+	Journal& operator=(const Journal&) = delete;
+};
+
+#endif /*JOURNAL_H*/
@@ -0,0 +1,69 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Read-only memory mapping of an entire file.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (fast CSV import)
+ */
+
+#include "MappedFile.h"
+
+MappedFile::MappedFile(LPCWSTR filePath)
+	: hFile(INVALID_HANDLE_VALUE)
+	, hMapping(NULL)
+	, pView(nullptr)
+	, length(0)
+{
+	this->hFile = CreateFileW(filePath, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (this->hFile == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(this->hFile, &fileSize)
+		|| (unsigned long long)fileSize.QuadPart > (unsigned long long)SIZE_MAX) {
+		this->close();
+		return;
+	}
+	this->length = (size_t)fileSize.QuadPart;
+	if (this->length == 0) {
+		// An empty file cannot be mapped but is a valid (empty) content
+		return;
+	}
+	this->hMapping = CreateFileMappingW(this->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (this->hMapping != NULL) {
+		this->pView = (const char*)MapViewOfFile(this->hMapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (this->pView == nullptr) {
+		this->close();
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	this->close();
+}
+
+void MappedFile::close()
+{
+	if (this->pView != nullptr) {
+		UnmapViewOfFile(this->pView);
+		this->pView = nullptr;
+	}
+	if (this->hMapping != NULL) {
+		CloseHandle(this->hMapping);
+		this->hMapping = NULL;
+	}
+	if (this->hFile != INVALID_HANDLE_VALUE) {
+		CloseHandle(this->hFile);
+		this->hFile = INVALID_HANDLE_VALUE;
+	}
+	this->length = 0;
+}
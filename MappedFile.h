@@ -0,0 +1,51 @@
+#pragma once
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Read-only memory mapping of an entire file (e.g. for the import of drawings),
+ * such that the content can be parsed in place without any copying.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (fast CSV import)
+ */
+
+#include <Windows.h>
+#include <cstddef>
+
+class MappedFile
+{
+public:
+	// Maps the file with the given path (check isOpen() for success)
+	explicit MappedFile(LPCWSTR filePath);
+	// Unmaps and closes the file
+	~MappedFile();
+
+	// Returns true if the file could be opened and mapped
+	inline bool isOpen() const { return this->hFile != INVALID_HANDLE_VALUE; }
+	// Returns the start of the file content (nullptr if the file is empty)
+	inline const char* data() const { return this->pView; }
+	// Returns the size of the file content in bytes
+	inline size_t size() const { return this->length; }
+
+private:
+	HANDLE hFile;			// The file handle
+	HANDLE hMapping;		// The file mapping object (NULL for an empty file)
+	const char* pView;		// The mapped view of the file
+	size_t length;			// The file size
+
+	// Releases all handles
+	void close();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif /*MAPPEDFILE_H*/
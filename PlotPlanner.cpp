@@ -0,0 +1,419 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Toolpath planning for pen plotters (stitching and ordering of the turtle
+ * segments), see PlotPlanner.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   New method simplify() (simplified vector export)
+ * 2026-10-18   Created for VERSION 11.1.0 (pen-plotter export)
+ */
+
+#include "PlotPlanner.h"
+#include "ExportPipeline.h"
+#include "Simplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+namespace {
+	inline double distance(const PlotPoint& a, const PlotPoint& b)
+	{
+		double dx = (double)b.x - a.x, dy = (double)b.y - a.y;
+		return sqrt(dx * dx + dy * dy);
+	}
+}
+
+PlotPlanner::PlotPlanner(float tolerance)
+	: tolerance(tolerance > 0 ? tolerance : 0.01f)
+	, bounds(SegmentBounds::empty())
+	, plannedStats()
+{
+}
+
+uint64_t PlotPlanner::getKey(float x, float y) const
+{
+	int64_t qx = llround(x / this->tolerance);
+	int64_t qy = llround(y / this->tolerance);
+	return ((uint64_t)qx << 32) ^ ((uint64_t)qy & 0xFFFFFFFFu);
+}
+
+void PlotPlanner::addSegments(const Segment* segs, size_t count)
+{
+	this->segments.reserve(this->segments.size() + count);
+	for (size_t i = 0; i < count; i++) {
+		const Segment& seg = segs[i];
+		this->bounds.include(seg);
+		// Extend the current run if the segment continues it in the same colour
+		if (!this->runs.empty()) {
+			const Segment& last = this->segments.back();
+			if (last.argb == seg.argb && this->getKey(last.x2, last.y2) == this->getKey(seg.x1, seg.y1)) {
+				this->segments.push_back(seg);
+				this->runs.back().count++;
+				continue;
+			}
+		}
+		this->runs.push_back(Run{ this->segments.size(), 1 });
+		this->segments.push_back(seg);
+	}
+}
+
+void PlotPlanner::addChunks(const std::vector<SegmentChunkView>& chunks)
+{
+	for (const SegmentChunkView& chunk : chunks) {
+		this->addSegments(chunk.segments, chunk.count);
+	}
+}
+
+PlotPoint PlotPlanner::getRunStart(size_t ix, bool reversed) const
+{
+	const Run& run = this->runs[ix];
+	if (reversed) {
+		const Segment& seg = this->segments[run.first + run.count - 1];
+		return PlotPoint{ seg.x2, seg.y2 };
+	}
+	const Segment& seg = this->segments[run.first];
+	return PlotPoint{ seg.x1, seg.y1 };
+}
+
+PlotPoint PlotPlanner::getRunEnd(size_t ix, bool reversed) const
+{
+	return this->getRunStart(ix, !reversed);
+}
+
+void PlotPlanner::appendRun(size_t ix, bool reversed, PlotPath& path) const
+{
+	const Run& run = this->runs[ix];
+	// The first point coincides with the last one of the preceding run (if any)
+	if (path.points.empty()) {
+		path.points.push_back(this->getRunStart(ix, reversed));
+	}
+	if (reversed) {
+		for (size_t i = run.first + run.count; i-- > run.first; ) {
+			path.points.push_back(PlotPoint{ this->segments[i].x1, this->segments[i].y1 });
+		}
+	}
+	else {
+		for (size_t i = run.first; i < run.first + run.count; i++) {
+			path.points.push_back(PlotPoint{ this->segments[i].x2, this->segments[i].y2 });
+		}
+	}
+}
+
+void PlotPlanner::stitch(const std::vector<size_t>& runIxs, std::vector<Chain>& chains) const
+{
+	// End point index: key -> local run number * 2 + (0 = start, 1 = end)
+	std::unordered_map<uint64_t, std::vector<size_t>> ends;
+	ends.reserve(runIxs.size() * 2);
+	for (size_t k = 0; k < runIxs.size(); k++) {
+		PlotPoint start = this->getRunStart(runIxs[k], false);
+		PlotPoint end = this->getRunEnd(runIxs[k], false);
+		ends[this->getKey(start.x, start.y)].push_back(k * 2);
+		ends[this->getKey(end.x, end.y)].push_back(k * 2 + 1);
+	}
+	std::vector<bool> isUsed(runIxs.size(), false);
+	// Finds an unused run with an end at point pt, returns its entry or SIZE_MAX
+	auto find = [&](const PlotPoint& pt) -> size_t {
+		std::unordered_map<uint64_t, std::vector<size_t>>::iterator it = ends.find(this->getKey(pt.x, pt.y));
+		if (it == ends.end()) {
+			return SIZE_MAX;
+		}
+		// Entries of used runs are dropped on the way
+		std::vector<size_t>& entries = it->second;
+		while (!entries.empty() && isUsed[entries.back() / 2]) {
+			entries.pop_back();
+		}
+		return entries.empty() ? SIZE_MAX : entries.back();
+	};
+
+	std::vector<Step> backward;
+	for (size_t k0 = 0; k0 < runIxs.size(); k0++) {
+		if (isUsed[k0]) {
+			continue;
+		}
+		isUsed[k0] = true;
+		Chain chain;
+		chain.steps.push_back(Step{ runIxs[k0], false });
+		// Extend at the end: a run starting there is drawn forward, one ending there reversed
+		PlotPoint tail = this->getRunEnd(runIxs[k0], false);
+		for (size_t entry = find(tail); entry != SIZE_MAX; entry = find(tail)) {
+			size_t k = entry / 2;
+			bool reversed = (entry & 1) != 0;
+			isUsed[k] = true;
+			chain.steps.push_back(Step{ runIxs[k], reversed });
+			tail = this->getRunEnd(runIxs[k], reversed);
+		}
+		// Extend at the start: a run ending there is drawn forward, one starting there reversed
+		PlotPoint head = this->getRunStart(runIxs[k0], false);
+		backward.clear();
+		for (size_t entry = find(head); entry != SIZE_MAX; entry = find(head)) {
+			size_t k = entry / 2;
+			bool reversed = (entry & 1) == 0;
+			isUsed[k] = true;
+			backward.push_back(Step{ runIxs[k], reversed });
+			head = this->getRunStart(runIxs[k], reversed);
+		}
+		chain.steps.insert(chain.steps.begin(), backward.rbegin(), backward.rend());
+		chain.start = head;
+		chain.end = tail;
+		chains.push_back(std::move(chain));
+	}
+}
+
+void PlotPlanner::orderGreedy(const std::vector<Chain>& chains, const PlotPoint& pos, std::vector<Step>& tour)
+{
+	const size_t n = chains.size();
+	tour.clear();
+	if (n == 0) {
+		return;
+	}
+	// Uniform grid over the chain end points with about one chain per cell
+	SegmentBounds area = SegmentBounds::empty();
+	for (const Chain& chain : chains) {
+		area.include(chain.start.x, chain.start.y);
+		area.include(chain.end.x, chain.end.y);
+	}
+	const size_t nSide = (size_t)ceil(sqrt((double)n));
+	const double extent = (std::max)((double)area.right - area.left, (double)area.bottom - area.top);
+	const double cellSize = extent > 0 ? extent / nSide * (1 + 1e-9) : 1.0;
+	const size_t nCols = (size_t)(((double)area.right - area.left) / cellSize) + 1;
+	const size_t nRows = (size_t)(((double)area.bottom - area.top) / cellSize) + 1;
+	auto getCol = [&](float x) -> size_t {
+		double c = floor((x - area.left) / cellSize);
+		return c < 0 ? 0 : (c >= nCols ? nCols - 1 : (size_t)c);
+	};
+	auto getRow = [&](float y) -> size_t {
+		double r = floor((y - area.top) / cellSize);
+		return r < 0 ? 0 : (r >= nRows ? nRows - 1 : (size_t)r);
+	};
+	// Cell entries: chain number * 2 + (0 = start, 1 = end)
+	std::vector<std::vector<size_t>> cells(nCols * nRows);
+	for (size_t c = 0; c < n; c++) {
+		cells[getRow(chains[c].start.y) * nCols + getCol(chains[c].start.x)].push_back(c * 2);
+		cells[getRow(chains[c].end.y) * nCols + getCol(chains[c].end.x)].push_back(c * 2 + 1);
+	}
+	auto removeEntry = [&](const PlotPoint& pt, size_t entry) {
+		std::vector<size_t>& cell = cells[getRow(pt.y) * nCols + getCol(pt.x)];
+		std::vector<size_t>::iterator it = std::find(cell.begin(), cell.end(), entry);
+		*it = cell.back();
+		cell.pop_back();
+	};
+
+	PlotPoint cur = pos;
+	tour.reserve(n);
+	while (tour.size() < n) {
+		// Search the rings of cells around the current position until no closer point is possible
+		const size_t col0 = getCol(cur.x), row0 = getRow(cur.y);
+		size_t best = SIZE_MAX;
+		double bestDist = HUGE_VAL;
+		for (size_t r = 0; ; r++) {
+			if (best != SIZE_MAX && bestDist <= (r - 1.0) * cellSize) {
+				break;
+			}
+			if (r > nCols && r > nRows) {
+				break;
+			}
+			size_t rowFrom = row0 >= r ? row0 - r : 0, rowTo = (std::min)(nRows - 1, row0 + r);
+			size_t colFrom = col0 >= r ? col0 - r : 0, colTo = (std::min)(nCols - 1, col0 + r);
+			for (size_t row = rowFrom; row <= rowTo; row++) {
+				bool isEdgeRow = row + r == row0 || row == row0 + r;
+				for (size_t col = colFrom; col <= colTo; col++) {
+					// Only the cells on the ring itself are new
+					if (!isEdgeRow && col + r != col0 && col != col0 + r) {
+						continue;
+					}
+					for (size_t entry : cells[row * nCols + col]) {
+						const Chain& chain = chains[entry / 2];
+						double dist = distance(cur, (entry & 1) ? chain.end : chain.start);
+						if (dist < bestDist) {
+							bestDist = dist;
+							best = entry;
+						}
+					}
+				}
+			}
+		}
+		const Chain& chain = chains[best / 2];
+		removeEntry(chain.start, best & ~(size_t)1);
+		removeEntry(chain.end, best | 1);
+		// Reached at its end, the chain is drawn backwards
+		bool reversed = (best & 1) != 0;
+		tour.push_back(Step{ best / 2, reversed });
+		cur = reversed ? chain.start : chain.end;
+	}
+}
+
+void PlotPlanner::improveTwoOpt(const std::vector<Chain>& chains, const PlotPoint& pos, std::vector<Step>& tour)
+{
+	const size_t n = tour.size();
+	if (n < 2) {
+		return;
+	}
+	// Start and end points of the tour members in their current orientation
+	std::vector<PlotPoint> starts(n), ends(n);
+	for (size_t i = 0; i < n; i++) {
+		const Chain& chain = chains[tour[i].index];
+		starts[i] = tour[i].reversed ? chain.end : chain.start;
+		ends[i] = tour[i].reversed ? chain.start : chain.end;
+	}
+	for (unsigned int pass = 0; pass < TWO_OPT_PASSES; pass++) {
+		bool improved = false;
+		for (size_t i = 0; i < n; i++) {
+			const PlotPoint& before = i > 0 ? ends[i - 1] : pos;
+			size_t jMax = (std::min)(n - 1, i + TWO_OPT_WINDOW - 1);
+			for (size_t j = i; j <= jMax; j++) {
+				/* Reversing members i..j replaces the travel before -> start(i) and
+				 * end(j) -> start(j+1) by before -> end(j) and start(i) -> start(j+1) */
+				double oldDist = distance(before, starts[i]);
+				double newDist = distance(before, ends[j]);
+				if (j + 1 < n) {
+					oldDist += distance(ends[j], starts[j + 1]);
+					newDist += distance(starts[i], starts[j + 1]);
+				}
+				if (newDist < oldDist - 1e-6) {
+					std::reverse(tour.begin() + i, tour.begin() + j + 1);
+					std::reverse(starts.begin() + i, starts.begin() + j + 1);
+					std::reverse(ends.begin() + i, ends.begin() + j + 1);
+					for (size_t k = i; k <= j; k++) {
+						tour[k].reversed = !tour[k].reversed;
+						std::swap(starts[k], ends[k]);
+					}
+					improved = true;
+				}
+			}
+		}
+		if (!improved) {
+			break;
+		}
+	}
+}
+
+void PlotPlanner::plan(Ordering ordering)
+{
+	this->paths.clear();
+	if (ordering == ORDER_STORED) {
+		for (size_t ix = 0; ix < this->runs.size(); ix++) {
+			this->paths.push_back(PlotPath{ this->segments[this->runs[ix].first].argb, {} });
+			this->appendRun(ix, false, this->paths.back());
+		}
+		this->plannedStats = measure(this->paths);
+		return;
+	}
+
+	// Group the runs by colour, the colours in order of their first use
+	std::vector<uint32_t> colours;
+	std::unordered_map<uint32_t, std::vector<size_t>> runsByColour;
+	for (size_t ix = 0; ix < this->runs.size(); ix++) {
+		uint32_t argb = this->segments[this->runs[ix].first].argb;
+		std::vector<size_t>& group = runsByColour[argb];
+		if (group.empty()) {
+			colours.push_back(argb);
+		}
+		group.push_back(ix);
+	}
+
+	// The pen starts where the drawing started and moves on from colour to colour
+	PlotPoint pos = this->runs.empty() ? PlotPoint{ 0, 0 } : this->getRunStart(0, false);
+	std::vector<Chain> chains;
+	std::vector<Step> tour;
+	for (uint32_t argb : colours) {
+		chains.clear();
+		this->stitch(runsByColour[argb], chains);
+		orderGreedy(chains, pos, tour);
+		if (ordering == ORDER_TWO_OPT) {
+			improveTwoOpt(chains, pos, tour);
+		}
+		for (const Step& step : tour) {
+			const Chain& chain = chains[step.index];
+			this->paths.push_back(PlotPath{ argb, {} });
+			PlotPath& path = this->paths.back();
+			if (step.reversed) {
+				for (size_t k = chain.steps.size(); k-- > 0; ) {
+					this->appendRun(chain.steps[k].index, !chain.steps[k].reversed, path);
+				}
+				pos = chain.start;
+			}
+			else {
+				for (const Step& runStep : chain.steps) {
+					this->appendRun(runStep.index, runStep.reversed, path);
+				}
+				pos = chain.end;
+			}
+		}
+	}
+	this->plannedStats = measure(this->paths);
+}
+
+void PlotPlanner::simplify(Simplifier& simplifier, const ExportPipeline* pPipeline)
+{
+	// The paths are independent of each other, so blocks of them may be reduced concurrently
+	const size_t nBlocks = (this->paths.size() + SIMPLIFY_BLOCK - 1) / SIMPLIFY_BLOCK;
+	auto reduceBlock = [this, &simplifier](size_t ix, std::string&) {
+		size_t end = (std::min)(this->paths.size(), (ix + 1) * SIMPLIFY_BLOCK);
+		for (size_t k = ix * SIMPLIFY_BLOCK; k < end; k++) {
+			std::vector<PlotPoint>& points = this->paths[k].points;
+			// (The end points are kept, so a path remains a path)
+			size_t nKept = simplifier.reduce(points.data(), points.size());
+			simplifier.count(points.size() - 1, nKept - 1);
+			points.resize(nKept);
+		}
+	};
+	if (pPipeline != nullptr) {
+		pPipeline->run(nBlocks, reduceBlock, [](const char*, size_t) { return true; });
+	}
+	else {
+		std::string none;
+		for (size_t ix = 0; ix < nBlocks; ix++) {
+			reduceBlock(ix, none);
+		}
+	}
+	this->plannedStats = measure(this->paths);
+}
+
+PlotStats PlotPlanner::getStoredStats() const
+{
+	PlotStats stats = {};
+	stats.nPaths = this->runs.size();
+	for (size_t ix = 0; ix < this->runs.size(); ix++) {
+		const Run& run = this->runs[ix];
+		for (size_t i = run.first; i < run.first + run.count; i++) {
+			const Segment& seg = this->segments[i];
+			stats.drawLength += distance(PlotPoint{ seg.x1, seg.y1 }, PlotPoint{ seg.x2, seg.y2 });
+		}
+		stats.nSegments += run.count;
+		if (ix > 0) {
+			stats.travelLength += distance(this->getRunEnd(ix - 1, false), this->getRunStart(ix, false));
+			if (this->segments[run.first].argb != this->segments[this->runs[ix - 1].first].argb) {
+				stats.nPenChanges++;
+			}
+		}
+	}
+	return stats;
+}
+
+PlotStats PlotPlanner::measure(const std::vector<PlotPath>& paths)
+{
+	PlotStats stats = {};
+	stats.nPaths = paths.size();
+	for (size_t ix = 0; ix < paths.size(); ix++) {
+		const std::vector<PlotPoint>& points = paths[ix].points;
+		for (size_t i = 1; i < points.size(); i++) {
+			stats.drawLength += distance(points[i - 1], points[i]);
+		}
+		stats.nSegments += points.size() - 1;
+		if (ix > 0) {
+			stats.travelLength += distance(paths[ix - 1].points.back(), points.front());
+			if (paths[ix].argb != paths[ix - 1].argb) {
+				stats.nPenChanges++;
+			}
+		}
+	}
+	return stats;
+}
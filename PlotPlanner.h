@@ -0,0 +1,139 @@
+#pragma once
+#ifndef PLOTPLANNER_H
+#define PLOTPLANNER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Toolpath planning for pen plotters. The turtle elements are stored in the
+ * order they were drawn, which may make a plotter lift and move its pen all
+ * over the sheet. The planner
+ * 1. groups the segments by colour (one pen per colour, in order of first use),
+ * 2. stitches the segments of a colour into maximal continuous polylines,
+ *    joining them at coinciding end points (either direction),
+ * 3. orders the polylines of each colour by a nearest-neighbour tour (over a
+ *    grid index of the end points), optionally improved by 2-opt moves, which
+ *    reverse a run of polylines if that shortens the pen-up travel,
+ * 4. optionally reduces the vertices of the planned polylines by a Simplifier
+ *    (after the stitching, so the polylines are as long as possible).
+ * Statistics of the stored order (consecutive connected segments of the same
+ * colour drawn in one go) and of the planned order allow to judge the gain.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   New method simplify() (simplified vector export)
+ * 2026-10-18   Created for VERSION 11.1.0 (pen-plotter export)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SegmentStore.h"
+
+class ExportPipeline;
+class Simplifier;
+
+// A point of a plot path (turtle coordinates)
+struct PlotPoint {
+	float x, y;
+};
+
+// A continuous pen-down polyline in a single colour (at least two points)
+struct PlotPath {
+	uint32_t argb;					// Colour (0xAARRGGBB)
+	std::vector<PlotPoint> points;	// Vertices in drawing order
+};
+
+// Length and pen statistics of a sequence of plot paths
+struct PlotStats {
+	size_t nSegments;		// Number of drawn segments
+	size_t nPaths;			// Number of polylines (pen-down strokes)
+	size_t nPenChanges;		// Number of colour changes between consecutive paths
+	double drawLength;		// Pen-down distance (turtle units)
+	double travelLength;	// Pen-up distance between the paths (turtle units)
+};
+
+class PlotPlanner
+{
+public:
+	// Path ordering strategies
+	enum Ordering {
+		ORDER_STORED,		// Stored order, consecutive connected segments joined only
+		ORDER_GREEDY,		// Stitched polylines in nearest-neighbour order
+		ORDER_TWO_OPT		// Greedy order improved by 2-opt moves
+	};
+	static const size_t TWO_OPT_WINDOW = 256;		// Maximum length of a reversed run of paths
+	static const unsigned int TWO_OPT_PASSES = 8;	// Maximum number of improvement passes
+	static const size_t SIMPLIFY_BLOCK = 1024;		// Paths per work item of simplify()
+
+	/* Prepares a planner; end points closer than tolerance (turtle units, per
+	 * coordinate) are considered coinciding */
+	explicit PlotPlanner(float tolerance = 0.01f);
+
+	// Adds count segments (in drawing order)
+	void addSegments(const Segment* segs, size_t count);
+	// Adds the segments of the given chunks (in drawing order)
+	void addChunks(const std::vector<SegmentChunkView>& chunks);
+
+	// Computes the paths with the given ordering (may be called repeatedly)
+	void plan(Ordering ordering = ORDER_TWO_OPT);
+	/* Reduces the vertices of the paths computed by plan() via simplifier (blocks of
+	 * paths concurrently if a pipeline is given) and updates the planned statistics */
+	void simplify(Simplifier& simplifier, const ExportPipeline* pPipeline = nullptr);
+	// Returns the paths computed by plan()
+	inline const std::vector<PlotPath>& getPaths() const { return this->paths; }
+	// Returns the statistics of the segments in stored order
+	PlotStats getStoredStats() const;
+	// Returns the statistics of the paths computed by plan()
+	inline const PlotStats& getPlannedStats() const { return this->plannedStats; }
+	// Returns the bounds of all added segments
+	inline const SegmentBounds& getBounds() const { return this->bounds; }
+
+	// Computes the statistics of the given path sequence
+	static PlotStats measure(const std::vector<PlotPath>& paths);
+
+private:
+	// A run of consecutive connected segments of the same colour (in stored order)
+	struct Run {
+		size_t first;		// Index of the first segment
+		size_t count;		// Number of segments
+	};
+	// A run (or chain) oriented for drawing
+	struct Step {
+		size_t index;		// Index of the run (or chain)
+		bool reversed;		// Whether it is drawn from its last point to its first
+	};
+	// A polyline of runs (start and end point cached for the ordering)
+	struct Chain {
+		std::vector<Step> steps;
+		PlotPoint start, end;
+	};
+
+	const float tolerance;
+	std::vector<Segment> segments;	// Copies of all added segments
+	std::vector<Run> runs;			// Runs in stored order
+	SegmentBounds bounds;
+	std::vector<PlotPath> paths;	// Result of plan()
+	PlotStats plannedStats;
+
+	// Returns the grid key of point (x, y) (the cell of size tolerance it falls into)
+	uint64_t getKey(float x, float y) const;
+	// Returns the first or last point of run ix when drawn in the given direction
+	PlotPoint getRunStart(size_t ix, bool reversed) const;
+	PlotPoint getRunEnd(size_t ix, bool reversed) const;
+	// Joins the given runs (of a single colour) into maximal chains
+	void stitch(const std::vector<size_t>& runIxs, std::vector<Chain>& chains) const;
+	// Orders the chains by nearest-neighbour search starting at position pos into tour
+	static void orderGreedy(const std::vector<Chain>& chains, const PlotPoint& pos, std::vector<Step>& tour);
+	// Improves the tour of the chains (drawn from position pos) by 2-opt moves
+	static void improveTwoOpt(const std::vector<Chain>& chains, const PlotPoint& pos, std::vector<Step>& tour);
+	// Appends the points of run ix in the given direction to path (skipping a joint point)
+	void appendRun(size_t ix, bool reversed, PlotPath& path) const;
+};
+
+#endif /*PLOTPLANNER_H*/
@@ -0,0 +1,416 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Emitter of HPGL and G-code plotter programs and a plotter simulator for
+ * their verification, see PlotterWriter.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (pen-plotter export)
+ */
+
+#include "PlotterWriter.h"
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+const double PlotterWriter::DEFAULT_MM_PER_UNIT = 0.25;
+const double PlotterWriter::GCODE_PEN_UP_Z = 5.0;
+const double PlotterWriter::GCODE_PEN_DOWN_Z = 0.0;
+
+PlotterWriter::PlotterWriter(std::ostream& out, Dialect dialect, const SegmentBounds& bounds,
+	double mmPerUnit)
+	: out(out)
+	, dialect(dialect)
+	, originX(bounds.isEmpty() ? 0.0 : bounds.left)
+	, originY(bounds.isEmpty() ? 0.0 : bounds.bottom)
+	, mmPerUnit(mmPerUnit)
+	, buffer(BUFFER_SIZE)
+	, nPens(0)
+	, penColour(0)
+{
+	this->pos = this->buffer.data();
+	this->limit = this->buffer.data() + BUFFER_SIZE - MAX_LINE_SIZE;
+}
+
+PlotterWriter::~PlotterWriter()
+{
+	this->flush();
+}
+
+bool PlotterWriter::flush()
+{
+	if (this->pos > this->buffer.data()) {
+		this->out.write(this->buffer.data(), this->pos - this->buffer.data());
+		this->pos = this->buffer.data();
+	}
+	return this->out.good();
+}
+
+void PlotterWriter::put(const char* text)
+{
+	size_t length = strlen(text);
+	memcpy(this->pos, text, length);
+	this->pos += length;
+}
+
+void PlotterWriter::put(long long value)
+{
+	this->pos = std::to_chars(this->pos, this->pos + 24, value).ptr;
+}
+
+void PlotterWriter::putMM(double value)
+{
+	// Micrometres, formatted by integer arithmetic
+	long long microns = llround(value * 1000);
+	if (microns < 0) {
+		*this->pos++ = '-';
+		microns = -microns;
+	}
+	this->put(microns / 1000);
+	*this->pos++ = '.';
+	int frac = (int)(microns % 1000);
+	*this->pos++ = (char)('0' + frac / 100);
+	*this->pos++ = (char)('0' + frac / 10 % 10);
+	*this->pos++ = (char)('0' + frac % 10);
+}
+
+void PlotterWriter::map(const PlotPoint& point, double& x, double& y) const
+{
+	// Turtle y coordinates grow downwards, plotter y coordinates upwards
+	double factor = this->mmPerUnit;
+	if (this->dialect == HPGL) {
+		factor *= HPGL_UNITS_PER_MM;
+	}
+	x = (point.x - this->originX) * factor;
+	y = (this->originY - point.y) * factor;
+}
+
+void PlotterWriter::writeHeader()
+{
+	if (this->dialect == HPGL) {
+		this->put("IN;\n");
+	}
+	else {
+		this->put("; Turtleizer drawing\nG21\nG90\nG0 Z");
+		this->putMM(GCODE_PEN_UP_Z);
+		*this->pos++ = '\n';
+	}
+}
+
+void PlotterWriter::selectPen(uint32_t argb)
+{
+	if (this->nPens > 0 && argb == this->penColour) {
+		return;
+	}
+	this->nPens++;
+	this->penColour = argb;
+	if (this->dialect == HPGL) {
+		// Colours beyond the pen count reuse the pens cyclically
+		this->put("PU;SP");
+		this->put((long long)((this->nPens - 1) % HPGL_PENS + 1));
+		this->put(";\n");
+	}
+	else {
+		// The operator mounts the pen while the machine pauses
+		static const char HEX_DIGITS[] = "0123456789ABCDEF";
+		this->put("M0 ; pen ");
+		this->put((long long)this->nPens);
+		this->put(": #");
+		for (int shift = 20; shift >= 0; shift -= 4) {
+			*this->pos++ = HEX_DIGITS[(argb >> shift) & 0xF];
+		}
+		*this->pos++ = '\n';
+	}
+}
+
+void PlotterWriter::writePath(const PlotPath& path)
+{
+	if (path.points.empty()) {
+		return;
+	}
+	double x, y;
+	this->map(path.points[0], x, y);
+	if (this->dialect == HPGL) {
+		long long lastX = llround(x), lastY = llround(y);
+		this->put("PU");
+		this->put(lastX);
+		*this->pos++ = ',';
+		this->put(lastY);
+		this->put(";\nPD");
+		// Points falling onto the same plotter unit are dropped (but a dot is drawn)
+		size_t nPoints = 0;
+		for (size_t i = 1; i < path.points.size(); i++) {
+			this->map(path.points[i], x, y);
+			long long ix = llround(x), iy = llround(y);
+			if (ix == lastX && iy == lastY && (nPoints > 0 || i + 1 < path.points.size())) {
+				continue;
+			}
+			if (nPoints == HPGL_POINTS_PER_PD) {
+				this->put(";\nPD");
+				nPoints = 0;
+			}
+			else if (nPoints > 0) {
+				*this->pos++ = ',';
+			}
+			this->put(ix);
+			*this->pos++ = ',';
+			this->put(iy);
+			nPoints++;
+			lastX = ix;
+			lastY = iy;
+			if (this->pos >= this->limit) {
+				this->flush();
+			}
+		}
+		this->put(";\n");
+	}
+	else {
+		long long lastX = llround(x * 1000), lastY = llround(y * 1000);
+		this->put("G0 X");
+		this->putMM(x);
+		this->put(" Y");
+		this->putMM(y);
+		this->put("\nG1 Z");
+		this->putMM(GCODE_PEN_DOWN_Z);
+		this->put(" F");
+		this->put((long long)GCODE_FEED_RATE);
+		*this->pos++ = '\n';
+		for (size_t i = 1; i < path.points.size(); i++) {
+			this->map(path.points[i], x, y);
+			long long mx = llround(x * 1000), my = llround(y * 1000);
+			if (mx == lastX && my == lastY) {
+				continue;
+			}
+			this->put("G1 X");
+			this->putMM(x);
+			this->put(" Y");
+			this->putMM(y);
+			*this->pos++ = '\n';
+			lastX = mx;
+			lastY = my;
+			if (this->pos >= this->limit) {
+				this->flush();
+			}
+		}
+		this->put("G0 Z");
+		this->putMM(GCODE_PEN_UP_Z);
+		*this->pos++ = '\n';
+	}
+	if (this->pos >= this->limit) {
+		this->flush();
+	}
+}
+
+void PlotterWriter::writePaths(const std::vector<PlotPath>& paths)
+{
+	for (const PlotPath& path : paths) {
+		this->selectPen(path.argb);
+		this->writePath(path);
+	}
+}
+
+bool PlotterWriter::finish()
+{
+	if (this->dialect == HPGL) {
+		this->put("PU0,0;\nSP0;\n");
+	}
+	else {
+		this->put("G0 Z");
+		this->putMM(GCODE_PEN_UP_Z);
+		this->put("\nG0 X0.000 Y0.000\nM2\n");
+	}
+	return this->flush();
+}
+
+PlotterSimulator::PlotterSimulator(PlotterWriter::Dialect dialect)
+	: dialect(dialect)
+	, x(0.0)
+	, y(0.0)
+	, isDown(false)
+	, nPens(0)
+	, drawLength(0.0)
+	, travelLength(0.0)
+	, pendingTravel(0.0)
+	, nStrokes(0)
+	, nMoves(0)
+{
+}
+
+void PlotterSimulator::moveTo(double newX, double newY)
+{
+	double dist = sqrt((newX - this->x) * (newX - this->x) + (newY - this->y) * (newY - this->y));
+	if (this->isDown) {
+		this->drawLength += dist;
+		this->nMoves++;
+	}
+	else {
+		this->pendingTravel += dist;
+	}
+	this->x = newX;
+	this->y = newY;
+}
+
+void PlotterSimulator::setPen(bool down)
+{
+	if (down && !this->isDown) {
+		// Only the travel between strokes counts (not the way from and back to the origin)
+		if (this->nStrokes > 0) {
+			this->travelLength += this->pendingTravel;
+		}
+		this->pendingTravel = 0.0;
+		this->nStrokes++;
+	}
+	this->isDown = down;
+}
+
+bool PlotterSimulator::runHPGL(const char* mnemonic, const std::vector<double>& args)
+{
+	const double mmPerUnit = 1.0 / PlotterWriter::HPGL_UNITS_PER_MM;
+	if (strcmp(mnemonic, "IN") == 0) {
+		this->setPen(false);
+		return args.empty();
+	}
+	if (strcmp(mnemonic, "SP") == 0) {
+		if (args.size() > 1) {
+			return false;
+		}
+		this->setPen(false);
+		if (!args.empty() && args[0] != 0) {
+			this->nPens++;
+		}
+		return true;
+	}
+	if (strcmp(mnemonic, "PU") == 0 || strcmp(mnemonic, "PD") == 0 || strcmp(mnemonic, "PA") == 0) {
+		if (args.size() % 2 != 0) {
+			return false;
+		}
+		if (mnemonic[0] == 'P' && mnemonic[1] != 'A') {
+			this->setPen(mnemonic[1] == 'D');
+		}
+		for (size_t i = 0; i < args.size(); i += 2) {
+			this->moveTo(args[i] * mmPerUnit, args[i + 1] * mmPerUnit);
+		}
+		return true;
+	}
+	return false;
+}
+
+bool PlotterSimulator::runGCode(const char* line, size_t length)
+{
+	int g = -1, m = -1;
+	double newX = this->x, newY = this->y;
+	bool hasXY = false, hasZ = false;
+	double z = 0.0;
+	size_t i = 0;
+	while (i < length) {
+		char letter = line[i];
+		if (letter == ';') {
+			break;		// Comment up to the end of the line
+		}
+		if (letter == ' ' || letter == '\t' || letter == '\r') {
+			i++;
+			continue;
+		}
+		char* pEnd = nullptr;
+		std::string number(line + i + 1, line + length);
+		double value = strtod(number.c_str(), &pEnd);
+		if (pEnd == number.c_str()) {
+			return false;
+		}
+		i += 1 + (pEnd - number.c_str());
+		switch (letter) {
+		case 'G': g = (int)value; break;
+		case 'M': m = (int)value; break;
+		case 'X': newX = value; hasXY = true; break;
+		case 'Y': newY = value; hasXY = true; break;
+		case 'Z': z = value; hasZ = true; break;
+		case 'F': break;
+		default: return false;
+		}
+	}
+	if (m == 0) {
+		this->setPen(false);
+		this->nPens++;
+	}
+	else if (m >= 0 && m != 2) {
+		return false;
+	}
+	if (g == 0 || g == 1) {
+		if (hasZ) {
+			this->setPen(z < (PlotterWriter::GCODE_PEN_UP_Z + PlotterWriter::GCODE_PEN_DOWN_Z) / 2);
+		}
+		if (hasXY) {
+			this->moveTo(newX, newY);
+		}
+	}
+	else if (g >= 0 && g != 21 && g != 90) {
+		return false;
+	}
+	return true;
+}
+
+bool PlotterSimulator::run(const char* text, size_t length)
+{
+	const char* end = text + length;
+	if (this->dialect == PlotterWriter::GCODE) {
+		while (text < end) {
+			const char* eol = static_cast<const char*>(memchr(text, '\n', end - text));
+			if (eol == nullptr) {
+				eol = end;
+			}
+			if (!this->runGCode(text, eol - text)) {
+				return false;
+			}
+			text = eol + 1;
+		}
+		return true;
+	}
+	// HPGL: two-letter mnemonics with comma-separated arguments, terminated by ';'
+	std::vector<double> args;
+	while (text < end) {
+		while (text < end && isspace((unsigned char)*text)) {
+			text++;
+		}
+		if (text == end) {
+			break;
+		}
+		if (end - text < 2 || !isalpha((unsigned char)text[0]) || !isalpha((unsigned char)text[1])) {
+			return false;
+		}
+		char mnemonic[3] = { text[0], text[1], '\0' };
+		text += 2;
+		const char* semi = static_cast<const char*>(memchr(text, ';', end - text));
+		if (semi == nullptr) {
+			semi = end;
+		}
+		args.clear();
+		std::string params(text, semi);
+		const char* pParam = params.c_str();
+		while (*pParam != '\0') {
+			char* pEnd = nullptr;
+			args.push_back(strtod(pParam, &pEnd));
+			if (pEnd == pParam) {
+				return false;
+			}
+			pParam = pEnd;
+			if (*pParam == ',') {
+				pParam++;
+			}
+			else if (*pParam != '\0') {
+				return false;
+			}
+		}
+		if (!this->runHPGL(mnemonic, args)) {
+			return false;
+		}
+		text = semi + (semi < end ? 1 : 0);
+	}
+	return true;
+}
@@ -0,0 +1,135 @@
+#pragma once
+#ifndef PLOTTERWRITER_H
+#define PLOTTERWRITER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Block-buffered emitter of plot paths (see PlotPlanner) as pen-plotter
+ * programs, either in HPGL (plotter units of 0.025 mm, one pen per colour
+ * via SP) or in G-code (millimetres, pen lifted and lowered along Z, a pause
+ * M0 for every pen change). The drawing is placed with the left bottom
+ * corner of its bounds at the plotter origin, the y axis pointing up.
+ * The PlotterSimulator runs such a program (as written here) on a virtual
+ * plotter and measures the pen-down and pen-up distances, so the planned
+ * toolpath can be verified without a plotter.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (pen-plotter export)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "PlotPlanner.h"
+
+class PlotterWriter
+{
+public:
+	// Plotter languages
+	enum Dialect {
+		HPGL,
+		GCODE
+	};
+	static const size_t BUFFER_SIZE = 1 << 20;		// Size of the output buffer
+	static const int HPGL_UNITS_PER_MM = 40;		// HPGL plotter units per millimetre
+	static const unsigned int HPGL_PENS = 8;		// Number of pens assumed for HPGL
+	static const size_t HPGL_POINTS_PER_PD = 32;	// Maximum number of points per PD instruction
+	static const double DEFAULT_MM_PER_UNIT;		// Default scale (millimetres per turtle unit)
+	static const double GCODE_PEN_UP_Z;				// Z position of the lifted pen (mm)
+	static const double GCODE_PEN_DOWN_Z;			// Z position of the lowered pen (mm)
+	static const int GCODE_FEED_RATE = 3000;		// Drawing speed (mm/min)
+
+	/* Prepares the emission to the stream out in the given dialect, mapping the
+	 * drawing area bounds (turtle coordinates) with mmPerUnit millimetres per unit */
+	PlotterWriter(std::ostream& out, Dialect dialect, const SegmentBounds& bounds,
+		double mmPerUnit = DEFAULT_MM_PER_UNIT);
+	// Flushes the buffer
+	~PlotterWriter();
+
+	// Writes the initialisation
+	void writeHeader();
+	// Writes the given paths (a pen change precedes every change of colour)
+	void writePaths(const std::vector<PlotPath>& paths);
+	// Lifts the pen, returns home, and flushes, returns false if the stream failed
+	bool finish();
+	// Passes the buffered text to the stream, returns false if the stream failed
+	bool flush();
+
+private:
+	static const size_t MAX_LINE_SIZE = 128;	// Upper bound for the length of an instruction
+
+	std::ostream& out;
+	const Dialect dialect;
+	const double originX, originY;	// Turtle coordinates of the plotter origin
+	const double mmPerUnit;
+	std::vector<char> buffer;
+	char* pos;						// Current write position in buffer
+	char* limit;					// Flush threshold (leaves MAX_LINE_SIZE bytes)
+	unsigned int nPens;				// Number of pens selected so far
+	uint32_t penColour;				// Colour of the current pen
+
+	// Appends the text (without terminating zero)
+	void put(const char* text);
+	// Appends the integer value
+	void put(long long value);
+	// Appends the value in millimetres with 3 decimals
+	void putMM(double value);
+	// Converts point into plotter coordinates (HPGL units or millimetres, y up)
+	void map(const PlotPoint& point, double& x, double& y) const;
+	// Switches to the pen for colour argb
+	void selectPen(uint32_t argb);
+	// Writes a single path
+	void writePath(const PlotPath& path);
+
+	PlotterWriter(const PlotterWriter&) = delete;
+	PlotterWriter& operator=(const PlotterWriter&) = delete;
+};
+
+class PlotterSimulator
+{
+public:
+	// Prepares a virtual plotter for programs of the given dialect
+	explicit PlotterSimulator(PlotterWriter::Dialect dialect);
+
+	/* Executes the program text (as produced by a PlotterWriter), returns false on
+	 * an unknown or malformed instruction */
+	bool run(const char* text, size_t length);
+	// Returns the pen-down distance (mm)
+	inline double getDrawLength() const { return this->drawLength; }
+	// Returns the pen-up distance between the strokes (mm), not counting the moves from and to the origin
+	inline double getTravelLength() const { return this->travelLength; }
+	// Returns the number of pen-down strokes
+	inline size_t getStrokeCount() const { return this->nStrokes; }
+	// Returns the number of pen changes (not counting the first pen)
+	inline size_t getPenChangeCount() const { return this->nPens > 0 ? this->nPens - 1 : 0; }
+	// Returns the number of pen-down moves
+	inline size_t getMoveCount() const { return this->nMoves; }
+
+private:
+	const PlotterWriter::Dialect dialect;
+	double x, y;				// Current position (mm)
+	bool isDown;				// Pen state
+	size_t nPens;				// Number of pen selections so far
+	double drawLength, travelLength;
+	double pendingTravel;		// Pen-up distance since the last stroke
+	size_t nStrokes, nMoves;
+
+	// Moves the pen to (newX, newY) in mm
+	void moveTo(double newX, double newY);
+	// Lowers or lifts the pen
+	void setPen(bool down);
+	// Executes a single HPGL instruction (mnemonic and arguments)
+	bool runHPGL(const char* mnemonic, const std::vector<double>& args);
+	// Executes a single G-code line
+	bool runGCode(const char* line, size_t length);
+};
+
+#endif /*PLOTTERWRITER_H*/
@@ -0,0 +1,667 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Row-streaming PNG encoder.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Parallel compression via an ExportPipeline, SSE2 filter selection
+ * 2026-10-18   Indexed-colour output (PngPalette, colour type PALETTE)
+ * 2026-10-18   Created for VERSION 11.1.0 (streaming PNG export)
+ */
+
+#include "PngEncoder.h"
+#include "ExportPipeline.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// SSE2 is part of every x64 target (define PNG_NO_SIMD to use the scalar code only)
+#if !defined(PNG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PNG_SSE2 1
+#endif
+
+namespace {
+	const int N_FILTERS = 5;	// None, Sub, Up, Average, Paeth
+
+	inline unsigned char paeth(int a, int b, int c)
+	{
+		int p = a + b - c;
+		int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+		if (pa <= pb && pa <= pc) {
+			return (unsigned char)a;
+		}
+		return (unsigned char)((pb <= pc) ? b : c);
+	}
+
+	// Magnitude of a filtered byte interpreted as signed value (filter heuristic)
+	inline unsigned int magnitude(unsigned char value)
+	{
+		return (value < 128) ? value : 256 - value;
+	}
+
+#if PNG_SSE2
+	inline __m128i abs16(__m128i x)
+	{
+		return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+	}
+
+	// Returns x where mask is set, otherwise y
+	inline __m128i select(__m128i mask, __m128i x, __m128i y)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, x), _mm_andnot_si128(mask, y));
+	}
+
+	// Paeth predictors for 8 samples in 16-bit lanes (see paeth())
+	inline __m128i paeth16(__m128i a, __m128i b, __m128i c)
+	{
+		__m128i bc = _mm_sub_epi16(b, c);
+		__m128i ac = _mm_sub_epi16(a, c);
+		__m128i pa = abs16(bc);
+		__m128i pb = abs16(ac);
+		__m128i pc = abs16(_mm_add_epi16(bc, ac));
+		__m128i notA = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+		return select(notA, select(_mm_cmpgt_epi16(pb, pc), c, b), a);
+	}
+
+	// Applies filter type f to the bytes of row from i on in blocks of 16 (advancing i),
+	// returns the sum of the magnitudes
+	unsigned long long filterSSE2(int f, const unsigned char* row, const unsigned char* up,
+		size_t bpp, size_t n, unsigned char* dest, size_t& i)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi8(1);
+		__m128i acc = zero;
+		for (; i + 16 <= n; i += 16) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+			__m128i v = x;
+			if (f != 0) {
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i - bpp));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i));
+				switch (f) {
+				case 1:
+					v = _mm_sub_epi8(x, a);
+					break;
+				case 2:
+					v = _mm_sub_epi8(x, b);
+					break;
+				case 3:
+					// _mm_avg_epu8 rounds up, the PNG average rounds down
+					v = _mm_sub_epi8(x, _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one)));
+					break;
+				default:
+				{
+					__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i - bpp));
+					__m128i lo = paeth16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero));
+					__m128i hi = paeth16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(c, zero));
+					v = _mm_sub_epi8(x, _mm_packus_epi16(lo, hi));
+				}
+				}
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), v);
+			// min(v, -v) is the magnitude of v as signed byte
+			acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_min_epu8(v, _mm_sub_epi8(zero, v)), zero));
+		}
+		uint64_t sums[2];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(sums), acc);
+		return sums[0] + sums[1];
+	}
+#endif /*PNG_SSE2*/
+
+	// Applies filter type f to the n bytes of row (with the previous row up and bpp bytes
+	// per pixel) into dest, returns the sum of the magnitudes of the filtered bytes
+	unsigned long long filterRow(int f, const unsigned char* row, const unsigned char* up,
+		size_t bpp, size_t n, unsigned char* dest)
+	{
+		unsigned long long sum = 0;
+		size_t i = 0;
+		// The first pixel has no left neighbours (a = c = 0)
+		for (; i < bpp && i < n; i++) {
+			unsigned char value = row[i];
+			switch (f) {
+			case 2: case 4: value -= up[i]; break;
+			case 3: value -= up[i] >> 1; break;
+			}
+			dest[i] = value;
+			sum += magnitude(value);
+		}
+#if PNG_SSE2
+		sum += filterSSE2(f, row, up, bpp, n, dest, i);
+#endif
+		switch (f) {
+		case 0:
+			for (; i < n; i++) {
+				sum += magnitude(dest[i] = row[i]);
+			}
+			break;
+		case 1:
+			for (; i < n; i++) {
+				sum += magnitude(dest[i] = (unsigned char)(row[i] - row[i - bpp]));
+			}
+			break;
+		case 2:
+			for (; i < n; i++) {
+				sum += magnitude(dest[i] = (unsigned char)(row[i] - up[i]));
+			}
+			break;
+		case 3:
+			for (; i < n; i++) {
+				sum += magnitude(dest[i] = (unsigned char)(row[i] - ((row[i - bpp] + up[i]) >> 1)));
+			}
+			break;
+		default:
+			for (; i < n; i++) {
+				sum += magnitude(dest[i] = (unsigned char)(row[i] - paeth(row[i - bpp], up[i], up[i - bpp])));
+			}
+		}
+		return sum;
+	}
+
+	inline void putUInt32(unsigned char* dest, uint32_t value)
+	{
+		dest[0] = (unsigned char)(value >> 24);
+		dest[1] = (unsigned char)(value >> 16);
+		dest[2] = (unsigned char)(value >> 8);
+		dest[3] = (unsigned char)value;
+	}
+
+	// Writes a chunk with the given type and data to out
+	void writePngChunk(std::ostream& out, const char* type, const unsigned char* data, size_t length)
+	{
+		unsigned char buf[8];
+		putUInt32(buf, (uint32_t)length);
+		for (int i = 0; i < 4; i++) {
+			buf[4 + i] = (unsigned char)type[i];
+		}
+		out.write(reinterpret_cast<const char*>(buf), 8);
+		if (length > 0) {
+			out.write(reinterpret_cast<const char*>(data), length);
+		}
+		uint32_t crc = Deflater::crc32(0, buf + 4, 4);
+		crc = Deflater::crc32(crc, data, length);
+		putUInt32(buf, crc);
+		out.write(reinterpret_cast<const char*>(buf), 4);
+	}
+
+	/* Filters row (n bytes, predecessor up) with each of the first nFilters filter
+	 * types into filtered (n + 1 bytes per type, led by the type byte), returns the
+	 * filtered row with the least sum of absolute differences */
+	const unsigned char* chooseFilter(const unsigned char* row, const unsigned char* up, size_t bpp,
+		size_t n, int nFilters, unsigned char* filtered)
+	{
+		int bestFilter = 0;
+		unsigned long long bestSum = ~0ull;
+		for (int f = 0; f < nFilters; f++) {
+			unsigned char* dest = filtered + f * (n + 1);
+			dest[0] = (unsigned char)f;
+			unsigned long long sum = filterRow(f, row, up, bpp, n, dest + 1);
+			if (sum < bestSum) {
+				bestSum = sum;
+				bestFilter = f;
+			}
+		}
+		return filtered + bestFilter * (n + 1);
+	}
+
+	// Hash slot of a colour in the palette lookup table (with size 1 << bits)
+	inline size_t colourSlot(uint32_t argb, int bits)
+	{
+		return (size_t)((argb * 0x9E3779B1u) >> (32 - bits));
+	}
+	const int HASH_BITS = 10;
+}
+
+/*======== PngPalette ========*/
+
+PngPalette::PngPalette()
+{
+	static_assert(HASH_SIZE == (size_t)1 << HASH_BITS, "HASH_BITS doesn't match HASH_SIZE");
+	this->colours.reserve(MAX_COLOURS);
+	this->clear();
+}
+
+void PngPalette::clear()
+{
+	this->colours.clear();
+	memset(this->slots, -1, sizeof(this->slots));
+	this->lastColour = 0;
+	this->lastIndex = -1;
+}
+
+int PngPalette::indexOf(uint32_t argb)
+{
+	if (argb == this->lastColour && this->lastIndex >= 0) {
+		return this->lastIndex;
+	}
+	size_t slot = colourSlot(argb, HASH_BITS);
+	// The table is at most a quarter full, so the probing sequences are short
+	while (this->slots[slot] >= 0) {
+		if (this->keys[slot] == argb) {
+			this->lastColour = argb;
+			return this->lastIndex = this->slots[slot];
+		}
+		slot = (slot + 1) & (HASH_SIZE - 1);
+	}
+	if (this->colours.size() >= MAX_COLOURS) {
+		return -1;
+	}
+	this->keys[slot] = argb;
+	this->slots[slot] = (int16_t)this->colours.size();
+	this->colours.push_back(argb);
+	this->lastColour = argb;
+	return this->lastIndex = this->slots[slot];
+}
+
+bool PngPalette::indexPixels(const uint32_t* pixels, size_t count, unsigned char* indices, uint32_t orMask)
+{
+	for (size_t i = 0; i < count; i++) {
+		int ix = this->indexOf(pixels[i] | orMask);
+		if (ix < 0) {
+			return false;
+		}
+		indices[i] = (unsigned char)ix;
+	}
+	return true;
+}
+
+int PngPalette::getBitDepth() const
+{
+	size_t n = this->colours.size();
+	return (n <= 2) ? 1 : (n <= 4) ? 2 : (n <= 16) ? 4 : 8;
+}
+
+bool PngPalette::hasTransparency() const
+{
+	for (uint32_t argb : this->colours) {
+		if ((argb >> 24) != 0xFF) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*======== PngWriter ========*/
+
+PngWriter::PngWriter(std::ostream& out, uint32_t width, uint32_t height,
+	ColourType colourType, int bitDepth, int level, const ExportPipeline* pPipeline)
+	: out(out)
+	, width(width)
+	, height(height)
+	, colourType(colourType)
+	, bitDepth(bitDepth)
+	, level(level)
+	, bytesPerPixel(colourType == GREY || colourType == PALETTE ? 1 : colourType == GREY_ALPHA ? 2 : colourType == RGB ? 3 : 4)
+	, inputSize(width * bytesPerPixel)
+	, rowSize(((size_t)width * bytesPerPixel * bitDepth + 7) / 8)
+	, nRows(0)
+	, prevRow(colourType == PALETTE ? 0 : rowSize, 0)
+	, filtered((colourType == PALETTE ? 1 : N_FILTERS) * (rowSize + 1))
+	, deflater(*this, level, Deflater::ZLIB)
+	, finished(false)
+	, pPipeline((pPipeline != nullptr && pPipeline->getThreadCount() > 1) ? pPipeline : nullptr)
+	, nJobs(0)
+	, adler(1)
+	, zlibStarted(false)
+{
+	this->idat.reserve(IDAT_SIZE);
+	if (this->pPipeline != nullptr) {
+		// One batch keeps all buffer slots of the pipeline busy
+		this->jobs.resize((size_t)this->pPipeline->getThreadCount() * ExportPipeline::SLOTS_PER_THREAD);
+		for (std::vector<unsigned char>& job : this->jobs) {
+			job.reserve(JOB_SIZE + this->rowSize + 1);
+		}
+	}
+}
+
+PngWriter::PngWriter(std::ostream& out, uint32_t width, uint32_t height, ColourType colourType, int level,
+	const ExportPipeline* pPipeline)
+	: PngWriter(out, width, height, colourType, 8, level, pPipeline)
+{
+	this->writeHeader();
+}
+
+PngWriter::PngWriter(std::ostream& out, uint32_t width, uint32_t height, const PngPalette& palette, int level,
+	const ExportPipeline* pPipeline)
+	: PngWriter(out, width, height, PALETTE, palette.getBitDepth(), level, pPipeline)
+{
+	this->writeHeader();
+	this->writePalette(palette);
+}
+
+PngWriter::~PngWriter()
+{
+}
+
+void PngWriter::writeHeader()
+{
+	static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	this->out.write(reinterpret_cast<const char*>(SIGNATURE), sizeof(SIGNATURE));
+	unsigned char ihdr[13];
+	putUInt32(ihdr, this->width);
+	putUInt32(ihdr + 4, this->height);
+	ihdr[8] = (unsigned char)this->bitDepth;
+	ihdr[9] = (unsigned char)this->colourType;
+	ihdr[10] = 0;	// deflate
+	ihdr[11] = 0;	// adaptive filtering
+	ihdr[12] = 0;	// no interlace
+	this->writeChunk("IHDR", ihdr, sizeof(ihdr));
+}
+
+void PngWriter::writePalette(const PngPalette& palette)
+{
+	const std::vector<uint32_t>& colours = palette.getColours();
+	unsigned char plte[3 * PngPalette::MAX_COLOURS] = {};
+	unsigned char trns[PngPalette::MAX_COLOURS] = {};
+	size_t nTrns = 0;
+	for (size_t i = 0; i < colours.size(); i++) {
+		uint32_t argb = colours[i];
+		plte[3 * i] = (unsigned char)(argb >> 16);
+		plte[3 * i + 1] = (unsigned char)(argb >> 8);
+		plte[3 * i + 2] = (unsigned char)argb;
+		trns[i] = (unsigned char)(argb >> 24);
+		// Trailing opaque entries may be omitted from the tRNS chunk
+		if (trns[i] != 0xFF) {
+			nTrns = i + 1;
+		}
+	}
+	this->writeChunk("PLTE", plte, 3 * colours.size());
+	if (nTrns > 0) {
+		this->writeChunk("tRNS", trns, nTrns);
+	}
+}
+
+void PngWriter::packIndices(const unsigned char* row)
+{
+	unsigned char* dest = &this->filtered[1];
+	if (this->bitDepth == 8) {
+		memcpy(dest, row, this->width);
+		return;
+	}
+	const int depth = this->bitDepth;
+	const int perByte = 8 / depth;
+	const unsigned char mask = (unsigned char)((1 << depth) - 1);
+	memset(dest, 0, this->rowSize);
+	// Pixels are packed from the most significant bits on
+	for (uint32_t x = 0; x < this->width; x++) {
+		int shift = 8 - depth * (int)(x % perByte + 1);
+		dest[x / perByte] |= (unsigned char)((row[x] & mask) << shift);
+	}
+}
+
+void PngWriter::writeChunk(const char* type, const unsigned char* data, size_t length)
+{
+	writePngChunk(this->out, type, data, length);
+}
+
+void PngWriter::put(const unsigned char* data, size_t length)
+{
+	while (length > 0) {
+		size_t n = IDAT_SIZE - this->idat.size();
+		if (n > length) {
+			n = length;
+		}
+		this->idat.insert(this->idat.end(), data, data + n);
+		data += n;
+		length -= n;
+		if (this->idat.size() >= IDAT_SIZE) {
+			this->writeChunk("IDAT", this->idat.data(), this->idat.size());
+			this->idat.clear();
+		}
+	}
+}
+
+bool PngWriter::writeRow(const unsigned char* row)
+{
+	if (this->finished || this->nRows >= this->height) {
+		return false;
+	}
+	if (this->colourType == PALETTE) {
+		this->filtered[0] = 0;	// no filter
+		this->packIndices(row);
+		this->compress(this->filtered.data(), this->rowSize + 1);
+		this->nRows++;
+		return this->out.good();
+	}
+	const size_t n = this->rowSize;
+	int nFilters = (this->level == 0) ? 1 : N_FILTERS;
+	this->compress(chooseFilter(row, this->prevRow.data(), this->bytesPerPixel, n, nFilters,
+		this->filtered.data()), n + 1);
+	this->prevRow.assign(row, row + n);
+	this->nRows++;
+	return this->out.good();
+}
+
+bool PngWriter::finish()
+{
+	if (!this->finished) {
+		std::vector<unsigned char> empty(this->inputSize, 0);
+		while (this->nRows < this->height) {
+			this->writeRow(empty.data());
+		}
+		if (this->pPipeline != nullptr) {
+			if (!this->jobs[this->nJobs].empty()) {
+				this->nJobs++;
+			}
+			this->compressJobs(this->nJobs);
+			// Final (empty) stored block and the checksum of the zlib stream
+			unsigned char trailer[9] = { 0x01, 0x00, 0x00, 0xFF, 0xFF };
+			putUInt32(trailer + 5, this->adler);
+			this->put(trailer, sizeof(trailer));
+		}
+		else {
+			this->deflater.finish();
+		}
+		if (!this->idat.empty()) {
+			this->writeChunk("IDAT", this->idat.data(), this->idat.size());
+			this->idat.clear();
+		}
+		this->writeChunk("IEND", nullptr, 0);
+		this->out.flush();
+		this->finished = true;
+	}
+	return this->out.good();
+}
+
+void PngWriter::compress(const unsigned char* data, size_t length)
+{
+	if (this->pPipeline == nullptr) {
+		this->deflater.write(data, length);
+		return;
+	}
+	std::vector<unsigned char>& job = this->jobs[this->nJobs];
+	job.insert(job.end(), data, data + length);
+	if (job.size() >= JOB_SIZE && ++this->nJobs == this->jobs.size()) {
+		this->compressJobs(this->nJobs);
+	}
+}
+
+void PngWriter::compressJobs(size_t count)
+{
+	if (!this->zlibStarted) {
+		unsigned char header[2];
+		Deflater::getZlibHeader(this->level, header);
+		this->put(header, sizeof(header));
+		this->zlibStarted = true;
+	}
+	std::vector<uint32_t> adlers(count);
+	size_t nDone = 0;
+	this->pPipeline->run(count,
+		[&](size_t ix, std::string& text) {
+			const std::vector<unsigned char>& job = this->jobs[ix];
+			StringSink sink(text);
+			Deflater jobDeflater(sink, this->level, Deflater::RAW);
+			// As in a serial stream, matches may refer to the preceding data
+			const std::vector<unsigned char>& before = (ix == 0) ? this->dictionary : this->jobs[ix - 1];
+			size_t nBefore = (std::min)(before.size(), Deflater::MAX_DICTIONARY);
+			jobDeflater.setDictionary(before.data() + before.size() - nBefore, nBefore);
+			jobDeflater.write(job.data(), job.size());
+			jobDeflater.flush();
+			adlers[ix] = Deflater::adler32(1, job.data(), job.size());
+		},
+		[&](const char* text, size_t length) {
+			this->put(reinterpret_cast<const unsigned char*>(text), length);
+			this->adler = Deflater::adler32Combine(this->adler, adlers[nDone], this->jobs[nDone].size());
+			nDone++;
+			return this->out.good();
+		});
+	if (count > 0) {
+		const std::vector<unsigned char>& last = this->jobs[count - 1];
+		size_t nLast = (std::min)(last.size(), Deflater::MAX_DICTIONARY);
+		this->dictionary.assign(last.end() - nLast, last.end());
+	}
+	for (size_t ix = 0; ix < count; ix++) {
+		this->jobs[ix].clear();
+	}
+	this->nJobs = 0;
+}
+
+/*======== ApngWriter ========*/
+
+ApngWriter::ApngWriter(std::ostream& out, uint32_t width, uint32_t height, uint32_t nFrames,
+	uint32_t nPlays, int level)
+	: out(out)
+	, width(width)
+	, height(height)
+	, nFrames(nFrames)
+	, level(level)
+	, frameNo(0)
+	, sequenceNo(0)
+	, frameWidth(0)
+	, frameHeight(0)
+	, nRows(0)
+	, inFrame(false)
+{
+	static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	this->out.write(reinterpret_cast<const char*>(SIGNATURE), sizeof(SIGNATURE));
+	unsigned char ihdr[13];
+	putUInt32(ihdr, width);
+	putUInt32(ihdr + 4, height);
+	ihdr[8] = 8;	// bit depth
+	ihdr[9] = (unsigned char)PngWriter::RGB;
+	ihdr[10] = 0;	// deflate
+	ihdr[11] = 0;	// adaptive filtering
+	ihdr[12] = 0;	// no interlace
+	writePngChunk(this->out, "IHDR", ihdr, sizeof(ihdr));
+	// The animation control chunk must precede the image data
+	unsigned char actl[8];
+	putUInt32(actl, nFrames);
+	putUInt32(actl + 4, nPlays);
+	writePngChunk(this->out, "acTL", actl, sizeof(actl));
+	this->data.reserve(DATA_SIZE + 4);
+}
+
+ApngWriter::~ApngWriter()
+{
+}
+
+bool ApngWriter::beginFrame(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint16_t delayMs,
+	DisposeOp dispose, BlendOp blend)
+{
+	if (this->inFrame) {
+		this->endFrame();
+	}
+	if (this->frameNo >= this->nFrames || width == 0 || height == 0
+		|| width > this->width || height > this->height || x > this->width - width || y > this->height - height
+		|| (this->frameNo == 0 && (x != 0 || y != 0 || width != this->width || height != this->height))) {
+		return false;
+	}
+	this->frameNo++;
+	unsigned char fctl[26];
+	putUInt32(fctl, this->sequenceNo++);
+	putUInt32(fctl + 4, width);
+	putUInt32(fctl + 8, height);
+	putUInt32(fctl + 12, x);
+	putUInt32(fctl + 16, y);
+	fctl[20] = (unsigned char)(delayMs >> 8);	// delay numerator
+	fctl[21] = (unsigned char)delayMs;
+	fctl[22] = (unsigned char)(1000 >> 8);		// delay denominator
+	fctl[23] = (unsigned char)(1000 & 0xFF);
+	fctl[24] = (unsigned char)dispose;
+	fctl[25] = (unsigned char)blend;
+	writePngChunk(this->out, "fcTL", fctl, sizeof(fctl));
+
+	this->frameWidth = width;
+	this->frameHeight = height;
+	this->nRows = 0;
+	this->prevRow.assign((size_t)width * 3, 0);
+	this->filtered.resize(N_FILTERS * ((size_t)width * 3 + 1));
+	// fdAT chunks start with their sequence number, filled in by writeData()
+	this->data.assign(this->frameNo == 1 ? 0 : 4, 0);
+	this->pDeflater.reset(new Deflater(*this, this->level, Deflater::ZLIB));
+	this->inFrame = true;
+	return this->out.good();
+}
+
+bool ApngWriter::writeRow(const unsigned char* row)
+{
+	if (!this->inFrame || this->nRows >= this->frameHeight) {
+		return false;
+	}
+	const size_t n = (size_t)this->frameWidth * 3;
+	int nFilters = (this->level == 0) ? 1 : N_FILTERS;
+	this->pDeflater->write(chooseFilter(row, this->prevRow.data(), 3, n, nFilters, this->filtered.data()), n + 1);
+	this->prevRow.assign(row, row + n);
+	this->nRows++;
+	return this->out.good();
+}
+
+bool ApngWriter::endFrame()
+{
+	if (this->inFrame) {
+		std::vector<unsigned char> empty((size_t)this->frameWidth * 3, 0);
+		while (this->nRows < this->frameHeight) {
+			this->writeRow(empty.data());
+		}
+		this->pDeflater->finish();
+		this->writeData();
+		this->pDeflater.reset();
+		this->inFrame = false;
+	}
+	return this->out.good();
+}
+
+bool ApngWriter::finish()
+{
+	this->endFrame();
+	writePngChunk(this->out, "IEND", nullptr, 0);
+	this->out.flush();
+	return this->frameNo == this->nFrames && this->out.good();
+}
+
+void ApngWriter::writeData()
+{
+	if (this->frameNo == 1) {
+		if (!this->data.empty()) {
+			writePngChunk(this->out, "IDAT", this->data.data(), this->data.size());
+		}
+		this->data.clear();
+	}
+	else if (this->data.size() > 4) {
+		putUInt32(this->data.data(), this->sequenceNo++);
+		writePngChunk(this->out, "fdAT", this->data.data(), this->data.size());
+		this->data.resize(4);
+	}
+}
+
+void ApngWriter::put(const unsigned char* bytes, size_t length)
+{
+	const size_t limit = DATA_SIZE + (this->frameNo == 1 ? 0 : 4);
+	while (length > 0) {
+		size_t n = limit - this->data.size();
+		if (n > length) {
+			n = length;
+		}
+		this->data.insert(this->data.end(), bytes, bytes + n);
+		bytes += n;
+		length -= n;
+		if (this->data.size() >= limit) {
+			this->writeData();
+		}
+	}
+}
@@ -0,0 +1,231 @@
+#pragma once
+#ifndef PNGENCODER_H
+#define PNGENCODER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Row-streaming PNG encoder: the image is passed in row by row (top-down), so
+ * only the current and the previous row are held in memory, no matter how big
+ * the image is. Each row is filtered adaptively (the filter type with the least
+ * sum of absolute differences wins) and compressed by a Deflater, the output is
+ * split into IDAT chunks of limited size.
+ * Images with at most 256 colours may be written as indexed-colour PNGs with a
+ * bit depth of 1, 2, 4, or 8 (depending on the number of colours, which a
+ * PngPalette gathers while mapping the pixels to palette indices). Indexed rows
+ * aren't filtered, as recommended by the PNG specification.
+ * With an ExportPipeline of several workers given, the filtered rows are gathered
+ * into jobs of about JOB_SIZE bytes, which are compressed concurrently (pigz-style:
+ * each job primed with the tail of its predecessor, ending with a sync flush) and
+ * concatenated into a single zlib stream. The filter selection uses SSE2 where
+ * available.
+ * The ApngWriter encodes animated PNGs (RGB samples) frame by frame, each frame
+ * covering only a region of the canvas (e.g. the bounds of what has changed).
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   ApngWriter for animated PNGs (frame regions, disposal and blend ops)
+ * 2026-10-18   Parallel compression via an ExportPipeline, SSE2 filter selection
+ * 2026-10-18   Indexed-colour output (PngPalette, colour type PALETTE)
+ * 2026-10-18   Created for VERSION 11.1.0 (streaming PNG export)
+ */
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "Deflate.h"
+
+class ExportPipeline;
+
+class PngPalette
+{
+public:
+	static const size_t MAX_COLOURS = 256;		// Maximum number of palette entries
+
+	PngPalette();
+
+	/* Returns the palette index of the colour argb (0xAARRGGBB), which is added
+	 * if new; returns -1 if the palette is full and doesn't contain argb */
+	int indexOf(uint32_t argb);
+	/* Maps count pixels (0xAARRGGBB values, combined with orMask, e.g. 0xFF000000 to
+	 * ignore undefined alpha bytes) to palette indices, adding new colours; returns
+	 * false if the palette overflowed (the indices are incomplete then) */
+	bool indexPixels(const uint32_t* pixels, size_t count, unsigned char* indices, uint32_t orMask = 0);
+	// Returns the number of colours
+	inline size_t size() const { return colours.size(); }
+	// Returns the colours (0xAARRGGBB) in order of their indices
+	inline const std::vector<uint32_t>& getColours() const { return colours; }
+	// Returns the least bit depth (1, 2, 4, or 8) sufficient for the indices
+	int getBitDepth() const;
+	// Returns true if some colour isn't fully opaque
+	bool hasTransparency() const;
+	// Removes all colours
+	void clear();
+
+private:
+	static const size_t HASH_SIZE = 1024;		// Slots of the lookup table (power of 2)
+
+	std::vector<uint32_t> colours;
+	uint32_t keys[HASH_SIZE];				// Colour per slot
+	int16_t slots[HASH_SIZE];				// Colour index per slot (-1 = empty)
+	uint32_t lastColour;					// Most recently looked-up colour (pixel runs)
+	int lastIndex;							// Index of lastColour (-1 = none)
+};
+
+class PngWriter : private ByteSink
+{
+public:
+	// Colour types (with 8 bits per sample unless indexed)
+	enum ColourType {
+		GREY = 0,
+		RGB = 2,
+		PALETTE = 3,
+		GREY_ALPHA = 4,
+		RGBA = 6
+	};
+
+	// Prepares the encoding of a width x height image to the (binary) stream out
+	// (colourType must not be PALETTE here), compressing concurrently if a pipeline
+	// with several workers is given
+	PngWriter(std::ostream& out, uint32_t width, uint32_t height,
+		ColourType colourType = RGB, int level = Deflater::DEFAULT_LEVEL,
+		const ExportPipeline* pPipeline = nullptr);
+	// Prepares the encoding of a width x height indexed-colour image with the given
+	// palette (1 ... 256 colours) to the (binary) stream out, compressing concurrently
+	// if a pipeline with several workers is given
+	PngWriter(std::ostream& out, uint32_t width, uint32_t height,
+		const PngPalette& palette, int level = Deflater::DEFAULT_LEVEL,
+		const ExportPipeline* pPipeline = nullptr);
+	~PngWriter();
+
+	// Encodes the next image row (width pixels with the samples of the colour type
+	// in file order, e.g. R, G, B, or one palette index byte per pixel), returns
+	// false if the stream failed
+	bool writeRow(const unsigned char* row);
+	// Completes the image (missing rows are filled with zeros), returns false if
+	// the stream failed
+	bool finish();
+	// Returns the number of bytes per image row (as passed to writeRow())
+	inline size_t getRowSize() const { return inputSize; }
+	// Returns the bit depth of the image
+	inline int getBitDepth() const { return bitDepth; }
+
+private:
+	static const size_t IDAT_SIZE = 65536;		// Max. data size of an IDAT chunk
+	static const size_t JOB_SIZE = 1 << 18;		// Min. filtered data size of a parallel job
+
+	std::ostream& out;
+	const uint32_t width, height;
+	const ColourType colourType;
+	const int bitDepth;
+	const int level;
+	const size_t bytesPerPixel;
+	const size_t inputSize;					// Bytes per row passed to writeRow()
+	const size_t rowSize;					// Bytes per (packed) image row
+	uint32_t nRows;							// Rows written so far
+	std::vector<unsigned char> prevRow;		// Previous unfiltered row (zeros at start)
+	std::vector<unsigned char> filtered;	// Filter type byte + filtered row (per type)
+	std::vector<unsigned char> idat;		// Compressed data for the next IDAT chunk
+	Deflater deflater;
+	bool finished;
+	// Parallel compression
+	const ExportPipeline* const pPipeline;	// Workers (null if compressing serially)
+	std::vector<std::vector<unsigned char>> jobs;	// Filtered rows per job of the batch
+	size_t nJobs;							// Number of complete jobs in the batch
+	std::vector<unsigned char> dictionary;	// Tail of the data preceding the batch
+	uint32_t adler;							// Adler-32 of the data compressed so far
+	bool zlibStarted;						// Whether the zlib header has been written
+
+	// Common constructor part
+	PngWriter(std::ostream& out, uint32_t width, uint32_t height,
+		ColourType colourType, int bitDepth, int level, const ExportPipeline* pPipeline);
+
+	// Writes the signature and the IHDR chunk
+	void writeHeader();
+	// Writes the PLTE chunk (and a tRNS chunk if needed) for palette
+	void writePalette(const PngPalette& palette);
+	// Packs the palette indices of row into filtered (after the filter type byte)
+	void packIndices(const unsigned char* row);
+	// Passes a filtered row to the deflater or the current parallel job
+	void compress(const unsigned char* data, size_t length);
+	// Compresses the first count jobs concurrently and passes the results on
+	void compressJobs(size_t count);
+	// Writes a chunk with the given type and data
+	void writeChunk(const char* type, const unsigned char* data, size_t length);
+	// Receives the compressed data from the Deflater (ByteSink)
+	void put(const unsigned char* data, size_t length) override;
+
+	PngWriter(const PngWriter&) = delete;
+	PngWriter& operator=(const PngWriter&) = delete;
+};
+
+class ApngWriter : private ByteSink
+{
+public:
+	// What happens to the frame region before the next frame is rendered
+	enum DisposeOp {
+		DISPOSE_NONE = 0,			// Left as it is
+		DISPOSE_BACKGROUND = 1,		// Cleared to transparent black
+		DISPOSE_PREVIOUS = 2		// Reverted to the content before the frame
+	};
+	// How the frame pixels are combined with the region
+	enum BlendOp {
+		BLEND_SOURCE = 0,			// Replace the region
+		BLEND_OVER = 1				// Alpha-composite over the region
+	};
+
+	/* Prepares the encoding of an animation of nFrames frames on a width x height
+	 * canvas (RGB samples), played nPlays times (0 = endlessly), to the (binary)
+	 * stream out */
+	ApngWriter(std::ostream& out, uint32_t width, uint32_t height, uint32_t nFrames,
+		uint32_t nPlays = 0, int level = Deflater::DEFAULT_LEVEL);
+	~ApngWriter();
+
+	/* Starts the next frame, covering the width x height region at (x, y) of the
+	 * canvas, to be shown for delayMs milliseconds. The first frame must cover the
+	 * entire canvas (it's also the static image for viewers without APNG support).
+	 * Returns false if the region exceeds the canvas or all frames have been written */
+	bool beginFrame(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint16_t delayMs,
+		DisposeOp dispose = DISPOSE_NONE, BlendOp blend = BLEND_SOURCE);
+	// Encodes the next row of the current frame (width R, G, B triples), returns false
+	// if the stream failed
+	bool writeRow(const unsigned char* row);
+	// Completes the current frame (missing rows are filled with zeros), returns false if
+	// the stream failed
+	bool endFrame();
+	// Completes the animation, returns false if frames are missing or the stream failed
+	bool finish();
+
+private:
+	static const size_t DATA_SIZE = 65536;		// Max. data size of an IDAT or fdAT chunk
+
+	std::ostream& out;
+	const uint32_t width, height;
+	const uint32_t nFrames;
+	const int level;
+	uint32_t frameNo;						// Number of the current frame (counting from 1)
+	uint32_t sequenceNo;					// Next sequence number for fcTL and fdAT chunks
+	uint32_t frameWidth, frameHeight;		// Region size of the current frame
+	uint32_t nRows;							// Rows of the current frame written so far
+	bool inFrame;
+	std::vector<unsigned char> prevRow;		// Previous unfiltered row (zeros at start)
+	std::vector<unsigned char> filtered;	// Filter type byte + filtered row (per type)
+	std::vector<unsigned char> data;		// Compressed data for the next IDAT or fdAT chunk
+	std::unique_ptr<Deflater> pDeflater;	// Compressor of the current frame
+
+	// Passes the collected data as IDAT (first frame) or fdAT chunk
+	void writeData();
+	// Receives the compressed data from the Deflater (ByteSink)
+	void put(const unsigned char* bytes, size_t length) override;
+
+	ApngWriter(const ApngWriter&) = delete;
+	ApngWriter& operator=(const ApngWriter&) = delete;
+};
+
+#endif /*PNGENCODER_H*/
@@ -0,0 +1,373 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Chunked, append-only store for the line segments drawn by a Turtle
+ * (single appending thread, concurrent readers).
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Segment clipping (SegmentBounds::contains(), clip(), clipChunks())
+ * 2026-10-18   Bulk append() for imported drawings
+ * 2026-10-18   Created for VERSION 11.1.0 (decoupling of turtle and window thread)
+ */
+
+#include "SegmentStore.h"
+#include <limits>
+
+SegmentBounds SegmentBounds::empty()
+{
+	const float inf = std::numeric_limits<float>::infinity();
+	SegmentBounds bounds = { inf, inf, -inf, -inf };
+	return bounds;
+}
+
+void SegmentBounds::include(const SegmentBounds& other)
+{
+	if (!other.isEmpty()) {
+		include(other.left, other.top);
+		include(other.right, other.bottom);
+	}
+}
+
+bool SegmentBounds::intersects(const SegmentBounds& other) const
+{
+	return !isEmpty() && !other.isEmpty()
+		&& left <= other.right && other.left <= right
+		&& top <= other.bottom && other.top <= bottom;
+}
+
+bool SegmentBounds::contains(const SegmentBounds& other) const
+{
+	return !other.isEmpty()
+		&& left <= other.left && other.right <= right
+		&& top <= other.top && other.bottom <= bottom;
+}
+
+bool SegmentBounds::clip(Segment& seg) const
+{
+	if (isEmpty()) {
+		return false;
+	}
+	// Parametric form seg.x1 + t * dx, seg.y1 + t * dy with t in [t0, t1]
+	double dx = (double)seg.x2 - seg.x1;
+	double dy = (double)seg.y2 - seg.y1;
+	const double p[4] = { -dx, dx, -dy, dy };
+	const double q[4] = { (double)seg.x1 - left, (double)right - seg.x1, (double)seg.y1 - top, (double)bottom - seg.y1 };
+	double t0 = 0.0, t1 = 1.0;
+	for (int i = 0; i < 4; i++) {
+		if (p[i] == 0.0) {
+			// Parallel to this edge - either entirely outside or irrelevant
+			if (q[i] < 0.0) {
+				return false;
+			}
+		}
+		else {
+			double r = q[i] / p[i];
+			if (p[i] < 0.0) {
+				// Entering the box
+				if (r > t1) {
+					return false;
+				}
+				if (r > t0) {
+					t0 = r;
+				}
+			}
+			else {
+				// Leaving the box
+				if (r < t0) {
+					return false;
+				}
+				if (r < t1) {
+					t1 = r;
+				}
+			}
+		}
+	}
+	const double x1 = seg.x1, y1 = seg.y1;
+	if (t1 < 1.0) {
+		seg.x2 = (float)(x1 + t1 * dx);
+		seg.y2 = (float)(y1 + t1 * dy);
+	}
+	if (t0 > 0.0) {
+		seg.x1 = (float)(x1 + t0 * dx);
+		seg.y1 = (float)(y1 + t0 * dy);
+	}
+	return true;
+}
+
+SegmentStore::Chunk::Chunk()
+	: bounds(SegmentBounds::empty())
+	, next(nullptr)
+{
+}
+
+SegmentStore::SegmentStore()
+	: head(nullptr)
+	, tail(nullptr)
+	, count(0)
+	, generation(0)
+	, nReaders(0)
+{
+}
+
+SegmentStore::~SegmentStore()
+{
+	Chunk* pChunk = this->head.load();
+	while (pChunk != nullptr) {
+		Chunk* pNext = pChunk->next.load();
+		delete pChunk;
+		pChunk = pNext;
+	}
+}
+
+void SegmentStore::push_back(const Segment& seg)
+{
+	size_t n = this->count.load(std::memory_order_relaxed);
+	unsigned int ix = (unsigned int)(n % CHUNK_SIZE);
+	if (ix == 0) {
+		// The current chunk is full (or there is none yet)
+		this->addChunk();
+	}
+	this->tail->items[ix] = seg;
+	this->tail->bounds.include(seg);
+	// Publish the new segment (and the chunk bounds) to the readers
+	this->count.store(n + 1, std::memory_order_release);
+}
+
+void SegmentStore::append(const Segment* segs, size_t count)
+{
+	size_t n = this->count.load(std::memory_order_relaxed);
+	while (count > 0) {
+		unsigned int ix = (unsigned int)(n % CHUNK_SIZE);
+		if (ix == 0) {
+			this->addChunk();
+		}
+		unsigned int nCopy = CHUNK_SIZE - ix;
+		if (count < nCopy) {
+			nCopy = (unsigned int)count;
+		}
+		Segment* pDest = this->tail->items + ix;
+		SegmentBounds bounds = this->tail->bounds;
+		for (unsigned int i = 0; i < nCopy; i++) {
+			pDest[i] = segs[i];
+			bounds.include(segs[i]);
+		}
+		this->tail->bounds = bounds;
+		segs += nCopy;
+		count -= nCopy;
+		n += nCopy;
+		// Publish the filled part of the chunk at once
+		this->count.store(n, std::memory_order_release);
+	}
+}
+
+void SegmentStore::addChunk()
+{
+	// Readers won't follow the link before the count has been published.
+	Chunk* pChunk = new Chunk();
+	if (this->tail == nullptr) {
+		this->head.store(pChunk, std::memory_order_release);
+	}
+	else {
+		this->tail->next.store(pChunk, std::memory_order_release);
+	}
+	this->tail = pChunk;
+}
+
+void SegmentStore::clear()
+{
+	std::unique_lock<std::mutex> lock(this->readerMutex);
+	this->readersDone.wait(lock, [this] { return this->nReaders == 0; });
+	// No reader can get in while we hold the mutex
+	Chunk* pChunk = this->head.exchange(nullptr);
+	this->tail = nullptr;
+	this->count.store(0);
+	this->generation.fetch_add(1);
+	while (pChunk != nullptr) {
+		Chunk* pNext = pChunk->next.load();
+		delete pChunk;
+		pChunk = pNext;
+	}
+}
+
+size_t SegmentStore::size() const
+{
+	return this->count.load(std::memory_order_acquire);
+}
+
+bool SegmentStore::empty() const
+{
+	return this->size() == 0;
+}
+
+unsigned int SegmentStore::getGeneration() const
+{
+	return this->generation.load();
+}
+
+SegmentStore::const_iterator SegmentStore::cbegin() const
+{
+	return const_iterator(this, this->head.load(std::memory_order_acquire), 0, 0);
+}
+
+SegmentStore::const_iterator SegmentStore::cend() const
+{
+	return const_iterator(this, nullptr, 0, this->size());
+}
+
+SegmentStore::const_iterator SegmentStore::at(size_t index) const
+{
+	const Chunk* pChunk = this->head.load(std::memory_order_acquire);
+	size_t nChunks = index / CHUNK_SIZE;
+	unsigned int ix = (unsigned int)(index % CHUNK_SIZE);
+	if (nChunks > 0 && ix == 0) {
+		// Stay at the end of the preceding chunk (its successor might not exist yet)
+		nChunks--;
+		ix = CHUNK_SIZE;
+	}
+	for (size_t i = 0; i < nChunks && pChunk != nullptr; i++) {
+		pChunk = pChunk->next.load(std::memory_order_acquire);
+	}
+	return const_iterator(this, pChunk, ix, index);
+}
+
+void SegmentStore::getChunks(std::vector<SegmentChunkView>& views, size_t from) const
+{
+	size_t n = this->size();
+	const Chunk* pChunk = this->head.load(std::memory_order_acquire);
+	for (size_t start = 0; start < n && pChunk != nullptr; start += CHUNK_SIZE) {
+		size_t end = start + CHUNK_SIZE;
+		if (end > from) {
+			SegmentChunkView view;
+			size_t first = (from > start) ? from - start : 0;
+			size_t last = (end <= n) ? CHUNK_SIZE : n - start;
+			view.segments = &pChunk->items[first];
+			view.count = last - first;
+			view.firstIndex = start + first;
+			if (first == 0 && last == CHUNK_SIZE) {
+				// Complete chunks won't change anymore, so their bounds are reliable
+				view.bounds = pChunk->bounds;
+			}
+			else {
+				// The appending thread may still be extending the chunk bounds
+				view.bounds = SegmentBounds::empty();
+				for (size_t i = 0; i < view.count; i++) {
+					view.bounds.include(view.segments[i]);
+				}
+			}
+			views.push_back(view);
+		}
+		if (end < n) {
+			pChunk = pChunk->next.load(std::memory_order_acquire);
+		}
+	}
+}
+
+SegmentStore::ReadLock::ReadLock(const SegmentStore& store)
+	: store(store)
+{
+	std::lock_guard<std::mutex> guard(store.readerMutex);
+	store.nReaders++;
+}
+
+SegmentStore::ReadLock::~ReadLock()
+{
+	std::lock_guard<std::mutex> guard(store.readerMutex);
+	if (--store.nReaders == 0) {
+		store.readersDone.notify_all();
+	}
+}
+
+SegmentStore::const_iterator::const_iterator()
+	: pStore(nullptr)
+	, pChunk(nullptr)
+	, ix(0)
+	, pos(0)
+{
+}
+
+SegmentStore::const_iterator::const_iterator(const SegmentStore* pStore, const Chunk* pChunk, unsigned int ix, size_t pos)
+	: pStore(pStore)
+	, pChunk(pChunk)
+	, ix(ix)
+	, pos(pos)
+{
+}
+
+void SegmentStore::const_iterator::resolve() const
+{
+	if (this->pChunk == nullptr) {
+		// Iterator was created on an empty store
+		this->pChunk = this->pStore->head.load(std::memory_order_acquire);
+		this->ix = 0;
+	}
+	else if (this->ix >= CHUNK_SIZE) {
+		this->pChunk = this->pChunk->next.load(std::memory_order_acquire);
+		this->ix = 0;
+	}
+}
+
+const Segment& SegmentStore::const_iterator::operator*() const
+{
+	this->resolve();
+	return this->pChunk->items[this->ix];
+}
+
+const Segment* SegmentStore::const_iterator::operator->() const
+{
+	this->resolve();
+	return &this->pChunk->items[this->ix];
+}
+
+SegmentStore::const_iterator& SegmentStore::const_iterator::operator++()
+{
+	this->resolve();
+	this->pos++;
+	if (++this->ix >= CHUNK_SIZE) {
+		const Chunk* pNext = this->pChunk->next.load(std::memory_order_acquire);
+		if (pNext != nullptr) {
+			this->pChunk = pNext;
+			this->ix = 0;
+		}
+		// Otherwise stay behind the last slot until the successor exists
+	}
+	return *this;
+}
+
+void clipChunks(const std::vector<SegmentChunkView>& chunks, const SegmentBounds& clip,
+	std::vector<SegmentChunkView>& clipped, std::vector<std::vector<Segment>>& storage)
+{
+	size_t nPassed = 0;
+	for (const SegmentChunkView& chunk : chunks) {
+		if (chunk.count == 0 || !chunk.bounds.intersects(clip)) {
+			continue;
+		}
+		SegmentChunkView view = chunk;
+		view.firstIndex = nPassed;
+		if (!clip.contains(chunk.bounds)) {
+			// (The buffer of a vector stays in place when the outer vector grows)
+			std::vector<Segment> segments;
+			view.bounds = SegmentBounds::empty();
+			for (size_t i = 0; i < chunk.count; i++) {
+				Segment seg = chunk.segments[i];
+				if (clip.clip(seg)) {
+					segments.push_back(seg);
+					view.bounds.include(seg);
+				}
+			}
+			if (segments.empty()) {
+				continue;
+			}
+			view.segments = segments.data();
+			view.count = segments.size();
+			storage.push_back(std::move(segments));
+		}
+		clipped.push_back(view);
+		nPassed += view.count;
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+#ifndef SEGMENTSTORE_H
+#define SEGMENTSTORE_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Chunked, append-only store for the line segments drawn by a Turtle.
+ * Exactly one thread (the one running the turtle program) may append or clear,
+ * while other threads (the window thread painting the canvas, exporters) may
+ * read concurrently without ever blocking the appending thread: segments are
+ * written into fixed-size chunks that are never moved, and only the element
+ * count is published. Only clear() has to wait for active readers.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Segment clipping (SegmentBounds::contains(), clip(), clipChunks())
+ * 2026-10-18   Bulk append() for imported drawings
+ * 2026-10-18   Created for VERSION 11.1.0 (decoupling of turtle and window thread)
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// A line drawn by a turtle (coordinates in turtle units)
+struct Segment {
+	float x1, y1;		// from position
+	float x2, y2;		// to position
+	uint32_t argb;		// colour to draw with (same layout as Gdiplus::ARGB)
+};
+
+// Axis-parallel bounding box in turtle coordinates (empty if left > right)
+struct SegmentBounds {
+	float left, top, right, bottom;
+
+	// Returns an empty bounds object
+	static SegmentBounds empty();
+	// Returns true if nothing has been included so far
+	inline bool isEmpty() const { return left > right; }
+	// Extends the bounds by the point (x, y)
+	inline void include(float x, float y)
+	{
+		if (x < left) { left = x; }
+		if (x > right) { right = x; }
+		if (y < top) { top = y; }
+		if (y > bottom) { bottom = y; }
+	}
+	// Extends the bounds by both end points of the given segment
+	inline void include(const Segment& seg)
+	{
+		include(seg.x1, seg.y1);
+		include(seg.x2, seg.y2);
+	}
+	// Extends the bounds by the given other bounds
+	void include(const SegmentBounds& other);
+	// Checks whether the (closed) boxes share at least one point
+	bool intersects(const SegmentBounds& other) const;
+	// Checks whether the other (non-empty) box lies entirely within this box
+	bool contains(const SegmentBounds& other) const;
+	/* Cuts the segment seg down to its part within the box (Liang-Barsky), returns
+	 * false if nothing of it is inside (seg is left as is then). End points within
+	 * the box are retained exactly */
+	bool clip(Segment& seg) const;
+};
+
+// Read-only view of a contiguous run of segments within a SegmentStore
+struct SegmentChunkView {
+	const Segment* segments;	// First segment of the run
+	size_t count;				// Number of segments in the run
+	size_t firstIndex;			// Index of segments[0] within the store
+	SegmentBounds bounds;		// Bounds of the segments in the run
+};
+
+class SegmentStore
+{
+	struct Chunk;
+public:
+	// Number of segments per chunk
+	static const unsigned int CHUNK_SIZE = 4096;
+
+	// Forward iterator over the published segments.
+	// An iterator positioned behind the last element stays valid when further
+	// segments are appended, so it may be kept as resume position.
+	class const_iterator {
+	public:
+		const_iterator();
+		const Segment& operator*() const;
+		const Segment* operator->() const;
+		const_iterator& operator++();
+		inline bool operator==(const const_iterator& other) const { return pos == other.pos; }
+		inline bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+		// Returns the index of the referenced element within the store
+		inline size_t index() const { return pos; }
+	private:
+		friend class SegmentStore;
+		const_iterator(const SegmentStore* pStore, const Chunk* pChunk, unsigned int ix, size_t pos);
+		// Moves on to the next chunk if the current one has been left
+		void resolve() const;
+		const SegmentStore* pStore;		// The store iterated over
+		mutable const Chunk* pChunk;	// Chunk holding the referenced element
+		mutable unsigned int ix;		// Index within the chunk
+		size_t pos;						// Index within the store
+	};
+
+	// RAII guard to be held by reading threads while they access segments;
+	// clear() waits until all guards have been released.
+	class ReadLock {
+	public:
+		explicit ReadLock(const SegmentStore& store);
+		~ReadLock();
+	private:
+		ReadLock(const ReadLock&) = delete;
+		ReadLock& operator=(const ReadLock&) = delete;
+		const SegmentStore& store;
+	};
+
+	SegmentStore();
+	~SegmentStore();
+
+	// Appends a segment (appending thread only)
+	void push_back(const Segment& seg);
+	// Appends count segments in bulk, publishing them chunk-wise (appending thread only)
+	void append(const Segment* segs, size_t count);
+	// Drops all segments (appending thread only, waits for active readers)
+	void clear();
+	// Returns the number of published segments
+	size_t size() const;
+	// Returns true if no segment has been published
+	bool empty() const;
+	// Returns a counter that is incremented by every clear()
+	unsigned int getGeneration() const;
+
+	// Returns an iterator to the first element
+	const_iterator cbegin() const;
+	// Returns the end iterator for the currently published segments
+	// (only good for comparison - use an incremented iterator as resume point)
+	const_iterator cend() const;
+	// Returns an iterator to the element with given index (by walking the chunks)
+	const_iterator at(size_t index) const;
+
+	// Appends views of all published chunks (starting with the chunk that holds
+	// element from) to views, the first and last view may be partial chunks.
+	// (The views are only valid while a ReadLock is held.)
+	void getChunks(std::vector<SegmentChunkView>& views, size_t from = 0) const;
+
+private:
+	struct Chunk {
+		Segment items[CHUNK_SIZE];		// Segment slots
+		SegmentBounds bounds;			// Bounds of the filled slots
+		std::atomic<Chunk*> next;		// Successor chunk or nullptr
+		Chunk();
+	};
+	std::atomic<Chunk*> head;				// First chunk (nullptr while empty)
+	Chunk* tail;							// Last chunk (appending thread only)
+	std::atomic<size_t> count;				// Number of published segments
+	std::atomic<unsigned int> generation;	// Number of clear() calls so far
+	mutable std::mutex readerMutex;			// Guards nReaders
+	mutable std::condition_variable readersDone;	// Signalled when nReaders drops to 0
+	mutable unsigned int nReaders;			// Number of active ReadLocks
+
+	// Links a new (empty) chunk behind the tail (appending thread only)
+	void addChunk();
+	SegmentStore(const SegmentStore&) = delete;
+	SegmentStore& operator=(const SegmentStore&) = delete;
+};
+
+/* Puts views of the parts of the given chunks within the box clip into clipped:
+ * chunks inside the box are passed on as they are, chunks outside are skipped by
+ * their bounds, and the clipped segments of the other chunks are copied into
+ * storage (to be kept along with the views). The firstIndex fields of the new
+ * views count the passed segments only, such that the views can be exported like
+ * the chunks of a store */
+void clipChunks(const std::vector<SegmentChunkView>& chunks, const SegmentBounds& clip,
+	std::vector<SegmentChunkView>& clipped, std::vector<std::vector<Segment>>& storage);
+
+#endif /*SEGMENTSTORE_H*/
@@ -0,0 +1,108 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Line simplification for the vector exports, see Simplifier.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (simplified vector export)
+ */
+
+#include "Simplifier.h"
+#include "ExportPipeline.h"
+
+Simplifier::Simplifier(float tolerance)
+	: tolerance(tolerance)
+	, nInput(0)
+	, nOutput(0)
+{
+}
+
+void Simplifier::simplifyChunks(const std::vector<SegmentChunkView>& chunks, std::vector<SegmentChunkView>& simplified,
+	std::vector<std::vector<Segment>>& storage, const ExportPipeline* pPipeline)
+{
+	// Each chunk gets a result vector of its own, so the workers needn't synchronise
+	const size_t base = storage.size();
+	storage.resize(base + chunks.size());
+	auto simplify = [&](size_t ix, std::string&) {
+		this->simplifyChunk(chunks[ix], storage[base + ix]);
+	};
+	if (pPipeline != nullptr) {
+		pPipeline->run(chunks.size(), simplify, [](const char*, size_t) { return true; });
+	}
+	else {
+		std::string none;
+		for (size_t ix = 0; ix < chunks.size(); ix++) {
+			simplify(ix, none);
+		}
+	}
+	size_t nPassed = 0;
+	for (size_t ix = 0; ix < chunks.size(); ix++) {
+		const std::vector<Segment>& segments = storage[base + ix];
+		this->count(chunks[ix].count, segments.size());
+		if (segments.empty()) {
+			continue;
+		}
+		SegmentChunkView view;
+		view.segments = segments.data();
+		view.count = segments.size();
+		view.firstIndex = nPassed;
+		// The remaining vertices are a subset of the former ones
+		view.bounds = chunks[ix].bounds;
+		simplified.push_back(view);
+		nPassed += view.count;
+	}
+}
+
+void Simplifier::count(uint64_t nBefore, uint64_t nAfter)
+{
+	this->nInput += nBefore;
+	this->nOutput += nAfter;
+}
+
+double Simplifier::getReductionRatio() const
+{
+	uint64_t nBefore = this->nInput;
+	return nBefore > 0 ? (double)this->nOutput / nBefore : 1.0;
+}
+
+void Simplifier::simplifyChunk(const SegmentChunkView& chunk, std::vector<Segment>& result) const
+{
+	std::vector<bool> keep;
+	std::vector<std::pair<size_t, size_t>> stack;
+	const Segment* segs = chunk.segments;
+	size_t first = 0;
+	while (first < chunk.count) {
+		// Find the run of connected segments of the same colour starting at first
+		size_t end = first + 1;
+		while (end < chunk.count && segs[end].argb == segs[first].argb
+			&& segs[end].x1 == segs[end - 1].x2 && segs[end].y1 == segs[end - 1].y2) {
+			end++;
+		}
+		// Vertex ix of the run is the start of segment first + ix (or the end of the last)
+		const size_t nPoints = end - first + 1;
+		auto getPoint = [segs, first, nPoints](size_t ix) {
+			return ix + 1 < nPoints
+				? std::make_pair(segs[first + ix].x1, segs[first + ix].y1)
+				: std::make_pair(segs[first + ix - 1].x2, segs[first + ix - 1].y2);
+		};
+		this->markVertices(nPoints, getPoint, keep, stack);
+		Segment seg = segs[first];
+		for (size_t ix = 1; ix < nPoints; ix++) {
+			if (keep[ix]) {
+				std::pair<float, float> p = getPoint(ix);
+				seg.x2 = p.first;
+				seg.y2 = p.second;
+				result.push_back(seg);
+				seg.x1 = seg.x2;
+				seg.y1 = seg.y2;
+			}
+		}
+		first = end;
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+#ifndef SIMPLIFIER_H
+#define SIMPLIFIER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Line simplification for the vector exports. Curves drawn by loops like
+ * forward(1); left(1) consist of long chains of tiny segments, which can be
+ * replaced by far fewer ones without a visible difference. The simplifier
+ * splits the segments into polylines (runs of consecutive connected segments
+ * of the same colour) and reduces each of them by the Ramer-Douglas-Peucker
+ * algorithm: only vertices deviating more than the tolerance (turtle units,
+ * i.e. pixels at scale 1) from the simplified line are kept, the end points
+ * always are. Polylines are cut at chunk borders, so the chunks can be
+ * simplified concurrently (via an ExportPipeline) and in a deterministic way.
+ * The segment counts before and after are summed up for the reduction ratio.
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (simplified vector export)
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "SegmentStore.h"
+
+class ExportPipeline;
+
+class Simplifier
+{
+public:
+	// Prepares the simplification with the given tolerance (turtle units, > 0)
+	explicit Simplifier(float tolerance);
+
+	// Returns the tolerance
+	inline float getTolerance() const { return this->tolerance; }
+
+	/* Appends views of the simplified chunks to simplified (the firstIndex fields
+	 * enumerate the remaining segments), whose segments are held by new elements
+	 * of storage; the chunks are simplified concurrently if a pipeline is given */
+	void simplifyChunks(const std::vector<SegmentChunkView>& chunks, std::vector<SegmentChunkView>& simplified,
+		std::vector<std::vector<Segment>>& storage, const ExportPipeline* pPipeline = nullptr);
+
+	/* Reduces the polyline with nPoints vertices (objects with float members x and y)
+	 * at points in place to the vertices to be kept, returns their number */
+	template<class Point>
+	size_t reduce(Point* points, size_t nPoints) const
+	{
+		std::vector<bool> keep;
+		std::vector<std::pair<size_t, size_t>> stack;
+		this->markVertices(nPoints, [points](size_t ix) { return std::make_pair(points[ix].x, points[ix].y); },
+			keep, stack);
+		size_t nKept = 0;
+		for (size_t ix = 0; ix < nPoints; ix++) {
+			if (keep[ix]) {
+				points[nKept++] = points[ix];
+			}
+		}
+		return nKept;
+	}
+
+	// Adds nBefore and nAfter to the segment counts (for simplifications done via reduce())
+	void count(uint64_t nBefore, uint64_t nAfter);
+	// Returns the number of segments passed to the simplification so far
+	inline uint64_t getInputCount() const { return this->nInput; }
+	// Returns the number of segments produced by the simplification so far
+	inline uint64_t getOutputCount() const { return this->nOutput; }
+	// Returns the ratio of produced and passed segments (1 if there weren't any)
+	double getReductionRatio() const;
+
+private:
+	const float tolerance;
+	std::atomic<uint64_t> nInput, nOutput;	// Segment counts (updated concurrently)
+
+	/* Marks the vertices of the polyline with nPoints vertices (as returned by
+	 * getPoint(ix)) to be kept in keep; stack is just working memory */
+	template<class GetPoint>
+	void markVertices(size_t nPoints, const GetPoint& getPoint, std::vector<bool>& keep,
+		std::vector<std::pair<size_t, size_t>>& stack) const
+	{
+		keep.assign(nPoints, false);
+		if (nPoints == 0) {
+			return;
+		}
+		keep.front() = keep.back() = true;
+		const double tol2 = (double)this->tolerance * this->tolerance;
+		// Iterative Ramer-Douglas-Peucker (a recursion might run out of stack)
+		stack.clear();
+		if (nPoints > 2) {
+			stack.push_back(std::make_pair((size_t)0, nPoints - 1));
+		}
+		while (!stack.empty()) {
+			size_t first = stack.back().first, last = stack.back().second;
+			stack.pop_back();
+			std::pair<float, float> a = getPoint(first), b = getPoint(last);
+			double dx = (double)b.first - a.first, dy = (double)b.second - a.second;
+			double len2 = dx * dx + dy * dy;
+			double maxDist2 = -1.0;
+			size_t ixMax = first;
+			for (size_t ix = first + 1; ix < last; ix++) {
+				std::pair<float, float> p = getPoint(ix);
+				double px = (double)p.first - a.first, py = (double)p.second - a.second;
+				// Distance to the line segment (not the infinite line), so reversals are kept
+				double t = len2 > 0 ? (px * dx + py * dy) / len2 : 0.0;
+				t = t < 0 ? 0 : (t > 1 ? 1 : t);
+				double ex = px - t * dx, ey = py - t * dy;
+				double dist2 = ex * ex + ey * ey;
+				if (dist2 > maxDist2) {
+					maxDist2 = dist2;
+					ixMax = ix;
+				}
+			}
+			if (maxDist2 > tol2) {
+				keep[ixMax] = true;
+				if (ixMax - first > 1) {
+					stack.push_back(std::make_pair(first, ixMax));
+				}
+				if (last - ixMax > 1) {
+					stack.push_back(std::make_pair(ixMax, last));
+				}
+			}
+		}
+	}
+
+	// Appends the simplified segments of chunk to result
+	void simplifyChunk(const SegmentChunkView& chunk, std::vector<Segment>& result) const;
+
+	Simplifier(const Simplifier&) = delete;
+	Simplifier& operator=(const Simplifier&) = delete;
+};
+
+#endif /*SIMPLIFIER_H*/
@@ -0,0 +1,514 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Buffered emitter for the SVG export of turtle drawings.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   writeDocumentEnd() tells whether the document was written completely
+ * 2026-10-18   Colour classes adoptable from another writer (merged side files)
+ * 2026-10-18   Fragment writers for the concurrent formatting of chunks
+ * 2026-10-18   Optional gzip compression on the fly (svgz)
+ * 2026-10-18   Compact mode with precision control and viewBox scaling
+ * 2026-10-18   Created for VERSION 11.1.0 (high-throughput SVG export)
+ */
+
+#include "SvgWriter.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+SvgWriter::SvgWriter(std::ostream& out, int precision, int compression)
+	: SvgWriter(out, precision, BUFFER_SIZE, nullptr, nullptr)
+{
+	if (compression != NO_COMPRESSION) {
+		this->pSink.reset(new StreamSink(out));
+		this->pDeflater.reset(new Deflater(*this->pSink, compression, Deflater::GZIP));
+	}
+}
+
+SvgWriter::SvgWriter(std::string& text, const SvgWriter& master)
+	: SvgWriter(master.out, master.precision, FRAGMENT_BUFFER_SIZE, &text, &master)
+{
+	this->scale = master.scale;
+}
+
+SvgWriter::SvgWriter(std::ostream& out, int precision, size_t bufferSize,
+	std::string* pText, const SvgWriter* pMaster)
+	: out(out)
+	, buffer(bufferSize)
+	, nFlushed(0)
+	, pText(pText)
+	, pMaster(pMaster)
+	, precision(precision < 0 ? PRECISION_COMPATIBLE : (precision > MAX_PRECISION ? MAX_PRECISION : precision))
+	, gridFactor(1.0)
+	, gridUnit(1)
+	, offsetX(0.0f)
+	, offsetY(0.0f)
+	, scale(1.0f)
+	, maxPoints(0)
+	, nPoints(0)
+	, lastX(0.0f)
+	, lastY(0.0f)
+	, lastARGB(0)
+	, isPathOpen(false)
+	, gridX(0)
+	, gridY(0)
+	, lastCommand('\0')
+	, needsSeparator(false)
+	, lastClass(0)
+{
+	this->pos = this->buffer.data();
+	this->limit = this->buffer.data() + bufferSize - MAX_ITEM_SIZE;
+	for (int i = 0; i < this->precision; i++) {
+		this->gridUnit *= 10;
+	}
+	this->gridFactor = (double)this->gridUnit;
+}
+
+SvgWriter::~SvgWriter()
+{
+	this->flush();
+	if (this->pDeflater) {
+		this->pDeflater->finish();
+	}
+}
+
+bool SvgWriter::flush()
+{
+	if (this->pos > this->buffer.data()) {
+		if (this->pText != nullptr) {
+			this->pText->append(this->buffer.data(), this->pos - this->buffer.data());
+		}
+		else if (this->pDeflater) {
+			this->pDeflater->write(this->buffer.data(), this->pos - this->buffer.data());
+		}
+		else {
+			this->out.write(this->buffer.data(), this->pos - this->buffer.data());
+		}
+		this->nFlushed += this->pos - this->buffer.data();
+		this->pos = this->buffer.data();
+	}
+	return this->out.good();
+}
+
+uint64_t SvgWriter::getBytesWritten() const
+{
+	return this->nFlushed + (this->pos - this->buffer.data());
+}
+
+uint64_t SvgWriter::getBytesOut() const
+{
+	if (this->pDeflater) {
+		return this->pDeflater->getTotalOut();
+	}
+	return this->nFlushed;
+}
+
+void SvgWriter::append(const char* text)
+{
+	this->append(text, strlen(text));
+}
+
+void SvgWriter::append(const char* text, size_t length)
+{
+	while (length > 0) {
+		this->reserve();
+		size_t n = this->buffer.data() + this->buffer.size() - this->pos;
+		if (n > length) {
+			n = length;
+		}
+		memcpy(this->pos, text, n);
+		this->pos += n;
+		text += n;
+		length -= n;
+	}
+}
+
+void SvgWriter::writeText(const char* text, size_t length)
+{
+	this->append(text, length);
+}
+
+void SvgWriter::appendInt(long long value)
+{
+	this->reserve();
+	this->pos = std::to_chars(this->pos, this->pos + MAX_ITEM_SIZE, value).ptr;
+}
+
+void SvgWriter::appendPadded(long long value, int width)
+{
+	this->reserve();
+	char digits[24];
+	char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+	int nDigits = (int)(end - digits);
+	// (Like an ostream with fill '0', we just pad on the left, even before a sign)
+	for (int i = nDigits; i < width; i++) {
+		*this->pos++ = '0';
+	}
+	memcpy(this->pos, digits, nDigits);
+	this->pos += nDigits;
+}
+
+void SvgWriter::appendHex6(uint32_t value)
+{
+	static const char HEX_DIGITS[] = "0123456789abcdef";
+	this->reserve();
+	for (int shift = 20; shift >= 0; shift -= 4) {
+		*this->pos++ = HEX_DIGITS[(value >> shift) & 0xF];
+	}
+}
+
+void SvgWriter::appendFloat(float value)
+{
+	this->reserve();
+	this->pos = std::to_chars(this->pos, this->pos + MAX_ITEM_SIZE, value,
+		std::chars_format::general, 6).ptr;
+}
+
+void SvgWriter::appendEscaped(const char* text)
+{
+	for (const char* pChar = text; *pChar != '\0'; pChar++) {
+		switch (*pChar) {
+		case '&': this->append("&amp;"); break;
+		case '<': this->append("&lt;"); break;
+		case '>': this->append("&gt;"); break;
+		default:
+			this->reserve();
+			*this->pos++ = *pChar;
+		}
+	}
+}
+
+void SvgWriter::writeDocumentStart(float width, float height, float scale, const char* title, uint32_t bgRGB)
+{
+	this->scale = scale;
+	if (this->precision != PRECISION_COMPATIBLE) {
+		this->writeDocumentStartCompact(width, height, scale, title, bgRGB);
+		return;
+	}
+	long pxWidth = (long)ceil(width * scale);
+	long pxHeight = (long)ceil(height * scale);
+	this->append("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n");
+	this->append("<!-- Created with Turtleizer_CPP (https://github.com/codemanyak/Turtleizer_CPP) -->\n");
+	this->append("<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"");
+	this->appendInt(pxWidth);
+	this->append("\" height=\"");
+	this->appendInt(pxHeight);
+	this->append("\">\n");
+	this->append("  <title>");
+	this->appendEscaped(title);
+	this->append("</title>\n");
+
+	/* Draw the background:
+	 * The fill colour must not be given as hex code, otherwise the rectangle
+	 * will always be black! */
+	this->append("    <rect style=\"fill:rgb(");
+	this->appendInt((bgRGB >> 16) & 0xFF);
+	this->append(",");
+	this->appendInt((bgRGB >> 8) & 0xFF);
+	this->append(",");
+	this->appendInt(bgRGB & 0xFF);
+	this->append(");fill-opacity:1\"  x=\"0\" y=\"0\" width=\"");
+	this->appendInt(pxWidth);
+	this->append("\" height=\"");
+	this->appendInt(pxHeight);
+	this->append("\" id=\"background\"/>\n");
+
+	// Now the group for the elements
+	this->append("  <g id=\"elements\" style=\"fill:none;stroke-width:");
+	this->appendFloat(scale);
+	this->append("px;stroke-opacity:1:stroke-linejoin:miter\">\n");
+}
+
+void SvgWriter::writeDocumentStartCompact(float width, float height, float scale, const char* title, uint32_t bgRGB)
+{
+	long pxWidth = (long)ceil(width * scale);
+	long pxHeight = (long)ceil(height * scale);
+	this->append("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n");
+	this->append("<!-- Created with Turtleizer_CPP (https://github.com/codemanyak/Turtleizer_CPP) -->\n");
+	this->append("<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"");
+	this->appendInt(pxWidth);
+	this->append("\" height=\"");
+	this->appendInt(pxHeight);
+	// The viewBox does the scaling, such that the coordinates remain turtle units
+	this->append("\" viewBox=\"0 0 ");
+	this->appendFloat(pxWidth / scale);
+	this->append(" ", 1);
+	this->appendFloat(pxHeight / scale);
+	this->append("\">\n");
+	this->append("  <title>");
+	this->appendEscaped(title);
+	this->append("</title>\n");
+	this->append("  <rect width=\"100%\" height=\"100%\" style=\"fill:rgb(");
+	this->appendInt((bgRGB >> 16) & 0xFF);
+	this->append(",");
+	this->appendInt((bgRGB >> 8) & 0xFF);
+	this->append(",");
+	this->appendInt(bgRGB & 0xFF);
+	this->append(")\"/>\n");
+	this->append("  <g style=\"fill:none;stroke-width:1;stroke-linejoin:miter\">\n");
+}
+
+bool SvgWriter::writeDocumentEnd()
+{
+	this->append("  </g>\n");
+	if (this->precision != PRECISION_COMPATIBLE && !this->palette.empty()) {
+		// Style sheets apply to the entire document, wherever they are placed
+		this->append("  <style>\n");
+		for (size_t i = 0; i < this->palette.size(); i++) {
+			this->append("    .c", 6);
+			this->appendInt(i);
+			this->append("{stroke:#", 9);
+			this->appendHex6(this->palette[i]);
+			this->append("}\n", 2);
+		}
+		this->append("  </style>\n");
+	}
+	this->append("</svg>\n");
+	bool okay = this->flush();
+	if (this->pDeflater) {
+		// The trailer (CRC and length) is written to the stream here
+		this->pDeflater->finish();
+	}
+	this->out.flush();
+	return okay && this->out.good();
+}
+
+void SvgWriter::beginPaths(float offsetX, float offsetY, int maxPoints)
+{
+	this->offsetX = offsetX;
+	this->offsetY = offsetY;
+	this->maxPoints = maxPoints;
+	this->nPoints = 0;
+	this->isPathOpen = false;
+}
+
+void SvgWriter::resumePaths(float offsetX, float offsetY, int maxPoints, size_t index, const Segment* pPrevious)
+{
+	this->beginPaths(offsetX, offsetY, maxPoints);
+	if (index == 0 || pPrevious == nullptr) {
+		return;
+	}
+	// Everything the path logic depends on can be derived from the predecessor
+	this->nPoints = (int)index;
+	this->lastX = pPrevious->x2;
+	this->lastY = pPrevious->y2;
+	if (this->precision == PRECISION_COMPATIBLE) {
+		this->lastARGB = pPrevious->argb;
+	}
+	else {
+		this->lastARGB = pPrevious->argb & 0xFFFFFF;
+		this->lastClass = this->getColourClass(this->lastARGB);
+		// (The position is always that of the predecessor's end on the grid)
+		this->gridX = this->toGrid(pPrevious->x2, offsetX);
+		this->gridY = this->toGrid(pPrevious->y2, offsetY);
+		this->isPathOpen = true;
+	}
+}
+
+void SvgWriter::registerColours(const Segment* segments, size_t count)
+{
+	if (this->precision == PRECISION_COMPATIBLE || this->pMaster != nullptr) {
+		return;
+	}
+	uint32_t lastRGB = 0;
+	for (size_t i = 0; i < count; i++) {
+		uint32_t rgb = segments[i].argb & 0xFFFFFF;
+		if (i == 0 || rgb != lastRGB) {
+			this->getColourClass(rgb);
+			lastRGB = rgb;
+		}
+	}
+}
+
+void SvgWriter::adoptColours(const SvgWriter& other)
+{
+	this->colourClasses = other.colourClasses;
+	this->palette = other.palette;
+}
+
+void SvgWriter::addSegments(const Segment* segments, size_t count)
+{
+	if (this->precision != PRECISION_COMPATIBLE) {
+		this->addSegmentsCompact(segments, count);
+		return;
+	}
+	const float scale = this->scale;
+	for (size_t i = 0; i < count; i++) {
+		const Segment& seg = segments[i];
+		// (As nPoints is never reset, once maxPoints has been reached every further
+		// segment gets a path of its own - we retain this behaviour of the former
+		// export for the sake of identical output.)
+		if (this->nPoints == 0 || this->lastX != seg.x1 || this->lastY != seg.y1
+			|| this->lastARGB != seg.argb
+			|| this->nPoints >= this->maxPoints) {
+			if (this->nPoints > 0) {
+				// End the previous path
+				this->append("\" />\n");
+			}
+			// Start a new path
+			this->append("    <path\n      style=\"stroke:#");
+			this->appendHex6(seg.argb);
+			this->append("\"\n      id=\"path");
+			this->appendPadded(this->nPoints, 5);
+			this->append("\"\n      d=\"m ");
+			this->appendFloat((seg.x1 + this->offsetX) * scale);
+			this->append(",", 1);
+			this->appendFloat((seg.y1 + this->offsetY) * scale);
+			this->append(" ", 1);
+		}
+		this->appendFloat((seg.x2 - seg.x1) * scale);
+		this->append(",", 1);
+		this->appendFloat((seg.y2 - seg.y1) * scale);
+		this->append(" ", 1);
+		this->lastX = seg.x2;
+		this->lastY = seg.y2;
+		this->lastARGB = seg.argb;
+		this->nPoints++;
+	}
+}
+
+void SvgWriter::endPaths()
+{
+	if (this->precision != PRECISION_COMPATIBLE) {
+		if (this->isPathOpen) {
+			this->append("\"/>\n", 4);
+		}
+		this->isPathOpen = false;
+	}
+	else if (this->nPoints > 0) {
+		this->append("\" />\n");
+	}
+	this->nPoints = 0;
+}
+
+unsigned int SvgWriter::getColourClass(uint32_t rgb)
+{
+	if (this->pMaster != nullptr) {
+		// The master's palette must have been completed by registerColours()
+		auto it = this->pMaster->colourClasses.find(rgb);
+		return (it != this->pMaster->colourClasses.end()) ? it->second : 0;
+	}
+	auto it = this->colourClasses.find(rgb);
+	if (it != this->colourClasses.end()) {
+		return it->second;
+	}
+	unsigned int ix = (unsigned int)this->palette.size();
+	this->colourClasses[rgb] = ix;
+	this->palette.push_back(rgb);
+	return ix;
+}
+
+void SvgWriter::appendCommand(char cmd)
+{
+	if (cmd != this->lastCommand) {
+		this->reserve();
+		*this->pos++ = cmd;
+		this->lastCommand = cmd;
+		this->needsSeparator = false;
+	}
+}
+
+void SvgWriter::appendGridValue(long long value)
+{
+	this->reserve();
+	char* p = this->pos;
+	// A minus sign separates the number from its predecessor as well
+	if (value < 0) {
+		*p++ = '-';
+		value = -value;
+	}
+	else if (this->needsSeparator) {
+		*p++ = ' ';
+	}
+	long long intPart = value / this->gridUnit;
+	long long fraction = value % this->gridUnit;
+	// Leading zeros are omitted (".5"), trailing zeros of the fraction as well
+	if (intPart != 0 || fraction == 0) {
+		p = std::to_chars(p, p + 24, intPart).ptr;
+	}
+	if (fraction != 0) {
+		int nDigits = this->precision;
+		while (fraction % 10 == 0) {
+			fraction /= 10;
+			nDigits--;
+		}
+		*p++ = '.';
+		for (int i = nDigits - 1; i >= 0; i--) {
+			p[i] = (char)('0' + fraction % 10);
+			fraction /= 10;
+		}
+		p += nDigits;
+	}
+	this->pos = p;
+	this->needsSeparator = true;
+}
+
+void SvgWriter::addSegmentsCompact(const Segment* segments, size_t count)
+{
+	/* Each call starts with explicit commands, such that the output of a chunk
+	 * does not depend on the commands of preceding chunks (see resumePaths()) */
+	this->lastCommand = '\0';
+	for (size_t i = 0; i < count; i++) {
+		const Segment& seg = segments[i];
+		uint32_t rgb = seg.argb & 0xFFFFFF;
+		long long x1 = this->toGrid(seg.x1, this->offsetX);
+		long long y1 = this->toGrid(seg.y1, this->offsetY);
+		if (!this->isPathOpen || rgb != this->lastARGB) {
+			if (this->isPathOpen) {
+				this->append("\"/>\n", 4);
+			}
+			this->lastClass = this->getColourClass(rgb);
+			this->lastARGB = rgb;
+			this->append("    <path class=\"c", 18);
+			this->appendInt(this->lastClass);
+			this->append("\" d=\"", 5);
+			this->lastCommand = '\0';
+			this->appendCommand('M');
+			this->appendGridValue(x1);
+			this->appendGridValue(y1);
+			// Implicit successors of M would be absolute, so we note a pseudo command
+			this->lastCommand = 'L';
+			this->gridX = x1;
+			this->gridY = y1;
+			this->isPathOpen = true;
+		}
+		else if (x1 != this->gridX || y1 != this->gridY) {
+			// Gap within the same colour: move relatively
+			this->appendCommand('m');
+			this->appendGridValue(x1 - this->gridX);
+			this->appendGridValue(y1 - this->gridY);
+			// Implicit successors of m are relative lines
+			this->lastCommand = 'l';
+			this->gridX = x1;
+			this->gridY = y1;
+		}
+		long long dx = this->toGrid(seg.x2, this->offsetX) - this->gridX;
+		long long dy = this->toGrid(seg.y2, this->offsetY) - this->gridY;
+		if (dx == 0 && dy == 0) {
+			// Vanishes on the grid
+			continue;
+		}
+		if (dy == 0) {
+			this->appendCommand('h');
+			this->appendGridValue(dx);
+		}
+		else if (dx == 0) {
+			this->appendCommand('v');
+			this->appendGridValue(dy);
+		}
+		else {
+			this->appendCommand('l');
+			this->appendGridValue(dx);
+			this->appendGridValue(dy);
+		}
+		this->gridX += dx;
+		this->gridY += dy;
+	}
+}
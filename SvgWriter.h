@@ -0,0 +1,185 @@
+#pragma once
+#ifndef SVGWRITER_H
+#define SVGWRITER_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Buffered emitter for the SVG export of turtle drawings. Numbers are formatted
+ * with std::to_chars (no locale, no stream state) into a large reusable buffer,
+ * which is passed to the output stream in big blocks.
+ * In compatible mode (PRECISION_COMPATIBLE) the produced text is the same as the
+ * former iostream-based export did write (float coordinates in "%g" style, i.e.
+ * 6 significant digits), except for the title, which now holds the file name
+ * instead of a pointer value.
+ * In compact mode (precision 0 ... MAX_PRECISION decimals) the coordinates are
+ * rounded to a fixed grid, the scale is left to a viewBox, paths consist of the
+ * shortest relative commands (h, v, l, m for gaps) and the stroke colours are
+ * referred to via CSS classes, one per colour in use.
+ * With a compression level given, the text is gzip-compressed on the fly (the
+ * result being an .svgz file), in which case the stream must be binary.
+ * For concurrent formatting, fragment writers may format chunks of segments into
+ * separate texts (resumePaths() derives the path state from the predecessor of
+ * the chunk), which are then passed to the master writer in order (writeText()).
+ * This file deliberately does without WinAPI and GDI+ dependencies.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   writeDocumentEnd() tells whether the document was written completely
+ * 2026-10-18   Colour classes adoptable from another writer (merged side files)
+ * 2026-10-18   Fragment writers for the concurrent formatting of chunks
+ * 2026-10-18   Optional gzip compression on the fly (svgz)
+ * 2026-10-18   Compact mode with precision control and viewBox scaling
+ * 2026-10-18   Created for VERSION 11.1.0 (high-throughput SVG export)
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Deflate.h"
+#include "SegmentStore.h"
+
+class SvgWriter
+{
+public:
+	static const size_t BUFFER_SIZE = 1 << 20;	// Size of the output buffer
+	static const int PRECISION_COMPATIBLE = -1;	// Precision value for the former output format
+	static const int MAX_PRECISION = 6;			// Maximum number of decimals in compact mode
+	static const int NO_COMPRESSION = -1;		// Compression value for plain SVG output
+
+	/* Prepares the emission to the stream out, either in compatible mode or with
+	 * coordinates rounded to precision decimals (compact mode); unless compression
+	 * is NO_COMPRESSION, the output is gzip-compressed with this level (0 ... 9) */
+	explicit SvgWriter(std::ostream& out, int precision = PRECISION_COMPATIBLE,
+		int compression = NO_COMPRESSION);
+	/* Prepares a fragment writer appending to text, with the settings (and the
+	 * colour classes) of master, for a concurrent formatting of path chunks */
+	SvgWriter(std::string& text, const SvgWriter& master);
+	// Flushes the buffer (and terminates the compressed stream)
+	~SvgWriter();
+
+	/* Writes the XML prologue, the svg start tag for a picture of width x height
+	 * (in turtle units) to be scaled by scale, with given title (UTF-8), the
+	 * background rectangle in colour bgRGB (0xRRGGBB) and the start tag of the
+	 * element group. In compatible mode, scale should be integral since it is
+	 * applied to every coordinate, in compact mode it may be any positive value */
+	void writeDocumentStart(float width, float height, float scale, const char* title, uint32_t bgRGB);
+	/* Closes the element group (adds the colour classes in compact mode) and the
+	 * svg element, terminates the compressed stream if any; returns false if the
+	 * stream failed (e.g. the disk was full), i.e. the document is incomplete */
+	bool writeDocumentEnd();
+
+	/* Prepares the path output for the elements of a turtle, which are to be
+	 * shifted by (offsetX, offsetY); in compatible mode a new path is started
+	 * after maxPoints points */
+	void beginPaths(float offsetX, float offsetY, int maxPoints);
+	/* Like beginPaths(), but prepares the continuation with the segment of number
+	 * index (within the elements of the turtle), preceded by *pPrevious, as if
+	 * all segments up to *pPrevious had been added before */
+	void resumePaths(float offsetX, float offsetY, int maxPoints, size_t index, const Segment* pPrevious);
+	/* Assigns colour classes to the colours of the given segments in advance
+	 * (needed in compact mode before fragment writers are used) */
+	void registerColours(const Segment* segments, size_t count);
+	/* Takes over the colour classes of other, whose paths are to be merged via
+	 * writeText() (e.g. from a side file), in place of any own ones */
+	void adoptColours(const SvgWriter& other);
+	// Adds the given count segments to the paths, starting new paths where necessary
+	void addSegments(const Segment* segments, size_t count);
+	// Terminates the current path (if any)
+	void endPaths();
+
+	// Appends already formatted text (e.g. that of a fragment writer)
+	void writeText(const char* text, size_t length);
+	// Passes the buffered text to the stream, returns false if the stream failed
+	bool flush();
+	// Returns the number of bytes produced so far (including the buffered ones)
+	uint64_t getBytesWritten() const;
+	// Returns the number of bytes passed to the stream (differs if compressed)
+	uint64_t getBytesOut() const;
+
+private:
+	static const size_t MAX_ITEM_SIZE = 256;	// Buffer reserve for a single item
+	static const size_t FRAGMENT_BUFFER_SIZE = 1 << 16;	// Buffer size of fragment writers
+
+	std::ostream& out;
+	std::vector<char> buffer;
+	char* pos;				// Current write position in buffer
+	char* limit;			// Flush threshold (leaves MAX_ITEM_SIZE bytes)
+	uint64_t nFlushed;		// Number of bytes passed to the stream (or the deflater)
+	std::unique_ptr<StreamSink> pSink;		// Stream adapter for the deflater
+	std::unique_ptr<Deflater> pDeflater;	// Compressor (if gzip output is wanted)
+	std::string* const pText;				// Target text of a fragment writer
+	const SvgWriter* const pMaster;			// Owner of the colour classes for a fragment writer
+	const int precision;	// Number of decimals (PRECISION_COMPATIBLE for former format)
+	double gridFactor;		// Multiplier from turtle units to grid units (compact mode)
+	long long gridUnit;		// Grid units per turtle unit as integer (compact mode)
+	// Path state
+	float offsetX, offsetY;
+	float scale;
+	int maxPoints;
+	int nPoints;			// Points written for the current turtle (also used in path ids)
+	float lastX, lastY;		// End of the previous segment
+	uint32_t lastARGB;		// Colour of the previous segment
+	// Compact path state
+	bool isPathOpen;		// Whether a path element has been started
+	long long gridX, gridY;	// Current path position in grid units
+	char lastCommand;		// Most recent path command (implicitly repeated)
+	bool needsSeparator;	// Whether a non-negative number must be preceded by a blank
+	std::unordered_map<uint32_t, unsigned int> colourClasses;	// Class index per RGB value
+	std::vector<uint32_t> palette;	// RGB values in order of class index
+	unsigned int lastClass;	// Class index of lastARGB
+
+	// Common constructor part
+	SvgWriter(std::ostream& out, int precision, size_t bufferSize,
+		std::string* pText, const SvgWriter* pMaster);
+
+	// Makes sure there is room for another item
+	inline void reserve()
+	{
+		if (pos >= limit) {
+			flush();
+		}
+	}
+	// Appends the given literal text
+	void append(const char* text);
+	void append(const char* text, size_t length);
+	// Appends the decimal representation of value
+	void appendInt(long long value);
+	// Appends value with at least width digits (padded with zeros)
+	void appendPadded(long long value, int width);
+	// Appends the lower 24 bits of value as six lowercase hex digits
+	void appendHex6(uint32_t value);
+	// Appends value like an ostream with default settings would ("%g")
+	void appendFloat(float value);
+	// Appends text with XML special characters escaped
+	void appendEscaped(const char* text);
+
+	// Compact mode counterparts of addSegments() and the document frame
+	void addSegmentsCompact(const Segment* segments, size_t count);
+	void writeDocumentStartCompact(float width, float height, float scale, const char* title, uint32_t bgRGB);
+	// Converts a turtle coordinate into grid units
+	inline long long toGrid(float coord, float offset) const
+	{
+		double value = ((double)coord + offset) * gridFactor;
+		return (long long)(value < 0 ? value - 0.5 : value + 0.5);
+	}
+	// Appends the path command cmd unless it would be implicitly repeated
+	void appendCommand(char cmd);
+	// Appends a coordinate given in grid units in shortest decimal form
+	void appendGridValue(long long value);
+	// Returns the class index for the colour rgb, registering it if necessary
+	unsigned int getColourClass(uint32_t rgb);
+
+	SvgWriter(const SvgWriter&) = delete;
+	SvgWriter& operator=(const SvgWriter&) = delete;
+};
+
+#endif /*SVGWRITER_H*/
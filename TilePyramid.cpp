@@ -0,0 +1,304 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Deep-zoom export of huge drawings (tile pyramid in the Deep Zoom layout),
+ * see TilePyramid.h
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (deep-zoom tile pyramid export)
+ */
+
+#include "TilePyramid.h"
+#include "Turtle.h"
+#include "ExportPipeline.h"
+#include "PngEncoder.h"
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+TilePyramid::TilePyramid(const RectF& bounds, Color background, float scale)
+	: bounds(bounds)
+	, background(background)
+	, scale(scale)
+	, width(0)
+	, height(0)
+	, nLevels(0)
+	, nWritten(0)
+	, nSkipped(0)
+{
+	double dWidth = ceil(bounds.Width * scale);
+	double dHeight = ceil(bounds.Height * scale);
+	// Same limits as with the image export
+	if (scale > 0 && dWidth >= 1 && dHeight >= 1 && dWidth <= INT_MAX && dHeight <= INT_MAX) {
+		this->width = (UINT)dWidth;
+		this->height = (UINT)dHeight;
+		// Level 0 is a single pixel, the last level has the full size
+		UINT extent = (std::max)(this->width, this->height);
+		this->nLevels = 1;
+		while (((uint64_t)1 << (this->nLevels - 1)) < extent) {
+			this->nLevels++;
+		}
+	}
+}
+
+void TilePyramid::addLayer(const std::vector<SegmentChunkView>& chunks)
+{
+	this->layers.push_back(chunks);
+}
+
+unsigned int TilePyramid::getLevelCount() const
+{
+	return this->nLevels;
+}
+
+void TilePyramid::getLevelSize(unsigned int level, UINT& width, UINT& height) const
+{
+	// Halved (rounding up) for every level below the last one
+	unsigned int shift = this->nLevels - 1 - level;
+	width = (UINT)(((uint64_t)this->width + ((uint64_t)1 << shift) - 1) >> shift);
+	height = (UINT)(((uint64_t)this->height + ((uint64_t)1 << shift) - 1) >> shift);
+}
+
+REAL TilePyramid::getLevelScale(unsigned int level) const
+{
+	return (REAL)ldexp(this->scale, -(int)(this->nLevels - 1 - level));
+}
+
+void TilePyramid::collectTiles(unsigned int level, std::vector<Tile>& tiles) const
+{
+	UINT levelWidth, levelHeight;
+	this->getLevelSize(level, levelWidth, levelHeight);
+	const UINT nCols = (levelWidth + TILE_SIZE - 1) / TILE_SIZE;
+	const UINT nRows = (levelHeight + TILE_SIZE - 1) / TILE_SIZE;
+	const double levelScale = this->getLevelScale(level);
+	// Tolerance in pixels for the pen width and the antialiasing
+	const double margin = 1.0;
+	std::vector<bool> isTouched((size_t)nCols * nRows, false);
+
+	// Computes the tile range covered by box b, returns false if it's outside
+	auto getRange = [&](const SegmentBounds& b, UINT& col0, UINT& col1, UINT& row0, UINT& row1) -> bool {
+		double x0 = (b.left - this->bounds.X) * levelScale - margin;
+		double x1 = (b.right - this->bounds.X) * levelScale + margin;
+		double y0 = (b.top - this->bounds.Y) * levelScale - margin;
+		double y1 = (b.bottom - this->bounds.Y) * levelScale + margin;
+		if (x1 < 0 || y1 < 0 || x0 >= levelWidth || y0 >= levelHeight) {
+			return false;
+		}
+		col0 = (UINT)((std::max)(x0, 0.0) / TILE_SIZE);
+		col1 = (UINT)((std::min)(x1, levelWidth - 1.0) / TILE_SIZE);
+		row0 = (UINT)((std::max)(y0, 0.0) / TILE_SIZE);
+		row1 = (UINT)((std::min)(y1, levelHeight - 1.0) / TILE_SIZE);
+		return true;
+	};
+	auto mark = [&](UINT col0, UINT col1, UINT row0, UINT row1) {
+		for (UINT row = row0; row <= row1; row++) {
+			for (UINT col = col0; col <= col1; col++) {
+				isTouched[(size_t)row * nCols + col] = true;
+			}
+		}
+	};
+
+	UINT col0, col1, row0, row1;
+	for (const std::vector<SegmentChunkView>& chunks : this->layers) {
+		for (const SegmentChunkView& chunk : chunks) {
+			if (chunk.bounds.isEmpty() || !getRange(chunk.bounds, col0, col1, row0, row1)) {
+				continue;
+			}
+			// A chunk within a few tiles is taken as a whole, otherwise segment by segment
+			if ((uint64_t)(col1 - col0 + 1) * (row1 - row0 + 1) <= 4) {
+				mark(col0, col1, row0, row1);
+				continue;
+			}
+			for (size_t i = 0; i < chunk.count; i++) {
+				SegmentBounds segBounds = SegmentBounds::empty();
+				segBounds.include(chunk.segments[i]);
+				if (getRange(segBounds, col0, col1, row0, row1)) {
+					mark(col0, col1, row0, row1);
+				}
+			}
+		}
+	}
+	for (UINT row = 0; row < nRows; row++) {
+		for (UINT col = 0; col < nCols; col++) {
+			if (isTouched[(size_t)row * nCols + col]) {
+				tiles.push_back(Tile{ level, col, row });
+			}
+		}
+	}
+}
+
+bool TilePyramid::renderTile(const Tile& tile, std::string& text) const
+{
+	UINT levelWidth, levelHeight;
+	this->getLevelSize(tile.level, levelWidth, levelHeight);
+	const UINT x0 = tile.col * TILE_SIZE, y0 = tile.row * TILE_SIZE;
+	const UINT tileWidth = (std::min)(TILE_SIZE, levelWidth - x0);
+	const UINT tileHeight = (std::min)(TILE_SIZE, levelHeight - y0);
+	const REAL levelScale = this->getLevelScale(tile.level);
+
+	// Every tile gets its own bitmap and graphics, so workers don't share GDI+ objects
+	Bitmap bitmap((INT)tileWidth, (INT)tileHeight, PixelFormat32bppRGB);
+	if (bitmap.GetLastStatus() != Ok) {
+		return false;
+	}
+	Graphics gr(&bitmap);
+	gr.Clear(this->background);
+	gr.TranslateTransform(-(REAL)x0, -(REAL)y0);
+	gr.ScaleTransform(levelScale, levelScale);
+	gr.TranslateTransform(-this->bounds.X, -this->bounds.Y);
+	// Only lines touching the tile (with some tolerance for the pen width) matter
+	REAL margin = 1.0f + 1.0f / levelScale;
+	RectF clip(this->bounds.X + x0 / levelScale - margin, this->bounds.Y + y0 / levelScale - margin,
+		tileWidth / levelScale + 2 * margin, tileHeight / levelScale + 2 * margin);
+	for (const std::vector<SegmentChunkView>& chunks : this->layers) {
+		Turtle::drawChunks(gr, chunks, &clip);
+	}
+	gr.Flush(FlushIntentionSync);
+
+	BitmapData data;
+	Gdiplus::Rect rect(0, 0, (INT)tileWidth, (INT)tileHeight);
+	if (bitmap.LockBits(&rect, ImageLockModeRead, PixelFormat32bppRGB, &data) != Ok) {
+		return false;
+	}
+	// Scan for the palette (the alpha bytes of PixelFormat32bppRGB are undefined)
+	PngPalette palette;
+	std::vector<unsigned char> indices((size_t)tileWidth * tileHeight);
+	bool indexed = true;
+	for (UINT y = 0; indexed && y < tileHeight; y++) {
+		const uint32_t* pSrc = reinterpret_cast<const uint32_t*>(
+			static_cast<const unsigned char*>(data.Scan0) + (size_t)y * data.Stride);
+		indexed = palette.indexPixels(pSrc, tileWidth, &indices[(size_t)y * tileWidth], 0xFF000000);
+	}
+	// A tile with the background colour only is left out
+	if (indexed && palette.size() == 1 && palette.getColours()[0] == (this->background.GetValue() | 0xFF000000)) {
+		bitmap.UnlockBits(&data);
+		return true;
+	}
+	std::ostringstream out(std::ios::binary);
+	if (indexed) {
+		PngWriter png(out, tileWidth, tileHeight, palette);
+		for (UINT y = 0; y < tileHeight; y++) {
+			png.writeRow(&indices[(size_t)y * tileWidth]);
+		}
+		png.finish();
+	}
+	else {
+		PngWriter png(out, tileWidth, tileHeight, PngWriter::RGB);
+		std::vector<unsigned char> row(png.getRowSize());
+		for (UINT y = 0; y < tileHeight; y++) {
+			// Convert the BGRX pixels into RGB samples
+			const unsigned char* pSrc = static_cast<const unsigned char*>(data.Scan0) + (size_t)y * data.Stride;
+			unsigned char* pDest = row.data();
+			for (UINT x = 0; x < tileWidth; x++, pSrc += 4) {
+				*pDest++ = pSrc[2];
+				*pDest++ = pSrc[1];
+				*pDest++ = pSrc[0];
+			}
+			png.writeRow(row.data());
+		}
+		png.finish();
+	}
+	bitmap.UnlockBits(&data);
+	text = out.str();
+	return true;
+}
+
+bool TilePyramid::writeManifest(const std::wstring& path) const
+{
+	std::ofstream out(path.c_str(), std::ios::binary);
+	out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		<< "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" Format=\"png\" Overlap=\"0\" TileSize=\""
+		<< TILE_SIZE << "\">\n"
+		<< "  <Size Width=\"" << this->width << "\" Height=\"" << this->height << "\"/>\n"
+		<< "</Image>\n";
+	out.close();
+	return out.good();
+}
+
+bool TilePyramid::write(LPCWSTR basePath, const ExportPipeline* pPipeline)
+{
+	this->nWritten = 0;
+	this->nSkipped = 0;
+	if (this->nLevels == 0) {
+		return false;
+	}
+	// Cull the tiles of all levels, the coarse levels first
+	std::vector<Tile> tiles;
+	size_t nTiles = 0;
+	for (unsigned int level = 0; level < this->nLevels; level++) {
+		UINT levelWidth, levelHeight;
+		this->getLevelSize(level, levelWidth, levelHeight);
+		size_t nLevelTiles = (size_t)((levelWidth + TILE_SIZE - 1) / TILE_SIZE)
+			* ((levelHeight + TILE_SIZE - 1) / TILE_SIZE);
+		if (nLevelTiles > MAX_TILES_PER_LEVEL) {
+			return false;
+		}
+		nTiles += nLevelTiles;
+		this->collectTiles(level, tiles);
+	}
+	this->nSkipped = nTiles - tiles.size();
+
+	const std::wstring filesDir = std::wstring(basePath) + L"_files";
+	if (!CreateDirectoryW(filesDir.c_str(), NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+		return false;
+	}
+	std::vector<bool> hasLevelDir(this->nLevels, false);
+	std::atomic<bool> failed(false);
+	size_t nextTile = 0;		// Index of the tile passed to the consumer next
+
+	auto formatter = [&](size_t index, std::string& text) {
+		if (!this->renderTile(tiles[index], text)) {
+			failed = true;
+		}
+	};
+	auto consumer = [&](const char* text, size_t length) -> bool {
+		const Tile& tile = tiles[nextTile++];
+		if (failed) {
+			return false;
+		}
+		if (length == 0) {
+			this->nSkipped++;
+			return true;
+		}
+		std::wstring levelDir = filesDir + L"\\" + std::to_wstring(tile.level);
+		if (!hasLevelDir[tile.level]) {
+			if (!CreateDirectoryW(levelDir.c_str(), NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+				return false;
+			}
+			hasLevelDir[tile.level] = true;
+		}
+		std::wstring path = levelDir + L"\\" + std::to_wstring(tile.col) + L"_"
+			+ std::to_wstring(tile.row) + L".png";
+		std::ofstream out(path.c_str(), std::ios::binary);
+		out.write(text, length);
+		out.close();
+		if (!out.good()) {
+			return false;
+		}
+		this->nWritten++;
+		return true;
+	};
+
+	bool okay = true;
+	if (pPipeline != nullptr) {
+		okay = pPipeline->run(tiles.size(), formatter, consumer);
+	}
+	else {
+		std::string text;
+		for (size_t ix = 0; okay && ix < tiles.size(); ix++) {
+			text.clear();
+			formatter(ix, text);
+			okay = consumer(text.data(), text.size());
+		}
+	}
+	// The manifest comes last, so an incomplete pyramid won't be found by viewers
+	return okay && !failed && this->writeManifest(std::wstring(basePath) + L".dzi");
+}
@@ -0,0 +1,91 @@
+#pragma once
+#ifndef TILEPYRAMID_H
+#define TILEPYRAMID_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Deep-zoom export of huge drawings: the segment chunks of one or more layers
+ * (turtles) are rendered into a pyramid of 256 x 256 PNG tiles in the Deep Zoom
+ * layout (as understood by OpenSeadragon and other viewers):
+ *   <base>.dzi                          XML manifest (tile size, image size)
+ *   <base>_files/<level>/<col>_<row>.png  tiles, level 0 being a single pixel
+ * Every level has half the resolution of the one above it. Each level is drawn
+ * from the vectors at its own scale (no downsampling), so there is never more
+ * than one tile bitmap per worker thread in memory. Tiles not touched by any
+ * chunk are culled by the chunk and segment bounds, tiles rendering to plain
+ * background are skipped (the viewers show their background there).
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (deep-zoom tile pyramid export)
+ */
+
+#include <Windows.h>
+#include <gdiplus.h>
+#include <string>
+#include <vector>
+#include "SegmentStore.h"
+using namespace Gdiplus;
+
+class ExportPipeline;
+
+class TilePyramid
+{
+public:
+	static const UINT TILE_SIZE = 256;		// Width and height of the (inner) tiles
+	static const size_t MAX_TILES_PER_LEVEL = (size_t)1 << 28;	// Limit of the culling map per level
+
+	/* Prepares a pyramid for the drawing area bounds (turtle coordinates), to be
+	 * rendered at scale on the given background at the most detailed level */
+	TilePyramid(const RectF& bounds, Color background, float scale = 1.0f);
+
+	/* Adds the chunks of a layer (drawn in order of addition); the views must stay
+	 * valid until write() has returned */
+	void addLayer(const std::vector<SegmentChunkView>& chunks);
+	// Returns the number of levels (0 if the scaled bounds are empty or too large)
+	unsigned int getLevelCount() const;
+	// Returns the pixel width and height of the given level
+	void getLevelSize(unsigned int level, UINT& width, UINT& height) const;
+
+	/* Writes the manifest basePath + ".dzi" and the non-empty tiles into the
+	 * directory basePath + "_files" (rendering and compressing the tiles concurrently
+	 * if a pipeline is given). Returns false if the pyramid is empty or too large or
+	 * if a file couldn't be written */
+	bool write(LPCWSTR basePath, const ExportPipeline* pPipeline = nullptr);
+	// Returns the number of tile files written by the last write()
+	inline size_t getTileCount() const { return this->nWritten; }
+	// Returns the number of tiles found empty (culled or plain background) by the last write()
+	inline size_t getSkippedCount() const { return this->nSkipped; }
+
+private:
+	// Address of a tile within the pyramid
+	struct Tile {
+		unsigned int level;
+		UINT col, row;
+	};
+
+	const RectF bounds;				// Drawing area in turtle coordinates
+	const Color background;			// Background colour of the tiles
+	const float scale;				// Scale of the most detailed level
+	UINT width, height;				// Pixel size of the most detailed level
+	unsigned int nLevels;			// Number of levels
+	std::vector<std::vector<SegmentChunkView>> layers;	// Chunks to be drawn
+	size_t nWritten, nSkipped;		// Statistics of the last write()
+
+	// Returns the factor from turtle units to pixels on the given level
+	REAL getLevelScale(unsigned int level) const;
+	// Appends the tiles of level touched by any segment (by bounds) to tiles
+	void collectTiles(unsigned int level, std::vector<Tile>& tiles) const;
+	/* Renders the tile into a PNG file image in text (left empty if the tile shows
+	 * nothing but background), returns false if the tile bitmap failed */
+	bool renderTile(const Tile& tile, std::string& text) const;
+	// Writes the Deep Zoom manifest to the file path
+	bool writeManifest(const std::wstring& path) const;
+};
+
+#endif /*TILEPYRAMID_H*/
@@ -10,10 +10,32 @@
  * Turtle objects may be created to share the drawing area.
  *
  * Author: Kay Grtzig
- * Version: 11.0.1 (covering capabilities of Structorizer 3.31, functional GUI)
+ * Version: 11.1.0 (covering capabilities of Structorizer 3.31, functional GUI)
  *
  * History (add at top):
  * --------------------------------------------------------
+ * 2026-10-18   VERSION 11.1.0: New method execute() for batches of commands
+ * 2026-10-18   VERSION 11.1.0: New method visitChunks() instead of writeDrawing(), writeJournal(),
+ *              writeFrames(), and writeIncrement() (the exporters drive themselves)
+ * 2026-10-18   VERSION 11.1.0: New method writeIncrement() for the incremental re-export
+ * 2026-10-18   VERSION 11.1.0: drawChunks() cuts lines at the border of the clip rectangle
+ * 2026-10-18   VERSION 11.1.0: New method writeFrames() for the raw frame streaming
+ * 2026-10-18   VERSION 11.1.0: New method lockChunks() for the tile pyramid export
+ * 2026-10-18   VERSION 11.1.0: New methods writeJournal(), appendElements(), getState(), and
+ *              restoreState() for the drawing journal, pen state changes locked
+ * 2026-10-18   VERSION 11.1.0: New method writeDrawing() (binary format), chunk loops of
+ *              drawElements(), writeSVG(), writeCSV() moved to static methods for reuse
+ * 2026-10-18   VERSION 11.1.0: New method importCSV() (bulk load of exported drawings)
+ * 2026-10-18   VERSION 11.1.0: writeCSV() delegates the formatting to a CsvWriter
+ * 2026-10-18   VERSION 11.1.0: writeSVG() and writeCSV() format chunk by chunk, optionally
+ *              concurrently via an ExportPipeline (output identical to the serial one)
+ * 2026-10-18   VERSION 11.1.0: writeSVG() without scale argument (the SvgWriter knows it)
+ * 2026-10-18   VERSION 11.1.0: writeSVG() delegates the formatting to an SvgWriter
+ * 2026-10-18   VERSION 11.1.0: New method getGeneration() (per-turtle canvas layers)
+ * 2026-10-18   VERSION 11.1.0: New methods drawElements() and getExtent() (banded PNG export)
+ * 2026-10-18   VERSION 11.1.0: Elements appended to a SegmentStore instead of a list, such
+ *              that the window thread may paint them concurrently; state access locked,
+ *              moves unified in moveTo(), TurtleLine methods turned into static helpers
  * 2024-10-05   VERSION 11.0.1: Conversions REAL <-> double avoided
  * 2021-04-06   VERSION 11.0.0: Method draw decomposed to support memory HDC / bitblt
  * 2021-04-05   VERSION 11.0.0: New method for SVG export, nearest point search
@@ -33,6 +55,12 @@
 #include <iomanip>
 #include "Turtle.h"
 #include "Turtleizer.h"
+#include "ExportPipeline.h"
+#include "CsvReader.h"
+#include "CsvWriter.h"
+#include "DrawingFormat.h"
+#include "MappedFile.h"
+#include "SvgWriter.h"
 
 // Two-step conversion macro of string literals into wide-character string literals
 #define WIDEN2(x) L ## x
@@ -52,8 +80,9 @@ Turtle::Turtle(int x, int y, LPCWSTR imagePath)
 	, orient(0.0)
 	, defaultColour(Color::Black)
 	, pTurtleizer(Turtleizer::getInstance())
-	, lastDrawn(elements.cend())
+	, nextToDraw(elements.cbegin())
 	, nDrawn(0)
+	, drawnGeneration(0)
 {
 	if (imagePath != nullptr) {
 		this->turtleImagePath = this->makeFilePath(imagePath, false);
@@ -86,18 +115,11 @@ void Turtle::forward(double pixels, Color col)
 {
 	// FIXME: correct the angle
 	PointF oldP(this->pos);
+	PointF newP(oldP);
 	double angle = M_PI * (90 + this->orient) / 180.0;
-	this->pos.X += (REAL)(pixels * cos(angle));
-	this->pos.Y -= (REAL)(pixels * sin(angle));
-	if (this->penIsDown) {
-		this->elements.push_back(TurtleLine(oldP.X, oldP.Y, this->pos.X, this->pos.Y, col));
-		if (this->elements.size() == 1) {
-			this->lastDrawn = this->elements.cbegin();
-		}
-		// Extend the bounds by the current position
-		RectF::Union(this->bounds, this->bounds, RectF(this->pos.X, this->pos.Y, 1, 1));
-	}
-	this->refresh(oldP);
+	newP.X += (REAL)(pixels * cos(angle));
+	newP.Y -= (REAL)(pixels * sin(angle));
+	this->moveTo(oldP, newP, col);
 }
 
 // Make the turtle move the given number of pixels forward.
@@ -110,30 +132,45 @@ void Turtle::fd(int pixels)
 void Turtle::fd(int pixels, Color col)
 {
 	// FIXME: correct the angle
-	this->pos.X = round(this->pos.X);
-	this->pos.Y = round(this->pos.Y);
-	PointF oldP(this->pos);
+	PointF oldP(round(this->pos.X), round(this->pos.Y));
+	PointF newP(oldP);
 	double angle = M_PI * (90 + this->orient) / 180.0;
-	this->pos.X += (REAL)round(pixels * cos(angle));
-	this->pos.Y -= (REAL)round(pixels * sin(angle));
-	if (this->penIsDown) {
-		this->elements.push_back(TurtleLine(oldP.X, oldP.Y, this->pos.X, this->pos.Y, col));
-		if (this->elements.size() == 1) {
-			this->lastDrawn = this->elements.cbegin();
+	newP.X += (REAL)round(pixels * cos(angle));
+	newP.Y -= (REAL)round(pixels * sin(angle));
+	this->moveTo(oldP, newP, col);
+}
+
+// Moves the turtle from oldPos to newPos, records the line if the pen is down
+void Turtle::moveTo(const PointF& oldPos, const PointF& newPos, Color col)
+{
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		this->pos = newPos;
+		if (this->penIsDown) {
+			// Extend the bounds by the current position
+			RectF::Union(this->bounds, this->bounds, RectF(newPos.X, newPos.Y, 1, 1));
 		}
-		// Extend the bounds by the current position
-		RectF::Union(this->bounds, this->bounds, RectF(this->pos.X, this->pos.Y, 1, 1));
 	}
-	this->refresh(oldP);
+	if (this->penIsDown) {
+		// This only publishes the line, painting is left to the window thread
+		TurtleLine line = { oldPos.X, oldPos.Y, newPos.X, newPos.Y, (uint32_t)col.GetValue() };
+		this->elements.push_back(line);
+	}
+	this->refresh(oldPos);
 }
 
 // Rotates the turtle to the left by some angle (degrees!).
 void Turtle::left(double degrees)
 {
 	// FIXME: Normalise angle
-	this->orient += degrees;
+	bool visible = false;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		this->orient += degrees;
+		visible = this->isVisible;
+	}
 	// TO DO: Trigger damage
-	if (this->isVisible) {
+	if (visible) {
 		this->refresh(this->pos);
 	}
 }
@@ -141,15 +178,18 @@ void Turtle::left(double degrees)
 // Sets the turtle to the position (X,Y).
 void Turtle::gotoXY(int x, int y)
 {
-	PointF oldP(this->pos);
-	if (this->isVisible) {
+	bool visible = this->isTurtleShown();
+	if (visible) {
 		// If necessary, clear the turtle symbol and restore the drawing behind
 		this->showTurtle(false);
-		this->isVisible = true;
 	}
-	this->pos.X = (REAL)x;
-	this->pos.Y = (REAL)y;
-	if (this->isVisible) {
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		this->isVisible = visible;
+		this->pos.X = (REAL)x;
+		this->pos.Y = (REAL)y;
+	}
+	if (visible) {
 		this->refresh(this->pos);
 	}
 }
@@ -169,20 +209,30 @@ void Turtle::gotoY(int y)
 // The turtle lifts the pen up, so when moving no line will be drawn
 void Turtle::penUp()
 {
+	// START KGU 2026-10-18: The journal thread reads the pen state
+	std::lock_guard<std::mutex> guard(this->stateMutex);
+	// END KGU 2026-10-18
 	this->penIsDown = false;
 }
 
 // The turtle sets the pen down, so a line is being drawn when moving
 void Turtle::penDown()
 {
+	// START KGU 2026-10-18: The journal thread reads the pen state
+	std::lock_guard<std::mutex> guard(this->stateMutex);
+	// END KGU 2026-10-18
 	this->penIsDown = true;
 }
 
 // Show the turtle again
 void Turtle::showTurtle(bool show)
 {
-	bool doRefresh = this->isVisible != show;
-	this->isVisible = show;
+	bool doRefresh = false;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		doRefresh = this->isVisible != show;
+		this->isVisible = show;
+	}
 	if (doRefresh) {
 		this->refresh(this->pos, true);
 	}
@@ -191,6 +241,9 @@ void Turtle::showTurtle(bool show)
 // Sets the default pen colour (used for moves without color argument) to the RGB values
 void Turtle::setPenColor(unsigned char red, unsigned char green, unsigned char blue)
 {
+	// START KGU 2026-10-18: The journal thread reads the pen colour
+	std::lock_guard<std::mutex> guard(this->stateMutex);
+	// END KGU 2026-10-18
 	this->defaultColour = Color(red, green, blue);
 }
 
@@ -198,25 +251,128 @@ void Turtle::setPenColor(unsigned char red, unsigned char green, unsigned char b
 void Turtle::clear()
 {
 	RectF oldBounds(this->getBounds());
+	// This waits for a concurrent painting of the elements to finish, the
+	// window thread will notice the new store generation and start afresh
 	this->elements.clear();
-	this->bounds = RectF(this->pos.X, this->pos.Y, 1.0f, 1.0f);
-	this->lastDrawn = this->elements.cend();
-	this->nDrawn = 0;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		this->bounds = RectF(this->pos.X, this->pos.Y, 1.0f, 1.0f);
+	}
 	// START KGU 2021-04-05: issue #6 performance improvement
 	//this->refresh(this->pos);
-	this->pTurtleizer->refresh(bounds, -1);
+	this->pTurtleizer->refresh(oldBounds, -1);
 	// END KGU 2021-04-05
 }
 
+// Executes a batch of commands, publishing state, lines and damage once
+void Turtle::execute(const Command* cmds, size_t count)
+{
+	if (count == 0) {
+		return;
+	}
+	// The commands work on a copy of the state, which is published at the end
+	PointF oldPos, curPos;
+	double orientation = 0.0;
+	bool penDown = true;
+	uint32_t argb = 0;
+	RectF bounds;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		oldPos = this->pos;
+		orientation = this->orient;
+		penDown = this->penIsDown;
+		argb = (uint32_t)this->defaultColour.GetValue();
+		bounds = this->bounds;
+	}
+	curPos = oldPos;
+	SegmentBounds passed = SegmentBounds::empty();		// Bounds of all visited positions
+	passed.include(oldPos.X, oldPos.Y);
+	// The lines are handed to the store in portions of a chunk
+	std::vector<TurtleLine> lines;
+	lines.reserve((std::min)(count, (size_t)Elements::CHUNK_SIZE));
+	for (size_t i = 0; i < count; i++) {
+		const Command& cmd = cmds[i];
+		switch (cmd.opcode) {
+		case CMD_FORWARD:
+		case CMD_FD:
+		{
+			// Same computations as in forward() and fd(), respectively
+			double angle = M_PI * (90 + orientation) / 180.0;
+			PointF fromP(curPos);
+			PointF toP;
+			if (cmd.opcode == CMD_FORWARD) {
+				toP = fromP;
+				toP.X += (REAL)(cmd.value * cos(angle));
+				toP.Y -= (REAL)(cmd.value * sin(angle));
+			}
+			else {
+				int pixels = (int)cmd.value;
+				fromP = PointF(round(curPos.X), round(curPos.Y));
+				toP = fromP;
+				toP.X += (REAL)round(pixels * cos(angle));
+				toP.Y -= (REAL)round(pixels * sin(angle));
+			}
+			if (penDown) {
+				TurtleLine line = { fromP.X, fromP.Y, toP.X, toP.Y, argb };
+				lines.push_back(line);
+				// Extended by the end position exactly as in moveTo() (same results)
+				RectF::Union(bounds, bounds, RectF(toP.X, toP.Y, 1, 1));
+				if (lines.size() == Elements::CHUNK_SIZE) {
+					this->elements.append(lines.data(), lines.size());
+					lines.clear();
+				}
+			}
+			curPos = toP;
+			passed.include(curPos.X, curPos.Y);
+			break;
+		}
+		case CMD_LEFT:
+			orientation += cmd.value;
+			break;
+		case CMD_PEN_UP:
+			penDown = false;
+			break;
+		case CMD_PEN_DOWN:
+			penDown = true;
+			break;
+		case CMD_PEN_COLOUR:
+			argb = cmd.argb;
+			break;
+		}
+	}
+	if (!lines.empty()) {
+		this->elements.append(lines.data(), lines.size());
+	}
+	bool visible = false;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		this->pos = curPos;
+		this->orient = orientation;
+		this->penIsDown = penDown;
+		this->defaultColour = Color((ARGB)argb);
+		this->bounds = bounds;
+		visible = this->isVisible;
+	}
+	// One damage rectangle covering all visited positions (cf. refresh())
+	LONG halfIconSize = visible ? (LONG)(max(this->turtleHeight, this->turtleWidth) / sqrt(2.0) + 1) : 1L;
+	REAL left = floor(passed.left) - halfIconSize;
+	REAL right = ceil(passed.right) + halfIconSize;
+	REAL top = floor(passed.top) - halfIconSize;
+	REAL bottom = ceil(passed.bottom) + halfIconSize;
+	this->pTurtleizer->refresh(RectF(left, top, right - left, bottom - top), (int)this->elements.size());
+}
+
 // Returns the current horizontal pixel position in floating-point resolution
 double Turtle::getX() const
 {
+	std::lock_guard<std::mutex> guard(this->stateMutex);
 	return (double) this->pos.X;
 }
 
 // Returns the current vertical pixel position in floating-point resolution
 double Turtle::getY() const
 {
+	std::lock_guard<std::mutex> guard(this->stateMutex);
 	return (double) this->pos.Y;
 }
 
@@ -224,7 +380,11 @@ double Turtle::getY() const
 double Turtle::getOrientation() const
 {
 	// TODO: Test the correct results
-	double ori = this->orient;
+	double ori = 0.0;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		ori = this->orient;
+	}
 	while (ori > 180) { ori -= 360; }
 	while (ori < -180) { ori += 360; }
 	return -ori;
@@ -232,6 +392,7 @@ double Turtle::getOrientation() const
 
 RectF Turtle::getBounds() const
 {
+	std::lock_guard<std::mutex> guard(this->stateMutex);
 	// Ensure the current turtle position is contained by the bound.
 	if (!this->bounds.Contains(this->pos)) {
 		RectF myBounds(this->pos.X, this->pos.Y, 1.0f, 1.0f);
@@ -241,27 +402,49 @@ RectF Turtle::getBounds() const
 	return this->bounds;
 }
 
+RectF Turtle::getExtent() const
+{
+	RectF extent = this->getBounds();
+	std::lock_guard<std::mutex> guard(this->stateMutex);
+	if (this->isVisible) {
+		// Consider rotation, so use maximum diagonal (as in refresh())
+		REAL halfIconSize = (REAL)(max(this->turtleHeight, this->turtleWidth) / sqrt(2.0) + 1);
+		RectF iconRect(this->pos.X - halfIconSize, this->pos.Y - halfIconSize,
+			2 * halfIconSize, 2 * halfIconSize);
+		RectF::Union(extent, extent, iconRect);
+	}
+	return extent;
+}
+
 bool Turtle::isTurtleShown() const
 {
+	std::lock_guard<std::mutex> guard(this->stateMutex);
 	return this->isVisible;
 }
 
-// Refreshes the window i.e. invalidates the region between `oldPos
-// and this->pos and then updates the window
+// Refreshes the window i.e. reports the region between `oldPos and
+// this->pos as damaged (the window thread will repaint it in time)
 void Turtle::refresh(const PointF& oldPos, bool forceIconSize) const
 {
+	PointF curPos;
+	bool visible = false;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		curPos = this->pos;
+		visible = this->isVisible;
+	}
 	// Consider rotation, so use maximum diagonal
-	LONG halfIconSize = (forceIconSize || this->isVisible) ? (LONG)(max(this->turtleHeight, this->turtleWidth) / sqrt(2.0) +1) : 1L;
+	LONG halfIconSize = (forceIconSize || visible) ? (LONG)(max(this->turtleHeight, this->turtleWidth) / sqrt(2.0) +1) : 1L;
 	// START KGU 2021-04-02: Issue #6 We must consider transformations - this is not the window RECT!
 	//RECT rect;
 	//rect.left = (LONG)floor(min(oldPos.X, this->pos.X)) - halfIconSize;
 	//rect.right = (LONG)ceil(max(oldPos.X, this->pos.X)) + halfIconSize;
 	//rect.top = (LONG)floor(min(oldPos.Y, this->pos.Y)) - halfIconSize;
 	//rect.bottom = (LONG)ceil(max(oldPos.Y, this->pos.Y)) + halfIconSize;
-	REAL left = floor(min(oldPos.X, this->pos.X)) - halfIconSize;
-	REAL right = ceil(max(oldPos.X, this->pos.X)) + halfIconSize;
-	REAL top = floor(min(oldPos.Y, this->pos.Y)) - halfIconSize;
-	REAL bottom = ceil(max(oldPos.Y, this->pos.Y)) + halfIconSize;
+	REAL left = floor(min(oldPos.X, curPos.X)) - halfIconSize;
+	REAL right = ceil(max(oldPos.X, curPos.X)) + halfIconSize;
+	REAL top = floor(min(oldPos.Y, curPos.Y)) - halfIconSize;
+	REAL bottom = ceil(max(oldPos.Y, curPos.Y)) + halfIconSize;
 	RectF rect(left, top, right - left, bottom - top);
 	// END KGU 2021-04-02
 	this->pTurtleizer->refresh(rect, (int)this->elements.size());
@@ -298,10 +481,11 @@ LPCWSTR Turtle::makeFilePath(LPCWSTR filename, bool addProductPath) const
 REAL Turtle::getNearestPoint(const PointF& coord, bool betweenEnds, double radius, PointF& nearest) const
 {
 	REAL minDist = -1.0;
+	Elements::ReadLock lock(this->elements);
 	for (Elements::const_iterator it(this->elements.cbegin()); it != this->elements.cend(); ++it)
 	{
 		PointF cand;
-		REAL dist = it->getNearestPoint(coord, betweenEnds, cand);
+		REAL dist = getNearestPoint(*it, coord, betweenEnds, cand);
 		if (dist == 0.0) {
 			nearest = cand;
 			return dist;
@@ -314,31 +498,31 @@ REAL Turtle::getNearestPoint(const PointF& coord, bool betweenEnds, double radiu
 	return minDist;
 }
 
-void Turtle::draw(Graphics& gr, bool drawAll, bool withImage)
+bool Turtle::draw(Graphics& gr, bool drawAll, bool withImage, size_t maxElements)
 {
 	// START KGU 2021-04-05: issue #6 performance improvement
 	//for (Elements::const_iterator it(this->elements.cbegin()); it != this->elements.cend(); ++it)
 	//{
 	//	it->draw(gr);
 	//}
-	if (drawAll) {
+	// START KGU 2026-10-18: The turtle thread may append (or clear) concurrently
+	Elements::ReadLock lock(this->elements);
+	unsigned int generation = this->elements.getGeneration();
+	if (drawAll || generation != this->drawnGeneration) {
 		this->nDrawn = 0;
-		this->lastDrawn = this->elements.cbegin();
+		this->nextToDraw = this->elements.cbegin();
+		this->drawnGeneration = generation;
 	}
-	unsigned int nElements = (unsigned int)this->elements.size();
-	Elements::const_iterator it(this->lastDrawn);
-	if (nElements == this->nDrawn) {
-		return;
-	}
-	else if (this->nDrawn > 0) {
-		++it;
+	size_t nElements = this->elements.size();
+	size_t nToDraw = nElements;
+	if (nElements - this->nDrawn > maxElements) {
+		nToDraw = this->nDrawn + maxElements;
 	}
-	for (; this->nDrawn < nElements; ++it, this->nDrawn++) {
-		it->draw(gr);
-		if (this->nDrawn > 0) {
-			++this->lastDrawn;
-		}
+	for (; this->nDrawn < nToDraw; ++this->nextToDraw, this->nDrawn++) {
+		drawLine(gr, *this->nextToDraw);
 	}
+	bool complete = this->nDrawn >= nElements;
+	// END KGU 2026-10-18
 	// END KGU  2021-04-05
 
 	// START KGU 2021-04-05: Issue #6, delegated to drawImage()
@@ -374,17 +558,69 @@ void Turtle::draw(Graphics& gr, bool drawAll, bool withImage)
 //		gr.Flush();
 //		delete image;
 //	}
-	if (withImage && this->isVisible) {
+	if (withImage) {
 		this->drawImage(gr);
 	}
 	// END KGU 2021-04-05
 
+	return complete;
 }
 
 // START KGU 2021-04-05: Issue #6 drawing of the icon separated
+void Turtle::drawElements(Graphics& gr, const RectF* pClip) const
+{
+	Elements::ReadLock lock(this->elements);
+	std::vector<SegmentChunkView> chunks;
+	this->elements.getChunks(chunks);
+	drawChunks(gr, chunks, pClip);
+}
+
+void Turtle::drawChunks(Graphics& gr, const std::vector<SegmentChunkView>& chunks, const RectF* pClip)
+{
+	SegmentBounds clip = SegmentBounds::empty();
+	if (pClip != NULL) {
+		clip.include(pClip->X, pClip->Y);
+		clip.include(pClip->GetRight(), pClip->GetBottom());
+	}
+	for (const SegmentChunkView& chunk : chunks) {
+		// Whole chunks outside the clip area can be skipped by their bounds
+		if (pClip != NULL && !chunk.bounds.intersects(clip)) {
+			continue;
+		}
+		for (size_t i = 0; i < chunk.count; i++) {
+			const TurtleLine& line = chunk.segments[i];
+			if (pClip != NULL) {
+				SegmentBounds lineBounds = SegmentBounds::empty();
+				lineBounds.include(line);
+				if (!lineBounds.intersects(clip)) {
+					continue;
+				}
+				if (!clip.contains(lineBounds)) {
+					// Far-off end points would cost GDI+ precision and time, so cut the line
+					TurtleLine part = line;
+					if (clip.clip(part)) {
+						drawLine(gr, part);
+					}
+					continue;
+				}
+			}
+			drawLine(gr, line);
+		}
+	}
+}
+
 void Turtle::drawImage(Graphics& gr) const
 {
-	if (this->isVisible) {
+	PointF curPos;
+	double curOrient = 0.0;
+	bool visible = false;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		curPos = this->pos;
+		curOrient = this->orient;
+		visible = this->isVisible;
+	}
+	if (visible) {
 		Matrix transf;
 		gr.GetTransform(&transf);
 		//Gdiplus::REAL matrix[6];
@@ -402,8 +638,8 @@ void Turtle::drawImage(Graphics& gr) const
 		printf("The width of the image is %u.\n", this->turtleWidth);
 		printf("The height of the image is %u.\n", this->turtleHeight);
 #endif /*DEBUG_PRINT*/
-		gr.TranslateTransform(this->pos.X, this->pos.Y);
-		gr.RotateTransform(-(REAL)this->orient);
+		gr.TranslateTransform(curPos.X, curPos.Y);
+		gr.RotateTransform(-(REAL)curOrient);
 
 		//Matrix transf;
 		//gr.GetTransform(&transf);
@@ -424,7 +660,12 @@ bool Turtle::hasElements() const
 	return !this->elements.empty();
 }
 
-void Turtle::writeSVG(std::ostream& ostr, PointF offset, unsigned short scale) const
+unsigned int Turtle::getGeneration() const
+{
+	return this->elements.getGeneration();
+}
+
+void Turtle::writeSVG(SvgWriter& svg, PointF offset, const ExportPipeline* pPipeline) const
 {
 	/* In contrast to Structorizer TurtleBox, which exports the points
 	 * as int coordinate pairs, we export them with real-number coordinates.
@@ -439,72 +680,193 @@ void Turtle::writeSVG(std::ostream& ostr, PointF offset, unsigned short scale) c
 	 * Anyway, we are on the safer side here, paths can get longer and surprisingly
 	 * do get longer than on export from Structorizer's TurtleBox.
 	 */
-	PointF lastPt;
-	Color lastCol;
-	int nPoints = 0;
-	ostr.fill('0');
-	for (Elements::const_iterator it(this->elements.cbegin()); it != this->elements.cend(); ++it)
-	{
-			PointF from = it->getFrom();
-			PointF to = it->getTo();
-			Color col = it->getColor();
-			if (nPoints == 0 || !lastPt.Equals(from)
-				|| lastCol.GetValue() != col.GetValue()
-				|| nPoints >= MAX_POINTS_PER_SVG_PATH) {
-				if (nPoints > 0) {
-					// End the previous path
-					ostr << "\" />\n";
-				}
-				// Start a new path
-				ostr << "    <path\n";
-				ostr << "      style=\"stroke:#"
-					<< std::hex << std::setw(6)
-					<< (int)(col.GetValue() & 0xFFFFFF)
-					<< std::dec << "\"\n";
-				ostr << "      id=\"path" << std::setw(5) << nPoints << "\"\n";
-				ostr << "      d=\"m "
-					<< ((from.X + offset.X) * scale) << ","
-					<< ((from.Y + offset.Y) * scale) << " ";
-			}
-			ostr << ((to.X - from.X) * scale) << ","
-				<< ((to.Y - from.Y) * scale) << " ";
-			lastPt = to;
-			lastCol = col;
-			nPoints++;
+	// START KGU 2026-10-18: Formatting done by SvgWriter, chunk by chunk
+	Elements::ReadLock lock(this->elements);
+	std::vector<SegmentChunkView> chunks;
+	this->elements.getChunks(chunks);
+	writeChunksSVG(svg, offset, chunks, pPipeline);
+	// END KGU 2026-10-18
+}
+
+void Turtle::writeChunksSVG(SvgWriter& svg, PointF offset, const std::vector<SegmentChunkView>& chunks,
+	const ExportPipeline* pPipeline)
+{
+	svg.beginPaths(offset.X, offset.Y, MAX_POINTS_PER_SVG_PATH);
+	if (pPipeline == nullptr || chunks.size() < 2) {
+		for (const SegmentChunkView& chunk : chunks) {
+			svg.addSegments(chunk.segments, chunk.count);
+		}
+		svg.endPaths();
+		return;
 	}
-	if (nPoints > 0) {
-		ostr << "\" />\n";
+	// The colour classes must be fixed before the chunks are formatted independently
+	for (const SegmentChunkView& chunk : chunks) {
+		svg.registerColours(chunk.segments, chunk.count);
 	}
+	pPipeline->run(chunks.size(),
+		[&](size_t ix, std::string& text) {
+			const SegmentChunkView& chunk = chunks[ix];
+			const Segment* pPrevious = NULL;
+			if (ix > 0) {
+				pPrevious = &chunks[ix - 1].segments[chunks[ix - 1].count - 1];
+			}
+			SvgWriter fragment(text, svg);
+			fragment.resumePaths(offset.X, offset.Y, MAX_POINTS_PER_SVG_PATH, chunk.firstIndex, pPrevious);
+			fragment.addSegments(chunk.segments, chunk.count);
+			if (ix + 1 == chunks.size()) {
+				fragment.endPaths();
+			}
+		},
+		[&](const char* text, size_t length) {
+			svg.writeText(text, length);
+			return true;
+		});
+}
 
+void Turtle::writeCSV(CsvWriter& csv, unsigned int turtleNo, const ExportPipeline* pPipeline) const
+{
+	// START KGU 2026-10-18: Rows formatted by the CsvWriter chunk by chunk (possibly concurrently)
+	Elements::ReadLock lock(this->elements);
+	std::vector<SegmentChunkView> chunks;
+	this->elements.getChunks(chunks);
+	writeChunksCSV(csv, turtleNo, chunks, pPipeline);
+	// END KGU 2026-10-18
 }
 
-void Turtle::writeCSV(std::ostream& ostr, char separator) const
+void Turtle::writeChunksCSV(CsvWriter& csv, unsigned int turtleNo, const std::vector<SegmentChunkView>& chunks,
+	const ExportPipeline* pPipeline)
 {
-	char colStr[9];
-	for (Elements::const_iterator it(this->elements.cbegin()); it != this->elements.cend(); ++it)
+	if (pPipeline == nullptr || chunks.size() < 2) {
+		for (const SegmentChunkView& chunk : chunks) {
+			csv.writeRows(chunk.segments, chunk.count, chunk.firstIndex, turtleNo);
+		}
+		return;
+	}
+	pPipeline->run(chunks.size(),
+		[&](size_t ix, std::string& text) {
+			const SegmentChunkView& chunk = chunks[ix];
+			csv.formatRows(chunk.segments, chunk.count, chunk.firstIndex, turtleNo, text);
+		},
+		[&](const char* text, size_t length) {
+			csv.writeText(text, length);
+			return true;
+		});
+}
+
+void Turtle::visitChunks(const ChunkStart& start, const ChunkVisitor& visit) const
+{
+	// The generation must belong to the very chunks passed
+	Elements::ReadLock lock(this->elements);
+	std::vector<SegmentChunkView> chunks;
+	size_t from = start(this->elements.getGeneration());
+	this->elements.getChunks(chunks, from);
+	visit(chunks);
+}
+
+void Turtle::visitChunks(size_t from, const ChunkVisitor& visit) const
+{
+	Elements::ReadLock lock(this->elements);
+	std::vector<SegmentChunkView> chunks;
+	this->elements.getChunks(chunks, from);
+	visit(chunks);
+}
+
+void Turtle::getState(DrawingFormat::TurtleRecord& state) const
+{
+	RectF myBounds = this->getBounds();
+	state.boundsX = myBounds.X;
+	state.boundsY = myBounds.Y;
+	state.boundsWidth = myBounds.Width;
+	state.boundsHeight = myBounds.Height;
+	std::lock_guard<std::mutex> guard(this->stateMutex);
+	state.orientation = this->orient;
+	state.posX = this->pos.X;
+	state.posY = this->pos.Y;
+	state.penARGB = (uint32_t)this->defaultColour.GetValue();
+	state.penDown = this->penIsDown ? 1 : 0;
+	state.visible = this->isVisible ? 1 : 0;
+}
+
+void Turtle::restoreState(const DrawingFormat::TurtleRecord& state)
+{
+	PointF oldPos;
 	{
-		PointF from = it->getFrom();
-		PointF to = it->getTo();
-		Color col = it->getColor();
-		sprintf(colStr, "ff%02x%02x%02x", col.GetRed(), col.GetGreen(), col.GetBlue());
-		ostr << (int)from.X << separator << (int)from.Y << separator
-			<< (int)to.X << separator << (int)to.Y << separator
-			<< colStr << std::endl;
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		oldPos = this->pos;
+		this->pos = PointF(state.posX, state.posY);
+		this->orient = state.orientation;
+		this->defaultColour = Color((ARGB)state.penARGB);
+		this->penIsDown = state.penDown != 0;
+		this->isVisible = state.visible != 0;
 	}
+	this->refresh(oldPos, true);
 }
 
+void Turtle::appendElements(const Segment* segs, size_t count)
+{
+	if (count == 0) {
+		return;
+	}
+	SegmentBounds added = SegmentBounds::empty();
+	for (size_t i = 0; i < count; i++) {
+		added.include(segs[i]);
+	}
+	this->elements.append(segs, count);
+	this->adoptElements(added, segs[count - 1]);
+}
 
-Turtle::TurtleLine::TurtleLine(REAL x1, REAL y1, REAL x2, REAL y2, Color col)
-: x1(x1)
-, y1(y1)
-, x2(x2)
-, y2(y2)
-, col(col)
+std::unique_ptr<SegmentStore::ReadLock> Turtle::lockChunks(std::vector<SegmentChunkView>& chunks) const
 {
+	std::unique_ptr<Elements::ReadLock> pLock(new Elements::ReadLock(this->elements));
+	this->elements.getChunks(chunks);
+	return pLock;
 }
 
-REAL Turtle::TurtleLine::getNearestPoint(const PointF& pt, bool betweenEnds, PointF& nearest) const
+bool Turtle::importCSV(LPCWSTR filePath, size_t* pnRows)
+{
+	if (pnRows != nullptr) {
+		*pnRows = 0;
+	}
+	MappedFile file(filePath);
+	if (!file.isOpen()) {
+		return false;
+	}
+	CsvReader reader(file.data(), file.size());
+	Segment last = {};
+	bool ok = reader.read([this, &last](const Segment* segs, size_t count) {
+		this->elements.append(segs, count);
+		last = segs[count - 1];
+	});
+	if (pnRows != nullptr) {
+		*pnRows = reader.getRowCount();
+	}
+	if (reader.getRowCount() > 0) {
+		this->adoptElements(reader.getBounds(), last);
+	}
+	return ok;
+}
+
+void Turtle::adoptElements(const SegmentBounds& added, const Segment& last)
+{
+	// Replay: the turtle ends where the last added line ends
+	RectF rect(added.left, added.top,
+		added.right - added.left + 1, added.bottom - added.top + 1);
+	PointF oldPos;
+	{
+		std::lock_guard<std::mutex> guard(this->stateMutex);
+		oldPos = this->pos;
+		this->pos = PointF(last.x2, last.y2);
+		RectF::Union(this->bounds, this->bounds, rect);
+	}
+	this->pTurtleizer->refresh(rect, (int)this->elements.size());
+	this->refresh(oldPos);
+}
+
+
+REAL Turtle::getNearestPoint(const TurtleLine& line, const PointF& pt, bool betweenEnds, PointF& nearest)
 {
+	const REAL x1 = line.x1, y1 = line.y1;
+	const REAL x2 = line.x2, y2 = line.y2;
 	if (betweenEnds) {
 		// We abuse a point for the direction vector
 		PointF dvec(x2 - x1, y2 - y1);
@@ -548,10 +910,10 @@ REAL Turtle::TurtleLine::getNearestPoint(const PointF& pt, bool betweenEnds, Poi
 	return 0;	// Not reachable
 }
 
-void Turtle::TurtleLine::draw(Gdiplus::Graphics& gr) const
+void Turtle::drawLine(Gdiplus::Graphics& gr, const TurtleLine& line)
 {
 	// Draw a line
-	Pen pen(this->col);
-	gr.DrawLine(&pen, this->x1, this->y1, this->x2, this->y2);
+	Pen pen(Color(line.argb));
+	gr.DrawLine(&pen, line.x1, line.y1, line.x2, line.y2);
 }
 
@@ -13,10 +13,33 @@
  * Turtle objects may be created to share the drawing area.
  *
  * Author: Kay Grtzig
- * Version: 11.0.0 (covering capabilities of Structorizer 3.31, functional GUI)
+ * Version: 11.1.0 (covering capabilities of Structorizer 3.31, functional GUI)
  *
  * History (add on top):
  * --------------------------------------------------------
+ * 2026-10-18	VERSION 11.1.0: New method visitChunks() instead of the exporter-specific methods
+ *				writeDrawing(), writeJournal(), writeFrames(), and writeIncrement(), the
+ *				exporter types are only forward-declared
+ * 2026-10-18	VERSION 11.1.0: New method execute() for batches of commands (Command, Opcode)
+ * 2026-10-18	VERSION 11.1.0: New method writeIncrement() (incremental re-export)
+ * 2026-10-18	VERSION 11.1.0: drawChunks() cuts lines at the border of the clip rectangle
+ * 2026-10-18	VERSION 11.1.0: New method writeFrames() (raw frame streaming)
+ * 2026-10-18	VERSION 11.1.0: New method lockChunks() (chunk views for the tile pyramid export)
+ * 2026-10-18	VERSION 11.1.0: New methods writeJournal(), appendElements(), getState(), and
+ *				restoreState() for the drawing journal
+ * 2026-10-18	VERSION 11.1.0: New method writeDrawing() (binary format), static chunk methods
+ *				drawChunks(), writeChunksSVG(), writeChunksCSV() (also for loaded drawings)
+ * 2026-10-18	VERSION 11.1.0: New method importCSV() for the reload of exported drawings
+ * 2026-10-18	VERSION 11.1.0: writeCSV() emits via a CsvWriter (formatCSV() dropped)
+ * 2026-10-18	VERSION 11.1.0: writeSVG() and writeCSV() may format chunks concurrently (ExportPipeline)
+ * 2026-10-18	VERSION 11.1.0: Scale argument of writeSVG() dropped (now a matter of the SvgWriter)
+ * 2026-10-18	VERSION 11.1.0: writeSVG() emits via an SvgWriter instead of an ostream
+ * 2026-10-18	VERSION 11.1.0: New method getGeneration() (per-turtle canvas layers)
+ * 2026-10-18	VERSION 11.1.0: New methods drawElements() and getExtent() for banded exports
+ * 2026-10-18	VERSION 11.1.0: draw() may be limited to a number of elements (progressive drawing)
+ * 2026-10-18	VERSION 11.1.0: Elements kept in a thread-safe SegmentStore (the window
+ *				thread paints while the turtle program goes on appending), TurtleLine
+ *				reduced to the plain Segment record, turtle state guarded by a mutex
  * 2021-04-07	VERSION 11.0.0: Enh. 6 - method writeElementsToCSV added
  * 2021-04-06   VERSION 11.0.0: Method draw decomposed to support memory HDC / bitblt
  * 2021-04-05	VERSION 11.0.0: New method for SVG export, nearest point search
@@ -29,33 +52,44 @@
 
 #include <Windows.h>
 #include <gdiplus.h>
-#include <list>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <string>
+#include <vector>
+#include "SegmentStore.h"
 using namespace Gdiplus;
-using std::list;
 
 class Turtleizer;
+class ExportPipeline;
+class SvgWriter;
+class CsvWriter;
+struct DrawingTurtleRecord;
 
 class Turtle
 {
 public:
-	// Internal class tracking a line drawn by the turtle (for onPaint())
-	class TurtleLine {
-	public:
-		friend class Turtle;
-		void draw(Graphics& gr) const;
-		inline PointF getFrom() const { return PointF(x1, y1); }
-		inline PointF getTo() const { return PointF(x2, y2); }
-		inline Color getColor() const { return col; }
-	private:
-		TurtleLine(REAL x1, REAL y1, REAL x2, REAL y2, Color col);
-		REAL x1, y1;	// from position
-		REAL x2, y2;	// to position
-		Color col;		// colour to draw with
-		/* Identifies the nearest end point or point on line to the given
-		 * coordinate pt, returns its distance or -1 and puts its coordinates into
-		 * point nearest. */
-		REAL getNearestPoint(const PointF& pt, bool betweenEnds, PointF& nearest) const;
+	// A line drawn by the turtle (tracked for onPaint() and the exports)
+	typedef Segment TurtleLine;
+	// Receives the store generation of the elements, returns the index of the first element of interest
+	typedef std::function<size_t(unsigned int generation)> ChunkStart;
+	// Receives views of the chunks holding the elements of interest
+	typedef std::function<void(const std::vector<SegmentChunkView>& chunks)> ChunkVisitor;
+	// Operation codes of the batch commands (see execute())
+	enum Opcode : uint8_t {
+		CMD_FORWARD,		// forward(value), floating-point coordinate model
+		CMD_FD,				// fd(value), integer coordinate model (value integral)
+		CMD_LEFT,			// left(value), i.e. rotation by value degrees (negative: right)
+		CMD_PEN_UP,			// penUp()
+		CMD_PEN_DOWN,		// penDown()
+		CMD_PEN_COLOUR		// Sets the pen colour to argb (0xAARRGGBB, cf. setPenColor())
+	};
+	// A batch command, e.g. {Turtle::CMD_FORWARD, 10} or {Turtle::CMD_PEN_COLOUR, 0, 0xFFFF0000}
+	struct Command {
+		Opcode opcode;
+		double value;		// Distance (pixels) or angle (degrees)
+		uint32_t argb;		// Pen colour for CMD_PEN_COLOUR
 	};
 
 	Turtle(int x, int y, LPCWSTR imagePath = NULL);
@@ -97,6 +131,10 @@ public:
 	void setPenColor(unsigned char red, unsigned char green, unsigned char blue);
 	// Wipes all drawn content of this turtle
 	void clear();
+	// Executes the count commands at cmds with the same outcome as the respective single
+	// calls, but appends the lines in bulk, extends the bounds once and reports a single
+	// damage rectangle for the whole batch (so the window shows its result only afterwards)
+	void execute(const Command* cmds, size_t count);
 
 	// Returns the current horizontal pixel position in floating-point resolution
 	double getX() const;
@@ -109,39 +147,89 @@ public:
 	bool isTurtleShown() const;
 	// Returns the current drawing bounds of this turtle
 	RectF getBounds() const;
+	// Returns the current drawing bounds of this turtle, including the turtle symbol if visible
+	RectF getExtent() const;
 	/* Searches the nearest end point or point on line within the given radius to
 	 * given coordinate, returns its distance or -1 and puts its coordinates into
 	 * point nearest (if such a point was found). (The result may be ambiguous.)
 	 */
 	REAL getNearestPoint(const PointF& coord, bool betweenEnds, double radius, PointF& nearest) const;
 
-	// Draws the trajectory of this turtle (and possibly the turtle itself) in 2D graphics gr
-	void draw(Graphics& gr, bool drawAll = true, bool withImage = true);
+	// Draws the trajectory of this turtle (and possibly the turtle itself) in 2D graphics gr,
+	// continuing after the elements drawn before unless drawAll is set. At most maxElements
+	// elements will be drawn, returns true if all elements have been drawn.
+	// (to be called from the window thread only)
+	bool draw(Graphics& gr, bool drawAll = true, bool withImage = true, size_t maxElements = SIZE_MAX);
+	// Draws all elements of this turtle (or only those touching the clip rectangle, if given)
+	// in 2D graphics gr without affecting the progress of draw() (e.g. for exports)
+	void drawElements(Graphics& gr, const RectF* pClip = NULL) const;
 	// Draws this turtle (if visible) in 2D graphics gr
 	void drawImage(Graphics& gr) const;
 	// Reports whether this turtle has drawn elements
 	bool hasElements() const;
-	// Writes SVG descriptions of the elements to the given stream
-	void writeSVG(std::ostream& ostr, PointF offset, unsigned short scale = 1) const;
-	// Writes the CSV information of all gathered line elements to the given stream ostr
-	void writeCSV(std::ostream& ostr, char separator) const;
+	// Returns a counter that is incremented whenever this turtle clears its elements
+	unsigned int getGeneration() const;
+	// Writes SVG descriptions of the elements to the given SVG writer
+	// (formatting the element chunks concurrently if a pipeline is given)
+	void writeSVG(SvgWriter& svg, PointF offset, const ExportPipeline* pPipeline = nullptr) const;
+	// Writes the CSV rows of all gathered line elements to the given CSV writer, with
+	// turtleNo as turtle column (formatting the chunks concurrently if a pipeline is given)
+	void writeCSV(CsvWriter& csv, unsigned int turtleNo, const ExportPipeline* pPipeline = nullptr) const;
+	// Appends the lines of the CSV file filePath (as exported) to the elements of this turtle,
+	// which is then placed at the end of the last line (the pen state doesn't matter). Returns
+	// false if the file can't be read or has a malformed row (preceding rows are kept), puts
+	// the number of imported lines into *pnRows if given. (To be called from the turtle thread.)
+	bool importCSV(LPCWSTR filePath, size_t* pnRows = nullptr);
+	// Passes the store generation of the elements to start, which returns the index of the
+	// first element of interest, then views of the chunks holding the elements from there on
+	// to visit, both under the read lock of the store (a clear() by the turtle program waits).
+	// Serves the exporters that only take the elements added since their previous visit
+	// (journal, frame stream, incremental export), may be called from any thread
+	void visitChunks(const ChunkStart& start, const ChunkVisitor& visit) const;
+	// Passes views of the chunks holding the elements from index from on to visit (under the
+	// read lock of the store), may be called from any thread
+	void visitChunks(size_t from, const ChunkVisitor& visit) const;
+	// Fills in the state fields (position, orientation, bounds, pen, visibility) of state
+	// (a DrawingFormat::TurtleRecord)
+	void getState(DrawingTurtleRecord& state) const;
+	// Adopts position, orientation, pen colour and state, and visibility from state
+	void restoreState(const DrawingTurtleRecord& state);
+	// Appends the given count lines to the elements of this turtle, which is then placed at
+	// the end of the last line (the pen state doesn't matter). (To be called from the turtle thread.)
+	void appendElements(const Segment* segs, size_t count);
+	// Puts views of all element chunks into chunks and returns the lock keeping them valid
+	// (a clear() by the turtle program waits until the lock has been released)
+	std::unique_ptr<SegmentStore::ReadLock> lockChunks(std::vector<SegmentChunkView>& chunks) const;
+
+	// Draws the segments of the given chunks (only those touching the clip rectangle, if given,
+	// cut at its border)
+	// in 2D graphics gr
+	static void drawChunks(Graphics& gr, const std::vector<SegmentChunkView>& chunks, const RectF* pClip = NULL);
+	// Writes SVG paths for the segments of the given chunks (as writeSVG() does for the elements)
+	static void writeChunksSVG(SvgWriter& svg, PointF offset, const std::vector<SegmentChunkView>& chunks,
+		const ExportPipeline* pPipeline = nullptr);
+	// Writes CSV rows for the segments of the given chunks (as writeCSV() does for the elements)
+	static void writeChunksCSV(CsvWriter& csv, unsigned int turtleNo, const std::vector<SegmentChunkView>& chunks,
+		const ExportPipeline* pPipeline = nullptr);
 
 protected:
-	// Type name for the list of tracked line elements
-	typedef list<TurtleLine> Elements;
+	// Type name for the store of tracked line elements
+	typedef SegmentStore Elements;
 private:
 	static const int MAX_POINTS_PER_SVG_PATH = 800;
 	static const LPCWSTR TURTLE_IMAGE_FILE;		// File name of the turtle image
 	Turtleizer* const pTurtleizer;				// The singleton Turtleizer instance
 	LPCWSTR	turtleImagePath;					// The derived turtle file path
 	UINT turtleWidth, turtleHeight;				// The turtle image extensions
+	mutable std::mutex stateMutex;				// Guards pos, bounds, orient, isVisible and the pen
 	Gdiplus::PointF pos;						// current turtle position
 	Gdiplus::RectF bounds;						// current bounds of the trajectory
 	double orient;							// current orientation in degrees
-	Elements elements;						// List of lines drawn in this session
+	Elements elements;						// Store of lines drawn in this session
 	Color defaultColour;					// Default colour for line segments without explicit colour
-	Elements::const_iterator lastDrawn;		// Iterator to the last drawn element
-	unsigned int nDrawn;					// Number of drawn elements so far
+	Elements::const_iterator nextToDraw;	// Iterator to the first element not drawn yet
+	size_t nDrawn;							// Number of drawn elements so far
+	unsigned int drawnGeneration;			// Store generation the drawn elements belong to
 	bool penIsDown;							// Whether the pen is ready to draw
 	bool isVisible;							// Whether the turtle itself ought to be visible
 
@@ -149,13 +237,25 @@ private:
 	// folder) if and the given file name `filename.
 	// (if the image file name isn't given, the turtle image will be used)
 	LPCWSTR makeFilePath(LPCWSTR filename = TURTLE_IMAGE_FILE, bool addProductPath = true) const;
+	// Moves the turtle from oldPos to newPos, records the line in colour col if
+	// the pen is down, and refreshes the affected region
+	void moveTo(const PointF& oldPos, const PointF& newPos, Color col);
+	// Extends the bounds by added (the bounds of appended elements), places the turtle at
+	// the end of last and refreshes the affected region
+	void adoptElements(const SegmentBounds& added, const Segment& last);
+	// Draws the given line element in 2D graphics gr
+	static void drawLine(Graphics& gr, const TurtleLine& line);
+	/* Identifies the nearest end point or point on the given line to the given
+	 * coordinate pt, returns its distance or -1 and puts its coordinates into
+	 * point nearest. */
+	static REAL getNearestPoint(const TurtleLine& line, const PointF& pt, bool betweenEnds, PointF& nearest);
 
 protected:
-	// Refresh the window (i. e. invalidate the region between oldPos and this->pos) 
+	// Refresh the window (i. e. invalidate the region between oldPos and this->pos)
 	// If forceIconSize is set true, then the damaged region will be enlarged to include the
 	// turtle symbol no matter if turtle is visible
 	virtual void refresh(const PointF& oldPos, bool forceIconSize = false) const;
 
 };
 
-#endif /*TURTLE_H*/
\ No newline at end of file
+#endif /*TURTLE_H*/
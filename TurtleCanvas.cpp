@@ -13,10 +13,41 @@
  * Turtle objects may be created to share the drawing area.
  *
  * Author: Kay Grtzig
- * Version: 11.0.1 (covering capabilities of Structorizer 3.31, functional GUI)
+ * Version: 11.1.0 (covering capabilities of Structorizer 3.31, functional GUI)
  *
  * History (add on top):
  * --------------------------------------------------------
+ * 2026-10-18   New method getDamageStats() (damage coalescing counters outside DEBUG_PRINT)
+ * 2026-10-18   Binary drawing export fed via Turtle::visitChunks() (no writeDrawing() anymore)
+ * 2026-10-18   Background colour obtained via Turtleizer::getBackground() (thread-safe)
+ * 2026-10-18   At most MAX_LAYERS segment layers, the surplus turtles share the last one
+ * 2026-10-18   Neither invalidation nor painting of new lines within deferred-update scopes (Batch)
+ * 2026-10-18   CSV, SVG, and plotter export may simplify the lines with a chosen tolerance (Simplifier)
+ * 2026-10-18   New context menu item to export the visible region (PNG etc. or SVG), lines clipped
+ * 2026-10-18   New context menu item to export the drawing progress as animated PNG
+ * 2026-10-18   New context menu item to export the drawing for pen plotters (HPGL or G-code)
+ * 2026-10-18   New context menu item to export the drawing as deep-zoom tile pyramid
+ * 2026-10-18   PNG export may also produce BMP, PPM, PAM, or QOI files (by extension)
+ * 2026-10-18   PNG export compresses concurrently (ExportPipeline passed to the PngWriter)
+ * 2026-10-18   PNG export detects drawings with at most 256 colours and writes them as
+ *              indexed-colour PNGs (bit depth 1, 2, 4, or 8)
+ * 2026-10-18   New context menu item to export the drawing in the binary drawing format
+ * 2026-10-18   CSV export via a block-buffered CsvWriter, coordinate precision and the
+ *              optional turtle number and element index columns chosen in the save dialog
+ * 2026-10-18   SVG and CSV export format the element chunks concurrently (ExportPipeline)
+ * 2026-10-18   SVG export compressed on the fly (gzip) if the file name ends with .svgz
+ * 2026-10-18   SVG export optionally compact (rounded coordinates, viewBox scaling, colour
+ *              classes) with the precision chosen in the save dialog
+ * 2026-10-18   SVG export formats via a buffered SvgWriter (no iostream formatting),
+ *              the title now shows the file name
+ * 2026-10-18   Layered compositing: lines cached in a transparent layer per turtle,
+ *              background, axes, measuring line and turtle images composed per paint
+ * 2026-10-18   Damage rectangles coalesced by a DamageAccumulator (bounded set per frame)
+ * 2026-10-18   PNG export renders horizontal bands of bounded size and streams their rows
+ *              into a PngWriter instead of rendering into a bitmap of full bounds size
+ * 2026-10-18   Progressive, interruptible redrawing of the memory bitmap in onPaint()
+ * 2026-10-18   Damage collected thread-safely and flushed by a frame timer on the window
+ *              thread (VERSION 11.1.0: the turtle program runs in a different thread)
  * 2024-10-05   Explicit casts to avoid compiler warnings on numeric conversion
  * 2021-04-21   Snap radius dialog implemented
  * 2021-04-20   Coordinate input dialog implemented (still without icon and with odd font)
@@ -33,10 +64,21 @@
 #define WIDEN(x) WIDEN2(x)
 #define __WFILE__ WIDEN(__FILE__)
 
+#include <climits>
 #include <cmath>
 #include <fstream>
 #include <windowsx.h>
-#include "ImageEncoders.h"
+#include "CsvWriter.h"
+#include "DrawingAnimation.h"
+#include "DrawingWriter.h"
+#include "ExportPipeline.h"
+#include "ImageWriters.h"
+#include "PlotPlanner.h"
+#include "PlotterWriter.h"
+#include "PngEncoder.h"
+#include "Simplifier.h"
+#include "SvgWriter.h"
+#include "TilePyramid.h"
 
 const TurtleCanvas::NameType TurtleCanvas::WCLASS_NAME = TEXT("TurtleCanvas");
 
@@ -44,9 +86,9 @@ const TurtleCanvas::TDlgSaveCSV TurtleCanvas::tplSaveCSV = {
 	{
 		WS_CHILD | WS_CLIPSIBLINGS | DS_3DLOOK | DS_CONTROL,
 		0,
-		2 + N_CSV_SEPARATORS,
+		4 + N_CSV_SEPARATORS + N_CSV_PRECISIONS + N_CSV_EXTRA_COLUMNS + N_SIMPLIFY_TOLERANCES,
 		0, 0,		// relative horizontal and vertical position
-		75, 170		// horizontal and vertical size
+		150, 205	// horizontal and vertical size
 	},
 	0,	// no menu
 	0,	// standard dialog box class
@@ -62,6 +104,98 @@ const TurtleCanvas::TDlgSaveCSV TurtleCanvas::tplSaveCSV = {
 		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 45, 50, 10, IDC_CUST_START+3}, 0xFFFF, 0x0080, 0, 0},
 		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 60, 50, 10, IDC_CUST_START+4}, 0xFFFF, 0x0080, 0, 0},
 		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 75, 50, 10, IDC_CUST_START+5}, 0xFFFF, 0x0080, 0, 0},
+	},
+	// group box for the precision (label)
+	{{WS_VISIBLE | WS_CHILD | BS_GROUPBOX, 0, 1, 100, 70, 15 * N_CSV_PRECISIONS + 10, IDC_CUST_START+6}, 0xFFFF, 0x0080, 0, 0},
+	// radio buttons
+	{
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP, 0, 10, 110, 55, 10, IDC_CUST_START+7}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 125, 55, 10, IDC_CUST_START+8}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 140, 55, 10, IDC_CUST_START+9}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 155, 55, 10, IDC_CUST_START+10}, 0xFFFF, 0x0080, 0, 0},
+	},
+	// check boxes for the optional columns
+	{
+		{{WS_VISIBLE | WS_CHILD | BS_AUTOCHECKBOX | WS_GROUP, 0, 3, 175, 65, 10, IDC_CUST_START+11}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTOCHECKBOX, 0, 3, 190, 65, 10, IDC_CUST_START+12}, 0xFFFF, 0x0080, 0, 0},
+	},
+	// group box for the simplification (label)
+	{{WS_VISIBLE | WS_CHILD | BS_GROUPBOX, 0, 76, 5, 70, 15 * N_SIMPLIFY_TOLERANCES + 10, IDC_CUST_START+13}, 0xFFFF, 0x0080, 0, 0},
+	// radio buttons
+	{
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP, 0, 85, 15, 55, 10, IDC_CUST_START+14}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 85, 30, 55, 10, IDC_CUST_START+15}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 85, 45, 55, 10, IDC_CUST_START+16}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 85, 60, 55, 10, IDC_CUST_START+17}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 85, 75, 55, 10, IDC_CUST_START+18}, 0xFFFF, 0x0080, 0, 0},
+	}
+};
+
+const TurtleCanvas::TDlgSaveSVG TurtleCanvas::tplSaveSVG = {
+	{
+		WS_CHILD | WS_CLIPSIBLINGS | DS_3DLOOK | DS_CONTROL,
+		0,
+		4 + N_SVG_PRECISIONS + N_SVGZ_LEVELS + N_SIMPLIFY_TOLERANCES,
+		0, 0,		// relative horizontal and vertical position
+		190, 170	// horizontal and vertical size
+	},
+	0,	// no menu
+	0,	// standard dialog box class
+	0,	// no title
+	// static text control for positioning
+	{{WS_CHILD | WS_VISIBLE | SS_LEFT, 0, 0, 0, 0, 150, stc32}, 0xFFFF, 0x0082, 0, 0},
+	// group box (label)
+	{{WS_VISIBLE | WS_CHILD | BS_GROUPBOX, 0, 1, 5, 100, 15 * N_SVG_PRECISIONS + 10, IDC_CUST_START}, 0xFFFF, 0x0080, 0, 0},
+	// radio buttons
+	{
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP, 0, 10, 15, 85, 10, IDC_CUST_START+1}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 30, 85, 10, IDC_CUST_START+2}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 45, 85, 10, IDC_CUST_START+3}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 60, 85, 10, IDC_CUST_START+4}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 75, 85, 10, IDC_CUST_START+5}, 0xFFFF, 0x0080, 0, 0},
+	},
+	// group box for the compression level (label)
+	{{WS_VISIBLE | WS_CHILD | BS_GROUPBOX, 0, 1, 100, 100, 15 * N_SVGZ_LEVELS + 10, IDC_CUST_START+6}, 0xFFFF, 0x0080, 0, 0},
+	// radio buttons
+	{
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP, 0, 10, 110, 85, 10, IDC_CUST_START+7}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 125, 85, 10, IDC_CUST_START+8}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 140, 85, 10, IDC_CUST_START+9}, 0xFFFF, 0x0080, 0, 0},
+	},
+	// group box for the simplification (label)
+	{{WS_VISIBLE | WS_CHILD | BS_GROUPBOX, 0, 106, 5, 80, 15 * N_SIMPLIFY_TOLERANCES + 10, IDC_CUST_START+10}, 0xFFFF, 0x0080, 0, 0},
+	// radio buttons
+	{
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP, 0, 115, 15, 65, 10, IDC_CUST_START+11}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 115, 30, 65, 10, IDC_CUST_START+12}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 115, 45, 65, 10, IDC_CUST_START+13}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 115, 60, 65, 10, IDC_CUST_START+14}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 115, 75, 65, 10, IDC_CUST_START+15}, 0xFFFF, 0x0080, 0, 0},
+	}
+};
+
+const TurtleCanvas::TDlgSavePlot TurtleCanvas::tplSavePlot = {
+	{
+		WS_CHILD | WS_CLIPSIBLINGS | DS_3DLOOK | DS_CONTROL,
+		0,
+		2 + N_SIMPLIFY_TOLERANCES,
+		0, 0,		// relative horizontal and vertical position
+		85, 95		// horizontal and vertical size
+	},
+	0,	// no menu
+	0,	// standard dialog box class
+	0,	// no title
+	// static text control for positioning
+	{{WS_CHILD | WS_VISIBLE | SS_LEFT, 0, 0, 0, 0, 150, stc32}, 0xFFFF, 0x0082, 0, 0},
+	// group box for the simplification (label)
+	{{WS_VISIBLE | WS_CHILD | BS_GROUPBOX, 0, 1, 5, 80, 15 * N_SIMPLIFY_TOLERANCES + 10, IDC_CUST_START}, 0xFFFF, 0x0080, 0, 0},
+	// radio buttons
+	{
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP, 0, 10, 15, 65, 10, IDC_CUST_START+1}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 30, 65, 10, IDC_CUST_START+2}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 45, 65, 10, IDC_CUST_START+3}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 60, 65, 10, IDC_CUST_START+4}, 0xFFFF, 0x0080, 0, 0},
+		{{WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON, 0, 10, 75, 65, 10, IDC_CUST_START+5}, 0xFFFF, 0x0080, 0, 0},
 	}
 };
 
@@ -157,14 +291,18 @@ const TurtleCanvas::MenuDef TurtleCanvas::MENU_DEFINITIONS[] = {
 	{NULL, {}, nullptr, false},
 	//{TEXT("Update on every turtle action\tU"), {FVIRTKEY, LOBYTE(VkKeyScanA('U'))}, TurtleCanvas::handleToggleUpdate, true},
 	//{NULL, {}, nullptr, false},
+	{TEXT("Export drawing as binary file ...\tD"), {FVIRTKEY, LOBYTE(VkKeyScanA('D'))}, TurtleCanvas::handleExportDrawing, false},
 	{TEXT("Export drawing items as CSV ...\tX"), {FVIRTKEY, LOBYTE(VkKeyScanA('X'))}, TurtleCanvas::handleExportCSV, false},
+	{TEXT("Export drawing for pen plotter ...\tH"), {FVIRTKEY, LOBYTE(VkKeyScanA('H'))}, TurtleCanvas::handleExportPlot, false},
 	{TEXT("Export drawing as PNG ...\tCtrl+S"), {FCONTROL | FVIRTKEY, LOBYTE(VkKeyScanA('S'))}, TurtleCanvas::handleExportPNG, false},
-	{TEXT("Export drawing as SVG ...\tV"), {FVIRTKEY, LOBYTE(VkKeyScanA('V'))}, TurtleCanvas::handleExportSVG, false}
+	{TEXT("Export drawing animation (APNG) ...\tN"), {FVIRTKEY, LOBYTE(VkKeyScanA('N'))}, TurtleCanvas::handleExportAnimation, false},
+	{TEXT("Export drawing as SVG ...\tV"), {FVIRTKEY, LOBYTE(VkKeyScanA('V'))}, TurtleCanvas::handleExportSVG, false},
+	{TEXT("Export drawing as tile pyramid ...\tP"), {FVIRTKEY, LOBYTE(VkKeyScanA('P'))}, TurtleCanvas::handleExportTiles, false},
+	{TEXT("Export visible region as image or SVG ...\tW"), {FVIRTKEY, LOBYTE(VkKeyScanA('W'))}, TurtleCanvas::handleExportView, false}
 };
 // END KGU 2021-03-28
 
 // START KGU 2021-04-07: Issue #6 CSV export
-const char* TurtleCanvas::CSV_COL_HEADERS[] = { "xFrom", "yFrom", "xTo", "yTo", "color" };
 const char TurtleCanvas::CSV_SEPARATORS[N_CSV_SEPARATORS] = { ',', ';', '\t', ' ', ':' };
 // END KGU 2021-04-07
 // START KGU 2021-04-18: Separator configuration for CSV export (#6)
@@ -178,6 +316,63 @@ const TurtleCanvas::NameType TurtleCanvas::CSV_SEPARATOR_NAMES[N_CSV_SEPARATORS]
 };
 unsigned short TurtleCanvas::ixCSVSepa = 0;
 // END KGU 2021-04-18
+// START KGU 2026-10-18: Precision and column configuration for CSV export
+const int TurtleCanvas::CSV_PRECISIONS[N_CSV_PRECISIONS] = {
+	CsvWriter::PRECISION_INTEGRAL, 1, 2, 3
+};
+const TurtleCanvas::NameType TurtleCanvas::CSV_PRECISION = TEXT("Coordinates");
+const TurtleCanvas::NameType TurtleCanvas::CSV_PRECISION_NAMES[N_CSV_PRECISIONS] = {
+	TEXT("Integral"),
+	TEXT("1 decimal"),
+	TEXT("2 decimals"),
+	TEXT("3 decimals")
+};
+unsigned short TurtleCanvas::ixCSVPrecision = 0;
+const unsigned int TurtleCanvas::CSV_EXTRA_COLUMNS[N_CSV_EXTRA_COLUMNS] = {
+	CsvWriter::COL_TURTLE, CsvWriter::COL_INDEX
+};
+const TurtleCanvas::NameType TurtleCanvas::CSV_EXTRA_COLUMN_NAMES[N_CSV_EXTRA_COLUMNS] = {
+	TEXT("Turtle number"),
+	TEXT("Element index")
+};
+unsigned int TurtleCanvas::csvColumns = 0;
+// END KGU 2026-10-18
+// START KGU 2026-10-18: Precision configuration for SVG export
+const int TurtleCanvas::SVG_PRECISIONS[N_SVG_PRECISIONS] = {
+	SvgWriter::PRECISION_COMPATIBLE, 3, 2, 1, 0
+};
+const TurtleCanvas::NameType TurtleCanvas::SVG_PRECISION = TEXT("Coordinates");
+const TurtleCanvas::NameType TurtleCanvas::SVG_PRECISION_NAMES[N_SVG_PRECISIONS] = {
+	TEXT("Exact (compatible)"),
+	TEXT("Compact, 3 decimals"),
+	TEXT("Compact, 2 decimals"),
+	TEXT("Compact, 1 decimal"),
+	TEXT("Compact, integral")
+};
+unsigned short TurtleCanvas::ixSVGPrecision = 0;
+const int TurtleCanvas::SVGZ_LEVELS[N_SVGZ_LEVELS] = { 1, Deflater::DEFAULT_LEVEL, 9 };
+const TurtleCanvas::NameType TurtleCanvas::SVGZ_LEVEL = TEXT("Compression (svgz)");
+const TurtleCanvas::NameType TurtleCanvas::SVGZ_LEVEL_NAMES[N_SVGZ_LEVELS] = {
+	TEXT("Fast"),
+	TEXT("Normal"),
+	TEXT("Best")
+};
+unsigned short TurtleCanvas::ixSVGZLevel = 1;
+// END KGU 2026-10-18
+// START KGU 2026-10-18: Simplification tolerance for the vector exports (turtle units)
+const float TurtleCanvas::SIMPLIFY_TOLERANCES[N_SIMPLIFY_TOLERANCES] = {
+	0.0f, 0.1f, 0.25f, 0.5f, 1.0f
+};
+const TurtleCanvas::NameType TurtleCanvas::SIMPLIFICATION = TEXT("Simplification");
+const TurtleCanvas::NameType TurtleCanvas::SIMPLIFY_TOLERANCE_NAMES[N_SIMPLIFY_TOLERANCES] = {
+	TEXT("None"),
+	TEXT("0.1 pixel"),
+	TEXT("0.25 pixel"),
+	TEXT("0.5 pixel"),
+	TEXT("1 pixel")
+};
+unsigned short TurtleCanvas::ixSimplification = 0;
+// END KGU 2026-10-18
 
 TurtleCanvas::TurtleCanvas(Turtleizer& frame, HWND hFrame)
 	: pFrame(&frame)
@@ -202,6 +397,10 @@ TurtleCanvas::TurtleCanvas(Turtleizer& frame, HWND hFrame)
 	, mouseCoord(0, 0)
 	, tracksMouse(false)
 	, mustRedraw(true)
+	, statusPending(false)
+	, lastStatusUpdate(0)
+	, batchDepth(0)
+	, presentAll(false)
 {
 	this->hArrow = LoadCursor(NULL, IDC_ARROW);
 	this->hCross = LoadCursor(NULL, IDC_CROSS);
@@ -287,10 +486,16 @@ TurtleCanvas::TurtleCanvas(Turtleizer& frame, HWND hFrame)
 	// START KGU 2021-03-31: Issue #6
 	adjustScrollbars();
 	// END KGU 2021-03-21
+
+	// START KGU 2026-10-18: The collected damage is flushed in regular intervals
+	SetTimer(this->hCanvas, IDT_FRAME, FRAME_INTERVAL, NULL);
+	// END KGU 2026-10-18
 }
 
 TurtleCanvas::~TurtleCanvas()
 {
+	KillTimer(this->hCanvas, IDT_FRAME);
+	this->releaseBuffers();
 	if (this->hAccel != NULL) {
 		DestroyAcceleratorTable(this->hAccel);
 	}
@@ -305,6 +510,17 @@ LRESULT TurtleCanvas::CanvasWndProc(HWND hWnd, UINT message, WPARAM wParam, LPAR
 		pInstance->onPaint();	// instance-specific refresh
 		pInstance->adjustScrollbars();
 		return FALSE;
+	// START KGU 2026-10-18: Frame timer for the damage collected from the turtle thread
+	case WM_TIMER:
+		if (wParam == IDT_FRAME) {
+			pInstance->onFrameTimer();
+			return FALSE;
+		}
+		return DefWindowProc(hWnd, message, wParam, lParam);
+	case WM_PRESENT:
+		pInstance->onPresent();
+		return FALSE;
+	// END KGU 2026-10-18
 	case WM_CONTEXTMENU:
 	{
 		// FIXME extract the coordinates from lParam
@@ -379,6 +595,29 @@ UINT_PTR TurtleCanvas::saveCSVHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPA
 				}
 			}
 		}
+		// START KGU 2026-10-18: Precision and optional columns
+		const UINT idPrecGroup = IDC_CUST_START + N_CSV_SEPARATORS + 1;
+		SetDlgItemText(hDlg, idPrecGroup, CSV_PRECISION);
+		for (unsigned short i = 0; i < N_CSV_PRECISIONS; i++) {
+			UINT idRBtn = idPrecGroup + i + 1;
+			if (GetDlgItem(hDlg, idRBtn) != NULL) {
+				SetDlgItemText(hDlg, idRBtn, CSV_PRECISION_NAMES[i]);
+				if (i == ixCSVPrecision) {
+					CheckDlgButton(hDlg, idRBtn, BST_CHECKED);
+				}
+			}
+		}
+		for (unsigned short i = 0; i < N_CSV_EXTRA_COLUMNS; i++) {
+			UINT idCBox = idPrecGroup + N_CSV_PRECISIONS + i + 1;
+			if (GetDlgItem(hDlg, idCBox) != NULL) {
+				SetDlgItemText(hDlg, idCBox, CSV_EXTRA_COLUMN_NAMES[i]);
+				if (csvColumns & CSV_EXTRA_COLUMNS[i]) {
+					CheckDlgButton(hDlg, idCBox, BST_CHECKED);
+				}
+			}
+		}
+		initSimplificationButtons(hDlg, idPrecGroup + N_CSV_PRECISIONS + N_CSV_EXTRA_COLUMNS + 1);
+		// END KGU 2026-10-18
 	}
 		return FALSE;
 	case WM_NOTIFY:
@@ -392,6 +631,21 @@ UINT_PTR TurtleCanvas::saveCSVHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPA
 					ixCSVSepa = i;
 				}
 			}
+			// START KGU 2026-10-18: Precision and optional columns
+			for (unsigned short i = 0; i < N_CSV_PRECISIONS; i++) {
+				if (IsDlgButtonChecked(hDlg, i + IDC_CUST_START + N_CSV_SEPARATORS + 2)) {
+					ixCSVPrecision = i;
+				}
+			}
+			csvColumns = 0;
+			for (unsigned short i = 0; i < N_CSV_EXTRA_COLUMNS; i++) {
+				if (IsDlgButtonChecked(hDlg, i + IDC_CUST_START + N_CSV_SEPARATORS + N_CSV_PRECISIONS + 2)) {
+					csvColumns |= CSV_EXTRA_COLUMNS[i];
+				}
+			}
+			readSimplificationButtons(hDlg,
+				IDC_CUST_START + N_CSV_SEPARATORS + N_CSV_PRECISIONS + N_CSV_EXTRA_COLUMNS + 2);
+			// END KGU 2026-10-18
 			break;
 		default:
 			break;
@@ -404,6 +658,110 @@ UINT_PTR TurtleCanvas::saveCSVHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPA
 	}
 }
 
+UINT_PTR TurtleCanvas::saveSVGHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPARAM lParam)
+{
+	switch (msgId) {
+	case WM_INITDIALOG:
+	{
+		SetDlgItemText(hDlg, IDC_CUST_START, SVG_PRECISION);
+		for (unsigned short i = 0; i < N_SVG_PRECISIONS; i++) {
+			UINT idRBtn = IDC_CUST_START + i + 1;
+			HWND hBtn = GetDlgItem(hDlg, idRBtn);
+			if (hBtn != NULL) {
+				SetDlgItemText(hDlg, idRBtn, SVG_PRECISION_NAMES[i]);
+				if (i == ixSVGPrecision) {
+					CheckDlgButton(hDlg, idRBtn, BST_CHECKED);
+				}
+			}
+		}
+		const UINT idLevelGroup = IDC_CUST_START + N_SVG_PRECISIONS + 1;
+		SetDlgItemText(hDlg, idLevelGroup, SVGZ_LEVEL);
+		for (unsigned short i = 0; i < N_SVGZ_LEVELS; i++) {
+			UINT idRBtn = idLevelGroup + i + 1;
+			HWND hBtn = GetDlgItem(hDlg, idRBtn);
+			if (hBtn != NULL) {
+				SetDlgItemText(hDlg, idRBtn, SVGZ_LEVEL_NAMES[i]);
+				if (i == ixSVGZLevel) {
+					CheckDlgButton(hDlg, idRBtn, BST_CHECKED);
+				}
+			}
+		}
+		initSimplificationButtons(hDlg, idLevelGroup + N_SVGZ_LEVELS + 1);
+	}
+		return FALSE;
+	case WM_NOTIFY:
+	{
+		OFNOTIFY* pNotify = (OFNOTIFY*)lParam;
+		if (pNotify->hdr.code == CDN_FILEOK) {
+			for (unsigned short i = 0; i < N_SVG_PRECISIONS; i++) {
+				if (IsDlgButtonChecked(hDlg, i + IDC_CUST_START + 1)) {
+					ixSVGPrecision = i;
+				}
+			}
+			for (unsigned short i = 0; i < N_SVGZ_LEVELS; i++) {
+				if (IsDlgButtonChecked(hDlg, i + IDC_CUST_START + N_SVG_PRECISIONS + 2)) {
+					ixSVGZLevel = i;
+				}
+			}
+			readSimplificationButtons(hDlg, IDC_CUST_START + N_SVG_PRECISIONS + N_SVGZ_LEVELS + 2);
+		}
+	}
+		return FALSE;
+
+	default:
+		return FALSE;
+	}
+}
+
+UINT_PTR TurtleCanvas::savePlotHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPARAM lParam)
+{
+	switch (msgId) {
+	case WM_INITDIALOG:
+		initSimplificationButtons(hDlg, IDC_CUST_START);
+		return FALSE;
+	case WM_NOTIFY:
+	{
+		OFNOTIFY* pNotify = (OFNOTIFY*)lParam;
+		if (pNotify->hdr.code == CDN_FILEOK) {
+			readSimplificationButtons(hDlg, IDC_CUST_START);
+		}
+	}
+		return FALSE;
+
+	default:
+		return FALSE;
+	}
+}
+
+void TurtleCanvas::initSimplificationButtons(HWND hDlg, UINT idGroup)
+{
+	SetDlgItemText(hDlg, idGroup, SIMPLIFICATION);
+	for (unsigned short i = 0; i < N_SIMPLIFY_TOLERANCES; i++) {
+		UINT idRBtn = idGroup + i + 1;
+		if (GetDlgItem(hDlg, idRBtn) != NULL) {
+			SetDlgItemText(hDlg, idRBtn, SIMPLIFY_TOLERANCE_NAMES[i]);
+			if (i == ixSimplification) {
+				CheckDlgButton(hDlg, idRBtn, BST_CHECKED);
+			}
+		}
+	}
+}
+
+void TurtleCanvas::readSimplificationButtons(HWND hDlg, UINT idGroup)
+{
+	for (unsigned short i = 0; i < N_SIMPLIFY_TOLERANCES; i++) {
+		if (IsDlgButtonChecked(hDlg, idGroup + i + 1)) {
+			ixSimplification = i;
+		}
+	}
+}
+
+std::unique_ptr<Simplifier> TurtleCanvas::makeSimplifier()
+{
+	float tolerance = SIMPLIFY_TOLERANCES[ixSimplification];
+	return std::unique_ptr<Simplifier>(tolerance > 0 ? new Simplifier(tolerance) : nullptr);
+}
+
 BOOL CALLBACK TurtleCanvas::DialogCoordProc(HWND hDlg, UINT msgId, WPARAM wParam, LPARAM lParam)
 {
 	TurtleCanvas* pInstance = getInstance();
@@ -633,32 +991,96 @@ BOOL CALLBACK TurtleCanvas::AdjustChildFontProc(HWND hWnd, LPARAM lParam)
 
 void TurtleCanvas::redraw(const RectF& rectF, int nElements)
 {
-	// Perform the coordinate transformations
-	RECT rect;
-	rect.left = (LONG)((rectF.X + this->displacement.X) * this->zoomFactor - this->scrollPos.x);
-	rect.top = (LONG)((rectF.Y + this->displacement.Y) * this->zoomFactor - this->scrollPos.y);
-	rect.right = rect.left + (LONG)(this->zoomFactor * rectF.Width);
-	rect.bottom = rect.top + (LONG)(this->zoomFactor * rectF.Height);
-	InvalidateRect(this->hCanvas, &rect, TRUE);
-	if (this->autoUpdate
-		// START KGU4 2016-11-02: Reduce degrading of drawing speed with growing history
-		&& (nElements % (nElements / 20 + 1) == 0)
-		// END KGU4 2016-11-02
-		) {
-		UpdateWindow(this->hCanvas);
-	}
+	// START KGU 2026-10-18: Called from the turtle thread - so we must not paint here,
+	// the damage is only collected and will be invalidated by onFrameTimer()
+	SegmentBounds rect = { rectF.X, rectF.Y, rectF.GetRight(), rectF.GetBottom() };
+	this->damage.add(rect);
+	// END KGU 2026-10-18
 }
 
 void TurtleCanvas::redraw(bool automatic, const RECT* pRect)
 {
+	// START KGU 2026-10-18: Set the mode first, as the frame timer may interfere
+	this->autoUpdate = automatic;
+	// END KGU 2026-10-18
+	RECT rcClient;
 	if (pRect == nullptr) {
-		RECT rcClient;
 		GetClientRect(this->hCanvas, &rcClient);
 		pRect = &rcClient;
+		// The collected damage is covered now
+		this->damage.clear();
 	}
 	InvalidateRect(this->hCanvas, pRect, FALSE);
 	UpdateWindow(this->hCanvas);
-	this->autoUpdate = automatic;
+}
+
+void TurtleCanvas::invalidateAll()
+{
+	this->damage.clear();
+	InvalidateRect(this->hCanvas, NULL, FALSE);
+}
+
+void TurtleCanvas::beginBatch()
+{
+	this->batchDepth++;
+}
+
+void TurtleCanvas::endBatch()
+{
+	// (A surplus call must not wrap the counter around)
+	unsigned int depth = this->batchDepth;
+	while (depth > 0 && !this->batchDepth.compare_exchange_weak(depth, depth - 1)) {}
+	if (depth == 1) {
+		// The window thread is to present the result without waiting for the frame timer
+		PostMessage(this->hCanvas, WM_PRESENT, 0, 0);
+	}
+}
+
+void TurtleCanvas::cancelBatches()
+{
+	this->batchDepth = 0;
+	this->presentAll = false;
+}
+
+VOID TurtleCanvas::onPresent()
+{
+	if (this->batchDepth > 0) {
+		// Another scope has been opened meanwhile
+		return;
+	}
+	if (this->presentAll.exchange(false)) {
+		// Layers rebuilt within the scope are still incomplete
+		this->invalidateAll();
+	}
+	this->onFrameTimer();
+}
+
+VOID TurtleCanvas::onFrameTimer()
+{
+	if (this->autoUpdate && this->batchDepth == 0 && this->damage.take(this->damagedRects)) {
+		this->statusPending = true;
+		for (const SegmentBounds& rectF : this->damagedRects) {
+			// Perform the coordinate transformations
+			RECT rect;
+			rect.left = (LONG)((rectF.left + this->displacement.X) * this->zoomFactor - this->scrollPos.x);
+			rect.top = (LONG)((rectF.top + this->displacement.Y) * this->zoomFactor - this->scrollPos.y);
+			rect.right = rect.left + (LONG)(this->zoomFactor * (rectF.right - rectF.left));
+			rect.bottom = rect.top + (LONG)(this->zoomFactor * (rectF.bottom - rectF.top));
+			InvalidateRect(this->hCanvas, &rect, TRUE);
+		}
+#if DEBUG_PRINT
+		DamageAccumulator::Stats stats = this->damage.getStats();
+		printf("damage: %llu raw -> %llu coalesced rects in %llu frames (%llu collapsed)\n",
+			stats.nRaw, stats.nCoalesced, stats.nFrames, stats.nCollapsed);
+#endif /*DEBUG_PRINT*/
+	}
+	// The statusbar update is comparatively expensive, so we do it less often
+	DWORD now = GetTickCount();
+	if (this->statusPending && now - this->lastStatusUpdate >= STATUS_INTERVAL) {
+		this->statusPending = false;
+		this->lastStatusUpdate = now;
+		this->pFrame->updateStatusbar();
+	}
 }
 
 TurtleCanvas* TurtleCanvas::getInstance()
@@ -724,7 +1146,7 @@ void TurtleCanvas::scroll(bool horizontally, bool forward, bool large, unsigned
 		}
 		this->scrollPos.y = newScr;
 	}
-	this->mustRedraw = true;
+	this->setDirty();
 	// Force the mouse coordinate to be updated
 	if (this->hTooltip != NULL) {
 		SendMessage(this->hTooltip, TTM_TRACKACTIVATE, (WPARAM)FALSE,
@@ -799,6 +1221,11 @@ RECT TurtleCanvas::getScrollRect() const
 	return rcClient;
 }
 
+DamageAccumulator::Stats TurtleCanvas::getDamageStats() const
+{
+	return this->damage.getStats();
+}
+
 bool TurtleCanvas::translateAccelerators(LPMSG pMessage) const
 {
 	bool done = false;
@@ -821,33 +1248,39 @@ VOID TurtleCanvas::onPaint()
 	HCURSOR oldCursor = GetCursor();
 	PAINTSTRUCT  ps;
 	HDC hdc = BeginPaint(this->hCanvas, &ps);
+	// START KGU 2026-10-18: Flags and turtle list may be modified by the turtle thread
+	bool mustRedraw = this->mustRedraw.exchange(false);
+	Turtleizer::Turtles turtles = pFrame->getTurtles();
+	bool complete = true;	// Whether all elements have got into the layers
+	bool deferred = this->batchDepth > 0;	// Whether new lines are to wait for the end of the batch
+	bool rebuilt = false;	// Whether a layer had to be redrawn from scratch
+	// END KGU 2026-10-18
 	
 	Graphics graphics(hdc);
 #if DEBUG_PRINT
 	//printf("executing onPaint on window %x\n", (unsigned int)this->hCanvas);	// DEBUG
 #endif /*DEBUG_PRINT*/
 
-	if (mustRedraw && this->hdcScrCompat != NULL) {
-		DeleteDC(this->hdcScrCompat);
-		DeleteObject(this->hBmpCompat);	// FIXME: Might it already have been deleted?;
-		this->hBmpCompat = NULL;
-		this->hdcScrCompat = NULL;
+	// START KGU 2026-10-18: The buffers only have to be replaced if the screen size changed
+	if (this->hdcScrCompat != NULL
+		&& (this->bmp.bmWidth != GetDeviceCaps(hdc, HORZRES)
+			|| this->bmp.bmHeight != GetDeviceCaps(hdc, VERTRES))) {
+		this->releaseBuffers();
 	}
+	// END KGU 2026-10-18
 	if (this->hdcScrCompat == NULL) {
-		// Create a memory DC as bitmap backup for the turtle drawings
-		// (these do not need redrawing, only additions unless the
-		// background gets changed or certain turtle trayectories get cleared.
-		// Therefore we do not have to redraw all but only the most recently
-		// added lines into the bitmap and may then do a bitblp.
+		// Create a memory DC as bitmap backup for the composed picture.
+		// START KGU 2026-10-18: The turtle drawings are cached in one transparent
+		// layer per turtle (these do not need redrawing, only additions unless
+		// the respective turtle clears its trajectory). Therefore we do not have
+		// to redraw all but only the most recently added lines into the layers.
+		// Background, layers, axes, measuring line and turtle images are then
+		// composed in the memory DC (only within the region to be painted) and
+		// copied to the screen by a bitblt, such that changing the background,
+		// toggling the axes, or moving the turtles never requires a line redraw.
 		// On scrolling, zooming, or resizing, however, we will have to
-		// produce a new bitmap from scratch.
-		// 
-		// Only the turtle images and the measuring lines are to be drawn
-		// directly onto the screen afterwards. This should dramatically
-		// accelerate drawing (with the price of a buffered bitmap)
-		// screen. The normal DC provides a snapshot of the 
-		// screen contents. The memory DC keeps a copy of this 
-		// snapshot in the associated bitmap.
+		// produce the layers from scratch.
+		// END KGU 2026-10-18
 		SetCursor(this->hWait);
 		this->hdcScrCompat = CreateCompatibleDC(hdc);
 		if (this->hdcScrCompat == NULL) {
@@ -884,23 +1317,81 @@ VOID TurtleCanvas::onPaint()
 	// END KGU 2021-03-21
 
 	if (this->hdcScrCompat != NULL) {
-		Graphics grCompat(this->hdcScrCompat);
-		if (mustRedraw) {
-			grCompat.Clear(pFrame->backgroundColour);
+		// START KGU 2026-10-18: Bring the segment layers of all turtles up to date
+		// (the number of layers is bounded, so the surplus turtles share the last one)
+		size_t nLayers = (std::min)(turtles.size(), MAX_LAYERS);
+		this->fitLayers(nLayers);
+		std::vector<std::vector<std::pair<Turtle*, unsigned int>>> contents(nLayers);
+		std::vector<size_t> layerIndices;	// Layer index per turtle
+		for (Turtleizer::Turtles::const_iterator it(turtles.begin()); it != turtles.end(); ++it)
+		{
+			size_t ixLayer = (std::min)(layerIndices.size(), nLayers - 1);
+			layerIndices.push_back(ixLayer);
+			contents[ixLayer].push_back(std::make_pair(*it, (*it)->getGeneration()));
+		}
+		std::vector<std::unique_ptr<Graphics>> layerGraphics;
+		for (size_t ixLayer = 0; ixLayer < nLayers; ixLayer++)
+		{
+			TurtleLayer& layer = this->layers[ixLayer];
+			Graphics* pGrLayer = new Graphics(layer.pBitmap);
+			layerGraphics.emplace_back(pGrLayer);
+			// A turtle that has cleared its trajectory only requires its own layer redrawn
+			// (or the shared one, together with the other turtles therein)
+			if (mustRedraw || contents[ixLayer] != layer.contents) {
+				pGrLayer->Clear(Color(0, 0, 0, 0));
+				for (const std::pair<Turtle*, unsigned int>& content : contents[ixLayer]) {
+					content.first->draw(*pGrLayer, true, false, 0);
+				}
+				layer.contents.swap(contents[ixLayer]);
+				rebuilt = true;
+			}
+			pGrLayer->TranslateTransform(-(REAL)this->scrollPos.x, -(REAL)this->scrollPos.y);
+			pGrLayer->ScaleTransform(this->zoomFactor, this->zoomFactor);
+			pGrLayer->TranslateTransform(this->displacement.X, this->displacement.Y);
 		}
-		grCompat.TranslateTransform(-(REAL)this->scrollPos.x, -(REAL)this->scrollPos.y);
-		grCompat.ScaleTransform(this->zoomFactor, this->zoomFactor);
-		grCompat.TranslateTransform(this->displacement.X, this->displacement.Y);
 
 		// Draw / update the recorded lines (without the turtle images temselves)
-		for (Turtleizer::Turtles::const_iterator it(pFrame->turtles.begin()); it != pFrame->turtles.end(); ++it)
+		// in slices and stop when the time budget is exhausted or user input is
+		// waiting (the rest will follow). So a burst of zoom or scroll requests
+		// gets handled between the slices, each restarting the redraw via setDirty().
+		// Within a deferred update, only layers redrawn from scratch are filled
+		DWORD startTime = GetTickCount();
+		if (!deferred || rebuilt) {
+			do {
+				complete = true;
+				size_t ix = 0;
+				for (Turtleizer::Turtles::const_iterator it(turtles.begin()); it != turtles.end(); ++it, ix++)
+				{
+					if (!(*it)->draw(*layerGraphics[layerIndices[ix]], false, false, PAINT_SLICE_SIZE)) {
+						complete = false;
+					}
+				}
+			} while (!complete
+				&& GetTickCount() - startTime < PAINT_TIME_BUDGET
+				&& HIWORD(GetQueueStatus(QS_INPUT)) == 0);
+		}
+		layerGraphics.clear();
+
+		// Compose the picture in the memory DC (only within the region to be painted)
+		RECT* prect = &ps.rcPaint;
+		Rect rcPaint(prect->left, prect->top, prect->right - prect->left, prect->bottom - prect->top);
+		Graphics grCompat(this->hdcScrCompat);
+		grCompat.SetClip(rcPaint);
+		grCompat.Clear(pFrame->getBackground());
+		grCompat.SetCompositingQuality(CompositingQualityHighSpeed);
+		grCompat.SetInterpolationMode(InterpolationModeNearestNeighbor);
+		for (size_t ixLayer = 0; ixLayer < nLayers; ixLayer++)
 		{
-			(*it)->draw(grCompat, mustRedraw, false);
+			grCompat.DrawImage(this->layers[ixLayer].pBitmap, rcPaint,
+				rcPaint.X, rcPaint.Y, rcPaint.Width, rcPaint.Height, UnitPixel);
 		}
+		grCompat.TranslateTransform(-(REAL)this->scrollPos.x, -(REAL)this->scrollPos.y);
+		grCompat.ScaleTransform(this->zoomFactor, this->zoomFactor);
+		grCompat.TranslateTransform(this->displacement.X, this->displacement.Y);
+		this->drawOverlays(grCompat, turtles);
 
 		// Now copy the contents to the true context
-		RECT* prect = &ps.rcPaint;	// FIXME in certain cases we might need the entire client area
-
+		// (if the drawing is incomplete then it will be a partial result)
 		BitBlt(ps.hdc,
 			prect->left, prect->top,
 			(prect->right - prect->left),
@@ -909,10 +1400,36 @@ VOID TurtleCanvas::onPaint()
 			prect->left,
 			prect->top,
 			SRCCOPY);
+		// END KGU 2026-10-18
+	}
+	else {
+		// Unfortunately we must draw all directly...
+
+		// Draw / update the recorded lines (without the turtle images temselves)
+		for (Turtleizer::Turtles::const_iterator it(turtles.begin()); it != turtles.end(); ++it)
+		{
+			(*it)->draw(graphics, true, false);
+		}
+		this->drawOverlays(graphics, turtles);
+	}
 
+	EndPaint(this->hCanvas, &ps);
+	// START KGU 2026-10-18: Continue an incomplete drawing with the next WM_PAINT, which
+	// will only be delivered after pending input messages
+	if (!complete && deferred) {
+		// The rest will follow when the deferred update ends
+		this->presentAll = true;
+	}
+	else if (!complete) {
+		InvalidateRect(this->hCanvas, NULL, FALSE);
 	}
+	// END KGU 2026-10-18
+	SetCursor(oldCursor);
+}
 
-	// Now draw all things that may be switched off or moved directly on the screen
+void TurtleCanvas::drawOverlays(Graphics& gr, const std::list<Turtle*>& turtles) const
+{
+	// Now draw all things that may be switched off or moved
 
 	// START KGU 2021-03-31: Enh. #6 Draw the axes crossing if specified directly
 	if (this->showAxes) {
@@ -920,49 +1437,54 @@ VOID TurtleCanvas::onPaint()
 		Pen pen(Color(0xff, 0xcc, 0xcc), 1 / this->zoomFactor);
 		REAL dashPattern[] = { 2.0f /*/ this->zoomFactor*/, 2.0f /*/ this->zoomFactor*/ };
 		pen.SetDashPattern(dashPattern, 2);
-		graphics.DrawLine(&pen, (int)bounds.X, 0, (int)(bounds.X + bounds.Width), 0);
-		graphics.DrawLine(&pen, 0, (int)bounds.Y, 0, (int)(bounds.Y + bounds.Height));
+		gr.DrawLine(&pen, (int)bounds.X, 0, (int)(bounds.X + bounds.Width), 0);
+		gr.DrawLine(&pen, 0, (int)bounds.Y, 0, (int)(bounds.Y + bounds.Height));
 	}
-
 	// END KGU 2021-03-31
+
 	// Draw the measuring line.
-	// It is of course more logical to do it after all the turtle lines, but in case
-	// we can't use the memory DC with the fast BitBlt we will have to start with the
-	// measuring line because the process is much slower than the mouse tracking such
-	// that it may often get aborted before it is the turn to draw the measuring line
-	// otherwise. Even at the beginning it is often not drawn completely, or remnants
-	// stay on the window. :-(
 	if (this->pDragStart != NULL && this->tracksMouse) {
 		Pen pen(Color(0xcc, 0xcc, 0xff), 1 / this->zoomFactor);
 		REAL dashPattern[] = { 4.0f /*/ this->zoomFactor*/, 4.0f /*/ this->zoomFactor*/ };
 		pen.SetDashPattern(dashPattern, 2);
-		graphics.DrawLine(&pen,
+		gr.DrawLine(&pen,
 			(int)this->pDragStart->X, (int)this->pDragStart->Y,
 			(int)this->mouseCoord.X, (int)this->mouseCoord.Y);
 	}
 
-	if (this->hdcScrCompat != NULL) {
-		// Draw the turtle images directly on the true device context
-		for (Turtleizer::Turtles::const_iterator it(pFrame->turtles.begin()); it != pFrame->turtles.end(); ++it)
-		{
-			(*it)->drawImage(graphics);
-		}
+	// Draw the turtle images at last
+	for (Turtleizer::Turtles::const_iterator it(turtles.begin()); it != turtles.end(); ++it)
+	{
+		(*it)->drawImage(gr);
 	}
-	else {
-		// Unfortunately we must draw all directly...
+}
 
-		// Draw / update the recorded lines (without the turtle images temselves)
-		for (Turtleizer::Turtles::const_iterator it(pFrame->turtles.begin()); it != pFrame->turtles.end(); ++it)
-		{
-			(*it)->draw(graphics);
-		}
+void TurtleCanvas::fitLayers(size_t nLayers)
+{
+	while (this->layers.size() > nLayers) {
+		delete this->layers.back().pBitmap;
+		this->layers.pop_back();
 	}
+	while (this->layers.size() < nLayers) {
+		// The (transparent) layer will be cleared and drawn from scratch before use,
+		// as its empty contents can't match
+		TurtleLayer layer;
+		layer.pBitmap = new Bitmap(this->bmp.bmWidth, this->bmp.bmHeight, PixelFormat32bppPARGB);
+		this->layers.push_back(layer);
+	}
+}
 
-	this->mustRedraw = false;
-
-	// END KGU 2021-03-31
-	EndPaint(this->hCanvas, &ps);
-	SetCursor(oldCursor);
+void TurtleCanvas::releaseBuffers()
+{
+	this->fitLayers(0);
+	if (this->hdcScrCompat != NULL) {
+		DeleteDC(this->hdcScrCompat);
+		this->hdcScrCompat = NULL;
+	}
+	if (this->hBmpCompat != NULL) {
+		DeleteObject(this->hBmpCompat);
+		this->hBmpCompat = NULL;
+	}
 }
 
 VOID TurtleCanvas::onContextMenu(int x, int y)
@@ -1104,7 +1626,7 @@ VOID TurtleCanvas::onScrollEvent(WORD scrollAction, WORD pos, BOOL isVertical)
 		}
 		break;
 	}
-	this->mustRedraw = true;
+	this->setDirty();
 	InvalidateRect(this->hCanvas, &rcClient, FALSE);
 	this->pFrame->updateStatusbar();
 }
@@ -1250,7 +1772,7 @@ void TurtleCanvas::scrollToCoord(const PointF& coord)
 			(LPARAM)&this->tooltipInfo);
 	}
 	this->tracksMouse = false;
-	this->mustRedraw = true;
+	this->setDirty();
 	InvalidateRect(this->hCanvas, &rcClient, TRUE);
 	UpdateWindow(this->hCanvas);
 	this->pFrame->updateStatusbar();
@@ -1285,11 +1807,12 @@ BOOL TurtleCanvas::handleGotoTurtle(bool testOnly)
 	printf("handleGotoTurtle\n");
 #endif /*DEBUG_PRINT*/
 	TurtleCanvas* pInstance = getInstance();
-	BOOL canDo = !pInstance->pFrame->turtles.empty();
+	Turtleizer::Turtles turtles = pInstance->pFrame->getTurtles();
+	BOOL canDo = !turtles.empty();
 	if (!canDo || testOnly) {
 		return canDo;
 	}
-	Turtle* turtle0 = getInstance()->pFrame->turtles.front();
+	Turtle* turtle0 = turtles.front();
 	PointF posTurtle((REAL)turtle0->getX(), (REAL)turtle0->getY());
 	getInstance()->scrollToCoord(posTurtle);
 	return TRUE;
@@ -1340,7 +1863,7 @@ BOOL TurtleCanvas::handleZoom100(bool testOnly)
 	// Try to keep current center coordinate
 	PointF center = pInstance->getCenterCoord();
 	pInstance->zoomFactor = 1.0f;
-	pInstance->mustRedraw = true;
+	pInstance->setDirty();
 	pInstance->scrollToCoord(center);
 	return TRUE;
 }
@@ -1363,7 +1886,7 @@ BOOL TurtleCanvas::handleZoomBounds(bool testOnly)
 	pInstance->zoomFactor = max(MIN_ZOOM, min(zoomH, zoomV));
 	pInstance->scrollPos.x = 0;
 	pInstance->scrollPos.y = 0;
-	pInstance->mustRedraw = true;
+	pInstance->setDirty();
 	pInstance->redraw(pInstance->autoUpdate);
 	pInstance->adjustScrollbars();
 	pInstance->pFrame->updateStatusbar();
@@ -1413,7 +1936,7 @@ BOOL TurtleCanvas::handleToggleTurtle(bool testOnly)
 	printf("handleToggleTurtle\n");
 #endif /*DEBUG_PRINT*/
 	Turtleizer* pInstance = getInstance()->pFrame;
-	BOOL isToCheck = pInstance->turtles.front()->isTurtleShown();
+	BOOL isToCheck = pInstance->getTurtles().front()->isTurtleShown();
 	if (testOnly) {
 		return isToCheck;
 	}
@@ -1435,7 +1958,7 @@ BOOL TurtleCanvas::handleSetBackground(bool testOnly)
 	config.lStructSize = sizeof(CHOOSECOLOR);
 	config.hwndOwner = pInstance->hCanvas;
 	config.hInstance = NULL;
-	config.rgbResult = pInstance->pFrame->backgroundColour.ToCOLORREF();
+	config.rgbResult = pInstance->pFrame->getBackground().ToCOLORREF();
 	config.lpCustColors = pInstance->customColors;
 	config.Flags = CC_RGBINIT;
 
@@ -1545,7 +2068,7 @@ BOOL TurtleCanvas::handleExportCSV(bool testOnly)
 #endif /*DEBUG_PRINT*/
 	BOOL canDo = FALSE;
 	TurtleCanvas* pInstance = getInstance();
-	for (Turtle* pTurtle : pInstance->pFrame->turtles) {
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
 		if (pTurtle->hasElements()) {
 			canDo = TRUE;
 			break;
@@ -1562,20 +2085,36 @@ BOOL TurtleCanvas::handleExportCSV(bool testOnly)
 	if (ixNameStart != 0xFFFFFFFF) {
 		HCURSOR oldCursor = GetCursor();
 		SetCursor(pInstance->hWait);
-		const unsigned short nCols = sizeof(CSV_COL_HEADERS) / sizeof(char*);
 		char separator = CSV_SEPARATORS[ixCSVSepa];	// Chosen separator
 		std::ofstream ostr(szFile);
 		if (ostr.is_open()) {
-			for (unsigned short col = 0; col < nCols; col++) {
-				if (col > 0) {
-					ostr << separator;
+			// START KGU 2026-10-18: Block-buffered CsvWriter, rows formatted concurrently
+			CsvWriter csv(ostr, separator, CSV_PRECISIONS[ixCSVPrecision], csvColumns);
+			csv.writeHeader();
+			ExportPipeline pipeline;
+			std::unique_ptr<Simplifier> pSimplifier = makeSimplifier();
+			unsigned int turtleNo = 0;
+			for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+				if (!pSimplifier) {
+					pTurtle->writeCSV(csv, turtleNo++, &pipeline);
+					continue;
 				}
-				ostr << CSV_COL_HEADERS[col];
+				// The simplified lines replace the elements (the indices enumerate them)
+				std::vector<SegmentChunkView> chunks, simplified;
+				std::vector<std::vector<Segment>> storage;
+				std::unique_ptr<SegmentStore::ReadLock> pLock = pTurtle->lockChunks(chunks);
+				pSimplifier->simplifyChunks(chunks, simplified, storage, &pipeline);
+				Turtle::writeChunksCSV(csv, turtleNo++, simplified, &pipeline);
 			}
-			ostr << std::endl;
-			for (Turtle* pTurtle : pInstance->pFrame->turtles) {
-				pTurtle->writeCSV(ostr, separator);
+			csv.flush();
+#if DEBUG_PRINT
+			printf("CSV export: %llu rows\n", (unsigned long long)csv.getRowCount());
+#endif /*DEBUG_PRINT*/
+			if (pSimplifier) {
+				SetCursor(oldCursor);
+				pInstance->reportSimplification(*pSimplifier);
 			}
+			// END KGU 2026-10-18
 		}
 		else {
 			MessageBox(
@@ -1598,14 +2137,14 @@ BOOL TurtleCanvas::handleExportCSV(bool testOnly)
 	return TRUE;
 }
 
-BOOL TurtleCanvas::handleExportPNG(bool testOnly)
+BOOL TurtleCanvas::handleExportDrawing(bool testOnly)
 {
 #if DEBUG_PRINT
-	printf("handleExportPNG\n");
+	printf("handleExportDrawing\n");
 #endif /*DEBUG_PRINT*/
 	BOOL canDo = FALSE;
 	TurtleCanvas* pInstance = getInstance();
-	for (Turtle* pTurtle : pInstance->pFrame->turtles) {
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
 		if (pTurtle->hasElements()) {
 			canDo = TRUE;
 			break;
@@ -1615,72 +2154,203 @@ BOOL TurtleCanvas::handleExportPNG(bool testOnly)
 		return canDo;
 	}
 	TCHAR szFile[_MAX_PATH] = { 0 };       // The buffer for the file path
-	RectF bounds = pInstance->pFrame->getBounds();
-	WORD ixNameStart = pInstance->chooseFileName(TEXT("All files\0*.*\0PNG files\0*.PNG\0"),
-		TEXT("png"), szFile);
+	WORD ixNameStart = pInstance->chooseFileName(
+		TEXT("All files\0*.*\0Turtleizer drawing files\0*.TZD\0"),
+		TEXT("tzd"), szFile);
 	if (ixNameStart != 0xFFFFFFFF) {
 		HCURSOR oldCursor = GetCursor();
 		SetCursor(pInstance->hWait);
-		// TODO
-		Graphics * pGraphics = Graphics::FromHWND(pInstance->hCanvas, FALSE);
-		if (pGraphics != NULL) {
-			Turtleizer* pFrame = pInstance->pFrame;
-			HDC hdc = pGraphics->GetHDC();
-			HDC hdcc = CreateCompatibleDC(hdc);
-			BITMAP bmp;
-			bmp.bmBitsPixel = (BYTE)GetDeviceCaps(hdc, BITSPIXEL);
-			bmp.bmPlanes = (BYTE)GetDeviceCaps(hdc, PLANES);
-			RectF bounds = pFrame->getBounds();
-			bmp.bmWidth = (LONG)bounds.Width;
-			bmp.bmHeight = (LONG)bounds.Height;
-
-			// The width must be byte-aligned. 
-			bmp.bmWidthBytes = ((bmp.bmWidth + 15) & ~15) / 8;
-
-			// Create a bitmap for the compatible DC. 
-			HBITMAP hBmp = CreateBitmap(bmp.bmWidth, bmp.bmHeight,
-				bmp.bmPlanes, bmp.bmBitsPixel, (CONST VOID*) NULL);
-
-			// Select the bitmap for the compatible DC. 
-			SelectObject(hdcc, hBmp);
-			// Now derive a new graphics object for the bitmap
-			Graphics grCompat(hdcc);
-			grCompat.Clear(pFrame->backgroundColour);
-			grCompat.TranslateTransform(-bounds.X, -bounds.Y);
-
-			// Draw / update the recorded lines (without the turtle images temselves)
-			for (Turtleizer::Turtles::const_iterator it(pFrame->turtles.begin()); it != pFrame->turtles.end(); ++it) {
-				(*it)->draw(grCompat, true, false);
-			}
-			// Draw the axes if switched on
-			if (pInstance->showAxes) {
-				Pen pen(Color(0xff, 0xcc, 0xcc), 1);
-				REAL dashPattern[] = { 2.0f, 2.0f };
-				pen.SetDashPattern(dashPattern, 2);
-				grCompat.DrawLine(&pen, (int)bounds.X, 0, (int)(bounds.X + bounds.Width), 0);
-				grCompat.DrawLine(&pen, 0, (int)bounds.Y, 0, (int)(bounds.Y + bounds.Height));
+		std::ofstream ostr(szFile, std::ios::out | std::ios::binary);
+		bool ok = ostr.is_open();
+		if (ok) {
+			// The segment chunks are written as they are, in a single pass
+			DrawingWriter writer(ostr);
+			for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+				DrawingFormat::TurtleRecord record = {};
+				pTurtle->getState(record);
+				pTurtle->visitChunks(0, [&](const std::vector<SegmentChunkView>& chunks) {
+					writer.addTurtle(record, chunks);
+				});
 			}
-			// Draw the turtle icons at last
-			for (Turtleizer::Turtles::const_iterator it(pFrame->turtles.begin()); it != pFrame->turtles.end(); ++it)
-			{
-				(*it)->drawImage(grCompat);
-			}
-			
-			Bitmap* pBmp = Bitmap::FromHBITMAP(hBmp, NULL);
-			if (!ImageEncoders::Save(pBmp, szFile)) {
-				MessageBox(
-					pInstance->hFrame,
-					TEXT("PNG export failed: Codec may be missing."),
-					TEXT("Export failed"),
-					MB_ICONERROR | MB_OK
-				);
-			}
-
-			delete pBmp;
-			delete pGraphics;
+			ok = writer.finish((uint32_t)pInstance->pFrame->getBackground().GetValue());
+#if DEBUG_PRINT
+			printf("Drawing export: %llu bytes\n", (unsigned long long)writer.getBytesWritten());
+#endif /*DEBUG_PRINT*/
 		}
 		SetCursor(oldCursor);
-	}
+		if (!ok) {
+			MessageBox(
+				pInstance->hFrame,
+				TEXT("File could not be written."),
+				TEXT("Export failed"),
+				MB_ICONERROR | MB_OK
+			);
+		}
+	}
+	else {
+		MessageBox(
+			pInstance->hFrame,
+			TEXT("No drawing export was done."),
+			TEXT("Export canceled"),
+			MB_ICONERROR | MB_OK
+		);
+	}
+	return TRUE;
+}
+
+BOOL TurtleCanvas::handleExportPlot(bool testOnly)
+{
+#if DEBUG_PRINT
+	printf("handleExportPlot\n");
+#endif /*DEBUG_PRINT*/
+	BOOL canDo = FALSE;
+	TurtleCanvas* pInstance = getInstance();
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+		if (pTurtle->hasElements()) {
+			canDo = TRUE;
+			break;
+		}
+	}
+	if (!canDo || testOnly) {
+		return canDo;
+	}
+	TCHAR szFile[_MAX_PATH] = { 0 };       // The buffer for the file path
+	WORD ixNameStart = pInstance->chooseFileName(
+		TEXT("All files\0*.*\0HPGL files\0*.PLT;*.HPGL\0G-code files\0*.GCODE;*.NC\0"),
+		TEXT("plt"), szFile,
+		(LPOFNHOOKPROC)savePlotHookProc, (LPDLGTEMPLATE)&tplSavePlot.dlt);
+	if (ixNameStart != 0xFFFFFFFF) {
+		HCURSOR oldCursor = GetCursor();
+		SetCursor(pInstance->hWait);
+		// The language is told by the extension, HPGL unless it's a G-code file
+		const wchar_t* pExt = wcsrchr(szFile + ixNameStart, L'.');
+		PlotterWriter::Dialect dialect = PlotterWriter::HPGL;
+		if (pExt != NULL && (_wcsicmp(pExt, L".gcode") == 0 || _wcsicmp(pExt, L".nc") == 0
+			|| _wcsicmp(pExt, L".ngc") == 0)) {
+			dialect = PlotterWriter::GCODE;
+		}
+		// The lines of all turtles are grouped by colour, stitched, and ordered together
+		PlotPlanner planner;
+		for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+			std::vector<SegmentChunkView> chunks;
+			std::unique_ptr<SegmentStore::ReadLock> pLock = pTurtle->lockChunks(chunks);
+			planner.addChunks(chunks);
+		}
+		planner.plan();
+		// The stitched polylines are simplified as a whole
+		std::unique_ptr<Simplifier> pSimplifier = makeSimplifier();
+		if (pSimplifier) {
+			ExportPipeline pipeline;
+			planner.simplify(*pSimplifier, &pipeline);
+		}
+		std::ofstream ostr(szFile, std::ios::out | std::ios::binary);
+		bool ok = ostr.is_open();
+		if (ok) {
+			PlotterWriter writer(ostr, dialect, planner.getBounds());
+			writer.writeHeader();
+			writer.writePaths(planner.getPaths());
+			ok = writer.finish();
+		}
+		SetCursor(oldCursor);
+		if (!ok) {
+			MessageBox(
+				pInstance->hFrame,
+				TEXT("File could not be written."),
+				TEXT("Export failed"),
+				MB_ICONERROR | MB_OK
+			);
+		}
+		else {
+			// Report the gain of the planning
+			PlotStats before = planner.getStoredStats();
+			const PlotStats& after = planner.getPlannedStats();
+			const double mmPerUnit = PlotterWriter::DEFAULT_MM_PER_UNIT;
+			TCHAR report[500];
+#if UNICODE
+			int length = swprintf(
+#else
+			int length = sprintf(
+#endif /*UNICODE*/
+				report, ARRAYSIZE(report),
+				TEXT("Pen-down distance: %.0f mm\n\n")
+				TEXT("In drawing order: %zu strokes, %zu pen changes, %.0f mm pen-up travel\n")
+				TEXT("As plotted: %zu strokes, %zu pen changes, %.0f mm pen-up travel"),
+				after.drawLength * mmPerUnit,
+				before.nPaths, before.nPenChanges, before.travelLength * mmPerUnit,
+				after.nPaths, after.nPenChanges, after.travelLength * mmPerUnit
+			);
+			if (pSimplifier && length > 0) {
+#if UNICODE
+				swprintf(
+#else
+				sprintf(
+#endif /*UNICODE*/
+					report + length, ARRAYSIZE(report) - length,
+					TEXT("\n\nSimplified (tolerance %g pixel): %llu of %llu lines kept (%.1f %%)"),
+					(double)pSimplifier->getTolerance(),
+					(unsigned long long)pSimplifier->getOutputCount(),
+					(unsigned long long)pSimplifier->getInputCount(),
+					pSimplifier->getReductionRatio() * 100.0
+				);
+			}
+			MessageBox(
+				pInstance->hFrame,
+				report,
+				TEXT("Plotter export"),
+				MB_ICONINFORMATION | MB_OK
+			);
+		}
+	}
+	else {
+		MessageBox(
+			pInstance->hFrame,
+			TEXT("No plotter export was done."),
+			TEXT("Export canceled"),
+			MB_ICONERROR | MB_OK
+		);
+	}
+	return TRUE;
+}
+
+BOOL TurtleCanvas::handleExportPNG(bool testOnly)
+{
+#if DEBUG_PRINT
+	printf("handleExportPNG\n");
+#endif /*DEBUG_PRINT*/
+	BOOL canDo = FALSE;
+	TurtleCanvas* pInstance = getInstance();
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+		if (pTurtle->hasElements()) {
+			canDo = TRUE;
+			break;
+		}
+	}
+	if (!canDo || testOnly) {
+		return canDo;
+	}
+	TCHAR szFile[_MAX_PATH] = { 0 };       // The buffer for the file path
+	// START KGU 2026-10-18: Further raster formats via the ImageWriterRegistry
+	//WORD ixNameStart = pInstance->chooseFileName(TEXT("All files\0*.*\0PNG files\0*.PNG\0"),
+	//	TEXT("png"), szFile);
+	WORD ixNameStart = pInstance->chooseFileName(
+		TEXT("All files\0*.*\0PNG files\0*.PNG\0QOI files\0*.QOI\0BMP files\0*.BMP\0PPM files\0*.PPM\0PAM files\0*.PAM\0"),
+		TEXT("png"), szFile);
+	// END KGU 2026-10-18
+	if (ixNameStart != 0xFFFFFFFF) {
+		HCURSOR oldCursor = GetCursor();
+		SetCursor(pInstance->hWait);
+		// START KGU 2026-10-18: Banded rendering, streamed into the PNG file
+		if (!pInstance->exportImage(szFile, 1.0f)) {
+			MessageBox(
+				pInstance->hFrame,
+				TEXT("Image export failed: File not writable or image too large."),
+				TEXT("Export failed"),
+				MB_ICONERROR | MB_OK
+			);
+		}
+		// END KGU 2026-10-18
+		SetCursor(oldCursor);
+	}
 	else {
 		MessageBox(
 			pInstance->hFrame,
@@ -1692,6 +2362,168 @@ BOOL TurtleCanvas::handleExportPNG(bool testOnly)
 	return TRUE;
 }
 
+bool TurtleCanvas::exportImage(LPCTSTR fileName, float scale, const RectF* pRegion) const
+{
+	// The turtle symbols may stick out of the line bounds
+	RectF bounds = pRegion != nullptr ? *pRegion : this->pFrame->getBounds(true);
+	double dWidth = ceil(bounds.Width * scale);
+	double dHeight = ceil(bounds.Height * scale);
+	// PNG dimensions are limited to 2^31 - 1, GDI+ bitmaps to int extents
+	if (scale <= 0 || dWidth < 1 || dHeight < 1 || dWidth > INT_MAX || dHeight > INT_MAX) {
+		return false;
+	}
+	UINT width = (UINT)dWidth, height = (UINT)dHeight;
+	// Only a band of bounded byte size is held in memory (at least one row)
+	UINT bandHeight = (UINT)max((size_t)1, min((size_t)height, PNG_BAND_BYTES / ((size_t)width * 4)));
+	Bitmap band((INT)width, (INT)bandHeight, PixelFormat32bppRGB);
+	if (band.GetLastStatus() != Ok) {
+		return false;
+	}
+	Graphics gr(&band);
+	Turtleizer::Turtles turtles = this->pFrame->getTurtles();
+	Color bgColour = this->pFrame->getBackground();
+	Pen axisPen(Color(0xff, 0xcc, 0xcc), 1);
+	REAL dashPattern[] = { 2.0f, 2.0f };
+	axisPen.SetDashPattern(dashPattern, 2);
+
+	std::ofstream ostr(fileName, std::ios::binary);
+	if (!ostr.good()) {
+		return false;
+	}
+	// START KGU 2026-10-18: Band rendering shared by the palette scan and the RGB export
+	// Renders the band starting at row y0 and locks its first nRows rows in data
+	auto renderBand = [&](UINT y0, UINT nRows, BitmapData& data) -> bool {
+		gr.ResetTransform();
+		gr.Clear(bgColour);
+		gr.TranslateTransform(0, -(REAL)y0);
+		gr.ScaleTransform(scale, scale);
+		gr.TranslateTransform(-bounds.X, -bounds.Y);
+		// Only lines touching the band (with some tolerance for the pen width) matter
+		REAL margin = 1.0f + 1.0f / scale;
+		RectF clip(bounds.X - margin, bounds.Y + y0 / scale - margin,
+			bounds.Width + 2 * margin, nRows / scale + 2 * margin);
+		for (Turtleizer::Turtles::const_iterator it(turtles.begin()); it != turtles.end(); ++it) {
+			(*it)->drawElements(gr, &clip);
+		}
+		// Draw the axes if switched on
+		if (this->showAxes) {
+			gr.DrawLine(&axisPen, bounds.X, 0.0f, bounds.X + bounds.Width, 0.0f);
+			gr.DrawLine(&axisPen, 0.0f, bounds.Y, 0.0f, bounds.Y + bounds.Height);
+		}
+		// Draw the turtle icons at last
+		for (Turtleizer::Turtles::const_iterator it(turtles.begin()); it != turtles.end(); ++it) {
+			(*it)->drawImage(gr);
+		}
+		gr.Flush(FlushIntentionSync);
+
+		Gdiplus::Rect rect(0, 0, (INT)width, (INT)nRows);
+		return band.LockBits(&rect, ImageLockModeRead, PixelFormat32bppRGB, &data) == Ok;
+	};
+
+	// Formats other than PNG just get the rows as they are (unknown extensions mean PNG)
+	const ImageWriterRegistry::Format* pFormat = ImageWriterRegistry::findForFile(fileName);
+	if (pFormat != nullptr && pFormat->name != "PNG") {
+		std::unique_ptr<ImageWriter> pWriter = pFormat->create(ostr, width, height, false);
+		bool okay = ostr.good();
+		for (UINT y0 = 0; okay && y0 < height; y0 += bandHeight) {
+			UINT nRows = min(bandHeight, height - y0);
+			BitmapData data;
+			if (!renderBand(y0, nRows, data)) {
+				okay = false;
+				break;
+			}
+			for (UINT y = 0; okay && y < nRows; y++) {
+				okay = pWriter->writeRow(reinterpret_cast<const uint32_t*>(
+					static_cast<const unsigned char*>(data.Scan0) + (size_t)y * data.Stride));
+			}
+			band.UnlockBits(&data);
+		}
+		return pWriter->finish() && okay;
+	}
+
+	// Turtle drawings mostly consist of a few colours, so try an indexed-colour image
+	// first: the bands are scanned for the palette while the pixels are mapped to their
+	// indices, which are retained if the image isn't too large (otherwise the bands are
+	// rendered again). Beyond 256 colours, the image is written with RGB samples.
+	// (The alpha bytes of PixelFormat32bppRGB are undefined, hence the orMask.)
+	PngPalette palette;
+	std::vector<unsigned char> indices;
+	bool retainIndices = (size_t)width * height <= PNG_INDEX_BYTES;
+	indices.resize(retainIndices ? (size_t)width * height : width);
+	bool indexed = true;
+	bool okay = true;
+	for (UINT y0 = 0; okay && indexed && y0 < height; y0 += bandHeight) {
+		UINT nRows = min(bandHeight, height - y0);
+		BitmapData data;
+		if (!renderBand(y0, nRows, data)) {
+			okay = false;
+			break;
+		}
+		for (UINT y = 0; indexed && y < nRows; y++) {
+			const uint32_t* pSrc = reinterpret_cast<const uint32_t*>(
+				static_cast<const unsigned char*>(data.Scan0) + (size_t)y * data.Stride);
+			size_t offset = retainIndices ? (size_t)(y0 + y) * width : 0;
+			indexed = palette.indexPixels(pSrc, width, &indices[offset], 0xFF000000);
+		}
+		band.UnlockBits(&data);
+	}
+	if (!okay) {
+		return false;
+	}
+	// The compression (dominating for large images) runs concurrently
+	ExportPipeline pipeline;
+	if (indexed) {
+		PngWriter png(ostr, width, height, palette, Deflater::DEFAULT_LEVEL, &pipeline);
+		if (retainIndices) {
+			for (UINT y = 0; okay && y < height; y++) {
+				okay = png.writeRow(&indices[(size_t)y * width]);
+			}
+		}
+		for (UINT y0 = 0; okay && !retainIndices && y0 < height; y0 += bandHeight) {
+			UINT nRows = min(bandHeight, height - y0);
+			BitmapData data;
+			if (!renderBand(y0, nRows, data)) {
+				okay = false;
+				break;
+			}
+			for (UINT y = 0; okay && y < nRows; y++) {
+				const uint32_t* pSrc = reinterpret_cast<const uint32_t*>(
+					static_cast<const unsigned char*>(data.Scan0) + (size_t)y * data.Stride);
+				// The palette is complete, so the same rendering won't add colours
+				okay = palette.indexPixels(pSrc, width, indices.data(), 0xFF000000)
+					&& png.writeRow(indices.data());
+			}
+			band.UnlockBits(&data);
+		}
+		return png.finish() && okay;
+	}
+
+	PngWriter png(ostr, width, height, PngWriter::RGB, Deflater::DEFAULT_LEVEL, &pipeline);
+	std::vector<unsigned char> row(png.getRowSize());
+	for (UINT y0 = 0; okay && y0 < height; y0 += bandHeight) {
+		UINT nRows = min(bandHeight, height - y0);
+		BitmapData data;
+		if (!renderBand(y0, nRows, data)) {
+			okay = false;
+			break;
+		}
+		// END KGU 2026-10-18
+		for (UINT y = 0; okay && y < nRows; y++) {
+			// Convert the BGRX pixels into RGB samples
+			const unsigned char* pSrc = static_cast<const unsigned char*>(data.Scan0) + (size_t)y * data.Stride;
+			unsigned char* pDest = row.data();
+			for (UINT x = 0; x < width; x++, pSrc += 4) {
+				*pDest++ = pSrc[2];
+				*pDest++ = pSrc[1];
+				*pDest++ = pSrc[0];
+			}
+			okay = png.writeRow(row.data());
+		}
+		band.UnlockBits(&data);
+	}
+	return png.finish() && okay;
+}
+
 BOOL TurtleCanvas::handleExportSVG(bool testOnly)
 {
 #if DEBUG_PRINT
@@ -1699,7 +2531,7 @@ BOOL TurtleCanvas::handleExportSVG(bool testOnly)
 #endif /*DEBUG_PRINT*/
 	BOOL canDo = FALSE;
 	TurtleCanvas* pInstance = getInstance();
-	for (Turtle* pTurtle : pInstance->pFrame->turtles) {
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
 		if (pTurtle->hasElements()) {
 			canDo = TRUE;
 			break;
@@ -1710,66 +2542,372 @@ BOOL TurtleCanvas::handleExportSVG(bool testOnly)
 	}
 	TCHAR szFile[_MAX_PATH] = { 0 };       // The buffer for the file path
 	RectF bounds = pInstance->pFrame->getBounds();
-	WORD ixNameStart = pInstance->chooseFileName(TEXT("All files\0*.*\0SVG files\0*.SVG\0"),
-		TEXT("svg"), szFile);
+	WORD ixNameStart = pInstance->chooseFileName(
+		TEXT("All files\0*.*\0SVG files\0*.SVG\0Compressed SVG files\0*.SVGZ\0"),
+		TEXT("svg"), szFile,
+		(LPOFNHOOKPROC)saveSVGHookProc, (LPDLGTEMPLATE)&tplSaveSVG.dlt);
 	if (ixNameStart != 0xFFFFFFFF) {
 		HCURSOR oldCursor = GetCursor();
 		SetCursor(pInstance->hWait);
-		// TODO get the scale via the saveFile dialog...
-		unsigned short scale = 1;
-		RectF bounds = pInstance->pFrame->getBounds();
-		PointF offset(-bounds.X, -bounds.Y);
-		std::ofstream ostr(szFile);
-		if (ostr.is_open()) {
-			ostr << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
-			ostr << "<!-- Created with Turtleizer_CPP"
-				<< " (https://github.com/codemanyak/Turtleizer_CPP) -->\n";
-			ostr << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\""
-				<< (long)ceil(bounds.Width * scale) << "\" height=\""
-				<< (long)ceil(bounds.Height * scale) << "\">\n";
-			ostr << "  <title>" << szFile + ixNameStart << "</title>\n";
-
-			/* Draw the background:
-			 * The fill colour must not be given as hex code, otherwise the rectangle
-			 * will always be black! */
-			Color bg = pInstance->pFrame->backgroundColour;
-			ostr << "    <rect style=\"fill:rgb("
-				<< (int)bg.GetRed() << "," << (int)bg.GetGreen() << "," << (int)bg.GetBlue()
-				<< ");fill-opacity:1\" ";
-			ostr << " x=\"0\" y=\"0\" width=\"" << (long)ceil(bounds.Width * scale)
-				<< "\" height=\"" << (long)ceil(bounds.Height * scale) << "\" ";
-			ostr << "id=\"background\"/>\n";
-
-			// Now export the elements
-			ostr << "  <g id=\"elements\" style=\"fill:none;stroke-width:"
-				<< scale << + "px;stroke-opacity:1:stroke-linejoin:miter\">\n";
-
-			for (Turtle* pTurtle : pInstance->pFrame->turtles) {
-				pTurtle->writeSVG(ostr, offset, scale);
+		// START KGU 2026-10-18: Document emission moved to exportSVG() (shared with region export)
+		std::unique_ptr<Simplifier> pSimplifier = makeSimplifier();
+		SvgSizes sizes = {};
+		if (!pInstance->exportSVG(szFile, szFile + ixNameStart, nullptr, pSimplifier.get(), &sizes)) {
+			// Either not opened or not written completely (e.g. disk full)
+			MessageBox(
+				pInstance->hFrame,
+				TEXT("File could not be written."),
+				TEXT("Export failed"),
+				MB_ICONERROR | MB_OK
+			);
+		}
+		else if (SVG_PRECISIONS[ixSVGPrecision] != SvgWriter::PRECISION_COMPATIBLE
+			|| sizes.nFile != sizes.nText) {
+			// Report the gain of the compact mode and the compression
+			SetCursor(oldCursor);
+			TCHAR report[500];
+#if UNICODE
+			int length = swprintf(
+#else
+			int length = sprintf(
+#endif /*UNICODE*/
+				report, ARRAYSIZE(report),
+				TEXT("Exact (compatible) SVG: %llu bytes\nAs written: %llu bytes of SVG (%.1f %%)"),
+				(unsigned long long)sizes.nCompatible,
+				(unsigned long long)sizes.nText,
+				sizes.nText * 100.0 / sizes.nCompatible
+			);
+			if (sizes.nFile != sizes.nText && length > 0) {
+#if UNICODE
+				length += swprintf(
+#else
+				length += sprintf(
+#endif /*UNICODE*/
+					report + length, ARRAYSIZE(report) - length,
+					TEXT(", %llu bytes in the compressed file (%.1f %%)"),
+					(unsigned long long)sizes.nFile,
+					sizes.nFile * 100.0 / sizes.nCompatible
+				);
 			}
+			if (pSimplifier && length > 0) {
+#if UNICODE
+				swprintf(
+#else
+				sprintf(
+#endif /*UNICODE*/
+					report + length, ARRAYSIZE(report) - length,
+					TEXT("\n\nSimplified (tolerance %g pixel): %llu of %llu lines kept (%.1f %%)"),
+					(double)pSimplifier->getTolerance(),
+					(unsigned long long)pSimplifier->getOutputCount(),
+					(unsigned long long)pSimplifier->getInputCount(),
+					pSimplifier->getReductionRatio() * 100.0
+				);
+			}
+			MessageBox(
+				pInstance->hFrame,
+				report,
+				TEXT("SVG export"),
+				MB_ICONINFORMATION | MB_OK
+			);
+		}
+		else if (pSimplifier) {
+			SetCursor(oldCursor);
+			pInstance->reportSimplification(*pSimplifier);
+		}
+		// END KGU 2026-10-18
+		SetCursor(oldCursor);
+	}
+	else {
+		MessageBox(
+			pInstance->hFrame,
+			TEXT("No SVG export was done."),
+			TEXT("Export canceled"),
+			MB_ICONERROR | MB_OK
+		);
+	}
+
+	return TRUE;
+}
+
+bool TurtleCanvas::exportSVG(LPCTSTR fileName, LPCTSTR fileTitle, const RectF* pRegion,
+	Simplifier* pSimplifier, SvgSizes* pSizes) const
+{
+	// TODO get the scale via the saveFile dialog...
+	// (In compact mode, any positive scale would be fine, otherwise integral ones)
+	float scale = 1.0f;
+	RectF bounds = pRegion != nullptr ? *pRegion : this->pFrame->getBounds();
+	PointF offset(-bounds.X, -bounds.Y);
+	// An .svgz file is gzip-compressed (and must be binary)
+	int nChars = lstrlen(fileName);
+	bool compressed = nChars > 5 && lstrcmpi(fileName + nChars - 5, TEXT(".svgz")) == 0;
+	std::ofstream ostr(fileName, compressed ? std::ios::out | std::ios::binary : std::ios::out);
+	if (!ostr.is_open()) {
+		return false;
+	}
+	SvgWriter svg(ostr, SVG_PRECISIONS[ixSVGPrecision],
+		compressed ? SVGZ_LEVELS[ixSVGZLevel] : SvgWriter::NO_COMPRESSION);
+#ifdef UNICODE
+	// The title (file name) must be UTF-8 encoded
+	char title[3 * _MAX_PATH + 1] = { 0 };
+	WideCharToMultiByte(CP_UTF8, 0, fileTitle, -1, title, sizeof(title), NULL, NULL);
+#else
+	const char* title = fileTitle;
+#endif /*UNICODE*/
+	Color bg = this->pFrame->getBackground();
+	svg.writeDocumentStart(bounds.Width, bounds.Height, scale,
+		title, bg.GetValue() & 0xFFFFFF);
+
+	// In compact mode, the size the former (compatible) output would have had is
+	// determined by a counting pass: without stream buffer nothing gets written
+	std::ostream nowhere(nullptr);
+	std::unique_ptr<SvgWriter> pCompatible;
+	if (pSizes != nullptr && SVG_PRECISIONS[ixSVGPrecision] != SvgWriter::PRECISION_COMPATIBLE) {
+		pCompatible.reset(new SvgWriter(nowhere));
+		pCompatible->writeDocumentStart(bounds.Width, bounds.Height, scale,
+			title, bg.GetValue() & 0xFFFFFF);
+	}
+
+	// Now export the elements (chunks formatted concurrently, written in order)
+	ExportPipeline pipeline;
+	// Only the parts of the lines within the region (chunks outside are skipped)
+	SegmentBounds clip = SegmentBounds::empty();
+	clip.include(bounds.X, bounds.Y);
+	clip.include(bounds.GetRight(), bounds.GetBottom());
+	for (Turtle* pTurtle : this->pFrame->getTurtles()) {
+		std::vector<SegmentChunkView> chunks, clipped, simplified;
+		std::vector<std::vector<Segment>> storage;
+		std::unique_ptr<SegmentStore::ReadLock> pLock = pTurtle->lockChunks(chunks);
+		const std::vector<SegmentChunkView>* pChunks = &chunks;
+		if (pRegion != nullptr) {
+			clipChunks(*pChunks, clip, clipped, storage);
+			pChunks = &clipped;
+		}
+		// The simplification follows the clipping, which may split polylines
+		if (pSimplifier != nullptr) {
+			pSimplifier->simplifyChunks(*pChunks, simplified, storage, &pipeline);
+			pChunks = &simplified;
+		}
+		Turtle::writeChunksSVG(svg, offset, *pChunks, &pipeline);
+		if (pCompatible) {
+			Turtle::writeChunksSVG(*pCompatible, offset, *pChunks, &pipeline);
+		}
+	}
 
-			ostr << "  </g>\n";
-			ostr << "</svg>\n";
+	bool okay = svg.writeDocumentEnd();
+	if (pSizes != nullptr) {
+		pSizes->nText = svg.getBytesWritten();
+		pSizes->nFile = svg.getBytesOut();
+		pSizes->nCompatible = pSizes->nText;
+		if (pCompatible) {
+			pCompatible->writeDocumentEnd();
+			pSizes->nCompatible = pCompatible->getBytesWritten();
 		}
-		else {
+	}
+	return okay;
+}
+
+void TurtleCanvas::reportSimplification(const Simplifier& simplifier) const
+{
+	TCHAR report[200];
+#if UNICODE
+	swprintf(
+#else
+	sprintf(
+#endif /*UNICODE*/
+		report, ARRAYSIZE(report),
+		TEXT("Simplified with a tolerance of %g pixel:\n%llu of %llu lines kept (%.1f %%)"),
+		(double)simplifier.getTolerance(),
+		(unsigned long long)simplifier.getOutputCount(),
+		(unsigned long long)simplifier.getInputCount(),
+		simplifier.getReductionRatio() * 100.0
+	);
+	MessageBox(
+		this->hFrame,
+		report,
+		TEXT("Simplified export"),
+		MB_ICONINFORMATION | MB_OK
+	);
+}
+
+BOOL TurtleCanvas::handleExportView(bool testOnly)
+{
+#if DEBUG_PRINT
+	printf("handleExportView\n");
+#endif /*DEBUG_PRINT*/
+	BOOL canDo = FALSE;
+	TurtleCanvas* pInstance = getInstance();
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+		if (pTurtle->hasElements()) {
+			canDo = TRUE;
+			break;
+		}
+	}
+	if (!canDo || testOnly) {
+		return canDo;
+	}
+	// The region currently shown in the window, in turtle coordinates
+	RECT rcView = pInstance->getScrollRect();
+	RectF region((REAL)rcView.left, (REAL)rcView.top,
+		(REAL)(rcView.right - rcView.left), (REAL)(rcView.bottom - rcView.top));
+	TCHAR szFile[_MAX_PATH] = { 0 };       // The buffer for the file path
+	WORD ixNameStart = pInstance->chooseFileName(
+		TEXT("All files\0*.*\0PNG files\0*.PNG\0SVG files\0*.SVG\0Compressed SVG files\0*.SVGZ\0QOI files\0*.QOI\0BMP files\0*.BMP\0PPM files\0*.PPM\0PAM files\0*.PAM\0"),
+		TEXT("png"), szFile);
+	if (ixNameStart != 0xFFFFFFFF) {
+		HCURSOR oldCursor = GetCursor();
+		SetCursor(pInstance->hWait);
+		// The file name extension decides between vector and raster export
+		int nChars = lstrlen(szFile);
+		bool isSVG = nChars > 4 && lstrcmpi(szFile + nChars - 4, TEXT(".svg")) == 0
+			|| nChars > 5 && lstrcmpi(szFile + nChars - 5, TEXT(".svgz")) == 0;
+		bool ok = isSVG
+			? pInstance->exportSVG(szFile, szFile + ixNameStart, &region)
+			: pInstance->exportImage(szFile, 1.0f, &region);
+		SetCursor(oldCursor);
+		if (!ok) {
 			MessageBox(
 				pInstance->hFrame,
-				TEXT("File could not be opened."),
+				TEXT("Export of the visible region failed: File not writable or image too large."),
 				TEXT("Export failed"),
 				MB_ICONERROR | MB_OK
 			);
 		}
+	}
+	else {
+		MessageBox(
+			pInstance->hFrame,
+			TEXT("No export was done."),
+			TEXT("Export canceled"),
+			MB_ICONERROR | MB_OK
+		);
+	}
+	return TRUE;
+}
+
+BOOL TurtleCanvas::handleExportAnimation(bool testOnly)
+{
+#if DEBUG_PRINT
+	printf("handleExportAnimation\n");
+#endif /*DEBUG_PRINT*/
+	BOOL canDo = FALSE;
+	TurtleCanvas* pInstance = getInstance();
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+		if (pTurtle->hasElements()) {
+			canDo = TRUE;
+			break;
+		}
+	}
+	if (!canDo || testOnly) {
+		return canDo;
+	}
+	TCHAR szFile[_MAX_PATH] = { 0 };       // The buffer for the file path
+	WORD ixNameStart = pInstance->chooseFileName(
+		TEXT("All files\0*.*\0Animated PNG files\0*.PNG;*.APNG\0"),
+		TEXT("png"), szFile);
+	if (ixNameStart != 0xFFFFFFFF) {
+		HCURSOR oldCursor = GetCursor();
+		SetCursor(pInstance->hWait);
+		// The turtles draw simultaneously, each advancing by the same number of elements per frame
+		DrawingAnimation animation(pInstance->pFrame->getBounds(), pInstance->pFrame->getBackground());
+		std::vector<std::unique_ptr<SegmentStore::ReadLock>> locks;
+		for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+			std::vector<SegmentChunkView> chunks;
+			locks.push_back(pTurtle->lockChunks(chunks));
+			animation.addLayer(chunks);
+		}
+		std::ofstream ostr(szFile, std::ios::out | std::ios::binary);
+		bool ok = ostr.is_open() && animation.write(ostr, animation.getStepFor());
+#if DEBUG_PRINT
+		printf("Animation export: %u frames, %llu pixels encoded\n",
+			animation.getFrameCount(), (unsigned long long)animation.getEncodedPixels());
+#endif /*DEBUG_PRINT*/
+		ostr.close();
+		locks.clear();
 		SetCursor(oldCursor);
+		if (!ok) {
+			MessageBox(
+				pInstance->hFrame,
+				TEXT("Animation export failed: File not writable or drawing too large."),
+				TEXT("Export failed"),
+				MB_ICONERROR | MB_OK
+			);
+		}
 	}
 	else {
 		MessageBox(
 			pInstance->hFrame,
-			TEXT("No SVG export was done."),
+			TEXT("No animation export was done."),
 			TEXT("Export canceled"),
 			MB_ICONERROR | MB_OK
 		);
 	}
+	return TRUE;
+}
 
+BOOL TurtleCanvas::handleExportTiles(bool testOnly)
+{
+#if DEBUG_PRINT
+	printf("handleExportTiles\n");
+#endif /*DEBUG_PRINT*/
+	BOOL canDo = FALSE;
+	TurtleCanvas* pInstance = getInstance();
+	for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+		if (pTurtle->hasElements()) {
+			canDo = TRUE;
+			break;
+		}
+	}
+	if (!canDo || testOnly) {
+		return canDo;
+	}
+	TCHAR szFile[_MAX_PATH] = { 0 };       // The buffer for the file path
+	WORD ixNameStart = pInstance->chooseFileName(
+		TEXT("All files\0*.*\0Deep Zoom images\0*.DZI\0"),
+		TEXT("dzi"), szFile);
+	if (ixNameStart != 0xFFFFFFFF) {
+		HCURSOR oldCursor = GetCursor();
+		SetCursor(pInstance->hWait);
+		// The tile directory is named after the manifest file (without extension)
+		std::wstring basePath(szFile);
+		size_t ixDot = basePath.find_last_of(L'.');
+		if (ixDot != std::wstring::npos && ixDot > ixNameStart && _wcsicmp(basePath.c_str() + ixDot, L".dzi") == 0) {
+			basePath.resize(ixDot);
+		}
+		// Tiles are culled by the drawing bounds, the turtle symbols are not rendered
+		TilePyramid pyramid(pInstance->pFrame->getBounds(), pInstance->pFrame->getBackground());
+		std::vector<std::unique_ptr<SegmentStore::ReadLock>> locks;
+		for (Turtle* pTurtle : pInstance->pFrame->getTurtles()) {
+			std::vector<SegmentChunkView> chunks;
+			locks.push_back(pTurtle->lockChunks(chunks));
+			pyramid.addLayer(chunks);
+		}
+		// Levels and tiles are rendered and compressed concurrently
+		ExportPipeline pipeline;
+		bool ok = pyramid.write(basePath.c_str(), &pipeline);
+#if DEBUG_PRINT
+		printf("Tile pyramid export: %u levels, %llu tiles written, %llu skipped\n",
+			pyramid.getLevelCount(), (unsigned long long)pyramid.getTileCount(),
+			(unsigned long long)pyramid.getSkippedCount());
+#endif /*DEBUG_PRINT*/
+		locks.clear();
+		SetCursor(oldCursor);
+		if (!ok) {
+			MessageBox(
+				pInstance->hFrame,
+				TEXT("Tile pyramid export failed: Directory not writable or drawing too large."),
+				TEXT("Export failed"),
+				MB_ICONERROR | MB_OK
+			);
+		}
+	}
+	else {
+		MessageBox(
+			pInstance->hFrame,
+			TEXT("No tile pyramid export was done."),
+			TEXT("Export canceled"),
+			MB_ICONERROR | MB_OK
+		);
+	}
 	return TRUE;
 }
 
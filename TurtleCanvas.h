@@ -13,10 +13,33 @@
  * Turtle objects may be created to share the drawing area.
  *
  * Author: Kay Grtzig
- * Version: 11.0.1 (covering capabilities of Structorizer 3.30-12, functional GUI)
+ * Version: 11.1.0 (covering capabilities of Structorizer 3.30-12, functional GUI)
  *
  * History (add on top):
  * --------------------------------------------------------
+ * 2026-10-18   New method getDamageStats() (damage coalescing counters outside DEBUG_PRINT)
+ * 2026-10-18   exportSVG() may tell the output sizes (compact versus compatible mode)
+ * 2026-10-18   Number of segment layers bounded by MAX_LAYERS (the last one shared), fitLayers()
+ * 2026-10-18   Deferred-update scopes (beginBatch(), endBatch()) for Turtleizer::Batch
+ * 2026-10-18   CSV, SVG, and plotter save dialogs with simplification tolerance choice (Simplifier)
+ * 2026-10-18   New handler handleExportView() and method exportSVG() for the export of a region
+ * 2026-10-18   New handler handleExportAnimation() for the animated PNG export
+ * 2026-10-18   New handler handleExportPlot() for the pen-plotter export (HPGL, G-code)
+ * 2026-10-18   New handler handleExportTiles() for the deep-zoom tile pyramid export
+ * 2026-10-18   exportPNG() renamed to exportImage(), also writes BMP, PPM, PAM, and QOI files
+ *              (by extension, via the ImageWriterRegistry)
+ * 2026-10-18   exportPNG() writes an indexed-colour PNG if there are at most 256 colours,
+ *              PNG_INDEX_BYTES
+ * 2026-10-18   New handler handleExportDrawing() for the binary drawing format
+ * 2026-10-18   CSV save dialog with coordinate precision and optional columns, CSV_COL_HEADERS
+ *              replaced by CsvWriter::COLUMN_HEADERS
+ * 2026-10-18   SVG save dialog with compression level choice for svgz files
+ * 2026-10-18   SVG save dialog with precision choice (compatible or compact output)
+ * 2026-10-18   Segment layer per turtle (TurtleLayer), overlays composed by drawOverlays()
+ * 2026-10-18   Damage kept in a coalescing DamageAccumulator, several rects per frame
+ * 2026-10-18   PNG export rendered in bands and streamed into a PngWriter (exportPNG)
+ * 2026-10-18   Progressive redrawing, interrupted by time budget or pending input
+ * 2026-10-18   Damage collection and frame timer for the separate window thread
  * 2024-10-04   Type modifications at MenuDef and chooseFileName(...)
  * 2021-04-20   CSV separator choice and coordinate input dialog implemented 
  * 2021-04-02   Scrolling, zooming, and background choice implemented
@@ -26,12 +49,20 @@
 #include <Windows.h>
 #include <gdiplus.h>
 #include <commctrl.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+#include "DamageAccumulator.h"
 
 using std::string;
 using std::wstring;
 using namespace Gdiplus;
 
+class Simplifier;
+class Turtle;
 class Turtleizer;
 
 class TurtleCanvas
@@ -41,10 +72,21 @@ public:
 	~TurtleCanvas();
 	static LRESULT CALLBACK CanvasWndProc(HWND hWnd, UINT message,
 		WPARAM wParam, LPARAM lParam);
-	// Redraws the turtle canvas (with nElements lines), at least in the given coord rectangle rectF
+	// Marks the given coord rectangle rectF as damaged (with nElements lines), the window thread
+	// will redraw it with the next frame timer tick (may be called from any thread)
 	void redraw(const RectF& rectF, int nElements);
 	// Redraws the turtle canvas (in the pixel rectangle pRect) and sets the autoUpdate mode according to automatic
 	void redraw(bool automatic, const RECT* pRect = nullptr);
+	// Invalidates the entire canvas regardless of the autoUpdate mode (may be called from any thread)
+	void invalidateAll();
+	// Opens a deferred-update scope (see Turtleizer::Batch): until the matching endBatch(), the
+	// damage is only collected, neither invalidated nor painted (may be called from any thread)
+	void beginBatch();
+	// Closes a deferred-update scope, the outermost one has the collected damage presented
+	// at once (may be called from any thread)
+	void endBatch();
+	// Drops all open deferred-update scopes (when the drawing is finished anyway)
+	void cancelBatches();
 	// Resizes the window according to the frame client area
 	void resize();
 	// Zooms in or out by factor ZOOM_RATE
@@ -60,9 +102,12 @@ public:
 	PointF getDisplacement() const;
 	// Returns the scroll intervals as rectangle in turtle coordinates
 	RECT getScrollRect() const;
+	// Returns the counters of the damage coalescing (raw rectangles versus invalidated ones)
+	DamageAccumulator::Stats getDamageStats() const;
 	// Translates accelerators as far as defined (returns whether it was handled)
 	bool translateAccelerators(LPMSG pMessage) const;
 	// Informs the canvas that the next redrawing has to be done from scratch
+	// (may be called from any thread)
 	void setDirty();
 
 private:
@@ -75,6 +120,16 @@ private:
 #endif /*UNICODE*/
 	// Number of choosable CSV separator characters
 	static const unsigned short N_CSV_SEPARATORS = 5;
+	// Number of choosable CSV coordinate precisions
+	static const unsigned short N_CSV_PRECISIONS = 4;
+	// Number of optional CSV columns
+	static const unsigned short N_CSV_EXTRA_COLUMNS = 2;
+	// Number of choosable SVG coordinate precisions
+	static const unsigned short N_SVG_PRECISIONS = 5;
+	// Number of choosable SVGZ compression levels
+	static const unsigned short N_SVGZ_LEVELS = 3;
+	// Number of choosable simplification tolerances (for the vector exports)
+	static const unsigned short N_SIMPLIFY_TOLERANCES = 5;
 	// Menudefinition structure
 	struct MenuDef {
 		LPCTSTR caption;
@@ -100,7 +155,36 @@ private:
 		TDlgItem fixItem;
 		TDlgItem groupItem;
 		TDlgItem radioItems[N_CSV_SEPARATORS];
+		TDlgItem precGroupItem;
+		TDlgItem precRadioItems[N_CSV_PRECISIONS];
+		TDlgItem columnItems[N_CSV_EXTRA_COLUMNS];
+		TDlgItem simpGroupItem;
+		TDlgItem simpRadioItems[N_SIMPLIFY_TOLERANCES];
 	} tplSaveCSV;		// Custom template for the CSV SaveFile dialog
+	// Dialog template structure for SVG file dialog customisation
+	static const struct TDlgSaveSVG {
+		DLGTEMPLATE dlt;
+		WORD menu;
+		WORD classd;
+		WCHAR title;		// There won't be a title
+		TDlgItem fixItem;
+		TDlgItem groupItem;
+		TDlgItem radioItems[N_SVG_PRECISIONS];
+		TDlgItem levelGroupItem;
+		TDlgItem levelRadioItems[N_SVGZ_LEVELS];
+		TDlgItem simpGroupItem;
+		TDlgItem simpRadioItems[N_SIMPLIFY_TOLERANCES];
+	} tplSaveSVG;		// Custom template for the SVG SaveFile dialog
+	// Dialog template structure for plotter file dialog customisation
+	static const struct TDlgSavePlot {
+		DLGTEMPLATE dlt;
+		WORD menu;
+		WORD classd;
+		WCHAR title;		// There won't be a title
+		TDlgItem fixItem;
+		TDlgItem simpGroupItem;
+		TDlgItem simpRadioItems[N_SIMPLIFY_TOLERANCES];
+	} tplSavePlot;		// Custom template for the plotter SaveFile dialog
 	// Dialog template structure for coordinate input
 	static const struct TDlgInputCoord {
 		DLGTEMPLATE dlt;
@@ -122,16 +206,43 @@ private:
 		TDlgItem buttons[2];		// Okay and Cancel button
 	} tplDlgRadius;
 	static const UINT IDC_CUST_START = 200;		// First id for customer controls
+	static const UINT_PTR IDT_FRAME = 1;		// Id of the frame timer flushing the damage
+	static const UINT FRAME_INTERVAL = 20;		// Frame timer interval in ms
+	static const UINT WM_PRESENT = WM_APP + 1;	// Posted when the outermost deferred-update scope ends
+	static const DWORD STATUS_INTERVAL = 200;	// Minimum interval between statusbar updates in ms
+	static const size_t PAINT_SLICE_SIZE = 4096;	// Elements per turtle to draw between the checks
+	static const DWORD PAINT_TIME_BUDGET = 30;	// Maximum drawing time per WM_PAINT in ms
+	static const size_t MAX_LAYERS = 4;			// Maximum number of (screen-sized) segment layers
+	static const size_t PNG_BAND_BYTES = 16 << 20;	// Maximum size of the PNG export band bitmap
+	static const size_t PNG_INDEX_BYTES = 64 << 20;	// Maximum size of a retained indexed PNG image
 	static const float MAX_ZOOM, MIN_ZOOM;		// Maximum and minimum zoom factor
 	static const float ZOOM_RATE;				// Zoom change factor
 	static const NameType WCLASS_NAME;			// Name of the window class
 	static const int IDM_CONTEXT_MENU = 20000;	// Start identifier for context menu items
 	static const MenuDef MENU_DEFINITIONS[];	// Context menu specification
-	static const char* CSV_COL_HEADERS[];		// Table column headers for the CSV export
 	static const char CSV_SEPARATORS[N_CSV_SEPARATORS];			// Choosable separator characters for CSV export
 	static const NameType CSV_SEPARATOR_NAMES[N_CSV_SEPARATORS];// CSV separator description strings (radio button captions)
 	static const NameType CSV_SEPARATOR;		// Caption for the separator radio button group
 	static unsigned short ixCSVSepa;			// Index of the CSV separator last used
+	static const int CSV_PRECISIONS[N_CSV_PRECISIONS];			// Choosable CSV coordinate precisions (CsvWriter)
+	static const NameType CSV_PRECISION_NAMES[N_CSV_PRECISIONS];// CSV precision descriptions (radio button captions)
+	static const NameType CSV_PRECISION;		// Caption for the precision radio button group
+	static unsigned short ixCSVPrecision;		// Index of the CSV precision last used
+	static const unsigned int CSV_EXTRA_COLUMNS[N_CSV_EXTRA_COLUMNS];	// Optional CSV columns (CsvWriter flags)
+	static const NameType CSV_EXTRA_COLUMN_NAMES[N_CSV_EXTRA_COLUMNS];	// Optional column descriptions (check box captions)
+	static unsigned int csvColumns;				// Optional CSV columns last chosen
+	static const int SVG_PRECISIONS[N_SVG_PRECISIONS];			// Choosable SVG precisions (SvgWriter)
+	static const NameType SVG_PRECISION_NAMES[N_SVG_PRECISIONS];// SVG precision descriptions (radio button captions)
+	static const NameType SVG_PRECISION;		// Caption for the precision radio button group
+	static unsigned short ixSVGPrecision;		// Index of the SVG precision last used
+	static const int SVGZ_LEVELS[N_SVGZ_LEVELS];				// Choosable compression levels for svgz files
+	static const NameType SVGZ_LEVEL_NAMES[N_SVGZ_LEVELS];		// Compression level descriptions (radio button captions)
+	static const NameType SVGZ_LEVEL;			// Caption for the compression radio button group
+	static unsigned short ixSVGZLevel;			// Index of the svgz compression level last used
+	static const float SIMPLIFY_TOLERANCES[N_SIMPLIFY_TOLERANCES];		// Choosable simplification tolerances (0 = none)
+	static const NameType SIMPLIFY_TOLERANCE_NAMES[N_SIMPLIFY_TOLERANCES];	// Tolerance descriptions (radio button captions)
+	static const NameType SIMPLIFICATION;		// Caption for the simplification radio button group
+	static unsigned short ixSimplification;		// Index of the simplification tolerance last used
 	TOOLINFO tooltipInfo;			// Tooltip info structure
 	COLORREF customColors[16];		// Cache for user background colours
 	HWND hCanvas;					// The handle of the canvas window (subwindow)
@@ -142,8 +253,15 @@ private:
 	HWND hTooltip;					// Tooltip handle
 	HACCEL hAccel;					// Handle of the accelerator table
 	HCURSOR hArrow, hCross, hWait;	// Cursor handles
-	HDC hdcScrCompat;				// memory DC for window buffering
+	HDC hdcScrCompat;				// memory DC for window buffering (composition)
 	HBITMAP hBmpCompat;				// bitmap handle to memory DC 
+	// Cached transparent rendering of the lines of one turtle (screen-sized), the last
+	// layer is shared by all turtles beyond the first MAX_LAYERS - 1 ones
+	struct TurtleLayer {
+		Bitmap* pBitmap;			// Layer bitmap (premultiplied ARGB)
+		std::vector<std::pair<Turtle*, unsigned int>> contents;	// Turtles drawn into it, with the generation
+	};
+	std::vector<TurtleLayer> layers;	// Segment layers (window thread only)
 	BITMAP bmp;						// bitmap data structure
 	float zoomFactor;				// current zoom factor (1.0f corresponds to 100%)
 	float snapRadius;				// Snap radius
@@ -154,9 +272,15 @@ private:
 	bool popupCoords;				// Whether coordinates are to be shown as popup
 	bool showAxes;					// Whether coordinate axes are to be drawn
 	bool snapLines;					// Snap mode (default: true)
-	bool autoUpdate;				// Whether the window is to be updated on every movement
+	std::atomic<bool> autoUpdate;	// Whether the window is to be updated on every movement
 	bool tracksMouse;				// Set true while the mouse is inside the window
-	bool mustRedraw;				// Flag indicating that the memory DC must be redrawn
+	std::atomic<bool> mustRedraw;	// Flag indicating that the memory DC must be redrawn
+	DamageAccumulator damage;		// Damaged regions (turtle coords) not invalidated yet
+	std::vector<SegmentBounds> damagedRects;	// Buffer for the damage of the current frame
+	bool statusPending;				// Whether the statusbar is to be updated
+	DWORD lastStatusUpdate;			// Tick count of the last statusbar update
+	std::atomic<unsigned int> batchDepth;	// Number of open deferred-update scopes
+	std::atomic<bool> presentAll;	// Whether a paint within a deferred update left the layers incomplete
 
 	// Retrieves the responsible instance of this class from the frame
 	static TurtleCanvas* getInstance();
@@ -169,8 +293,39 @@ private:
 	//    call simply fails) returns 0xffffffff
 	WORD chooseFileName(LPCTSTR filters, LPCTSTR defaultExt, LPTSTR fileName,
 		LPOFNHOOKPROC lpHookProc = NULL, LPDLGTEMPLATE lpdt = NULL);
+	// Renders the drawing (scaled by scale) in horizontal bands and streams them
+	//    into the image file fileName in the format associated with its extension
+	//    (PNG by default, as indexed-colour image if at most 256 colours occur),
+	//    returns false if the export failed; only the region is rendered if given
+	bool exportImage(LPCTSTR fileName, float scale, const RectF* pRegion = nullptr) const;
+	// Sizes of an SVG export in bytes
+	struct SvgSizes {
+		uint64_t nText;				// SVG text written
+		uint64_t nFile;				// Bytes in the file (fewer if compressed)
+		uint64_t nCompatible;		// SVG text in compatible mode (the former output)
+	};
+	// Writes the drawing (or only the parts of the lines within region, if given) as SVG
+	//    document with title fileTitle into the file fileName (gzip-compressed if its
+	//    extension is .svgz), returns false if the file can't be opened or written
+	//    completely; the lines are reduced by the simplifier if given; if pSizes is
+	//    given, the sizes are stored there (in compact mode, this costs a counting
+	//    pass in compatible mode)
+	bool exportSVG(LPCTSTR fileName, LPCTSTR fileTitle, const RectF* pRegion = nullptr,
+		Simplifier* pSimplifier = nullptr, SvgSizes* pSizes = nullptr) const;
+	// Shows the reduction achieved by the given simplifier in a message box
+	void reportSimplification(const Simplifier& simplifier) const;
 	// Callback method for refresh (WM_PAINT message event)
 	VOID onPaint();
+	// Draws axes, measuring line and turtle images onto gr (in turtle coordinates)
+	void drawOverlays(Graphics& gr, const std::list<Turtle*>& turtles) const;
+	// Provides exactly nLayers segment layers (releasing those of vanished turtles)
+	void fitLayers(size_t nLayers);
+	// Releases the composition buffer and all turtle layers
+	void releaseBuffers();
+	// Callback method for the frame timer, invalidates the collected damage
+	VOID onFrameTimer();
+	// Callback method for the end of a deferred update, invalidates the collected damage
+	VOID onPresent();
 	// Callback method for context menu event
 	VOID onContextMenu(int x, int y);
 	// General callback method for command handling
@@ -181,6 +336,14 @@ private:
 	VOID onMouseMove(WORD X, WORD Y, BOOL isButtonDown);
 	// Callback method for the save file dialog extension
 	static UINT_PTR saveCSVHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPARAM lParam);
+	static UINT_PTR saveSVGHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPARAM lParam);
+	static UINT_PTR savePlotHookProc(HWND hDlg, UINT msgId, WPARAM wParam, LPARAM lParam);
+	// Labels the simplification radio buttons following group idGroup and checks the one last used
+	static void initSimplificationButtons(HWND hDlg, UINT idGroup);
+	// Adopts the simplification tolerance checked among the radio buttons following group idGroup
+	static void readSimplificationButtons(HWND hDlg, UINT idGroup);
+	// Returns a new simplifier for the tolerance last chosen or nullptr if there is none
+	static std::unique_ptr<Simplifier> makeSimplifier();
 	// Callback method for Coordinate input dialog
 	static BOOL CALLBACK DialogCoordProc(HWND hDlg, UINT msgId, WPARAM wParam, LPARAM lParam);
 	// Callback method for Coordinate input dialog
@@ -211,9 +374,14 @@ private:
 	static BOOL handleToggleSnap(bool testOnly);
 	static BOOL handleSetSnapRadius(bool testOnly);
 	static BOOL handleToggleUpdate(bool testOnly);
+	static BOOL handleExportAnimation(bool testOnly);
 	static BOOL handleExportCSV(bool testOnly);
+	static BOOL handleExportDrawing(bool testOnly);
+	static BOOL handleExportPlot(bool testOnly);
 	static BOOL handleExportPNG(bool testOnly);
 	static BOOL handleExportSVG(bool testOnly);
+	static BOOL handleExportTiles(bool testOnly);
+	static BOOL handleExportView(bool testOnly);
 
 	// Returns NULL if text represents an int string or the pointer to the first unexpected character
 	static TCHAR* checkIntString(LPCTSTR text);
@@ -8,15 +8,26 @@
  *
  * Author: Kay Gürtzig
  *
- * The automatic update of the drawing area is initially done after each drawing step,
- * but will then be done ever less frequently with the growing number of elements (traces)
- * to be rendered.
+ * The window (and its message loop) is run by a thread of its own since version 11.1.0,
+ * the drawing area gets updated from the collected damage in regular short intervals.
  * By invoking updateWindow(false) the regular update may be suppressed entirely. By
  * using updateWindow(true) you may re-enable the regular update.
  * BOTH call induce an immediate window update.
  *
  * History (add at top):
  * --------------------------------------------------------
+ * 2026-10-18   VERSION 11.1.0: New method getDamageStats() (counters of the damage coalescing)
+ * 2026-10-18   VERSION 11.1.0: Journal, frame stream and incremental export fed via Turtle::visitChunks()
+ * 2026-10-18   VERSION 11.1.0: Background colour read and written atomically by all threads
+ * 2026-10-18   VERSION 11.1.0: replayJournal() rejects records of turtle indices out of sequence
+ * 2026-10-18   VERSION 11.1.0: Deferred-update scopes (class Batch), ended by awaitClose()
+ * 2026-10-18   VERSION 11.1.0: Command batches (execute()) for the main turtle
+ * 2026-10-18   VERSION 11.1.0: Incremental export (exportIncrement()), journal resumption
+ * 2026-10-18   VERSION 11.1.0: Optional raw frame stream rendered and written by background threads
+ * 2026-10-18   VERSION 11.1.0: Background change and clear() no longer enforce a complete redraw
+ * 2026-10-18   VERSION 11.1.0: Optional drawing journal written by a background thread, replay
+ * 2026-10-18   VERSION 11.1.0: Window creation and message loop moved to a UI thread started
+ *              by startUp(), turtle list access synchronised, statusbar DC/font leaks fixed
  * 2024-10-05   VERSION 11.0.1: Explicit casts to avoid numeric conversion warnings,
  *              constructor accomplished
  * 2021-04-05   VERSION 11.0.0: Additions for #6 (GUI functionality ~ Structorizer 3.31 added)
@@ -44,7 +55,14 @@
 
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
+#include <vector>
+#include "FrameSink.h"
+#include "IncrementalExport.h"
+#include "Journal.h"
+#include "MappedFile.h"
  // Precaution for VS2012
 #ifndef _MATH_DEFINES_DEFINED
 #define M_PI 3.14159265358979323846
@@ -55,7 +73,7 @@
 #define WIDEN(x) WIDEN2(x)
 #define __WFILE__ WIDEN(__FILE__)
 
-const Turtleizer::Version Turtleizer::VERSION(11, 0, 1);
+const Turtleizer::Version Turtleizer::VERSION(11, 1, 0);
 
 const Turtleizer::NameType Turtleizer::WCLASS_NAME = TEXT("Turtleizer");
 
@@ -98,16 +116,22 @@ Turtleizer::Turtleizer(String caption, unsigned int sizeX, unsigned int sizeY, H
 	, pCanvas(NULL)
 	, hStatusbar(NULL)
 	, gdiplusToken(NULL)
-	, backgroundColour(Color::White)
+	, backgroundARGB(Color::White)
 	, showStatusbar(true)
 	, statusbarPartWidths(nullptr)
 	, msg{NULL, 0u, 0u, 0L, 0}
+	, caption(caption)
+	, sizeX(sizeX)
+	, sizeY(sizeY)
+	, hInstance(hInstance)
+	, hUiThread(NULL)
+	, hReady(NULL)
 {
 	// Initialize GDI+.
 	GdiplusStartup(&this->gdiplusToken, &this->gdiplusStartupInput, NULL);
 
 	if (hInstance == NULL) {
-		hInstance = get_hInstance();
+		this->hInstance = hInstance = get_hInstance();
 	}
 
 	WNDCLASS wndClass = { 0 };
@@ -124,18 +148,9 @@ Turtleizer::Turtleizer(String caption, unsigned int sizeX, unsigned int sizeY, H
 
 	RegisterClass(&wndClass);
 
-	this->hWnd = CreateWindow(
-		WCLASS_NAME,			// window class name
-		caption.c_str(),		// window caption
-		WS_OVERLAPPEDWINDOW,	// window style
-		CW_USEDEFAULT,			// initial x position
-		CW_USEDEFAULT,			// initial y position
-		sizeX,					// initial x size
-		sizeY,					// initial y size
-		NULL,					// parent window handle
-		NULL,					// window menu handle
-		hInstance,				// program instance handle
-		NULL);					// creation parameters
+	// START KGU 2026-10-18: The window itself is created by the UI thread (see createWindow())
+	this->hReady = CreateEvent(NULL, TRUE, FALSE, NULL);
+	// END KGU 2026-10-18
 
 #if DEBUG_PRINT
 	char debug_buf[_MAX_PATH];
@@ -153,6 +168,13 @@ Turtleizer::Turtleizer(String caption, unsigned int sizeX, unsigned int sizeY, H
 
 Turtleizer::~Turtleizer(void)
 {
+	// START KGU 2026-10-18: The journal and frame stream threads read the turtles
+	this->stopJournal();
+	this->stopFrameStream();
+	// END KGU 2026-10-18
+	if (this->hReady != NULL) {
+		CloseHandle(this->hReady);
+	}
 	GdiplusShutdown(this->gdiplusToken);
 	for (Turtles::iterator itr = this->turtles.begin(); itr != this->turtles.end(); ++itr) {
 		delete *itr;
@@ -166,6 +188,37 @@ Turtleizer* Turtleizer::getInstance()
 	return pInstance;
 }
 
+// START KGU 2026-10-18: Window creation moved to the UI thread
+void Turtleizer::createWindow()
+{
+	const INT nCmdShow = SW_SHOWNORMAL;
+
+	this->hWnd = CreateWindow(
+		WCLASS_NAME,			// window class name
+		this->caption.c_str(),	// window caption
+		WS_OVERLAPPEDWINDOW,	// window style
+		CW_USEDEFAULT,			// initial x position
+		CW_USEDEFAULT,			// initial y position
+		this->sizeX,			// initial x size
+		this->sizeY,			// initial y size
+		NULL,					// parent window handle
+		NULL,					// window menu handle
+		this->hInstance,		// program instance handle
+		NULL);					// creation parameters
+
+	this->setupWindowAddons(this->hInstance);
+	ShowWindow(this->hWnd, nCmdShow);
+	UpdateWindow(this->hWnd);
+	this->updateStatusbar();
+}
+
+Turtleizer::Turtles Turtleizer::getTurtles() const
+{
+	std::lock_guard<std::mutex> guard(this->turtlesMutex);
+	return this->turtles;
+}
+// END KGU 2026-10-18
+
 // START KGU 2021-03-28: Enh. #6 (new GUI functions in correspondence to Structorizer)
 void Turtleizer::setupWindowAddons(HINSTANCE hInstance)
 {
@@ -233,24 +286,45 @@ Turtleizer* Turtleizer::startUp(unsigned int sizeX, unsigned int sizeY, HINSTANC
 
 	if (pInstance == NULL) {
 		pInstance = new Turtleizer(WCLASS_NAME, sizeX, sizeY, hInstance);
-		// ToDo set up the worker thread that is responding to the events
 		pInstance->turtles.push_back(new Turtle(sizeX / 2, sizeY / 2));
 		pInstance->home0 = Point(sizeX / 2, sizeY / 2);
-		pInstance->setupWindowAddons(hInstance);
+		// START KGU 2026-10-18: Set up the UI thread that is creating the window and responding to the events
+		pInstance->hUiThread = CreateThread(NULL, 0, Turtleizer::interact, pInstance, 0, NULL);
+		if (pInstance->hUiThread != NULL) {
+			// The turtle must not move before the canvas exists
+			WaitForSingleObject(pInstance->hReady, INFINITE);
+		}
+		else {
+			// Fall back to the single-threaded mode, awaitClose() will run the message loop
+			pInstance->createWindow();
+		}
+		// END KGU 2026-10-18
+	}
+	else {
+		ShowWindow(pInstance->hWnd, nCmdShow);
 	}
-	ShowWindow(pInstance->hWnd, nCmdShow);
-	UpdateWindow(pInstance->hWnd);
-	pInstance->updateStatusbar();
 	return pInstance;
 }
 
 void Turtleizer::awaitClose()
 {
 	if (pInstance != NULL) {
-		UpdateWindow(pInstance->hWnd);
-	}
-	Turtleizer::interact(NULL);
-	if (pInstance != NULL) {
+		// START KGU 2026-10-18: Show the complete drawing, even if automatic update is off
+		// or some Batch scope is still open
+		pInstance->pCanvas->cancelBatches();
+		pInstance->pCanvas->invalidateAll();
+		// The drawing is complete, so are the journal and the frame stream
+		pInstance->stopJournal();
+		pInstance->stopFrameStream();
+		if (pInstance->hUiThread != NULL) {
+			WaitForSingleObject(pInstance->hUiThread, INFINITE);
+			CloseHandle(pInstance->hUiThread);
+			pInstance->hUiThread = NULL;
+		}
+		else {
+			Turtleizer::interact(pInstance);
+		}
+		// END KGU 2026-10-18
 		delete pInstance;
 		pInstance = NULL;
 	}
@@ -323,10 +397,14 @@ void Turtleizer::showTurtle(bool show)
 // Sets the Turtleizer background to the colour defined by the RGB values
 void Turtleizer::setBackground(unsigned char red, unsigned char green, unsigned char blue)
 {
-	this->backgroundColour = Color(red, green, blue);
-	this->pCanvas->setDirty();
-	InvalidateRect(this->hWnd, NULL, TRUE);
-	UpdateWindow(this->hWnd);
+	// START KGU 2026-10-18: Read concurrently by the window, journal and frame threads
+	//this->backgroundColour = Color(red, green, blue);
+	this->backgroundARGB = Color(red, green, blue).GetValue();
+	// END KGU 2026-10-18
+	// START KGU 2026-10-18: The UI thread will repaint it, no need to wait here;
+	// the background is a separate layer, so the lines needn't be redrawn
+	this->pCanvas->invalidateAll();
+	// END KGU 2026-10-18
 }
 
 // Sets the default pen colour (used for moves without color argument) to the RGB values
@@ -366,13 +444,22 @@ double Turtleizer::getOrientation() const
 	return (this->turtles.front())->getOrientation();
 }
 
+// Executes the given commands with the main turtle in one go
+void Turtleizer::execute(const Turtle::Command* cmds, size_t count)
+{
+	(this->turtles.front())->execute(cmds, count);
+}
+
 // Refresh the window (i. e. invalidate the region between oldPos and this->pos) 
 void Turtleizer::refresh(const RectF& rect, int nElements)
 {
-	if (nElements < 0) {
-		// A turtle has cleared its traces such that all is to be redrawn completely
-		this->pCanvas->setDirty();
-	}
+	// START KGU 2026-10-18: If a turtle has cleared its traces (nElements < 0) then
+	// the canvas will notice it and redraw the layer of just this turtle
+	//if (nElements < 0) {
+	//	// A turtle has cleared its traces such that all is to be redrawn completely
+	//	this->pCanvas->setDirty();
+	//}
+	// END KGU 2026-10-18
 	pCanvas->redraw(rect, nElements);
 }
 
@@ -382,11 +469,207 @@ Turtle* Turtleizer::addNewTurtle(int x, int y, LPCWSTR imagePath)
 {
 	Turtle* pTurtle = new Turtle(x, y, imagePath);
 	if (pTurtle != nullptr) {
+		std::lock_guard<std::mutex> guard(this->turtlesMutex);
 		this->turtles.push_back(pTurtle);
 	}
 	return pTurtle;
 }
 
+bool Turtleizer::startJournal(LPCWSTR journalPath, bool resume)
+{
+	this->stopJournal();
+	std::ios::openmode mode = std::ios::out | std::ios::binary;
+	if (resume) {
+		// Just determines the length of the complete records
+		class Skipper : public Journal::Player {
+		public:
+			void onSegments(uint32_t, const Segment*, size_t) {}
+			void onState(uint32_t, const DrawingFormat::TurtleRecord&) {}
+			void onClear(uint32_t) {}
+			void onBackground(uint32_t) {}
+		} skipper;
+		size_t complete = 0;
+		{
+			MappedFile file(journalPath);
+			// A missing or empty file is simply started anew
+			resume = file.isOpen() && file.size() > 0;
+			if (resume && !Journal::replay(file.data(), file.size(), skipper, &complete)) {
+				return false;
+			}
+		}
+		if (resume) {
+			// A torn record is cut off (or its missing padding added)
+			std::error_code error;
+			std::filesystem::resize_file(journalPath, complete, error);
+			if (error) {
+				return false;
+			}
+			mode |= std::ios::app;
+		}
+	}
+	std::unique_ptr<std::ofstream> pFile(new std::ofstream(journalPath, mode));
+	if (!pFile->is_open()) {
+		return false;
+	}
+	this->pJournalFile = std::move(pFile);
+	this->pJournal.reset(new Journal(*this->pJournalFile, [this](Journal& journal) {
+		// Called by the journal thread: report the turtles in their list order
+		journal.addBackground((uint32_t)this->backgroundARGB.load());
+		unsigned int turtleNo = 0;
+		for (Turtle* pTurtle : this->getTurtles()) {
+			pTurtle->visitChunks(
+				[&](unsigned int generation) { return journal.beginTurtle(turtleNo, generation); },
+				[&](const std::vector<SegmentChunkView>& chunks) { journal.addSegments(turtleNo, chunks); });
+			DrawingFormat::TurtleRecord state = {};
+			pTurtle->getState(state);
+			journal.addState(turtleNo++, state);
+		}
+	}, resume));
+	return true;
+}
+
+void Turtleizer::stopJournal()
+{
+	// The destructor of the journal performs a final poll and joins its thread
+	this->pJournal.reset();
+	this->pJournalFile.reset();
+}
+
+void Turtleizer::startFrameStream(HANDLE hOutput, FrameFormat format, size_t segmentsPerFrame,
+	unsigned int intervalMs, unsigned int queueDepth)
+{
+	this->stopFrameStream();
+	if (queueDepth == 0) {
+		queueDepth = FrameSink::DEFAULT_QUEUE_DEPTH;
+	}
+	this->pFrameSink.reset(new FrameSink(hOutput, this->sizeX, this->sizeY, format, segmentsPerFrame,
+		intervalMs, queueDepth));
+	this->pFrameSink->start([this](FrameSink& sink) {
+		// Called by the render thread: the turtles are drawn in their list order
+		sink.setBackground(this->getBackground());
+		unsigned int turtleNo = 0;
+		for (Turtle* pTurtle : this->getTurtles()) {
+			pTurtle->visitChunks(
+				[&](unsigned int generation) { return sink.beginLayer(turtleNo, generation); },
+				[&](const std::vector<SegmentChunkView>& chunks) { sink.addSegments(turtleNo, chunks); });
+			turtleNo++;
+		}
+	});
+}
+
+bool Turtleizer::stopFrameStream()
+{
+	// The sink performs a final poll, takes a last frame, and waits for the writer
+	bool okay = this->pFrameSink == nullptr || this->pFrameSink->finish();
+	this->pFrameSink.reset();
+	return okay;
+}
+
+bool Turtleizer::exportIncrement(IncrementalExport& target, bool finish)
+{
+	Turtles turtles = this->getTurtles();
+	bool okay = target.beginSnapshot();
+	// A cleared turtle lets the second pass write the whole drawing anew
+	for (int pass = 0; okay && pass < 2; pass++) {
+		unsigned int turtleNo = 0;
+		for (Turtle* pTurtle : turtles) {
+			pTurtle->visitChunks(
+				[&](unsigned int generation) { return target.beginTurtle(turtleNo, generation); },
+				[&](const std::vector<SegmentChunkView>& chunks) { target.addSegments(turtleNo, chunks); });
+			turtleNo++;
+		}
+		if (!target.isRestartDue()) {
+			break;
+		}
+		okay = target.restart();
+	}
+	okay = target.endSnapshot() && okay;
+	if (okay && finish) {
+		okay = target.finish(this->getBounds(), this->getBackground());
+	}
+	return okay;
+}
+
+DamageAccumulator::Stats Turtleizer::getDamageStats() const
+{
+	DamageAccumulator::Stats stats = {};
+	if (this->pCanvas != NULL) {
+		stats = this->pCanvas->getDamageStats();
+	}
+	return stats;
+}
+
+bool Turtleizer::replayJournal(LPCWSTR journalPath)
+{
+	// Applies the journal records to the turtles of the given Turtleizer
+	class Player : public Journal::Player {
+	public:
+		explicit Player(Turtleizer& turtleizer)
+			: turtleizer(turtleizer)
+			, failed(false)
+		{
+			for (Turtle* pTurtle : turtleizer.getTurtles()) {
+				this->turtles.push_back(pTurtle);
+			}
+		}
+		void onSegments(uint32_t turtle, const Segment* segments, size_t count)
+		{
+			Turtle* pTurtle = this->getTurtle(turtle);
+			if (pTurtle != NULL) {
+				pTurtle->appendElements(segments, count);
+			}
+		}
+		void onState(uint32_t turtle, const DrawingFormat::TurtleRecord& state)
+		{
+			Turtle* pTurtle = this->getTurtle(turtle);
+			if (pTurtle != NULL) {
+				pTurtle->restoreState(state);
+			}
+		}
+		void onClear(uint32_t turtle)
+		{
+			Turtle* pTurtle = this->getTurtle(turtle);
+			if (pTurtle != NULL) {
+				pTurtle->clear();
+			}
+		}
+		void onBackground(uint32_t argb)
+		{
+			if (!this->failed) {
+				Color colour((ARGB)argb);
+				this->turtleizer.setBackground(colour.GetR(), colour.GetG(), colour.GetB());
+			}
+		}
+		// Returns true if a record with an invalid turtle index has stopped the replay
+		inline bool hasFailed() const { return this->failed; }
+	private:
+		Turtleizer& turtleizer;
+		std::vector<Turtle*> turtles;	// Turtles by journal index
+		bool failed;					// Set on an invalid turtle index, all later records are ignored
+		// Returns the turtle with the given journal index, adding it if it is the next one,
+		// or NULL if the index is invalid
+		Turtle* getTurtle(uint32_t turtleNo)
+		{
+			// The journal introduces the turtles in order, so the index may exceed the known
+			// ones by at most one - anything else is a corrupt record
+			if (this->failed || turtleNo > this->turtles.size()) {
+				this->failed = true;
+				return NULL;
+			}
+			if (turtleNo == this->turtles.size()) {
+				this->turtles.push_back(this->turtleizer.addNewTurtle(0, 0));
+			}
+			return this->turtles[turtleNo];
+		}
+	};
+	MappedFile file(journalPath);
+	if (!file.isOpen()) {
+		return false;
+	}
+	Player player(*this);
+	return Journal::replay(file.data(), file.size(), player) && !player.hasFailed();
+}
+
 
 LRESULT CALLBACK Turtleizer::WndProc(HWND hWnd, UINT message,
 	WPARAM wParam, LPARAM lParam)
@@ -496,11 +779,10 @@ void Turtleizer::updateStatusbar()
 	if (this->showStatusbar) {
 
 		HDC hdc = GetDC(this->hStatusbar);
-		Graphics grsb(hdc);
 		wchar_t statusBuffer[256];
 		wsprintf(statusBuffer, L"(%i, %i)", this->home0.X, this->home0.Y);
 		SendMessage(this->hStatusbar, SB_SETTEXT, 0, (LPARAM)statusBuffer);
-		Turtle* turtle0 = this->turtles.front();
+		Turtle* turtle0 = this->getTurtles().front();
 		double ori = turtle0->getOrientation();
 		bool neg = ori < 0;
 		int intgr = (int)floor(abs(ori));
@@ -532,6 +814,7 @@ void Turtleizer::updateStatusbar()
 		Font* pFont = nullptr;
 		int pos = 0;
 		if (hFont != NULL) {
+			Graphics grsb(hdc);
 			bool resize = false;
 			const int nParts = sizeof(STATUSBAR_ICON_IDS) / sizeof(int);
 			int sepPositions[nParts];
@@ -552,13 +835,17 @@ void Turtleizer::updateStatusbar()
 				// Remember the new widths
 				pos = 0;
 				for (int i = 0; i < nParts; i++) {
-					this->statusbarPartWidths[0] = sepPositions[i] - pos;
+					// START KGU 2026-10-18: Remember the width of the respective part
+					this->statusbarPartWidths[i] = sepPositions[i] - pos;
+					// END KGU 2026-10-18
 					pos = sepPositions[i];
 				}
 			}
-			DeleteObject(pFont);
+			// START KGU 2026-10-18: This is called in short intervals now, so avoid leaks
+			delete pFont;
 		}
-		//ReleaseDC(this->hStatusbar, hdc);	// This a good idea?
+		ReleaseDC(this->hStatusbar, hdc);
+		// END KGU 2026-10-18
 	}
 
 }
@@ -567,7 +854,7 @@ bool Turtleizer::snapToNearestPoint(PointF& coord, bool onLines, REAL radius) co
 {
 	REAL minDist = INFINITY;
 	PointF nearest;
-	for (Turtle* pTurtle : turtles) {
+	for (Turtle* pTurtle : this->getTurtles()) {
 		PointF nearPt;
 		REAL dist = pTurtle->getNearestPoint(coord, onLines, radius, nearPt);
 		if (dist == 0) {
@@ -586,12 +873,13 @@ bool Turtleizer::snapToNearestPoint(PointF& coord, bool onLines, REAL radius) co
 	return false;
 }
 
-RectF Turtleizer::getBounds() const
+RectF Turtleizer::getBounds(bool withTurtles) const
 {
 	RectF bounds;
 
-	for (Turtles::const_iterator itr = this->turtles.begin(); itr != this->turtles.end(); ++itr) {
-		RectF boundsI = (*itr)->getBounds();
+	Turtles turtles = this->getTurtles();
+	for (Turtles::const_iterator itr = turtles.begin(); itr != turtles.end(); ++itr) {
+		RectF boundsI = withTurtles ? (*itr)->getExtent() : (*itr)->getBounds();
 		RectF::Union(bounds, bounds, boundsI);
 	}
 
@@ -600,10 +888,18 @@ RectF Turtleizer::getBounds() const
 
 DWORD WINAPI Turtleizer::interact(LPVOID lpParam)
 {
-	if (pInstance != NULL) {
+	// START KGU 2026-10-18: Now the entry point of the UI thread
+	Turtleizer* pTurtleizer = (lpParam != NULL) ? (Turtleizer*)lpParam : pInstance;
+	if (pTurtleizer != NULL) {
+		if (pTurtleizer->hWnd == NULL) {
+			// A window must be created by the thread running its message loop
+			pTurtleizer->createWindow();
+			SetEvent(pTurtleizer->hReady);
+		}
 		// This is a loop waiting for interactive shutting of the window
-		pInstance->listen();
+		pTurtleizer->listen();
 	}
+	// END KGU 2026-10-18
 	return 0;
 }
 
@@ -660,6 +956,23 @@ void Turtleizer::updateWindow(bool automatic)
 	this->pCanvas->redraw(automatic);
 }
 
+Turtleizer::Batch::Batch()
+	: pTurtleizer(Turtleizer::getInstance())
+{
+	if (this->pTurtleizer == NULL) {
+		this->pTurtleizer = Turtleizer::startUp();
+	}
+	this->pTurtleizer->pCanvas->beginBatch();
+}
+
+Turtleizer::Batch::~Batch()
+{
+	// The Turtleizer may have been shut down meanwhile (awaitClose() ends all scopes)
+	if (Turtleizer::getInstance() == this->pTurtleizer) {
+		this->pTurtleizer->pCanvas->endBatch();
+	}
+}
+
 Turtleizer::Version::Version(unsigned short major, unsigned short minor, unsigned short bugfix)
 {
 	this->levels[0] = major;
@@ -879,6 +1192,16 @@ double getOrientation()
 	return pTurtle->getOrientation();
 }
 
+// Executes the given commands with the turtle in one go
+void execute(const Turtle::Command* cmds, size_t count)
+{
+	Turtleizer* pTurtle = Turtleizer::getInstance();
+	if (pTurtle == NULL) {
+		pTurtle = Turtleizer::startUp();
+	}
+	pTurtle->execute(cmds, count);
+}
+
 
 // Immediately updates the Turtleizer window i.e. refreshes all damaged regions.
 // After having been called with argument false, automatic updates after every
@@ -11,7 +11,7 @@
  * (http://structorizer.fisch.lu) for a simple C++ environment on Windows (WinAPI)
  *
  * Author: Kay Gürtzig
- * Version: 11.0.1
+ * Version: 11.1.0
  *
  * Usage:
  * 1. Configure a link to the compiled library (Turtleizer.lib) in your (Console) application
@@ -39,6 +39,7 @@
  *     //		clear()
  *     //		getX(), getY()
  *     //		getOrientation()
+ *     //		execute(commands, count)
  *     // The functions forward/fd und backward/bk may be equipped with a second
  *     // argument of type Turtleizer::TurtleColour, i.e. with one of the constants
  *     // (where Turtleizer::TC_BLACK is the default):
@@ -62,14 +63,22 @@
  *     return 0;
  * }
  *
- * The automatic update of the drawing area is initially done after each drawing step,
- * but will then be done ever less frequently with the growing number of elements (traces)
- * to be rendered. (To filter the elements by the damaged region does hardly cost less
- * efforts than to draw them rightaway. It already helped a lot to invalidate only the
- * affected region but was not sufficient.)
+ * Since version 11.1.0, the window and its message loop run in a thread of their own,
+ * which is started by startUp(). The turtle movements of the program thread just append
+ * the line elements to thread-safe stores and report the damaged regions, such that the
+ * drawing speed no longer depends on the painting and the window stays responsive. The
+ * window thread collects the damaged regions and updates the drawing area some fifty
+ * times a second (adding only the new elements to a bitmap buffer).
  * By invoking updateWindow(false) the regular update may be suppressed entirely. By
  * using updateWindow(true) you may re-enable the regular update.
  * BOTH calls induce an immediate window update.
+ * For bulk drawing, the update may also be deferred for a block by a local variable
+ *     {
+ *         Turtleizer::Batch batch;
+ *         // ... lots of moves ...
+ *     }
+ * which has the new lines presented at once when the block is left. Such scopes may
+ * be nested (only the outermost one presents) and don't touch the updateWindow mode.
  * 
  * Since version 11.0.0, the window has several GUI elements to allow zooming, scrolling,
  * measuring and picture export. The functions are available via a context menu and accel-
@@ -80,6 +89,18 @@
  *
  * History (add at top):
  * --------------------------------------------------------
+ * 2026-10-18   VERSION 11.1.0: Exporter headers (FrameSink.h, IncrementalExport.h) no longer
+ *              included, FrameSink::Format replaced by FrameFormat
+ * 2026-10-18   VERSION 11.1.0: Background colour held atomically (getBackground())
+ * 2026-10-18   VERSION 11.1.0: Deferred-update scopes (class Batch)
+ * 2026-10-18   VERSION 11.1.0: Command batches (execute())
+ * 2026-10-18   VERSION 11.1.0: New method getDamageStats() (counters of the damage coalescing)
+ * 2026-10-18   VERSION 11.1.0: Incremental export (exportIncrement()), journal resumption
+ * 2026-10-18   VERSION 11.1.0: Optional raw frame stream (startFrameStream(), stopFrameStream())
+ * 2026-10-18   VERSION 11.1.0: Optional drawing journal (startJournal(), stopJournal(),
+ *              replayJournal())
+ * 2026-10-18   VERSION 11.1.0: Window and message loop moved to a dedicated UI thread
+ *              (interact()), turtle list guarded by a mutex (getTurtles())
  * 2024-10-05   VERSION 11.0.1: Type of IDS_STATUSBAR modified (const int -> const UINT),
  *              declaration of unimplemented method onPaint() commented out; isDirty() removed
  * 2021-04-21   VERSION 11.0.0: GUI extensions according to #6 (~ Structorizer 3.31)
@@ -121,8 +142,12 @@
 #include <windows.h>
 #include <gdiplus.h>
 #include <commctrl.h>
+#include <atomic>
 #include <cstdio>
+#include <iosfwd>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 using namespace Gdiplus;
 using std::string;
@@ -134,6 +159,11 @@ using std::list;
 #include "Turtle.h"
 #include "TurtleCanvas.h"
 
+class Journal;
+class FrameSink;
+class IncrementalExport;
+enum FrameFormat : int;
+
 // Singleton class providing a drawing window with a "turtle"
 // that may be moved around producing lines in its wake
 class Turtleizer
@@ -158,6 +188,18 @@ public:
 		static const unsigned short N_LEVELS = 3;
 		unsigned short levels[N_LEVELS];
 	};
+	// Deferred-update scope: while an instance lives, the drawing is neither invalidated
+	// nor painted, the damage is just collected and presented at once by the destructor
+	// of the outermost instance. Starts the Turtleizer if it isn't running yet.
+	class Batch {
+	public:
+		Batch();
+		~Batch();
+	private:
+		Turtleizer* pTurtleizer;
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+	};
 	static LRESULT CALLBACK WndProc(HWND hWnd, UINT message,
 						 WPARAM wParam, LPARAM lParam);
 	static const unsigned int DEFAULT_WINDOWSIZE_X = 500;
@@ -172,7 +214,8 @@ public:
 	static inline void shutDown() { awaitClose(); }
 	// Returns the instance of the Turtleizer if there is any
 	static Turtleizer* getInstance();
-	// interactive thread - just waits for and reacts to user actions until closed
+	// interactive (window) thread - creates the window, then waits for and reacts to
+	// user actions and paint requests until closed
 	static DWORD WINAPI interact(LPVOID lpParam);
 
 	// Make the turtle move the given number of pixels forward (or backward if neg.) using pen colour.
@@ -211,6 +254,8 @@ public:
 	double getY() const;
 	// Returns the current orientation in degrees from North (clockwise = positive)
 	double getOrientation() const;
+	// Executes the count commands at cmds with the main turtle in one go (see Turtle::execute())
+	void execute(const Turtle::Command* cmds, size_t count);
 
 	// Immediately updates the Turtleizer window i.e. refreshes all damaged regions.
 	// After having been called with argument false, automatic updates after every
@@ -224,6 +269,39 @@ public:
 	// at the given position to the Turtleizer
 	Turtle* addNewTurtle(int x, int y, LPCWSTR imagePath = NULL);
 
+	// Starts journaling the drawing (lines, turtle states, clearing, background) into the
+	// file journalPath via a background thread, such that it may be restored after a crash
+	// (replacing a running journal); returns false if the file can't be created.
+	// With resume, an existing journal file is continued instead (after a torn record
+	// is cut off), which is expected to hold the current drawing, e.g. just restored by
+	// replayJournal(); so only later changes are appended
+	bool startJournal(LPCWSTR journalPath, bool resume = false);
+	// Completes and closes the journal if there is one (also done by awaitClose())
+	void stopJournal();
+	// Restores the drawing recorded in the journal file journalPath (as far as its records
+	// are complete), adding turtles as needed; returns false if it isn't a readable journal
+	// or a record refers to a turtle out of sequence (replay stops there)
+	bool replayJournal(LPCWSTR journalPath);
+	// Starts streaming raw frames of the drawing in progress to hOutput (e.g. the standard
+	// output handle, piped into a video encoder) via background threads, see FrameSink.h for
+	// the formats (FRAME_RGBA, FRAME_I420). The frames have the initial window size and show
+	// the area from the coordinate origin on, one is taken after every segmentsPerFrame new
+	// lines and/or every intervalMs milliseconds, at most queueDepth frames may be pending
+	// (0: FrameSink::DEFAULT_QUEUE_DEPTH); replaces a running stream
+	void startFrameStream(HANDLE hOutput, FrameFormat format, size_t segmentsPerFrame,
+		unsigned int intervalMs = 0, unsigned int queueDepth = 0);
+	// Completes the frame stream if there is one (also done by awaitClose()), returns false
+	// if writing to the output failed
+	bool stopFrameStream();
+	// Takes a snapshot of the drawing into the given incremental export (see IncrementalExport.h),
+	// i.e. appends the lines drawn since its previous snapshot (all of them after a clear);
+	// with finish, the export is completed (an SVG document merged); returns false if writing failed
+	bool exportIncrement(IncrementalExport& target, bool finish = false);
+	// Returns the counters of the window's damage coalescing: the rectangles reported by the
+	// turtle moves against those invalidated per frame, see DamageAccumulator.h (all zero
+	// before the window exists)
+	DamageAccumulator::Stats getDamageStats() const;
+
 private:
 	// Typename for the list of tracked line elements
 	typedef list<Turtle*> Turtles;
@@ -241,6 +319,14 @@ private:
 	static Turtleizer* pInstance;				// The singleton instance
 	ULONG_PTR gdiplusToken;						// Token of the GDI+ session
 	HWND hWnd;									// Window handle
+	// START KGU 2026-10-18: The window is created and run by a thread of its own
+	String caption;								// Window caption
+	unsigned int sizeX, sizeY;					// Initial window size
+	HINSTANCE hInstance;						// Program instance handle
+	HANDLE hUiThread;							// Handle of the window thread (or NULL)
+	HANDLE hReady;								// Event signalled when the window is ready
+	mutable std::mutex turtlesMutex;			// Guards the turtle list
+	// END KGU 2026-10-18
 	// START KGU 2021-03-28: Enh. #6 GUI extensions
 	TurtleCanvas* pCanvas;						// Pointer to the drawing canvas object
 	int* statusbarPartWidths;					// Array of statusbar part text widths
@@ -249,11 +335,25 @@ private:
 	MSG msg;									// Message instance for user interaction
 	GdiplusStartupInput gdiplusStartupInput;	// Structure needed for GdiplusStartup
 	Turtles turtles;						// List of turtles to be handled here
-	Color backgroundColour;					// Current background colour
+	// START KGU 2026-10-18: Set by the turtle thread, read by window, journal and frame threads
+	//Color backgroundColour;					// Current background colour
+	std::atomic<ARGB> backgroundARGB;		// Current background colour
+	// END KGU 2026-10-18
 	Point home0;							// Home position of the standard turtle
 	bool showStatusbar;						// Visibility of the statusbar
+	// START KGU 2026-10-18: Optional drawing journal
+	std::unique_ptr<std::ofstream> pJournalFile;	// Stream of the journal file
+	std::unique_ptr<Journal> pJournal;			// The journal writer (if active)
+	std::unique_ptr<FrameSink> pFrameSink;		// The frame stream (if active)
+	// END KGU 2026-10-18
 	// Hidden constructor - use Turtleizer::startUp() to create an instance!
 	Turtleizer(String caption, unsigned int sizeX, unsigned int sizeY, HINSTANCE hInstance = NULL);
+	// Creates and shows the window with all its addons (in the window thread)
+	void createWindow();
+	// Returns a snapshot of the turtle list (safe to iterate in any thread)
+	Turtles getTurtles() const;
+	// Returns the current background colour (safe in any thread)
+	inline Color getBackground() const { return Color(this->backgroundARGB.load()); }
 	// Callback method for refresh (OnPaint event) - obsolete
 	//VOID onPaint(HDC hdc);
 
@@ -262,8 +362,9 @@ private:
 	void updateStatusbar();
 	// Sets up several window decorations like statusbar, which might require pInstance to be set
 	void setupWindowAddons(HINSTANCE hInstance);
-	// Retrieves the combined bounds of all turtles
-	RectF getBounds() const;
+	// Retrieves the combined bounds of all turtles (with the visible turtle symbols
+	// if withTurtles is true)
+	RectF getBounds(bool withTurtles = false) const;
 	// END KGU 2021-03-28
 	// START KGU 2021-03-31: Issue #6
 	// Specifies the effective client area (without statusbar etc.)
@@ -348,6 +449,17 @@ double getY();
 // Returns the current orientation in degrees from North (clockwise = positive)
 double getOrientation();
 
+// Executes the count commands at cmds (see Turtle::Command) in one go, e.g. a circle:
+//     Turtle::Command circle[720];
+//     for (int i = 0; i < 720; i += 2) {
+//         circle[i] = { Turtle::CMD_FORWARD, 1 };
+//         circle[i + 1] = { Turtle::CMD_LEFT, 1 };
+//     }
+//     execute(circle, 720);
+// The result is the same as with the single calls, but the lines are published and the
+// window is informed only once, which is considerably faster for long loops.
+void execute(const Turtle::Command* cmds, size_t count);
+
 // Immediately updates the Turtleizer window i.e. refreshes all damaged regions.
 // After having been called with argument false, automatic updates after every
 // turtle movement will no longer be done, otherwise the turtle returns to the
@@ -0,0 +1,223 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of CsvWriter and CsvReader: the integral output is
+ * compared with that of the former ostream-based export (replicated below),
+ * and the output of all precisions, separators and optional columns is read
+ * back and compared with the original segments.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "CsvReader.h"
+#include "CsvWriter.h"
+#include <fstream>
+#include <sstream>
+
+using namespace TestSupport;
+
+static const char SEPARATORS[] = { ',', ';', '\t', ' ', ':' };	// As offered by the export dialog
+
+// The CSV export as it was before the CsvWriter (handleExportCSV() and Turtle::writeCSV())
+static void writeFormerCsv(std::ostream& ostr, const std::vector<std::vector<Segment>>& turtles, char separator)
+{
+	static const char* const HEADERS[] = { "xFrom", "yFrom", "xTo", "yTo", "color" };
+	for (unsigned short col = 0; col < 5; col++) {
+		if (col > 0) {
+			ostr << separator;
+		}
+		ostr << HEADERS[col];
+	}
+	ostr << std::endl;
+	char colStr[9];
+	for (const std::vector<Segment>& segs : turtles) {
+		for (const Segment& seg : segs) {
+			snprintf(colStr, sizeof(colStr), "ff%02x%02x%02x",
+				(seg.argb >> 16) & 0xFF, (seg.argb >> 8) & 0xFF, seg.argb & 0xFF);
+			ostr << (int)seg.x1 << separator << (int)seg.y1 << separator
+				<< (int)seg.x2 << separator << (int)seg.y2 << separator
+				<< colStr << std::endl;
+		}
+	}
+}
+
+static void writeCsv(std::ostream& out, const std::vector<std::vector<Segment>>& turtles, char separator,
+	int precision, unsigned int columns)
+{
+	CsvWriter writer(out, separator, precision, columns);
+	writer.writeHeader();
+	for (size_t turtleNo = 0; turtleNo < turtles.size(); turtleNo++) {
+		const std::vector<Segment>& segs = turtles[turtleNo];
+		for (size_t i = 0; i < segs.size(); i += SegmentStore::CHUNK_SIZE) {
+			writer.writeRows(segs.data() + i, std::min<size_t>(SegmentStore::CHUNK_SIZE, segs.size() - i),
+				i, (unsigned int)turtleNo + 1);
+		}
+	}
+}
+
+// Reads all rows with reader into segs, returns the result of read()
+static bool readAll(CsvReader& reader, std::vector<Segment>& segs)
+{
+	return reader.read([&](const Segment* batch, size_t count) {
+		segs.insert(segs.end(), batch, batch + count);
+	});
+}
+
+// Integral output is byte-identical to the former export
+static void testFormerIdentity()
+{
+	std::vector<std::vector<Segment>> turtles = { makeWalk(5000, 21), {}, makeWalk(3000, 22) };
+	turtles[1].push_back(Segment{ -0.5f, -1.5f, 2.99f, -2.99f, 0x80123456 });
+	for (char separator : SEPARATORS) {
+		std::ostringstream former, current;
+		writeFormerCsv(former, turtles, separator);
+		writeCsv(current, turtles, separator, CsvWriter::PRECISION_INTEGRAL, 0);
+		CHECK_MSG(former.str() == current.str(), "separator '%c'", separator);
+	}
+}
+
+static void testRoundTrip()
+{
+	std::vector<Segment> segs = makeWalk(3 * SegmentStore::CHUNK_SIZE + 77, 23);
+	segs.push_back(Segment{ -0.25f, 0.0f, -1234.5678f, 0.0049f, 0x00ABCDEF });
+	for (int precision : { CsvWriter::PRECISION_INTEGRAL, 0, 1, 2, 3, CsvWriter::MAX_PRECISION }) {
+		for (char separator : SEPARATORS) {
+			for (unsigned int columns : { 0u, CsvWriter::COL_TURTLE | CsvWriter::COL_INDEX }) {
+				std::ostringstream out;
+				writeCsv(out, { segs }, separator, precision, columns);
+				std::string text = out.str();
+				std::vector<Segment> parsed;
+				CsvReader reader(text.data(), text.size());
+				bool ok = readAll(reader, parsed);
+				CHECK_MSG(ok && reader.getSeparator() == separator && reader.getRowCount() == segs.size()
+					&& parsed.size() == segs.size(),
+					"precision %d separator '%c' columns %u: error line %zu", precision, separator, columns,
+					reader.getErrorLine());
+				size_t nBad = 0;
+				SegmentBounds bounds = SegmentBounds::empty();
+				for (size_t i = 0; i < std::min(parsed.size(), segs.size()); i++) {
+					const float expected[] = { segs[i].x1, segs[i].y1, segs[i].x2, segs[i].y2 };
+					const float actual[] = { parsed[i].x1, parsed[i].y1, parsed[i].x2, parsed[i].y2 };
+					for (int k = 0; k < 4; k++) {
+						if (precision == CsvWriter::PRECISION_INTEGRAL) {
+							nBad += actual[k] != (float)(int)expected[k];
+						}
+						else {
+							double tolerance = 0.5 * pow(10.0, -precision) + fabs(expected[k]) * 1.2e-7;
+							nBad += fabs((double)actual[k] - expected[k]) > tolerance;
+						}
+					}
+					// The colour is always exported as opaque
+					nBad += parsed[i].argb != (segs[i].argb | 0xFF000000);
+					bounds.include(parsed[i]);
+				}
+				const SegmentBounds& read = reader.getBounds();
+				CHECK(bounds.left == read.left && bounds.top == read.top
+					&& bounds.right == read.right && bounds.bottom == read.bottom);
+				CHECK_MSG(nBad == 0, "precision %d separator '%c' columns %u: %zu deviations",
+					precision, separator, columns, nBad);
+			}
+		}
+	}
+}
+
+// formatRows() (used by the parallel export) produces what writeRows() writes
+static void testFormatRows()
+{
+	std::vector<Segment> segs = makeWalk(1000, 24);
+	std::ostringstream out;
+	{
+		CsvWriter writer(out, ';', 2, CsvWriter::COL_INDEX);
+		writer.writeRows(segs.data(), segs.size(), 100, 3);
+		CHECK(writer.getRowCount() == segs.size());
+	}
+	std::ostringstream dummy;
+	CsvWriter writer(dummy, ';', 2, CsvWriter::COL_INDEX);
+	std::string text;
+	writer.formatRows(segs.data(), 600, 100, 3, text);
+	writer.formatRows(segs.data() + 600, 400, 700, 3, text);
+	CHECK(text == out.str());
+	CHECK(text.compare(0, 2, "10") == 0 && text.find(";100\n") != std::string::npos);
+}
+
+static void testMalformed()
+{
+	const std::string text = "xFrom,yFrom,xTo,yTo,color\n1,2,3,4,ff000000\r\n\n-1.5,2e1,3,+4,FF00ff00\n1,2,x,4,ff000000\n5,6,7,8,ff000000\n";
+	std::vector<Segment> parsed;
+	CsvReader reader(text.data(), text.size());
+	CHECK(!readAll(reader, parsed));
+	CHECK(reader.getRowCount() == 2 && parsed.size() == 2);
+	CHECK(reader.getErrorLine() == 5);
+	CHECK(parsed.size() == 2 && parsed[1].x1 == -1.5f && parsed[1].y1 == 20.0f && parsed[1].argb == 0xFF00FF00);
+
+	// No header, six-digit colour
+	const std::string bare = "1 2 3 4 123456\n";
+	CsvReader bareReader(bare.data(), bare.size());
+	parsed.clear();
+	CHECK(readAll(bareReader, parsed));
+	CHECK(bareReader.getSeparator() == ' ' && parsed.size() == 1 && parsed[0].argb == 0xFF123456);
+}
+
+static void benchmark(size_t n)
+{
+	std::vector<std::vector<Segment>> turtles = { makeWalk(n, 42) };
+	const char* fileName = "CsvTest.tmp";
+	printf("CSV export to a file and import, %zu rows (best of 3 runs)\n", n);
+	size_t bytes = 0;
+	auto toFile = [&](std::function<void(std::ostream&)> write) {
+		return bestOf(3, [&]() {
+			std::ofstream out(fileName, std::ios::binary);
+			write(out);
+			bytes = (size_t)out.tellp();
+		});
+	};
+	double t = toFile([&](std::ostream& out) { writeFormerCsv(out, turtles, ','); });
+	printf("  former ostream + endl   %6.2f s  %6.1f M rows/s  %6.1f MB\n", t, n / 1e6 / t, bytes / 1e6);
+	struct Variant { const char* name; int precision; unsigned int columns; };
+	const Variant variants[] = {
+		{ "CsvWriter, integral    ", CsvWriter::PRECISION_INTEGRAL, 0 },
+		{ "CsvWriter, 2 decimals  ", 2, 0 },
+		{ "3 decimals, both cols  ", 3, CsvWriter::COL_TURTLE | CsvWriter::COL_INDEX }
+	};
+	for (const Variant& variant : variants) {
+		t = toFile([&](std::ostream& out) { writeCsv(out, turtles, ',', variant.precision, variant.columns); });
+		printf("  %s %6.2f s  %6.1f M rows/s  %6.1f MB\n", variant.name, t, n / 1e6 / t, bytes / 1e6);
+	}
+	for (int precision : { CsvWriter::PRECISION_INTEGRAL, 2 }) {
+		std::ostringstream out;
+		writeCsv(out, turtles, ',', precision, 0);
+		std::string text = out.str();
+		size_t nRows = 0;
+		t = bestOf(3, [&]() {
+			CsvReader reader(text.data(), text.size());
+			reader.read([&](const Segment*, size_t) {});
+			nRows = reader.getRowCount();
+		});
+		printf("  CsvReader, %s %6.2f s  %6.1f M rows/s  %6.1f MB/s%s\n",
+			precision < 0 ? "integral    " : "2 decimals  ", t, nRows / 1e6 / t, text.size() / 1e6 / t,
+			nRows == n ? "" : "  (INCOMPLETE)");
+	}
+	remove(fileName);
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 2000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testFormerIdentity();
+	testRoundTrip();
+	testFormatRows();
+	testMalformed();
+	return report("CSV");
+}
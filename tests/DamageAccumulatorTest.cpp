@@ -0,0 +1,257 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the DamageAccumulator: the merge rule (overlapping
+ * rectangles are merged unless the union is more than twice their areas), the
+ * collapse into the union beyond the limit, the statistics counters, and that
+ * every damaged rectangle is covered by a rectangle handed out for its frame,
+ * also with concurrent adders. The benchmark feeds the damage of turtle moves
+ * (segment bounds widened by the turtle symbol) and reports the coalescing.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "DamageAccumulator.h"
+#include <atomic>
+#include <thread>
+
+using namespace TestSupport;
+
+static SegmentBounds makeRect(float left, float top, float right, float bottom)
+{
+	SegmentBounds rect = { left, top, right, bottom };
+	return rect;
+}
+
+static bool sameRect(const SegmentBounds& a, const SegmentBounds& b)
+{
+	return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+// Returns the rectangles handed out after adding the given ones to a fresh accumulator
+static std::vector<SegmentBounds> coalesce(const std::vector<SegmentBounds>& rects, size_t maxRects = 8)
+{
+	DamageAccumulator damage(maxRects);
+	for (const SegmentBounds& rect : rects) {
+		damage.add(rect);
+	}
+	std::vector<SegmentBounds> taken;
+	damage.take(taken);
+	return taken;
+}
+
+static void testMerge()
+{
+	std::vector<SegmentBounds> taken;
+	// Overlapping squares are merged
+	taken = coalesce({ makeRect(0, 0, 10, 10), makeRect(5, 5, 15, 15) });
+	CHECK(taken.size() == 1 && sameRect(taken[0], makeRect(0, 0, 15, 15)));
+	// Disjoint ones are kept apart
+	taken = coalesce({ makeRect(0, 0, 10, 10), makeRect(20, 0, 30, 10) });
+	CHECK(taken.size() == 2);
+	// Thin crossing strokes are kept apart: the union (10000) exceeds twice their areas (400)
+	taken = coalesce({ makeRect(0, 50, 100, 51), makeRect(50, 0, 51, 100) });
+	CHECK(taken.size() == 2);
+	// The limit of the rule: union exactly twice the sum (16 = 2 * (4 + 4)) is merged ...
+	taken = coalesce({ makeRect(0, 0, 4, 1), makeRect(0, 0, 1, 4) });
+	CHECK(taken.size() == 1 && sameRect(taken[0], makeRect(0, 0, 4, 4)));
+	// ... a little more (18 > 2 * (4 + 4.5)) is not
+	taken = coalesce({ makeRect(0, 0, 4, 1), makeRect(0, 0, 1, 4.5f) });
+	CHECK(taken.size() == 2);
+	// A bridging rectangle absorbs both neighbours (the growing union reaches the second)
+	taken = coalesce({ makeRect(0, 0, 10, 10), makeRect(15, 0, 25, 10), makeRect(8, 0, 17, 10) });
+	CHECK(taken.size() == 1 && sameRect(taken[0], makeRect(0, 0, 25, 10)));
+	// A contained rectangle adds nothing
+	taken = coalesce({ makeRect(0, 0, 10, 10), makeRect(2, 2, 3, 3) });
+	CHECK(taken.size() == 1 && sameRect(taken[0], makeRect(0, 0, 10, 10)));
+}
+
+static void testCollapse()
+{
+	DamageAccumulator damage(4);
+	for (int i = 0; i < 4; i++) {
+		damage.add(makeRect(100.0f * i, 0, 100.0f * i + 10, 10));
+	}
+	std::vector<SegmentBounds> taken;
+	CHECK(damage.getStats().nCollapsed == 0);
+	// The fifth separate rectangle exceeds the limit: a single union remains
+	damage.add(makeRect(0, 500, 10, 510));
+	CHECK(damage.getStats().nCollapsed == 1);
+	CHECK(damage.take(taken) && taken.size() == 1 && sameRect(taken[0], makeRect(0, 0, 310, 510)));
+	// Up to the limit nothing collapses
+	for (int i = 0; i < 4; i++) {
+		damage.add(makeRect(100.0f * i, 0, 100.0f * i + 10, 10));
+	}
+	CHECK(damage.take(taken) && taken.size() == 4 && damage.getStats().nCollapsed == 1);
+	// A limit of 0 is taken as 1
+	taken = coalesce({ makeRect(0, 0, 1, 1), makeRect(5, 5, 6, 6) }, 0);
+	CHECK(taken.size() == 1 && sameRect(taken[0], makeRect(0, 0, 6, 6)));
+}
+
+static void testStats()
+{
+	DamageAccumulator damage;
+	std::vector<SegmentBounds> taken(3);
+	CHECK(!damage.hasDamage() && !damage.take(taken) && taken.empty());
+	// Empty rectangles don't count
+	damage.add(SegmentBounds::empty());
+	CHECK(!damage.hasDamage() && damage.getStats().nRaw == 0);
+	for (int i = 0; i < 10; i++) {
+		damage.add(makeRect((float)i, 0, i + 2.0f, 2));		// Chain of overlapping squares
+	}
+	damage.add(makeRect(100, 100, 101, 101));
+	CHECK(damage.hasDamage());
+	CHECK(damage.take(taken) && taken.size() == 2 && !damage.hasDamage());
+	// Dropped damage is neither handed out nor counted as a frame
+	damage.add(makeRect(0, 0, 1, 1));
+	damage.clear();
+	CHECK(!damage.take(taken));
+	damage.add(makeRect(0, 0, 1, 1));
+	CHECK(damage.take(taken) && taken.size() == 1);
+	DamageAccumulator::Stats stats = damage.getStats();
+	CHECK_MSG(stats.nRaw == 13 && stats.nCoalesced == 3 && stats.nFrames == 2 && stats.nCollapsed == 0,
+		"%llu raw, %llu coalesced, %llu frames, %llu collapsed", (unsigned long long)stats.nRaw,
+		(unsigned long long)stats.nCoalesced, (unsigned long long)stats.nFrames, (unsigned long long)stats.nCollapsed);
+}
+
+// Returns a random rectangle like the damage of a turtle move (small, sometimes long)
+static SegmentBounds randomRect(Random& rnd)
+{
+	float x = (float)rnd.below(2000), y = (float)rnd.below(2000);
+	float w = 1.0f + rnd.below(rnd.below(10) == 0 ? 400 : 20), h = 1.0f + rnd.below(20);
+	return makeRect(x, y, x + w, y + h);
+}
+
+// Every damaged rectangle is covered by one handed out for its frame (also concurrently)
+static void testCoverage()
+{
+	Random rnd(51);
+	for (size_t maxRects : { (size_t)1, (size_t)3, DamageAccumulator::DEFAULT_MAX_RECTS, (size_t)64 }) {
+		DamageAccumulator damage(maxRects);
+		std::vector<SegmentBounds> frame, taken;
+		size_t nUncovered = 0, nTooMany = 0, nRaw = 0, nOut = 0;
+		for (int i = 0; i < 20000; i++) {
+			SegmentBounds rect = randomRect(rnd);
+			damage.add(rect);
+			frame.push_back(rect);
+			nRaw++;
+			if (rnd.below(50) == 0 || i == 19999) {
+				damage.take(taken);
+				nOut += taken.size();
+				nTooMany += taken.size() > maxRects;
+				for (const SegmentBounds& r : frame) {
+					nUncovered += std::none_of(taken.begin(), taken.end(),
+						[&](const SegmentBounds& t) { return t.contains(r); });
+				}
+				frame.clear();
+			}
+		}
+		DamageAccumulator::Stats stats = damage.getStats();
+		CHECK_MSG(nUncovered == 0 && nTooMany == 0, "limit %zu: %zu uncovered, %zu frames with too many",
+			maxRects, nUncovered, nTooMany);
+		CHECK(stats.nRaw == nRaw && stats.nCoalesced == nOut && nOut < nRaw);
+	}
+
+	// Two adding threads and a taking one: nothing gets lost
+	DamageAccumulator damage;
+	std::vector<SegmentBounds> taken;
+	std::atomic<int> nRunning(2);
+	size_t nOut = 0;
+	auto adder = [&](uint32_t seed) {
+		Random r(seed);
+		for (int i = 0; i < 100000; i++) {
+			damage.add(randomRect(r));
+		}
+		nRunning--;
+	};
+	std::thread t1(adder, 52), t2(adder, 53);
+	while (nRunning > 0 || damage.hasDamage()) {
+		if (damage.take(taken)) {
+			nOut += taken.size();
+		}
+		std::this_thread::yield();
+	}
+	t1.join();
+	t2.join();
+	DamageAccumulator::Stats stats = damage.getStats();
+	CHECK(stats.nRaw == 200000 && stats.nCoalesced == nOut && stats.nFrames > 0);
+}
+
+static void benchmark(size_t n)
+{
+	// Damage of turtle moves as Turtle::refresh() reports it: line bounds widened by
+	// the half diagonal of the turtle symbol, on short and on long moves
+	const float halfDiagonal = 23.0f;
+	const size_t movesPerFrame[] = { 100, 1000, 10000 };
+	printf("Damage coalescing of %zu turtle moves (rectangles widened by %.0f), best of 3 runs\n", n, halfDiagonal);
+	for (bool shortMoves : { true, false }) {
+		std::vector<Segment> walk = makeWalk(n, shortMoves ? 61 : 62);
+		std::vector<SegmentBounds> rects;
+		rects.reserve(n);
+		double rawArea = 0.0;
+		for (Segment& seg : walk) {
+			if (shortMoves) {
+				// forward(1) steps, bending slowly
+				seg.x2 = seg.x1 + (seg.x2 - seg.x1) / 50.0f;
+				seg.y2 = seg.y1 + (seg.y2 - seg.y1) / 50.0f;
+			}
+			SegmentBounds rect = SegmentBounds::empty();
+			rect.include(seg);
+			rect.left -= halfDiagonal;
+			rect.top -= halfDiagonal;
+			rect.right += halfDiagonal;
+			rect.bottom += halfDiagonal;
+			rects.push_back(rect);
+			rawArea += (double)(rect.right - rect.left) * (rect.bottom - rect.top);
+		}
+		printf("  %s moves:\n", shortMoves ? "short" : "long ");
+		for (size_t perFrame : movesPerFrame) {
+			for (size_t maxRects : { (size_t)1, DamageAccumulator::DEFAULT_MAX_RECTS, (size_t)32 }) {
+				DamageAccumulator::Stats stats = {};
+				double area = 0.0;
+				double t = bestOf(3, [&]() {
+					DamageAccumulator damage(maxRects);
+					std::vector<SegmentBounds> taken;
+					area = 0.0;
+					for (size_t i = 0; i < rects.size(); i++) {
+						damage.add(rects[i]);
+						if ((i + 1) % perFrame == 0 || i + 1 == rects.size()) {
+							damage.take(taken);
+							for (const SegmentBounds& r : taken) {
+								area += (double)(r.right - r.left) * (r.bottom - r.top);
+							}
+						}
+					}
+					stats = damage.getStats();
+				});
+				printf("    %5zu moves per frame, limit %2zu: %6.1f ns per add, %7llu raw -> %6llu invalidated"
+					" (%6.1f per frame, %3llu collapses), area %5.1f %% of the raw sum\n",
+					perFrame, maxRects, t * 1e9 / n, (unsigned long long)stats.nRaw,
+					(unsigned long long)stats.nCoalesced, (double)stats.nCoalesced / stats.nFrames,
+					(unsigned long long)stats.nCollapsed, 100.0 * area / rawArea);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 1000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testMerge();
+	testCollapse();
+	testStats();
+	testCoverage();
+	return report("DamageAccumulator");
+}
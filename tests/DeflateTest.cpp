@@ -0,0 +1,198 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the Deflater: the output of all levels and framings
+ * is decoded by the independent inflater of TestSupport.h (which also checks
+ * the trailers), including sync flushes, dictionary-primed pieces as used for
+ * the parallel PNG compression, and compressed SVG (svgz) documents.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "Deflate.h"
+#include "SvgWriter.h"
+#include <sstream>
+
+using namespace TestSupport;
+
+// Returns an SVG document of the given turtle walk (compact mode if precision >= 0)
+static std::string makeSvg(const std::vector<Segment>& segs, int precision, int compression = SvgWriter::NO_COMPRESSION)
+{
+	std::ostringstream out;
+	{
+		SvgWriter svg(out, precision, compression);
+		svg.writeDocumentStart(9000.0f, 9000.0f, 1.0f, "test.svg", 0xFFFFFF);
+		svg.beginPaths(0.0f, 0.0f, 800);
+		svg.addSegments(segs.data(), segs.size());
+		svg.endPaths();
+		svg.writeDocumentEnd();
+	}
+	return out.str();
+}
+
+// Test inputs with different characteristics
+static std::vector<std::string> makeInputs()
+{
+	std::vector<std::string> inputs;
+	inputs.push_back(std::string());
+	inputs.push_back("a");
+	inputs.push_back(std::string(100000, 'x'));					// long runs (distance 1)
+	std::string random(70000, '\0');
+	Random rnd(5);
+	for (char& c : random) {
+		c = (char)rnd.next();
+	}
+	inputs.push_back(random);									// incompressible
+	inputs.push_back(makeSvg(makeWalk(3000, 6), -1));			// text with matches beyond the window
+	std::string mixed = inputs.back().substr(0, 40000) + random.substr(0, 30000) + inputs.back().substr(0, 40000);
+	inputs.push_back(mixed);
+	return inputs;
+}
+
+static std::string deflate(const std::string& data, int level, Deflater::Format format, size_t portion = 0)
+{
+	std::string out;
+	StringSink sink(out);
+	Deflater deflater(sink, level, format);
+	if (portion == 0) {
+		deflater.write(data.data(), data.size());
+	}
+	else {
+		for (size_t i = 0; i < data.size(); i += portion) {
+			deflater.write(data.data() + i, std::min(portion, data.size() - i));
+		}
+	}
+	deflater.finish();
+	CHECK(deflater.getTotalIn() == data.size() && deflater.getTotalOut() == out.size());
+	return out;
+}
+
+static void testChecksums()
+{
+	std::string text = makeSvg(makeWalk(500, 7), 2);
+	CHECK(Deflater::crc32(0, "123456789", 9) == 0xCBF43926);
+	CHECK(Deflater::adler32(1, "Wikipedia", 9) == 0x11E60398);
+	CHECK(Deflater::crc32(0, text.data(), text.size()) == crc32(0, text.data(), text.size()));
+	CHECK(Deflater::adler32(1, text.data(), text.size()) == adler32(1, text.data(), text.size()));
+	size_t half = text.size() / 3;
+	uint32_t a1 = Deflater::adler32(1, text.data(), half);
+	uint32_t a2 = Deflater::adler32(1, text.data() + half, text.size() - half);
+	CHECK(Deflater::adler32Combine(a1, a2, text.size() - half) == adler32(1, text.data(), text.size()));
+}
+
+static void testRoundTrips()
+{
+	std::vector<std::string> inputs = makeInputs();
+	for (int level = 0; level <= 9; level++) {
+		for (size_t ix = 0; ix < inputs.size(); ix++) {
+			const std::string& data = inputs[ix];
+			std::string raw = deflate(data, level, Deflater::RAW);
+			std::string zlib = deflate(data, level, Deflater::ZLIB, 1000);
+			std::string gzip = deflate(data, level, Deflater::GZIP, 65536);
+			std::string rawOut, zlibOut, gzipOut;
+			size_t used = 0;
+			CHECK_MSG(Inflater::inflate(reinterpret_cast<const unsigned char*>(raw.data()), raw.size(), rawOut, &used)
+				&& used == raw.size() && rawOut == data, "RAW level %d input %zu", level, ix);
+			CHECK_MSG(Inflater::zlibDecode(zlib, zlibOut) && zlibOut == data, "ZLIB level %d input %zu", level, ix);
+			CHECK_MSG(Inflater::gzipDecode(gzip, gzipOut) && gzipOut == data, "GZIP level %d input %zu", level, ix);
+			if (level > 0 && ix == 2) {
+				CHECK_MSG(raw.size() < data.size() / 100, "level %d compresses runs to %zu bytes", level, raw.size());
+			}
+		}
+	}
+	unsigned char header[2];
+	Deflater::getZlibHeader(9, header);
+	CHECK(header[0] == 0x78 && ((header[0] << 8) | header[1]) % 31 == 0);
+}
+
+// Pieces compressed separately (primed with the preceding data) concatenate to one stream
+static void testPieces()
+{
+	std::string data = makeSvg(makeWalk(4000, 8), -1);
+	const size_t pieceSize = 50000;
+	std::string stream;
+	uint32_t adler = 1;
+	for (size_t start = 0; start < data.size(); start += pieceSize) {
+		size_t length = std::min(pieceSize, data.size() - start);
+		bool last = start + length >= data.size();
+		std::string piece;
+		StringSink sink(piece);
+		Deflater deflater(sink, 6, Deflater::RAW);
+		if (start > 0) {
+			size_t dictLength = std::min<size_t>(Deflater::MAX_DICTIONARY, start);
+			deflater.setDictionary(data.data() + start - dictLength, dictLength);
+		}
+		deflater.write(data.data() + start, length);
+		if (last) {
+			deflater.finish();
+		}
+		else {
+			deflater.flush();
+		}
+		stream += piece;
+		adler = Deflater::adler32Combine(adler, Deflater::adler32(1, data.data() + start, length), length);
+	}
+	std::string out;
+	size_t used = 0;
+	CHECK(Inflater::inflate(reinterpret_cast<const unsigned char*>(stream.data()), stream.size(), out, &used));
+	CHECK(used == stream.size() && out == data);
+	CHECK(adler == adler32(1, data.data(), data.size()));
+}
+
+// An svgz document decodes to the plain document
+static void testSvgz()
+{
+	std::vector<Segment> segs = makeWalk(20000, 9);
+	for (int precision : { -1, 2 }) {
+		std::string plain = makeSvg(segs, precision);
+		for (int level : { 1, 6, 9 }) {
+			std::string compressed = makeSvg(segs, precision, level);
+			std::string decoded;
+			CHECK_MSG(Inflater::gzipDecode(compressed, decoded) && decoded == plain,
+				"precision %d level %d", precision, level);
+			CHECK(compressed.size() < plain.size() / 2);
+		}
+	}
+}
+
+static void benchmark(size_t n)
+{
+	std::vector<Segment> segs = makeWalk(n, 42);
+	printf("SVGZ export, %zu segments, including the SVG formatting\n", n);
+	for (int precision : { -1, 2 }) {
+		std::string plain;
+		double tPlain = bestOf(3, [&]() { plain = makeSvg(segs, precision); });
+		printf("  %s (%.1f MB text): plain %.2f s\n", precision < 0 ? "compatible" : "compact, 2 decimals",
+			plain.size() / 1e6, tPlain);
+		for (int level : { 1, 6, 9 }) {
+			std::string compressed;
+			double t = bestOf(1, [&]() { compressed = makeSvg(segs, precision, level); });
+			std::string decoded;
+			bool ok = Inflater::gzipDecode(compressed, decoded) && decoded == plain;
+			printf("    level %d: %6.2f MB in %5.2f s  %6.1f MB/s in  round trip %s\n", level,
+				compressed.size() / 1e6, t, plain.size() / 1e6 / t, ok ? "ok" : "FAILED");
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 1000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testChecksums();
+	testRoundTrips();
+	testPieces();
+	testSvgz();
+	return report("Deflate");
+}
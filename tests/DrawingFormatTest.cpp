@@ -0,0 +1,301 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the binary drawing format (.tzd): drawings written
+ * by the DrawingWriter are reloaded by the DrawingReader (from memory, as the
+ * HeadlessTurtleizer does from a mapped file) and compared with the source,
+ * and corrupted files must be rejected without excessive allocations.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "DrawingReader.h"
+#include "DrawingWriter.h"
+#include "SvgWriter.h"
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+
+using namespace TestSupport;
+
+// An 8-byte aligned copy of a drawing file (as a mapped file would be)
+class AlignedData
+{
+public:
+	explicit AlignedData(const std::string& bytes)
+		: words((bytes.size() + 7) / 8 + 1)
+		, size(bytes.size())
+	{
+		memcpy(this->words.data(), bytes.data(), bytes.size());
+	}
+	inline char* data() { return reinterpret_cast<char*>(this->words.data()); }
+	inline size_t length() const { return this->size; }
+	// Overwrites the bytes at offset with the given value
+	template<typename T>
+	void patch(size_t offset, T value) { memcpy(this->data() + offset, &value, sizeof(T)); }
+	template<typename T>
+	T peek(size_t offset) { T value; memcpy(&value, this->data() + offset, sizeof(T)); return value; }
+private:
+	std::vector<uint64_t> words;
+	size_t size;
+};
+
+struct Drawing {
+	std::vector<std::unique_ptr<SegmentStore>> stores;
+	std::vector<DrawingFormat::TurtleRecord> records;
+};
+
+// Creates a drawing with nTurtles turtles, the second of which has no segments
+static Drawing makeDrawing(size_t nSegments, size_t nTurtles)
+{
+	Drawing drawing;
+	for (size_t ix = 0; ix < nTurtles; ix++) {
+		drawing.stores.emplace_back(new SegmentStore());
+		DrawingFormat::TurtleRecord rec = {};
+		if (ix != 1) {
+			std::vector<Segment> segs = makeWalk(nSegments / nTurtles + ix, 31 + (uint32_t)ix);
+			drawing.stores.back()->append(segs.data(), segs.size());
+			rec.posX = segs.back().x2;
+			rec.posY = segs.back().y2;
+		}
+		rec.orientation = 12.5 * ix - 90.0;
+		rec.boundsX = -1.0f;
+		rec.boundsY = -2.0f;
+		rec.boundsWidth = 9001.0f + ix;
+		rec.boundsHeight = 9002.0f;
+		rec.penARGB = 0xFF000000 | (uint32_t)(ix * 0x112233);
+		rec.penDown = ix % 2;
+		rec.visible = ix != 2;
+		drawing.records.push_back(rec);
+	}
+	return drawing;
+}
+
+static std::string writeDrawing(const Drawing& drawing, uint32_t background)
+{
+	std::ostringstream out;
+	DrawingWriter writer(out);
+	for (size_t ix = 0; ix < drawing.stores.size(); ix++) {
+		SegmentStore::ReadLock lock(*drawing.stores[ix]);
+		std::vector<SegmentChunkView> chunks;
+		drawing.stores[ix]->getChunks(chunks);
+		writer.addTurtle(drawing.records[ix], chunks);
+	}
+	CHECK(writer.finish(background));
+	CHECK(writer.getBytesWritten() == out.str().size());
+	return out.str();
+}
+
+// Exports the given chunks of all turtles as compact SVG (as HeadlessTurtleizer would)
+static std::string exportSvg(const std::vector<std::vector<SegmentChunkView>>& turtles)
+{
+	std::ostringstream out;
+	SvgWriter svg(out, 2);
+	svg.writeDocumentStart(9000.0f, 9000.0f, 1.0f, "drawing", 0xFFFFFF);
+	for (const std::vector<SegmentChunkView>& chunks : turtles) {
+		svg.beginPaths(0.0f, 0.0f, 800);
+		for (const SegmentChunkView& chunk : chunks) {
+			svg.addSegments(chunk.segments, chunk.count);
+		}
+		svg.endPaths();
+	}
+	svg.writeDocumentEnd();
+	return out.str();
+}
+
+static void testRoundTrip()
+{
+	Drawing drawing = makeDrawing(5 * SegmentStore::CHUNK_SIZE + 1000, 4);
+	AlignedData file(writeDrawing(drawing, 0xFF102030));
+	DrawingReader reader(file.data(), file.length());
+	CHECK_MSG(reader.isValid(), "%s", reader.getError());
+	if (!reader.isValid()) {
+		return;
+	}
+	CHECK(reader.getBackground() == 0xFF102030);
+	CHECK(reader.getTurtleCount() == drawing.stores.size());
+	uint64_t nTotal = 0;
+	std::vector<uint32_t> palette;
+	std::unordered_set<uint32_t> known;
+	std::vector<std::vector<SegmentChunkView>> original, loaded;
+	for (size_t ix = 0; ix < std::min(reader.getTurtleCount(), drawing.stores.size()); ix++) {
+		const SegmentStore& store = *drawing.stores[ix];
+		const DrawingReader::TurtleView& view = reader.getTurtle(ix);
+		const DrawingFormat::TurtleRecord& rec = *view.pRecord;
+		const DrawingFormat::TurtleRecord& src = drawing.records[ix];
+		CHECK(rec.orientation == src.orientation && rec.posX == src.posX && rec.posY == src.posY);
+		CHECK(rec.boundsX == src.boundsX && rec.boundsY == src.boundsY
+			&& rec.boundsWidth == src.boundsWidth && rec.boundsHeight == src.boundsHeight);
+		CHECK(rec.penARGB == src.penARGB && rec.penDown == src.penDown && rec.visible == src.visible);
+		CHECK(rec.nSegments == store.size());
+		nTotal += store.size();
+
+		std::vector<SegmentChunkView> chunks;
+		store.getChunks(chunks);
+		CHECK(view.chunks.size() == chunks.size());
+		bool same = true;
+		for (size_t i = 0; i < std::min(chunks.size(), view.chunks.size()); i++) {
+			const SegmentChunkView& a = chunks[i];
+			const SegmentChunkView& b = view.chunks[i];
+			same = same && a.count == b.count && a.firstIndex == b.firstIndex
+				&& memcmp(a.segments, b.segments, a.count * sizeof(Segment)) == 0
+				&& memcmp(&a.bounds, &b.bounds, sizeof(SegmentBounds)) == 0;
+			for (size_t k = 0; k < a.count; k++) {
+				if (known.insert(a.segments[k].argb).second) {
+					palette.push_back(a.segments[k].argb);
+				}
+			}
+		}
+		CHECK_MSG(same, "turtle %zu", ix);
+		original.push_back(chunks);
+		loaded.push_back(view.chunks);
+	}
+	CHECK(reader.getSegmentCount() == nTotal);
+	CHECK(reader.getPaletteSize() == palette.size()
+		&& std::equal(palette.begin(), palette.end(), reader.getPalette()));
+	// A re-export from the loaded drawing equals that from the stores
+	CHECK(exportSvg(original) == exportSvg(loaded));
+
+	// An empty drawing
+	Drawing empty;
+	AlignedData emptyFile(writeDrawing(empty, 0xFFFFFFFF));
+	DrawingReader emptyReader(emptyFile.data(), emptyFile.length());
+	CHECK(emptyReader.isValid() && emptyReader.getTurtleCount() == 0 && emptyReader.getSegmentCount() == 0);
+}
+
+// Expects the reader to reject the (patched) data with the given reason
+static void expectError(AlignedData& file, const char* expected, size_t length = 0)
+{
+	DrawingReader reader(file.data(), length > 0 ? length : file.length());
+	CHECK_MSG(!reader.isValid() && strcmp(reader.getError(), expected) == 0,
+		"expected \"%s\", got \"%s\"", expected, reader.isValid() ? "valid" : reader.getError());
+	CHECK(reader.getTurtleCount() == 0 && reader.getSegmentCount() == 0);
+}
+
+static void testCorruption()
+{
+	using Format = DrawingFormat;
+	Drawing drawing = makeDrawing(3 * SegmentStore::CHUNK_SIZE, 3);
+	const std::string bytes = writeDrawing(drawing, 0xFFFFFFFF);
+	const size_t trailerOffset = bytes.size() - sizeof(Format::Trailer);
+	AlignedData original(bytes);
+	const uint64_t dirOffset = original.peek<uint64_t>(trailerOffset);
+	const Format::Directory dir = original.peek<Format::Directory>((size_t)dirOffset);
+	const size_t firstRecord = (size_t)(dirOffset + Format::align(sizeof(Format::Directory))
+		+ Format::align(dir.nColours * sizeof(uint32_t)));
+	const size_t nChunksOffset = firstRecord + offsetof(Format::TurtleRecord, nChunks);
+
+	{ AlignedData file(bytes); expectError(file, "truncated drawing file", file.length() - 8); }
+	{ AlignedData file(bytes); expectError(file, "too short for a drawing", 24); }
+	{ AlignedData file(bytes); file.patch<char>(0, 'X'); expectError(file, "not a drawing file"); }
+	{ AlignedData file(bytes); file.patch<uint16_t>(8, Format::VERSION + 1); expectError(file, "unsupported format version"); }
+	{ AlignedData file(bytes); file.patch<uint64_t>(trailerOffset, dirOffset + 4); expectError(file, "bad directory offset"); }
+	{ AlignedData file(bytes); file.patch<uint64_t>(trailerOffset, bytes.size()); expectError(file, "bad directory offset"); }
+	{ AlignedData file(bytes); file.patch<uint32_t>((size_t)dirOffset + 4, 0x40000000); expectError(file, "bad palette size"); }
+	{ AlignedData file(bytes); file.patch<uint32_t>((size_t)dirOffset + 12, 12); expectError(file, "bad turtle records"); }
+	// A huge chunk count must be rejected before anything is reserved for it
+	{ AlignedData file(bytes); file.patch<uint32_t>(nChunksOffset, 0xFFFFFFFF); expectError(file, "bad chunk count"); }
+	{ AlignedData file(bytes); file.patch<uint32_t>(nChunksOffset, original.peek<uint32_t>(nChunksOffset) + 1);
+	  expectError(file, "inconsistent chunk"); }
+	{ AlignedData file(bytes); file.patch<uint32_t>(sizeof(Format::FileHeader), 7); expectError(file, "inconsistent chunk"); }
+	{ AlignedData file(bytes); file.patch<uint64_t>(firstRecord + offsetof(Format::TurtleRecord, firstChunk), 12);
+	  expectError(file, "bad chunk offset"); }
+	{ AlignedData file(bytes); file.patch<uint64_t>(firstRecord + offsetof(Format::TurtleRecord, nSegments), 1);
+	  expectError(file, "inconsistent segment count"); }
+	{ AlignedData file(bytes); file.patch<uint64_t>((size_t)dirOffset + 16, 1); expectError(file, "inconsistent segment count"); }
+	// Misaligned data (as from a badly placed buffer)
+	{
+		std::vector<uint64_t> words(bytes.size() / 8 + 2);
+		char* misaligned = reinterpret_cast<char*>(words.data()) + 4;
+		memcpy(misaligned, bytes.data(), bytes.size());
+		DrawingReader reader(misaligned, bytes.size());
+		CHECK(!reader.isValid() && strcmp(reader.getError(), "misaligned data") == 0);
+	}
+
+	// Random corruptions of the metadata must never crash, and if accepted, be consistent
+	Random rnd(77);
+	size_t nAccepted = 0;
+	const size_t metaStart = (size_t)dirOffset;
+	for (int round = 0; round < 20000; round++) {
+		AlignedData file(bytes);
+		int nFlips = 1 + rnd.below(3);
+		for (int k = 0; k < nFlips; k++) {
+			// Mostly in the metadata, sometimes in the chunk headers
+			size_t pos = (rnd.below(4) != 0)
+				? metaStart + rnd.below((uint32_t)(bytes.size() - metaStart))
+				: sizeof(Format::FileHeader) + rnd.below(32);
+			file.data()[pos] ^= (char)(1 << rnd.below(8));
+		}
+		DrawingReader reader(file.data(), file.length());
+		if (reader.isValid()) {
+			nAccepted++;
+			uint64_t nTotal = 0;
+			for (size_t ix = 0; ix < reader.getTurtleCount(); ix++) {
+				for (const SegmentChunkView& chunk : reader.getTurtle(ix).chunks) {
+					CHECK(chunk.segments >= (const Segment*)file.data()
+						&& (const char*)(chunk.segments + chunk.count) <= file.data() + file.length());
+					nTotal += chunk.count;
+				}
+			}
+			CHECK(nTotal == reader.getSegmentCount());
+		}
+	}
+	printf("  %zu of 20000 random corruptions were accepted as consistent\n", nAccepted);
+}
+
+static void benchmark(size_t n)
+{
+	Drawing drawing = makeDrawing(n, 4);
+	printf("Binary drawing format, 4 turtles, %zu segments (best of 5 runs)\n", n);
+	std::string bytes;
+	double tWrite = bestOf(5, [&]() { bytes = writeDrawing(drawing, 0xFFFFFFFF); });
+	AlignedData file(bytes);
+	bool valid = false;
+	size_t nChunks = 0;
+	double tLoad = bestOf(5, [&]() {
+		DrawingReader reader(file.data(), file.length());
+		valid = reader.isValid();
+		nChunks = 0;
+		for (size_t ix = 0; ix < reader.getTurtleCount(); ix++) {
+			nChunks += reader.getTurtle(ix).chunks.size();
+		}
+	});
+	// Reading all segments in place (what a re-export or rendering would do)
+	double sum = 0.0;
+	double tRead = bestOf(5, [&]() {
+		DrawingReader reader(file.data(), file.length());
+		for (size_t ix = 0; ix < reader.getTurtleCount(); ix++) {
+			for (const SegmentChunkView& chunk : reader.getTurtle(ix).chunks) {
+				for (size_t i = 0; i < chunk.count; i++) {
+					sum += chunk.segments[i].x2;
+				}
+			}
+		}
+	});
+	printf("  write (to memory)  %7.3f s  %7.1f MB/s  %6.1f M seg/s  %.1f MB\n", tWrite,
+		bytes.size() / 1e6 / tWrite, n / 1e6 / tWrite, bytes.size() / 1e6);
+	printf("  load and validate  %7.1f us for %zu chunks (no segment copied)  %s\n", tLoad * 1e6,
+		nChunks, valid ? "valid" : "INVALID");
+	printf("  load and read all  %7.3f s  %7.1f MB/s  %6.1f M seg/s  (checksum %g)\n", tRead,
+		bytes.size() / 1e6 / tRead, n / 1e6 / tRead, sum);
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 5000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testRoundTrip();
+	testCorruption();
+	return report("DrawingFormat");
+}
@@ -0,0 +1,180 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the frame conversion and cadence of the FrameSink:
+ * RGBA and I420 frames are compared with a floating-point BT.601 reference,
+ * and the frame boundaries by segment count and by time are checked.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "FrameFormat.h"
+
+using namespace TestSupport;
+
+// Canvas pixels as B, G, R, X bytes with a row stride beyond the width
+struct Canvas {
+	uint32_t width, height;
+	ptrdiff_t stride;
+	std::vector<unsigned char> bytes;
+
+	Canvas(uint32_t width, uint32_t height, uint32_t seed)
+		: width(width), height(height), stride(4 * (ptrdiff_t)width + 12), bytes(stride * height)
+	{
+		Random rnd(seed);
+		for (unsigned char& b : bytes) {
+			b = (unsigned char)rnd.next();
+		}
+	}
+	inline const unsigned char* at(uint32_t x, uint32_t y) const { return bytes.data() + y * stride + 4 * x; }
+};
+
+static int lumaOf(double r, double g, double b)
+{
+	return (int)floor(16 + (65.738 * r + 129.057 * g + 25.064 * b) / 256 + 0.5);
+}
+
+static void testRgba()
+{
+	Canvas canvas(37, 11, 91);
+	std::vector<unsigned char> frame(FrameConverter::getFrameSize(FRAME_RGBA, canvas.width, canvas.height));
+	CHECK(frame.size() == 37 * 11 * 4);
+	FrameConverter::convert(FRAME_RGBA, canvas.bytes.data(), canvas.stride, canvas.width, canvas.height, frame.data());
+	size_t nBad = 0;
+	for (uint32_t y = 0; y < canvas.height; y++) {
+		for (uint32_t x = 0; x < canvas.width; x++) {
+			const unsigned char* src = canvas.at(x, y);
+			const unsigned char* dst = frame.data() + 4 * ((size_t)y * canvas.width + x);
+			nBad += dst[0] != src[2] || dst[1] != src[1] || dst[2] != src[0] || dst[3] != 0xFF;
+		}
+	}
+	CHECK_MSG(nBad == 0, "%zu RGBA pixels differ", nBad);
+}
+
+static void testI420()
+{
+	Canvas canvas(38, 12, 92);
+	const uint32_t w = canvas.width, h = canvas.height;
+	std::vector<unsigned char> frame(FrameConverter::getFrameSize(FRAME_I420, w, h));
+	CHECK(frame.size() == 38 * 12 + 2 * 19 * 6);
+	FrameConverter::convert(FRAME_I420, canvas.bytes.data(), canvas.stride, w, h, frame.data());
+	const unsigned char* pY = frame.data();
+	const unsigned char* pU = pY + w * h;
+	const unsigned char* pV = pU + (w / 2) * (h / 2);
+	int maxDiff = 0;
+	for (uint32_t y = 0; y < h; y++) {
+		for (uint32_t x = 0; x < w; x++) {
+			const unsigned char* p = canvas.at(x, y);
+			maxDiff = std::max(maxDiff, abs(pY[y * w + x] - lumaOf(p[2], p[1], p[0])));
+		}
+	}
+	for (uint32_t y = 0; y < h; y += 2) {
+		for (uint32_t x = 0; x < w; x += 2) {
+			double r = 0, g = 0, b = 0;
+			for (int i = 0; i < 4; i++) {
+				const unsigned char* p = canvas.at(x + i % 2, y + i / 2);
+				r += p[2] / 4.0;
+				g += p[1] / 4.0;
+				b += p[0] / 4.0;
+			}
+			int u = (int)floor(128 + (-37.945 * r - 74.494 * g + 112.439 * b) / 256 + 0.5);
+			int v = (int)floor(128 + (112.439 * r - 94.154 * g - 18.285 * b) / 256 + 0.5);
+			size_t ix = (y / 2) * (w / 2) + x / 2;
+			maxDiff = std::max(maxDiff, std::max(abs(pU[ix] - u), abs(pV[ix] - v)));
+		}
+	}
+	CHECK_MSG(maxDiff <= 1, "I420 deviates by %d from the reference", maxDiff);
+
+	// The range limits: black and white
+	for (unsigned char level : { (unsigned char)0, (unsigned char)255 }) {
+		std::vector<unsigned char> plain(2 * 2 * 4, level);
+		unsigned char yuv[6];
+		FrameConverter::convert(FRAME_I420, plain.data(), 8, 2, 2, yuv);
+		int luma = level == 0 ? 16 : 235;
+		CHECK(yuv[0] == luma && yuv[3] == luma && yuv[4] == 128 && yuv[5] == 128);
+	}
+}
+
+/* Feeds chunks of the given sizes as the FrameSink does (slices ending at frame
+ * boundaries) and returns the segment counts at which frames were taken */
+static std::vector<size_t> feed(FrameCadence& cadence, const std::vector<size_t>& chunkSizes)
+{
+	std::vector<size_t> frames;
+	size_t total = 0;
+	for (size_t count : chunkSizes) {
+		size_t ix = 0;
+		while (ix < count) {
+			size_t n = std::min(count - ix, cadence.getRoom());
+			ix += n;
+			total += n;
+			if (cadence.addSegments(n)) {
+				frames.push_back(total);
+				cadence.frameTaken();
+			}
+		}
+	}
+	return frames;
+}
+
+static void testCadence()
+{
+	// By segment count: a frame after every 100 segments, regardless of the chunking
+	FrameCadence byCount(100, std::chrono::milliseconds(0));
+	std::vector<size_t> frames = feed(byCount, { 30, 250, 1, 0, 119, 1000 });
+	CHECK(frames.size() == 14 && byCount.getPending() == 0);
+	for (size_t i = 0; i < frames.size(); i++) {
+		CHECK(frames[i] == 100 * (i + 1));
+	}
+	frames = feed(byCount, { 42 });
+	CHECK(frames.empty() && byCount.getPending() == 42 && byCount.getRoom() == 58);
+	CHECK(byCount.takeDueFrames(FrameCadence::Clock::now() + std::chrono::hours(1)) == 0);
+
+	// By time only: one frame per elapsed interval, including the missed ones
+	FrameCadence byTime(0, std::chrono::milliseconds(40));
+	CHECK(byTime.getRoom() == SIZE_MAX && !byTime.addSegments(1000000));
+	FrameCadence::Clock::time_point t0 = FrameCadence::Clock::now();
+	byTime.start(t0);
+	CHECK(byTime.takeDueFrames(t0) == 0);
+	CHECK(byTime.takeDueFrames(t0 + std::chrono::milliseconds(39)) == 0);
+	CHECK(byTime.takeDueFrames(t0 + std::chrono::milliseconds(40)) == 1);
+	CHECK(byTime.takeDueFrames(t0 + std::chrono::milliseconds(79)) == 0);
+	CHECK(byTime.takeDueFrames(t0 + std::chrono::milliseconds(205)) == 4);
+	CHECK(byTime.takeDueFrames(t0 + std::chrono::milliseconds(240)) == 1);
+}
+
+static void benchmark(size_t n)
+{
+	// n = frame height (width 16:9)
+	uint32_t height = (uint32_t)n & ~1u, width = (height * 16 / 9 + 1) & ~1u;
+	Canvas canvas(width, height, 93);
+	printf("Frame conversion, %u x %u canvas (best of 5 runs)\n", width, height);
+	for (FrameFormat format : { FRAME_RGBA, FRAME_I420 }) {
+		std::vector<unsigned char> frame(FrameConverter::getFrameSize(format, width, height));
+		double t = bestOf(5, [&]() {
+			FrameConverter::convert(format, canvas.bytes.data(), canvas.stride, width, height, frame.data());
+		});
+		printf("  %s: %6.2f ms per frame  %7.1f Mpixel/s  %6.0f frames/s\n", format == FRAME_RGBA ? "RGBA" : "I420",
+			t * 1e3, (double)width * height / 1e6 / t, 1 / t);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 1080;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testRgba();
+	testI420();
+	testCadence();
+	return report("FrameFormat");
+}
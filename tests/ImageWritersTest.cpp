@@ -0,0 +1,542 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the image writers: the PNG (true-colour, indexed,
+ * and parallel compressed), BMP, PPM, PAM, and QOI output is decoded by the
+ * minimal decoders below and compared with the source pixels; the registry
+ * look-up is checked as well.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "ExportPipeline.h"
+#include "ImageWriters.h"
+#include "PngEncoder.h"
+#include <sstream>
+
+using namespace TestSupport;
+
+// A decoded (or source) image with pixels 0xAARRGGBB, top-down
+struct Image {
+	uint32_t width = 0, height = 0;
+	std::vector<uint32_t> pixels;
+};
+
+/* Renders a turtle-like drawing of the given size: nLines lines in nColours colours
+ * on a white background; with alpha set, some regions get translucent */
+static Image makeDrawingImage(uint32_t width, uint32_t height, size_t nLines, uint32_t nColours, bool alpha)
+{
+	Image img;
+	img.width = width;
+	img.height = height;
+	img.pixels.assign((size_t)width * height, 0xFFFFFFFF);
+	std::vector<Segment> segs = makeWalk(nLines, 51);
+	Random rnd(52);
+	std::vector<uint32_t> colours;
+	for (uint32_t i = 0; i < nColours; i++) {
+		colours.push_back(0xFF000000 | (rnd.next() & 0xFFFFFF));
+	}
+	for (size_t i = 0; i < segs.size(); i++) {
+		const Segment& s = segs[i];
+		uint32_t argb = colours[(i / 37) % nColours];
+		// Scale the walk area (9000 x 9000) to the image
+		double x1 = s.x1 * width / 9000.0, y1 = s.y1 * height / 9000.0;
+		double x2 = s.x2 * width / 9000.0, y2 = s.y2 * height / 9000.0;
+		int nSteps = (int)(std::max(fabs(x2 - x1), fabs(y2 - y1))) + 1;
+		for (int k = 0; k <= nSteps; k++) {
+			long x = (long)(x1 + (x2 - x1) * k / nSteps);
+			long y = (long)(y1 + (y2 - y1) * k / nSteps);
+			if (x >= 0 && y >= 0 && x < (long)width && y < (long)height) {
+				img.pixels[(size_t)y * width + x] = argb;
+			}
+		}
+	}
+	if (alpha) {
+		for (uint32_t y = 0; y < height; y++) {
+			for (uint32_t x = 0; x < width; x++) {
+				if ((x / 16 + y / 16) % 3 == 0) {
+					uint32_t& px = img.pixels[(size_t)y * width + x];
+					px = (px & 0xFFFFFF) | (((x * 7 + y) & 0xFF) << 24);
+				}
+			}
+		}
+	}
+	return img;
+}
+
+// Returns an image with exactly nColours distinct colours, the first of them translucent
+static Image makeIndexedImage(uint32_t width, uint32_t height, uint32_t nColours)
+{
+	Image img;
+	img.width = width;
+	img.height = height;
+	img.pixels.resize((size_t)width * height);
+	for (size_t i = 0; i < img.pixels.size(); i++) {
+		uint32_t k = (uint32_t)((i * 31) % nColours);
+		img.pixels[i] = (k == 0) ? 0x80FF0000 : 0xFF000000 | (k * 0x9E3779B1u >> 8);
+	}
+	return img;
+}
+
+static uint32_t getUInt32BE(const unsigned char* p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t getUInt32LE(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Decodes a PNG (colour types 0, 2, 3, 4, 6 with 8 bits per sample, or palette
+ * indices of 1, 2, 4, 8 bits), checking all chunk CRCs; returns false on errors */
+static bool decodePng(const std::string& file, Image& img)
+{
+	static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(file.data());
+	if (file.size() < 8 || memcmp(data, SIGNATURE, 8) != 0) {
+		return false;
+	}
+	int bitDepth = 0, colourType = -1;
+	std::vector<uint32_t> palette;
+	std::string idat;
+	bool ended = false;
+	size_t pos = 8;
+	while (pos + 12 <= file.size() && !ended) {
+		uint32_t length = getUInt32BE(data + pos);
+		if (length > file.size() - pos - 12) {
+			return false;
+		}
+		const unsigned char* type = data + pos + 4;
+		const unsigned char* body = data + pos + 8;
+		if (getUInt32BE(body + length) != crc32(0, type, length + 4)) {
+			return false;
+		}
+		if (memcmp(type, "IHDR", 4) == 0) {
+			img.width = getUInt32BE(body);
+			img.height = getUInt32BE(body + 4);
+			bitDepth = body[8];
+			colourType = body[9];
+			if (body[10] != 0 || body[11] != 0 || body[12] != 0) {
+				return false;	// compression, filter method, interlacing
+			}
+		}
+		else if (memcmp(type, "PLTE", 4) == 0) {
+			for (uint32_t i = 0; i + 3 <= length; i += 3) {
+				palette.push_back(0xFF000000 | (body[i] << 16) | (body[i + 1] << 8) | body[i + 2]);
+			}
+		}
+		else if (memcmp(type, "tRNS", 4) == 0) {
+			for (uint32_t i = 0; i < length && i < palette.size(); i++) {
+				palette[i] = (palette[i] & 0xFFFFFF) | ((uint32_t)body[i] << 24);
+			}
+		}
+		else if (memcmp(type, "IDAT", 4) == 0) {
+			idat.append(reinterpret_cast<const char*>(body), length);
+		}
+		else if (memcmp(type, "IEND", 4) == 0) {
+			ended = true;
+		}
+		pos += 12 + length;
+	}
+	static const int CHANNELS[] = { 1, 0, 3, 1, 2, 0, 4 };
+	if (!ended || pos != file.size() || colourType < 0 || colourType > 6 || CHANNELS[colourType] == 0
+		|| (colourType == 3) != (bitDepth != 8 || !palette.empty())) {
+		return false;
+	}
+	std::string raw;
+	if (!Inflater::zlibDecode(idat, raw)) {
+		return false;
+	}
+	const size_t bitsPerPixel = (size_t)CHANNELS[colourType] * bitDepth;
+	const size_t bpp = (bitsPerPixel + 7) / 8;		// Filter distance
+	const size_t rowSize = ((size_t)img.width * bitsPerPixel + 7) / 8;
+	if (raw.size() != (rowSize + 1) * img.height) {
+		return false;
+	}
+	std::vector<unsigned char> prev(rowSize, 0), row(rowSize);
+	img.pixels.resize((size_t)img.width * img.height);
+	for (uint32_t y = 0; y < img.height; y++) {
+		const unsigned char* src = reinterpret_cast<const unsigned char*>(raw.data()) + y * (rowSize + 1);
+		int filter = src[0];
+		for (size_t i = 0; i < rowSize; i++) {
+			int a = (i >= bpp) ? row[i - bpp] : 0;
+			int b = prev[i];
+			int c = (i >= bpp) ? prev[i - bpp] : 0;
+			int pred = 0;
+			switch (filter) {
+			case 0: pred = 0; break;
+			case 1: pred = a; break;
+			case 2: pred = b; break;
+			case 3: pred = (a + b) / 2; break;
+			case 4: {
+				int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+				pred = (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+				break;
+			}
+			default: return false;
+			}
+			row[i] = (unsigned char)(src[1 + i] + pred);
+		}
+		for (uint32_t x = 0; x < img.width; x++) {
+			uint32_t argb = 0;
+			const unsigned char* p = row.data() + x * bpp;
+			switch (colourType) {
+			case 0: argb = 0xFF000000 | p[0] * 0x010101u; break;
+			case 2: argb = 0xFF000000 | (p[0] << 16) | (p[1] << 8) | p[2]; break;
+			case 4: argb = ((uint32_t)p[1] << 24) | p[0] * 0x010101u; break;
+			case 6: argb = ((uint32_t)p[3] << 24) | (p[0] << 16) | (p[1] << 8) | p[2]; break;
+			case 3: {
+				size_t bit = (size_t)x * bitDepth;
+				unsigned ix = (row[bit / 8] >> (8 - bitDepth - bit % 8)) & ((1 << bitDepth) - 1);
+				if (ix >= palette.size()) {
+					return false;
+				}
+				argb = palette[ix];
+				break;
+			}
+			}
+			img.pixels[(size_t)y * img.width + x] = argb;
+		}
+		prev.swap(row);
+	}
+	return true;
+}
+
+// Decodes a BMP as written by the BmpWriter (24 bit or 32 bit bit fields, top-down)
+static bool decodeBmp(const std::string& file, Image& img)
+{
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(file.data());
+	if (file.size() < 54 || data[0] != 'B' || data[1] != 'M' || getUInt32LE(data + 2) != file.size()) {
+		return false;
+	}
+	const unsigned char* info = data + 14;
+	uint32_t offset = getUInt32LE(data + 10);
+	img.width = getUInt32LE(info + 4);
+	int32_t height = (int32_t)getUInt32LE(info + 8);
+	int bits = info[14];
+	if (height >= 0 || (bits != 24 && bits != 32)
+		|| (bits == 32 && (getUInt32LE(info) < 108 || getUInt32LE(info + 52) != 0xFF000000))) {
+		return false;
+	}
+	img.height = (uint32_t)-height;
+	size_t rowSize = ((size_t)img.width * (bits / 8) + 3) & ~(size_t)3;
+	if (offset + rowSize * img.height != file.size()) {
+		return false;
+	}
+	img.pixels.resize((size_t)img.width * img.height);
+	for (uint32_t y = 0; y < img.height; y++) {
+		const unsigned char* p = data + offset + y * rowSize;
+		for (uint32_t x = 0; x < img.width; x++, p += bits / 8) {
+			img.pixels[(size_t)y * img.width + x] = (bits == 32) ? getUInt32LE(p)
+				: 0xFF000000 | (p[2] << 16) | (p[1] << 8) | p[0];
+		}
+	}
+	return true;
+}
+
+// Decodes a PPM (P6) or PAM (P7 with tuple type RGB or RGB_ALPHA) with maxval 255
+static bool decodePnm(const std::string& file, Image& img)
+{
+	std::istringstream in(file);
+	std::string magic, token;
+	in >> magic;
+	int depth = 3, maxval = 0;
+	if (magic == "P6") {
+		in >> img.width >> img.height >> maxval;
+		in.get();
+	}
+	else if (magic == "P7") {
+		while (in >> token && token != "ENDHDR") {
+			if (token == "WIDTH") { in >> img.width; }
+			else if (token == "HEIGHT") { in >> img.height; }
+			else if (token == "DEPTH") { in >> depth; }
+			else if (token == "MAXVAL") { in >> maxval; }
+			else if (token == "TUPLTYPE") { in >> token; }
+		}
+		in.get();
+	}
+	if (!in || maxval != 255 || (depth != 3 && depth != 4)) {
+		return false;
+	}
+	size_t start = (size_t)in.tellg();
+	if (file.size() - start != (size_t)img.width * img.height * depth) {
+		return false;
+	}
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(file.data()) + start;
+	img.pixels.resize((size_t)img.width * img.height);
+	for (uint32_t& px : img.pixels) {
+		px = (depth == 4 ? (uint32_t)p[3] << 24 : 0xFF000000) | (p[0] << 16) | (p[1] << 8) | p[2];
+		p += depth;
+	}
+	return true;
+}
+
+// Decodes a QOI image according to the specification
+static bool decodeQoi(const std::string& file, Image& img)
+{
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(file.data());
+	static const unsigned char END_MARKER[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+	if (file.size() < 22 || memcmp(data, "qoif", 4) != 0
+		|| memcmp(data + file.size() - 8, END_MARKER, 8) != 0) {
+		return false;
+	}
+	img.width = getUInt32BE(data + 4);
+	img.height = getUInt32BE(data + 8);
+	const size_t nPixels = (size_t)img.width * img.height;
+	img.pixels.clear();
+	img.pixels.reserve(nPixels);
+	uint32_t index[64] = {};
+	unsigned char r = 0, g = 0, b = 0, a = 255;
+	size_t pos = 14;
+	const size_t end = file.size() - 8;
+	while (img.pixels.size() < nPixels && pos < end) {
+		unsigned char op = data[pos++];
+		int run = 1;
+		if (op == 0xFE) {
+			r = data[pos]; g = data[pos + 1]; b = data[pos + 2];
+			pos += 3;
+		}
+		else if (op == 0xFF) {
+			r = data[pos]; g = data[pos + 1]; b = data[pos + 2]; a = data[pos + 3];
+			pos += 4;
+		}
+		else if ((op & 0xC0) == 0x00) {
+			uint32_t px = index[op];
+			a = px >> 24; r = px >> 16; g = px >> 8; b = (unsigned char)px;
+		}
+		else if ((op & 0xC0) == 0x40) {
+			r += ((op >> 4) & 3) - 2;
+			g += ((op >> 2) & 3) - 2;
+			b += (op & 3) - 2;
+		}
+		else if ((op & 0xC0) == 0x80) {
+			int dg = (op & 0x3F) - 32;
+			unsigned char next = data[pos++];
+			r += dg + ((next >> 4) & 0xF) - 8;
+			g += dg;
+			b += dg + (next & 0xF) - 8;
+		}
+		else {
+			run = (op & 0x3F) + 1;
+		}
+		uint32_t px = ((uint32_t)a << 24) | (r << 16) | (g << 8) | b;
+		index[(r * 3 + g * 5 + b * 7 + a * 11) % 64] = px;
+		for (int i = 0; i < run && img.pixels.size() < nPixels; i++) {
+			img.pixels.push_back(px);
+		}
+	}
+	return img.pixels.size() == nPixels && pos == end;
+}
+
+// Writes img via the registered writer for ext, returns the file contents
+static std::string encode(const char* ext, const Image& img, bool withAlpha)
+{
+	std::ostringstream out;
+	const ImageWriterRegistry::Format* pFormat = ImageWriterRegistry::findByExtension(ext);
+	CHECK_MSG(pFormat != nullptr, "no format for %s", ext);
+	if (pFormat != nullptr) {
+		std::unique_ptr<ImageWriter> writer = pFormat->create(out, img.width, img.height, withAlpha);
+		bool ok = true;
+		// The last rows are left to finish() (filled with zeros)
+		for (uint32_t y = 0; y + 2 < img.height; y++) {
+			ok = writer->writeRow(img.pixels.data() + (size_t)y * img.width) && ok;
+		}
+		ok = writer->finish() && ok;
+		CHECK_MSG(ok, "%s writer failed", ext);
+	}
+	return out.str();
+}
+
+// Counts the pixels of decoded deviating from the expectation for img
+static size_t countDeviations(const Image& img, const Image& decoded, bool withAlpha)
+{
+	if (decoded.width != img.width || decoded.height != img.height || decoded.pixels.size() != img.pixels.size()) {
+		return img.pixels.size();
+	}
+	size_t nBad = 0;
+	for (uint32_t y = 0; y < img.height; y++) {
+		for (uint32_t x = 0; x < img.width; x++) {
+			size_t i = (size_t)y * img.width + x;
+			uint32_t expected = img.pixels[i];
+			if (y + 2 >= img.height) {
+				expected = 0;			// filled in by finish()
+			}
+			if (!withAlpha) {
+				expected |= 0xFF000000;
+			}
+			nBad += decoded.pixels[i] != expected;
+		}
+	}
+	return nBad;
+}
+
+static void testFormats()
+{
+	typedef bool (*Decoder)(const std::string&, Image&);
+	struct Case { const char* ext; Decoder decode; bool hasAlpha; };
+	const Case cases[] = {
+		{ "png", decodePng, true }, { "BMP", decodeBmp, true }, { "dib", decodeBmp, true },
+		{ "ppm", decodePnm, false }, { "pnm", decodePnm, false }, { "pam", decodePnm, true },
+		{ "qoi", decodeQoi, true }
+	};
+	for (bool withAlpha : { false, true }) {
+		// Odd width for the BMP row padding
+		Image img = makeDrawingImage(301, 203, 300, 10, withAlpha);
+		// The alpha bytes must be ignored without alpha, so give them garbage
+		if (!withAlpha) {
+			for (size_t i = 0; i < img.pixels.size(); i += 7) {
+				img.pixels[i] &= 0x7FFFFFFF;
+			}
+		}
+		for (const Case& c : cases) {
+			std::string file = encode(c.ext, img, withAlpha);
+			Image decoded;
+			bool ok = c.decode(file, decoded);
+			CHECK_MSG(ok, "%s (alpha %d) not decodable", c.ext, withAlpha);
+			size_t nBad = countDeviations(img, decoded, withAlpha && c.hasAlpha);
+			CHECK_MSG(ok && nBad == 0, "%s (alpha %d): %zu pixels differ", c.ext, withAlpha, nBad);
+		}
+	}
+}
+
+// Indexed PNGs of all bit depths, and the parallel compression
+static void testPng()
+{
+	for (uint32_t nColours : { 2u, 3u, 16u, 200u, 256u }) {
+		// Every colour occurs (31 is coprime to nColours), colour 0 is translucent (tRNS)
+		Image img = makeIndexedImage(333, 120, nColours);
+		PngPalette palette;
+		std::vector<unsigned char> indices(img.pixels.size());
+		CHECK(palette.indexPixels(img.pixels.data(), img.pixels.size(), indices.data()));
+		CHECK(palette.getColours().size() == nColours && palette.hasTransparency());
+		std::ostringstream out;
+		PngWriter png(out, img.width, img.height, palette);
+		for (uint32_t y = 0; y < img.height; y++) {
+			png.writeRow(indices.data() + (size_t)y * img.width);
+		}
+		CHECK(png.finish());
+		Image decoded;
+		CHECK_MSG(decodePng(out.str(), decoded) && decoded.pixels == img.pixels,
+			"indexed PNG with %u colours (%d bits)", nColours, palette.getBitDepth());
+	}
+	// A palette holds at most 256 colours
+	PngPalette palette;
+	Image many = makeIndexedImage(100, 100, 257);
+	std::vector<unsigned char> indices(many.pixels.size());
+	CHECK(!palette.indexPixels(many.pixels.data(), many.pixels.size(), indices.data()));
+
+	// Concurrent compression yields the same image (big enough for several jobs)
+	Image img = makeDrawingImage(1500, 900, 3000, 10, false);
+	ExportPipeline pipeline(4);
+	for (const ExportPipeline* pPipeline : { (const ExportPipeline*)nullptr, (const ExportPipeline*)&pipeline }) {
+		for (int level : { 0, 1, 6, 9 }) {
+			std::ostringstream out;
+			PngWriter png(out, img.width, img.height, PngWriter::RGB, level, pPipeline);
+			std::vector<unsigned char> row(png.getRowSize());
+			for (uint32_t y = 0; y < img.height; y++) {
+				for (uint32_t x = 0; x < img.width; x++) {
+					uint32_t argb = img.pixels[(size_t)y * img.width + x];
+					row[3 * x] = (unsigned char)(argb >> 16);
+					row[3 * x + 1] = (unsigned char)(argb >> 8);
+					row[3 * x + 2] = (unsigned char)argb;
+				}
+				png.writeRow(row.data());
+			}
+			CHECK(png.finish());
+			Image decoded;
+			CHECK_MSG(decodePng(out.str(), decoded) && decoded.pixels == img.pixels,
+				"%s PNG level %d", pPipeline ? "parallel" : "serial", level);
+		}
+	}
+}
+
+static void testRegistry()
+{
+	const ImageWriterRegistry::Format* pQoi = ImageWriterRegistry::findByExtension("qoi");
+	CHECK(pQoi != nullptr && pQoi->name == "QOI");
+	CHECK(ImageWriterRegistry::findForFile(L"C:\\my.pictures\\drawing.QoI") == pQoi);
+	CHECK(ImageWriterRegistry::findForFile(L"C:\\my.png\\drawing") == nullptr);
+	CHECK(ImageWriterRegistry::findForFile(L"drawing.tif") == nullptr);
+	CHECK(ImageWriterRegistry::findByExtension(L"p\u00e4m") == nullptr);
+	const ImageWriterRegistry::Format* pPnm = ImageWriterRegistry::findByExtension(L"PNM");
+	CHECK(pPnm != nullptr && pPnm->name == "PPM");
+	std::vector<std::string> names = ImageWriterRegistry::getFormatNames();
+	CHECK(names.size() >= 5 && names[0] == "PNG" && names[1] == "BMP" && names[2] == "PPM"
+		&& names[3] == "PAM" && names[4] == "QOI");
+	// Applications may add formats (here a PPM under another extension)
+	ImageWriterRegistry::addFormat({ "Test", "tst;TST2", pPnm->create });
+	const ImageWriterRegistry::Format* pTest = ImageWriterRegistry::findForFile(L"x.tst2");
+	CHECK(pTest != nullptr && pTest->name == "Test");
+	CHECK(ImageWriterRegistry::getFormatNames().back() == "Test");
+}
+
+static void benchmark(size_t n)
+{
+	// n = number of pixels in millions (default 12: 4000 x 3000)
+	uint32_t width = 4000, height = (uint32_t)(n * 1000000 / width);
+	Image img = makeDrawingImage(width, height, 20000, 10, false);
+	printf("Image encoding, %u x %u drawing (10 colours, 20000 lines), to memory (best of 3)\n", width, height);
+	for (const char* ext : { "png", "bmp", "ppm", "pam", "qoi" }) {
+		const ImageWriterRegistry::Format* pFormat = ImageWriterRegistry::findByExtension(ext);
+		size_t size = 0;
+		double t = bestOf(3, [&]() {
+			std::ostringstream out;
+			std::unique_ptr<ImageWriter> writer = pFormat->create(out, width, height, false);
+			for (uint32_t y = 0; y < height; y++) {
+				writer->writeRow(img.pixels.data() + (size_t)y * width);
+			}
+			writer->finish();
+			size = (size_t)out.tellp();
+		});
+		printf("  %-4s %7.0f ms  %7.1f Mpixel/s  %6.1f MB\n", pFormat->name.c_str(), t * 1e3,
+			img.pixels.size() / 1e6 / t, size / 1e6);
+	}
+	// The indexed PNG path of the canvas export, serially and in parallel
+	PngPalette palette;
+	std::vector<unsigned char> indices(img.pixels.size());
+	palette.indexPixels(img.pixels.data(), img.pixels.size(), indices.data());
+	ExportPipeline pipeline;
+	for (const ExportPipeline* pPipeline : { (const ExportPipeline*)nullptr, (const ExportPipeline*)&pipeline }) {
+		size_t size = 0;
+		double t = bestOf(3, [&]() {
+			std::ostringstream out;
+			PngWriter png(out, width, height, palette, Deflater::DEFAULT_LEVEL, pPipeline);
+			for (uint32_t y = 0; y < height; y++) {
+				png.writeRow(indices.data() + (size_t)y * width);
+			}
+			png.finish();
+			size = (size_t)out.tellp();
+		});
+		printf("  PNG, indexed (%u bits), %s: %7.0f ms  %7.1f Mpixel/s  %6.2f MB\n", (unsigned)palette.getBitDepth(),
+			pPipeline ? "parallel" : "serial  ", t * 1e3, img.pixels.size() / 1e6 / t, size / 1e6);
+	}
+	const int nLookups = 1000000;
+	size_t nFound = 0;
+	Stopwatch watch;
+	for (int i = 0; i < nLookups; i++) {
+		nFound += ImageWriterRegistry::findForFile(L"C:\\Users\\Public\\Pictures\\drawing.qoi") != nullptr;
+	}
+	printf("  findForFile(): %.0f ns per look-up (%zu found)\n", watch.seconds() * 1e9 / nLookups, nFound);
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 12;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testFormats();
+	testPng();
+	testRegistry();
+	return report("ImageWriters");
+}
@@ -0,0 +1,397 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the Journal: a drawing journaled while it grows (with
+ * clears, state and background changes) must be restored exactly by replay, a
+ * journal cut at any length must replay its complete records only, and a
+ * journal resumed after a torn record (as Turtleizer::startJournal() does it)
+ * must replay to the continued drawing. The benchmark measures the cost of
+ * the journal per forward() step, i.e. per segment appended to a store.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "Journal.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using namespace TestSupport;
+
+// The turtles of a drawing as the Turtleizer holds them (source of the journal)
+struct Drawing {
+	std::vector<std::unique_ptr<SegmentStore>> stores;
+	std::vector<DrawingFormat::TurtleRecord> states;
+	uint32_t background;
+	std::mutex mutex;			// Guards states and background
+
+	explicit Drawing(size_t nTurtles) : states(nTurtles), background(0xFFFFFFFF)
+	{
+		for (size_t ix = 0; ix < nTurtles; ix++) {
+			stores.emplace_back(new SegmentStore());
+		}
+	}
+
+	// Reports the drawing to the journal as Turtleizer::startJournal() does
+	void report(Journal& journal)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		journal.addBackground(background);
+		for (uint32_t turtleNo = 0; turtleNo < stores.size(); turtleNo++) {
+			const SegmentStore& store = *stores[turtleNo];
+			{
+				SegmentStore::ReadLock lock(store);
+				std::vector<SegmentChunkView> chunks;
+				store.getChunks(chunks, journal.beginTurtle(turtleNo, store.getGeneration()));
+				journal.addSegments(turtleNo, chunks);
+			}
+			journal.addState(turtleNo, states[turtleNo]);
+		}
+	}
+
+	void setState(uint32_t turtleNo, float x, float y, uint32_t argb)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		states[turtleNo].posX = x;
+		states[turtleNo].posY = y;
+		states[turtleNo].penARGB = argb;
+		states[turtleNo].nSegments = stores[turtleNo]->size();
+	}
+
+	void setBackground(uint32_t argb)
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		background = argb;
+	}
+};
+
+// Restores a drawing from the records, counts them
+class Recorder : public Journal::Player {
+public:
+	std::vector<std::vector<Segment>> turtles;
+	std::vector<DrawingFormat::TurtleRecord> states;
+	uint32_t background = 0;
+	size_t nRecords = 0, nClears = 0;
+
+	virtual void onSegments(uint32_t turtle, const Segment* segments, size_t count)
+	{
+		at(turtle).insert(turtles[turtle].end(), segments, segments + count);
+		nRecords++;
+	}
+	virtual void onState(uint32_t turtle, const DrawingFormat::TurtleRecord& state)
+	{
+		at(turtle);
+		states[turtle] = state;
+		nRecords++;
+	}
+	virtual void onClear(uint32_t turtle)
+	{
+		at(turtle).clear();
+		nRecords++;
+		nClears++;
+	}
+	virtual void onBackground(uint32_t argb)
+	{
+		background = argb;
+		nRecords++;
+	}
+private:
+	std::vector<Segment>& at(uint32_t turtle)
+	{
+		if (turtle >= turtles.size()) {
+			turtles.resize(turtle + 1);
+			states.resize(turtle + 1, DrawingFormat::TurtleRecord{});
+		}
+		return turtles[turtle];
+	}
+};
+
+// Only counts the records
+class Counter : public Journal::Player {
+public:
+	size_t nRecords = 0;
+
+	virtual void onSegments(uint32_t, const Segment*, size_t) { nRecords++; }
+	virtual void onState(uint32_t, const DrawingFormat::TurtleRecord&) { nRecords++; }
+	virtual void onClear(uint32_t) { nRecords++; }
+	virtual void onBackground(uint32_t) { nRecords++; }
+};
+
+// Returns the given bytes in 8-byte aligned memory (as replay() requires)
+static std::vector<uint64_t> aligned(const std::string& bytes)
+{
+	std::vector<uint64_t> words((bytes.size() + 7) / 8);
+	memcpy(words.data(), bytes.data(), bytes.size());
+	return words;
+}
+
+static std::string readFile(const std::filesystem::path& path)
+{
+	std::ifstream in(path, std::ios::in | std::ios::binary);
+	std::ostringstream text;
+	text << in.rdbuf();
+	return text.str();
+}
+
+static bool sameSegments(const std::vector<Segment>& a, const SegmentStore& store)
+{
+	SegmentStore::ReadLock lock(store);
+	std::vector<SegmentChunkView> chunks;
+	store.getChunks(chunks);
+	size_t ix = 0;
+	for (const SegmentChunkView& chunk : chunks) {
+		if (ix + chunk.count > a.size() || memcmp(a.data() + ix, chunk.segments, chunk.count * sizeof(Segment)) != 0) {
+			return false;
+		}
+		ix += chunk.count;
+	}
+	return ix == a.size();
+}
+
+// Checks the recorded drawing against the original one
+static void checkRestored(const Recorder& recorder, Drawing& drawing, const char* name)
+{
+	CHECK_MSG(recorder.turtles.size() == drawing.stores.size(), "%s: %zu turtles", name, recorder.turtles.size());
+	for (size_t ix = 0; ix < std::min(recorder.turtles.size(), drawing.stores.size()); ix++) {
+		CHECK_MSG(sameSegments(recorder.turtles[ix], *drawing.stores[ix]), "%s: turtle %zu: %zu of %zu segments",
+			name, ix, recorder.turtles[ix].size(), drawing.stores[ix]->size());
+		CHECK_MSG(memcmp(&recorder.states[ix], &drawing.states[ix], sizeof(DrawingFormat::TurtleRecord)) == 0,
+			"%s: turtle %zu: state differs", name, ix);
+	}
+	CHECK_MSG(recorder.background == drawing.background, "%s: background %08X", name, recorder.background);
+}
+
+/* Draws count segments of a walk with 3 turtles in portions, with pauses (such that
+ * the journal polls in between), state and background changes and, unless noClear,
+ * a clear of turtle 1 halfway */
+static void draw(Drawing& drawing, size_t count, uint32_t seed, bool noClear = false)
+{
+	std::vector<Segment> walk = makeWalk(count, seed);
+	Random rnd(seed);
+	size_t ix = 0;
+	while (ix < walk.size()) {
+		uint32_t turtleNo = rnd.below((uint32_t)drawing.stores.size());
+		size_t n = std::min<size_t>(walk.size() - ix, 1 + rnd.below(3000));
+		if (rnd.below(2) == 0) {
+			drawing.stores[turtleNo]->append(walk.data() + ix, n);
+		}
+		else {
+			// One by one, as forward() does
+			for (size_t i = ix; i < ix + n; i++) {
+				drawing.stores[turtleNo]->push_back(walk[i]);
+			}
+		}
+		ix += n;
+		drawing.setState(turtleNo, walk[ix - 1].x2, walk[ix - 1].y2, walk[ix - 1].argb);
+		if (rnd.below(5) == 0) {
+			drawing.setBackground(0xFF000000 | rnd.next());
+		}
+		if (!noClear && ix >= walk.size() / 2 && ix - n < walk.size() / 2) {
+			drawing.stores[1]->clear();
+			drawing.setState(1, 0.0f, 0.0f, 0xFF000000);
+		}
+		if (rnd.below(4) == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(Journal::FLUSH_INTERVAL_MS / 5));
+		}
+	}
+}
+
+// Journals a growing drawing and replays it
+static void testRoundTrip(std::string& journalText)
+{
+	Drawing drawing(3);
+	std::ostringstream out(std::ios::out | std::ios::binary);
+	{
+		Journal journal(out, [&](Journal& j) { drawing.report(j); });
+		draw(drawing, 200000, 31);
+		CHECK(journal.isGood());
+	}
+	journalText = out.str();
+	std::vector<uint64_t> data = aligned(journalText);
+	Recorder recorder;
+	size_t complete = 0;
+	CHECK(Journal::replay((const char*)data.data(), journalText.size(), recorder, &complete));
+	CHECK(complete == journalText.size());
+	checkRestored(recorder, drawing, "round trip");
+	CHECK(recorder.nClears == 1);
+	// A journal polled several times shouldn't consist of a single burst
+	CHECK_MSG(recorder.nRecords > 3 * 2 + 1, "%zu records", recorder.nRecords);
+
+	// Something else isn't replayed
+	std::string other = journalText;
+	other[0] = 'X';
+	std::vector<uint64_t> otherData = aligned(other);
+	Recorder nothing;
+	CHECK(!Journal::replay((const char*)otherData.data(), other.size(), nothing) && nothing.nRecords == 0);
+}
+
+// Replays the journal cut at every length, only complete records count
+static void testTorn(const std::string& journalText)
+{
+	// Record ends (unpadded and padded) by walking the headers
+	std::vector<std::pair<size_t, size_t>> ends;
+	size_t offset = sizeof(DrawingFormat::FileHeader);
+	while (offset < journalText.size()) {
+		Journal::RecordHeader header;
+		memcpy(&header, journalText.data() + offset, sizeof(header));
+		size_t end = offset + sizeof(header) + (size_t)header.size;
+		offset = offset + sizeof(header) + (size_t)DrawingFormat::align(header.size);
+		ends.push_back(std::make_pair(end, offset));
+	}
+	CHECK(offset == journalText.size());
+	std::vector<uint64_t> data = aligned(journalText);
+	// All lengths within the first records, and around the bounds of every record
+	std::vector<size_t> cuts;
+	for (size_t cut = 0; cut < 512; cut++) {
+		cuts.push_back(cut);
+	}
+	size_t start = sizeof(DrawingFormat::FileHeader), nPadded = 0;
+	for (const std::pair<size_t, size_t>& end : ends) {
+		for (size_t cut : { start + 1, start + sizeof(Journal::RecordHeader), end.first - 1, end.first, end.second - 1 }) {
+			cuts.push_back(cut);
+		}
+		nPadded += end.second > end.first;
+		start = end.second;
+	}
+	CHECK(nPadded > 0);
+	size_t nBad = 0;
+	for (size_t cut : cuts) {
+		Counter counter;
+		size_t complete = 0;
+		bool ok = Journal::replay((const char*)data.data(), std::min(cut, journalText.size()), counter, &complete);
+		if (cut < sizeof(DrawingFormat::FileHeader)) {
+			nBad += ok;
+			continue;
+		}
+		// The records ending within the cut (their padding may be missing)
+		size_t nComplete = 0, expected = sizeof(DrawingFormat::FileHeader);
+		while (nComplete < ends.size() && ends[nComplete].first <= cut) {
+			expected = ends[nComplete++].second;
+		}
+		nBad += !ok || counter.nRecords != nComplete || complete != expected;
+	}
+	CHECK_MSG(nBad == 0, "%zu cut lengths replayed wrongly", nBad);
+}
+
+// Journals into a file, tears it, resumes it as Turtleizer::startJournal() does
+static void testResume()
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "JournalTest.tzj";
+	Drawing drawing(3);
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		Journal journal(out, [&](Journal& j) { drawing.report(j); });
+		draw(drawing, 100000, 33, true);
+	}
+	std::string text = readFile(path);
+	// Tear the file within the padding of a record in the second half (payload complete)
+	size_t cut = 0, offset = sizeof(DrawingFormat::FileHeader);
+	while (offset < text.size()) {
+		Journal::RecordHeader header;
+		memcpy(&header, text.data() + offset, sizeof(header));
+		size_t end = offset + sizeof(header) + (size_t)header.size;
+		offset += sizeof(header) + (size_t)DrawingFormat::align(header.size);
+		if (end < offset && (cut == 0 || end < text.size() / 2)) {
+			cut = end;
+		}
+	}
+	CHECK(cut > sizeof(DrawingFormat::FileHeader) && cut < text.size());
+	std::filesystem::resize_file(path, cut);
+
+	// Restore the drawing from the torn journal
+	Recorder restored;
+	size_t complete = 0;
+	{
+		std::string torn = readFile(path);
+		std::vector<uint64_t> data = aligned(torn);
+		CHECK(torn.size() == cut && Journal::replay((const char*)data.data(), torn.size(), restored, &complete));
+	}
+	CHECK(complete > cut && complete == DrawingFormat::align(cut));
+	Drawing resumed(3);
+	for (size_t ix = 0; ix < restored.turtles.size(); ix++) {
+		resumed.stores[ix]->append(restored.turtles[ix].data(), restored.turtles[ix].size());
+		resumed.states[ix] = restored.states[ix];
+	}
+	resumed.background = restored.background;
+
+	// Continue the journal behind its complete records and draw on
+	std::filesystem::resize_file(path, complete);
+	{
+		std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::app);
+		Journal journal(out, [&](Journal& j) { resumed.report(j); }, true);
+		draw(resumed, 50000, 34);
+	}
+	text = readFile(path);
+	std::vector<uint64_t> data = aligned(text);
+	Recorder recorder;
+	CHECK(Journal::replay((const char*)data.data(), text.size(), recorder, &complete));
+	CHECK(complete == text.size());
+	checkRestored(recorder, resumed, "resumed");
+	std::filesystem::remove(path);
+}
+
+/* Appends n segments one by one (as n forward() calls do) to the first turtle of
+ * drawing, returns the seconds taken */
+static double forwardSteps(Drawing& drawing, const std::vector<Segment>& walk)
+{
+	Stopwatch watch;
+	for (const Segment& seg : walk) {
+		drawing.stores[0]->push_back(seg);
+	}
+	drawing.setState(0, walk.back().x2, walk.back().y2, walk.back().argb);
+	return watch.seconds();
+}
+
+static void benchmark(size_t n)
+{
+	std::vector<Segment> walk = makeWalk(n, 42);
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "JournalBench.tzj";
+	printf("Journal overhead per forward() step, %zu segments appended one by one (best of 3 runs)\n", n);
+	double tPlain = 1e30, tJournaled = 1e30, tTotal = 1e30;
+	uint64_t nWhileDrawing = 0, nTotal = 0;
+	for (int run = 0; run < 3; run++) {
+		Drawing plain(1);
+		tPlain = std::min(tPlain, forwardSteps(plain, walk));
+		Drawing journaled(1);
+		Stopwatch watch;
+		{
+			std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+			Journal journal(out, [&](Journal& j) { journaled.report(j); });
+			tJournaled = std::min(tJournaled, forwardSteps(journaled, walk));
+			nWhileDrawing = journal.getBytesWritten();
+		}
+		// Including the final poll (the rest of the drawing is written on destruction)
+		tTotal = std::min(tTotal, watch.seconds());
+		nTotal = std::filesystem::file_size(path);
+	}
+	std::filesystem::remove(path);
+	printf("  without journal   %6.2f ns per step  %7.1f M steps/s\n", tPlain * 1e9 / n, n / 1e6 / tPlain);
+	printf("  with journal      %6.2f ns per step  %7.1f M steps/s  (%+.2f ns per step)\n", tJournaled * 1e9 / n,
+		n / 1e6 / tJournaled, (tJournaled - tPlain) * 1e9 / n);
+	printf("  journal of %.1f MB complete after %.1f ms (%.1f MB written while drawing)\n",
+		nTotal / 1e6, tTotal * 1e3, nWhileDrawing / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 10000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	std::string journalText;
+	testRoundTrip(journalText);
+	testTorn(journalText);
+	testResume();
+	return report("Journal");
+}
@@ -0,0 +1,252 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the PlotPlanner and the PlotterWriter: every segment
+ * must be plotted exactly once with its colour in all orderings, the planned
+ * statistics must be consistent, and the HPGL and G-code programs are run on
+ * the PlotterSimulator, whose distances, strokes and pen changes must match
+ * the plan.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "PlotPlanner.h"
+#include "PlotterWriter.h"
+#include "Simplifier.h"
+#include <sstream>
+#include <tuple>
+
+using namespace TestSupport;
+
+static const PlotPlanner::Ordering ORDERINGS[] = {
+	PlotPlanner::ORDER_STORED, PlotPlanner::ORDER_GREEDY, PlotPlanner::ORDER_TWO_OPT
+};
+static const char* const ORDERING_NAMES[] = { "stored", "greedy", "2-opt" };
+
+// An undirected segment with its colour (for comparisons regardless of the drawing direction)
+typedef std::tuple<uint32_t, float, float, float, float> SegmentKey;
+
+static SegmentKey makeKey(float x1, float y1, float x2, float y2, uint32_t argb)
+{
+	if (std::make_pair(x2, y2) < std::make_pair(x1, y1)) {
+		std::swap(x1, x2);
+		std::swap(y1, y2);
+	}
+	return SegmentKey(argb, x1, y1, x2, y2);
+}
+
+// Returns count small squares of 3 colours in random order and random corners (grid data)
+static std::vector<Segment> makeSquares(size_t count, uint32_t seed)
+{
+	static const uint32_t COLOURS[] = { 0xFF000000, 0xFFFF0000, 0xFF0000FF };
+	static const float DX[] = { 10, 0, -10, 0 }, DY[] = { 0, 10, 0, -10 };
+	std::vector<Segment> segs;
+	segs.reserve(4 * count);
+	Random rnd(seed);
+	for (size_t i = 0; i < count; i++) {
+		float x = (float)(rnd.below(400) * 20), y = (float)(rnd.below(400) * 20);
+		uint32_t argb = COLOURS[rnd.below(3)];
+		int corner = rnd.below(4);
+		for (int k = 0; k < 4; k++) {
+			int side = (corner + k) % 4;
+			segs.push_back(Segment{ x, y, x + DX[side], y + DY[side], argb });
+			x += DX[side];
+			y += DY[side];
+		}
+	}
+	return segs;
+}
+
+// Returns segs with their colours mapped to nPens colours (as a plotter would draw them)
+static std::vector<Segment> withPens(std::vector<Segment> segs, uint32_t nPens)
+{
+	for (Segment& s : segs) {
+		s.argb = 0xFF000000 | (s.argb % nPens * 0x3F);
+	}
+	return segs;
+}
+
+// Checks that the paths plot every segment of segs exactly once (in either direction)
+static void checkCoverage(const std::vector<Segment>& segs, const std::vector<PlotPath>& paths, const char* name)
+{
+	std::vector<SegmentKey> expected, plotted;
+	for (const Segment& s : segs) {
+		expected.push_back(makeKey(s.x1, s.y1, s.x2, s.y2, s.argb));
+	}
+	for (const PlotPath& path : paths) {
+		for (size_t i = 1; i < path.points.size(); i++) {
+			const PlotPoint& a = path.points[i - 1];
+			const PlotPoint& b = path.points[i];
+			plotted.push_back(makeKey(a.x, a.y, b.x, b.y, path.argb));
+		}
+	}
+	std::sort(expected.begin(), expected.end());
+	std::sort(plotted.begin(), plotted.end());
+	CHECK_MSG(expected == plotted, "%s: %zu segments expected, %zu plotted (or different)", name,
+		expected.size(), plotted.size());
+}
+
+static bool nearlyEqual(double a, double b, double tolerance)
+{
+	return fabs(a - b) <= tolerance;
+}
+
+// Plots the paths and runs the program on the simulator, checks the figures against stats
+static void checkProgram(const PlotPlanner& planner, PlotterWriter::Dialect dialect, const char* name)
+{
+	const std::vector<PlotPath>& paths = planner.getPaths();
+	const PlotStats& stats = planner.getPlannedStats();
+	const double mmPerUnit = PlotterWriter::DEFAULT_MM_PER_UNIT;
+	std::ostringstream out;
+	{
+		PlotterWriter writer(out, dialect, planner.getBounds(), mmPerUnit);
+		writer.writeHeader();
+		writer.writePaths(paths);
+		CHECK(writer.finish());
+	}
+	std::string program = out.str();
+	PlotterSimulator simulator(dialect);
+	bool ok = simulator.run(program.data(), program.size());
+	const char* dialectName = dialect == PlotterWriter::HPGL ? "HPGL" : "G-code";
+	CHECK_MSG(ok, "%s %s: program not executable", name, dialectName);
+	// Rounding to plotter units (1/40 mm) or micrometres per point
+	double resolution = dialect == PlotterWriter::HPGL ? 1.0 / PlotterWriter::HPGL_UNITS_PER_MM : 0.001;
+	double tolerance = 2 * resolution * (stats.nSegments + stats.nPaths);
+	CHECK_MSG(simulator.getStrokeCount() == stats.nPaths && simulator.getPenChangeCount() == stats.nPenChanges,
+		"%s %s: %zu strokes, %zu pen changes, planned %zu, %zu", name, dialectName,
+		simulator.getStrokeCount(), simulator.getPenChangeCount(), stats.nPaths, stats.nPenChanges);
+	CHECK_MSG(nearlyEqual(simulator.getDrawLength(), stats.drawLength * mmPerUnit, tolerance)
+		&& nearlyEqual(simulator.getTravelLength(), stats.travelLength * mmPerUnit, tolerance),
+		"%s %s: drawn %.3f mm, travelled %.3f mm, planned %.3f, %.3f", name, dialectName,
+		simulator.getDrawLength(), simulator.getTravelLength(), stats.drawLength * mmPerUnit,
+		stats.travelLength * mmPerUnit);
+}
+
+static void testPlans()
+{
+	std::vector<Segment> walk = withPens(makeWalk(20000, 81, true), 5);
+	std::vector<Segment> squares = makeSquares(3000, 82);
+	for (const std::vector<Segment>* pSegs : { &walk, &squares }) {
+		const std::vector<Segment>& segs = *pSegs;
+		PlotPlanner planner;
+		// Added in two portions, the second one via chunk views
+		size_t half = segs.size() / 2;
+		planner.addSegments(segs.data(), half);
+		SegmentStore store;
+		store.append(segs.data() + half, segs.size() - half);
+		{
+			SegmentStore::ReadLock lock(store);
+			std::vector<SegmentChunkView> chunks;
+			store.getChunks(chunks);
+			planner.addChunks(chunks);
+		}
+		const PlotStats stored = planner.getStoredStats();
+		CHECK(stored.nSegments == segs.size());
+		std::vector<uint32_t> colours;
+		for (const Segment& s : segs) {
+			colours.push_back(s.argb);
+		}
+		std::sort(colours.begin(), colours.end());
+		const size_t nColours = std::unique(colours.begin(), colours.end()) - colours.begin();
+		double travel = 0.0;
+		size_t nPaths = 0;
+		for (int ix = 0; ix < 3; ix++) {
+			planner.plan(ORDERINGS[ix]);
+			const std::vector<PlotPath>& paths = planner.getPaths();
+			const PlotStats& stats = planner.getPlannedStats();
+			checkCoverage(segs, paths, ORDERING_NAMES[ix]);
+			PlotStats measured = PlotPlanner::measure(paths);
+			CHECK(measured.nSegments == segs.size() && stats.nSegments == segs.size());
+			CHECK(measured.nPaths == stats.nPaths && measured.nPenChanges == stats.nPenChanges);
+			CHECK(nearlyEqual(measured.drawLength, stored.drawLength, 1e-9 * stored.drawLength));
+			CHECK(nearlyEqual(measured.travelLength, stats.travelLength, 1e-9 * (1 + stats.travelLength)));
+			if (ix == 0) {
+				CHECK(stats.nPaths == stored.nPaths && stats.nPenChanges == stored.nPenChanges);
+			}
+			else {
+				// One pen per colour, polylines stitched, 2-opt only improves the greedy tour
+				CHECK(stats.nPenChanges + 1 == nColours && stats.nPaths <= nPaths);
+				CHECK(ix == 1 || stats.travelLength <= travel);
+			}
+			travel = stats.travelLength;
+			nPaths = stats.nPaths;
+			checkProgram(planner, PlotterWriter::HPGL, ORDERING_NAMES[ix]);
+			checkProgram(planner, PlotterWriter::GCODE, ORDERING_NAMES[ix]);
+		}
+		// The squares are closed, so the planned travel must be far below the stored one
+		CHECK(pSegs != &squares || travel < stored.travelLength / 4);
+
+		// Simplification keeps the strokes and shortens the drawn distance at most
+		Simplifier simplifier(0.5f);
+		size_t nPlanned = planner.getPlannedStats().nPaths;
+		planner.simplify(simplifier);
+		const PlotStats& simplified = planner.getPlannedStats();
+		CHECK(simplified.nPaths == nPlanned && simplified.nSegments <= segs.size());
+		CHECK(simplified.drawLength <= stored.drawLength * (1 + 1e-9));
+		CHECK(simplifier.getInputCount() == segs.size() && simplifier.getOutputCount() == simplified.nSegments);
+		checkProgram(planner, PlotterWriter::GCODE, "simplified");
+	}
+	// An empty drawing yields a valid program
+	PlotPlanner empty;
+	empty.plan();
+	CHECK(empty.getPaths().empty() && empty.getPlannedStats().nSegments == 0);
+	checkProgram(empty, PlotterWriter::HPGL, "empty");
+}
+
+static void benchmark(size_t n)
+{
+	struct Input { const char* name; std::vector<Segment> segs; };
+	const Input inputs[] = {
+		{ "turtle walk, 4 pens", withPens(makeWalk(n, 42, true), 4) },
+		{ "squares in random order", makeSquares(n / 4, 43) }
+	};
+	printf("Plot planning and plotter output, %zu segments each\n", n);
+	for (const Input& input : inputs) {
+		PlotPlanner planner;
+		planner.addSegments(input.segs.data(), input.segs.size());
+		PlotStats stored = planner.getStoredStats();
+		printf("  %s: stored order %zu strokes, %zu pen changes, travel %.0f\n", input.name,
+			stored.nPaths, stored.nPenChanges, stored.travelLength);
+		for (int ix = 0; ix < 3; ix++) {
+			Stopwatch watch;
+			planner.plan(ORDERINGS[ix]);
+			double t = watch.seconds();
+			const PlotStats& stats = planner.getPlannedStats();
+			printf("    %-6s %8.1f ms  %7zu strokes  %2zu pen changes  travel %10.0f (%5.1f %%)\n",
+				ORDERING_NAMES[ix], t * 1e3, stats.nPaths, stats.nPenChanges, stats.travelLength,
+				100.0 * stats.travelLength / stored.travelLength);
+		}
+		for (PlotterWriter::Dialect dialect : { PlotterWriter::HPGL, PlotterWriter::GCODE }) {
+			size_t size = 0;
+			double t = bestOf(3, [&]() {
+				std::ostringstream out;
+				PlotterWriter writer(out, dialect, planner.getBounds());
+				writer.writeHeader();
+				writer.writePaths(planner.getPaths());
+				writer.finish();
+				size = (size_t)out.tellp();
+			});
+			printf("    %-6s output %6.1f ms  %6.1f MB/s  %6.1f MB\n", dialect == PlotterWriter::HPGL ? "HPGL" : "G-code",
+				t * 1e3, size / 1e6 / t, size / 1e6);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 400000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testPlans();
+	return report("PlotPlanner");
+}
@@ -0,0 +1,248 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the SegmentStore: single and bulk appends, chunk
+ * views and bounds, iteration, clipping, and reading while another thread
+ * appends.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "SegmentStore.h"
+#include <atomic>
+#include <thread>
+
+using namespace TestSupport;
+
+static bool sameSegment(const Segment& a, const Segment& b)
+{
+	return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2 && a.argb == b.argb;
+}
+
+static bool sameBounds(const SegmentBounds& a, const SegmentBounds& b)
+{
+	return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+// Checks that the chunk views of store from index from cover exactly segs[from...]
+static void checkChunks(const SegmentStore& store, const std::vector<Segment>& segs, size_t from)
+{
+	SegmentStore::ReadLock lock(store);
+	std::vector<SegmentChunkView> views;
+	store.getChunks(views, from);
+	size_t next = from;
+	bool contentOk = true, boundsOk = true;
+	for (const SegmentChunkView& view : views) {
+		CHECK(view.firstIndex == next);
+		// Only the first view may start within a chunk, and no view crosses a chunk border
+		CHECK(view.firstIndex == from || view.firstIndex % SegmentStore::CHUNK_SIZE == 0);
+		CHECK(view.firstIndex / SegmentStore::CHUNK_SIZE
+			== (view.firstIndex + view.count - 1) / SegmentStore::CHUNK_SIZE);
+		SegmentBounds bounds = SegmentBounds::empty();
+		for (size_t i = 0; i < view.count; i++) {
+			contentOk = contentOk && sameSegment(view.segments[i], segs[view.firstIndex + i]);
+			bounds.include(view.segments[i]);
+		}
+		boundsOk = boundsOk && sameBounds(bounds, view.bounds);
+		next += view.count;
+	}
+	CHECK(contentOk);
+	CHECK(boundsOk);
+	CHECK(next == segs.size());
+}
+
+static void testAppend()
+{
+	const size_t n = 3 * SegmentStore::CHUNK_SIZE + 123;
+	std::vector<Segment> segs = makeWalk(n, 1);
+
+	SegmentStore single;
+	CHECK(single.empty());
+	for (const Segment& seg : segs) {
+		single.push_back(seg);
+	}
+	CHECK(single.size() == n);
+	checkChunks(single, segs, 0);
+	checkChunks(single, segs, SegmentStore::CHUNK_SIZE + 17);
+	checkChunks(single, segs, n);
+
+	// Bulk appends in portions not aligned with the chunks
+	SegmentStore bulk;
+	size_t done = 0;
+	for (size_t portion : { (size_t)1, (size_t)4000, (size_t)5000, (size_t)0, n }) {
+		size_t count = std::min(portion, n - done);
+		bulk.append(segs.data() + done, count);
+		done += count;
+	}
+	CHECK(bulk.size() == n);
+	checkChunks(bulk, segs, 0);
+
+	// Iteration, random access, and a resume position behind the end
+	size_t ix = 0;
+	bool iterOk = true;
+	for (SegmentStore::const_iterator it = bulk.cbegin(); it != bulk.cend(); ++it, ++ix) {
+		iterOk = iterOk && it.index() == ix && sameSegment(*it, segs[ix]);
+	}
+	CHECK(iterOk);
+	CHECK(ix == n);
+	CHECK(sameSegment(*bulk.at(2 * SegmentStore::CHUNK_SIZE), segs[2 * SegmentStore::CHUNK_SIZE]));
+	SegmentStore::const_iterator resume = bulk.at(n - 1);
+	++resume;
+	bulk.push_back(segs[0]);
+	CHECK(resume != bulk.cend());
+	CHECK(resume.index() == n && sameSegment(*resume, segs[0]));
+
+	// clear() drops everything and counts the generation
+	unsigned int generation = bulk.getGeneration();
+	bulk.clear();
+	CHECK(bulk.empty() && bulk.cbegin() == bulk.cend());
+	CHECK(bulk.getGeneration() == generation + 1);
+	bulk.append(segs.data(), 10);
+	CHECK(bulk.size() == 10 && sameSegment(*bulk.cbegin(), segs[0]));
+}
+
+static void testClipping()
+{
+	SegmentBounds box{ 0.0f, 0.0f, 100.0f, 50.0f };
+	Segment inside{ 10.0f, 10.0f, 20.0f, 20.0f, 0xFF000000 };
+	Segment crossing{ -50.0f, 25.0f, 150.0f, 25.0f, 0xFF000000 };
+	Segment outside{ 200.0f, 0.0f, 300.0f, 50.0f, 0xFF000000 };
+	Segment seg = inside;
+	CHECK(box.clip(seg) && sameSegment(seg, inside));
+	seg = crossing;
+	CHECK(box.clip(seg) && seg.x1 == 0.0f && seg.x2 == 100.0f && seg.y1 == 25.0f && seg.y2 == 25.0f);
+	seg = outside;
+	CHECK(!box.clip(seg) && sameSegment(seg, outside));
+
+	// Clipped chunks keep all segments within the box, passing whole chunks through
+	std::vector<Segment> segs = makeWalk(2 * SegmentStore::CHUNK_SIZE, 2);
+	SegmentStore store;
+	store.append(segs.data(), segs.size());
+	SegmentStore::ReadLock lock(store);
+	std::vector<SegmentChunkView> chunks, clipped;
+	std::vector<std::vector<Segment>> storage;
+	store.getChunks(chunks);
+	SegmentBounds all = SegmentBounds::empty();
+	for (const SegmentChunkView& view : chunks) {
+		all.include(view.bounds);
+	}
+	clipChunks(chunks, all, clipped, storage);
+	CHECK(clipped.size() == chunks.size() && storage.empty());
+	CHECK(clipped.size() > 0 && clipped[0].segments == chunks[0].segments);
+
+	SegmentBounds half{ all.left, all.top, (all.left + all.right) / 2, all.bottom };
+	clipped.clear();
+	clipChunks(chunks, half, clipped, storage);
+	size_t nClipped = 0;
+	bool insideOk = true;
+	for (const SegmentChunkView& view : clipped) {
+		CHECK(view.firstIndex == nClipped);
+		for (size_t i = 0; i < view.count; i++) {
+			const Segment& s = view.segments[i];
+			insideOk = insideOk && s.x1 <= half.right && s.x2 <= half.right;
+		}
+		nClipped += view.count;
+	}
+	CHECK(insideOk);
+	CHECK(nClipped > 0 && nClipped < segs.size());
+}
+
+// A reader must always see complete, correct segments up to the published count
+static void testConcurrentReading()
+{
+	const size_t n = 200 * SegmentStore::CHUNK_SIZE;
+	std::vector<Segment> segs = makeWalk(n, 3);
+	SegmentStore store;
+	std::atomic<bool> done(false);
+	std::atomic<size_t> nMismatches(0);
+	size_t nPolls = 0;
+	std::thread reader([&]() {
+		while (!done.load()) {
+			SegmentStore::ReadLock lock(store);
+			std::vector<SegmentChunkView> views;
+			store.getChunks(views);
+			for (const SegmentChunkView& view : views) {
+				// Spot check the ends of every view
+				if (!sameSegment(view.segments[0], segs[view.firstIndex])
+					|| !sameSegment(view.segments[view.count - 1], segs[view.firstIndex + view.count - 1])) {
+					nMismatches++;
+				}
+			}
+			nPolls++;
+		}
+	});
+	for (size_t i = 0; i < n; i += 1000) {
+		if (i % 2000 == 0) {
+			store.append(segs.data() + i, std::min<size_t>(1000, n - i));
+		}
+		else {
+			for (size_t j = i; j < std::min<size_t>(i + 1000, n); j++) {
+				store.push_back(segs[j]);
+			}
+		}
+	}
+	done = true;
+	reader.join();
+	CHECK(nMismatches == 0);
+	CHECK(nPolls > 0);
+	checkChunks(store, segs, 0);
+}
+
+static void benchmark(size_t n)
+{
+	std::vector<Segment> segs = makeWalk(n, 42);
+	printf("SegmentStore, %zu segments (best of 5 runs)\n", n);
+	double tPush = bestOf(5, [&]() {
+		SegmentStore store;
+		for (const Segment& seg : segs) {
+			store.push_back(seg);
+		}
+	});
+	double tAppend = bestOf(5, [&]() {
+		SegmentStore store;
+		store.append(segs.data(), segs.size());
+	});
+	SegmentStore store;
+	store.append(segs.data(), segs.size());
+	double sum = 0.0;
+	double tChunks = bestOf(5, [&]() {
+		SegmentStore::ReadLock lock(store);
+		std::vector<SegmentChunkView> views;
+		store.getChunks(views);
+		for (const SegmentChunkView& view : views) {
+			for (size_t i = 0; i < view.count; i++) {
+				sum += view.segments[i].x2;
+			}
+		}
+	});
+	double tIter = bestOf(5, [&]() {
+		for (SegmentStore::const_iterator it = store.cbegin(); it != store.cend(); ++it) {
+			sum += it->x2;
+		}
+	});
+	printf("  push_back        %7.1f M seg/s\n", n / 1e6 / tPush);
+	printf("  append           %7.1f M seg/s\n", n / 1e6 / tAppend);
+	printf("  read via chunks  %7.1f M seg/s\n", n / 1e6 / tChunks);
+	printf("  read via iterator%7.1f M seg/s  (checksum %g)\n", n / 1e6 / tIter, sum);
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 10000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testAppend();
+	testClipping();
+	testConcurrentReading();
+	return report("SegmentStore");
+}
@@ -0,0 +1,205 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the Simplifier: the simplified lines must consist of
+ * vertices of the original polylines, keep their colours and end points, and
+ * no dropped vertex may deviate more than the tolerance from the line that
+ * replaces it; the concurrent simplification must yield the serial result.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "ExportPipeline.h"
+#include "Simplifier.h"
+
+using namespace TestSupport;
+
+// A point type for Simplifier::reduce()
+struct Point {
+	float x, y;
+};
+
+/* Returns count steps of a turtle program drawing arcs: forward(1) with turns of
+ * 1 or 0.5 degrees (changing direction now and then), colour changes and pen-up gaps */
+static std::vector<Segment> makeArcs(size_t count, uint32_t seed)
+{
+	std::vector<Segment> segs;
+	segs.reserve(count);
+	Random rnd(seed);
+	double x = 4000.0, y = 4000.0, angle = 0.0, turn = 1.0;
+	uint32_t argb = 0xFF000000;
+	float lastX = (float)x, lastY = (float)y;
+	for (size_t i = 0; i < count; i++) {
+		if (rnd.below(500) == 0) {
+			turn = (rnd.below(2) == 0 ? 0.5 : 1.0) * (rnd.below(2) == 0 ? -1 : 1);
+		}
+		if (rnd.below(20000) == 0) {
+			argb = 0xFF000000 | (rnd.next() & 0xFFFFFF);
+		}
+		if (rnd.below(50000) == 0) {
+			x += rnd.below(200);
+			lastX = (float)x;
+		}
+		angle += turn;
+		x += cos(angle * 3.14159265358979 / 180.0);
+		y -= sin(angle * 3.14159265358979 / 180.0);
+		segs.push_back(Segment{ lastX, lastY, (float)x, (float)y, argb });
+		lastX = (float)x;
+		lastY = (float)y;
+	}
+	return segs;
+}
+
+// Returns the distance of (px, py) from the line segment (ax, ay)-(bx, by)
+static double distance(double px, double py, double ax, double ay, double bx, double by)
+{
+	double dx = bx - ax, dy = by - ay;
+	double len2 = dx * dx + dy * dy;
+	double t = len2 > 0 ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0;
+	t = std::max(0.0, std::min(1.0, t));
+	return hypot(px - ax - t * dx, py - ay - t * dy);
+}
+
+/* Checks that the simplified segments of a chunk replace the original ones within
+ * the tolerance, returns the maximum deviation of a dropped vertex */
+static double checkChunk(const SegmentChunkView& original, const SegmentChunkView& simplified, float tolerance)
+{
+	const Segment* in = original.segments;
+	size_t next = 0;		// Next original segment to be covered
+	double maxDeviation = 0.0;
+	size_t nBad = 0;
+	for (size_t k = 0; k < simplified.count && next < original.count; k++) {
+		const Segment& seg = simplified.segments[k];
+		nBad += seg.x1 != in[next].x1 || seg.y1 != in[next].y1 || seg.argb != in[next].argb;
+		// Find the original segment ending at the end of seg within the same polyline
+		size_t last = next;
+		while (last + 1 < original.count && (in[last].x2 != seg.x2 || in[last].y2 != seg.y2)
+			&& in[last + 1].argb == in[last].argb && in[last + 1].x1 == in[last].x2 && in[last + 1].y1 == in[last].y2) {
+			last++;
+		}
+		nBad += in[last].x2 != seg.x2 || in[last].y2 != seg.y2;
+		for (size_t i = next; i < last; i++) {
+			maxDeviation = std::max(maxDeviation, distance(in[i].x2, in[i].y2, seg.x1, seg.y1, seg.x2, seg.y2));
+		}
+		next = last + 1;
+	}
+	CHECK_MSG(nBad == 0 && next == original.count, "chunk at %zu: %zu mismatches, %zu of %zu covered",
+		original.firstIndex, nBad, next, original.count);
+	CHECK_MSG(maxDeviation <= tolerance * (1 + 1e-6), "chunk at %zu: deviation %g > %g",
+		original.firstIndex, maxDeviation, tolerance);
+	return maxDeviation;
+}
+
+static void testReduce()
+{
+	Simplifier simplifier(0.5f);
+	// A straight line is reduced to its end points
+	std::vector<Point> line;
+	for (int i = 0; i <= 100; i++) {
+		line.push_back(Point{ i * 1.0f, i * 0.5f });
+	}
+	CHECK(simplifier.reduce(line.data(), line.size()) == 2);
+	CHECK(line[0].x == 0.0f && line[1].x == 100.0f && line[1].y == 50.0f);
+	// A zigzag beyond the tolerance is kept, below the tolerance it goes
+	std::vector<Point> zigzag, flat;
+	for (int i = 0; i <= 50; i++) {
+		zigzag.push_back(Point{ i * 2.0f, (i % 2) * 1.2f });
+		flat.push_back(Point{ i * 2.0f, (i % 2) * 0.4f });
+	}
+	CHECK(simplifier.reduce(zigzag.data(), zigzag.size()) == 51);
+	CHECK(simplifier.reduce(flat.data(), flat.size()) == 2);
+	// A reversal on the same line keeps the turning point
+	Point reversal[] = { { 0, 0 }, { 5, 0 }, { 10, 0 }, { 5, 0 }, { 2, 0 } };
+	CHECK(simplifier.reduce(reversal, 5) == 3 && reversal[1].x == 10.0f && reversal[2].x == 2.0f);
+	CHECK(simplifier.reduce(reversal, 1) == 1 && simplifier.reduce(reversal, 0) == 0);
+}
+
+static void testChunks()
+{
+	std::vector<Segment> segs = makeArcs(5 * SegmentStore::CHUNK_SIZE + 321, 71);
+	// Unconnected and isolated segments stay
+	segs.push_back(Segment{ 1.0f, 1.0f, 2.0f, 2.0f, 0xFF00FF00 });
+	segs.push_back(Segment{ 2.0f, 2.0f, 3.0f, 3.0f, 0xFF0000FF });
+	SegmentStore store;
+	store.append(segs.data(), segs.size());
+	SegmentStore::ReadLock lock(store);
+	std::vector<SegmentChunkView> chunks;
+	store.getChunks(chunks);
+	ExportPipeline pipeline(4);
+	for (float tolerance : { 0.1f, 0.25f, 1.0f }) {
+		Simplifier serial(tolerance), parallel(tolerance);
+		std::vector<SegmentChunkView> simplified, simplifiedPar;
+		std::vector<std::vector<Segment>> storage, storagePar;
+		serial.simplifyChunks(chunks, simplified, storage);
+		parallel.simplifyChunks(chunks, simplifiedPar, storagePar, &pipeline);
+		CHECK(simplified.size() == chunks.size());
+		size_t nOut = 0;
+		for (size_t ix = 0; ix < std::min(chunks.size(), simplified.size()); ix++) {
+			checkChunk(chunks[ix], simplified[ix], tolerance);
+			CHECK(simplified[ix].firstIndex == nOut);
+			nOut += simplified[ix].count;
+		}
+		CHECK(serial.getInputCount() == segs.size() && serial.getOutputCount() == nOut);
+		CHECK(nOut < segs.size() / 5);
+		bool same = simplified.size() == simplifiedPar.size() && parallel.getOutputCount() == nOut;
+		for (size_t ix = 0; same && ix < simplified.size(); ix++) {
+			same = simplified[ix].count == simplifiedPar[ix].count
+				&& memcmp(simplified[ix].segments, simplifiedPar[ix].segments,
+					simplified[ix].count * sizeof(Segment)) == 0;
+		}
+		CHECK_MSG(same, "tolerance %g: concurrent result differs", tolerance);
+	}
+}
+
+static void benchmark(size_t n)
+{
+	std::vector<Segment> segs = makeArcs(n, 42);
+	SegmentStore store;
+	store.append(segs.data(), segs.size());
+	SegmentStore::ReadLock lock(store);
+	std::vector<SegmentChunkView> chunks;
+	store.getChunks(chunks);
+	ExportPipeline pipeline;
+	printf("Simplification of %zu arc steps (forward(1), 1 or 0.5 degree turns), best of 3 runs\n", n);
+	for (float tolerance : { 0.1f, 0.25f, 0.5f, 1.0f }) {
+		for (const ExportPipeline* pPipeline : { (const ExportPipeline*)nullptr, (const ExportPipeline*)&pipeline }) {
+			std::vector<SegmentChunkView> simplified;
+			std::vector<std::vector<Segment>> storage;
+			double t = bestOf(3, [&]() {
+				Simplifier simplifier(tolerance);
+				simplified.clear();
+				storage.clear();
+				simplifier.simplifyChunks(chunks, simplified, storage, pPipeline);
+			});
+			double maxDeviation = 0.0;
+			size_t nOut = 0;
+			for (size_t ix = 0; ix < simplified.size(); ix++) {
+				maxDeviation = std::max(maxDeviation, checkChunk(chunks[ix], simplified[ix], tolerance));
+				nOut += simplified[ix].count;
+			}
+			printf("  tolerance %4.2f, %s: %6.1f ms  %6.1f M seg/s  %8zu kept (%4.1f %%)  max deviation %.3f\n",
+				tolerance, pPipeline ? "parallel" : "serial  ", t * 1e3, n / 1e6 / t, nOut, 100.0 * nOut / n,
+				maxDeviation);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 2000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testReduce();
+	testChunks();
+	return report("Simplifier");
+}
@@ -0,0 +1,535 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Tests and benchmark of the SvgWriter: the compatible output is compared
+ * byte by byte with that of the former iostream-based export (replicated
+ * below), and the paths of both modes are parsed back and compared with the
+ * original segments. A stream failing at any point (like on a full disk)
+ * must be reported by writeDocumentEnd(), including the gzip trailer. The
+ * concurrent formatting of chunks by fragment writers (as Turtle does it) must
+ * yield the serial output byte by byte.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "ExportPipeline.h"
+#include "SvgWriter.h"
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+using namespace TestSupport;
+
+static const int MAX_POINTS_PER_PATH = 800;		// As Turtle::MAX_POINTS_PER_SVG_PATH
+
+// The SVG export as it was before the SvgWriter (Turtle::writeSVG() and the frame of
+// TurtleCanvas::handleExportSVG()), as reference for the compatible mode
+static void writeFormerSvg(std::ostream& ostr, const std::vector<std::vector<Segment>>& turtles,
+	float width, float height, unsigned short scale, float offsetX, float offsetY, const char* title, uint32_t bgRGB)
+{
+	ostr << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
+	ostr << "<!-- Created with Turtleizer_CPP" << " (https://github.com/codemanyak/Turtleizer_CPP) -->\n";
+	ostr << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\""
+		<< (long)ceil(width * scale) << "\" height=\"" << (long)ceil(height * scale) << "\">\n";
+	ostr << "  <title>" << title << "</title>\n";
+	ostr << "    <rect style=\"fill:rgb(" << (int)((bgRGB >> 16) & 255) << "," << (int)((bgRGB >> 8) & 255)
+		<< "," << (int)(bgRGB & 255) << ");fill-opacity:1\" ";
+	ostr << " x=\"0\" y=\"0\" width=\"" << (long)ceil(width * scale) << "\" height=\"" << (long)ceil(height * scale) << "\" ";
+	ostr << "id=\"background\"/>\n";
+	ostr << "  <g id=\"elements\" style=\"fill:none;stroke-width:" << scale << +"px;stroke-opacity:1:stroke-linejoin:miter\">\n";
+	for (const std::vector<Segment>& segs : turtles) {
+		float lastX = 0.0f, lastY = 0.0f;
+		uint32_t lastCol = 0;
+		int nPoints = 0;
+		ostr.fill('0');
+		for (const Segment& seg : segs) {
+			if (nPoints == 0 || lastX != seg.x1 || lastY != seg.y1 || lastCol != seg.argb
+				|| nPoints >= MAX_POINTS_PER_PATH) {
+				if (nPoints > 0) {
+					ostr << "\" />\n";
+				}
+				ostr << "    <path\n";
+				ostr << "      style=\"stroke:#" << std::hex << std::setw(6) << (int)(seg.argb & 0xFFFFFF) << std::dec << "\"\n";
+				ostr << "      id=\"path" << std::setw(5) << nPoints << "\"\n";
+				ostr << "      d=\"m " << ((seg.x1 + offsetX) * scale) << "," << ((seg.y1 + offsetY) * scale) << " ";
+			}
+			ostr << ((seg.x2 - seg.x1) * scale) << "," << ((seg.y2 - seg.y1) * scale) << " ";
+			lastX = seg.x2;
+			lastY = seg.y2;
+			lastCol = seg.argb;
+			nPoints++;
+		}
+		if (nPoints > 0) {
+			ostr << "\" />\n";
+		}
+	}
+	ostr << "  </g>\n" << "</svg>\n";
+}
+
+static void writeSvg(std::ostream& out, const std::vector<std::vector<Segment>>& turtles,
+	float width, float height, float scale, float offsetX, float offsetY, const char* title, uint32_t bgRGB,
+	int precision = SvgWriter::PRECISION_COMPATIBLE)
+{
+	SvgWriter svg(out, precision);
+	svg.writeDocumentStart(width, height, scale, title, bgRGB);
+	for (const std::vector<Segment>& segs : turtles) {
+		svg.beginPaths(offsetX, offsetY, MAX_POINTS_PER_PATH);
+		// In portions, like the chunks of a SegmentStore
+		for (size_t i = 0; i < segs.size(); i += 1000) {
+			svg.addSegments(segs.data() + i, std::min<size_t>(1000, segs.size() - i));
+		}
+		svg.endPaths();
+	}
+	svg.writeDocumentEnd();
+}
+
+// A line as parsed from a path (in document coordinates)
+struct Line {
+	double x1, y1, x2, y2;
+	uint32_t rgb;
+};
+
+static uint32_t parseHex6(const char* p)
+{
+	return (uint32_t)strtoul(std::string(p, 6).c_str(), nullptr, 16);
+}
+
+/* Parses the path data d (commands M, m, L, l, h, v with implicit repetition) and
+ * appends the drawn lines to lines; returns false on unexpected content */
+static bool parsePathData(const char* d, const char* end, uint32_t rgb, std::vector<Line>& lines)
+{
+	char cmd = '\0';
+	double x = 0.0, y = 0.0;
+	std::vector<double> args;
+	const char* p = d;
+	while (p < end) {
+		if (*p == ' ' || *p == ',' || *p == '\n') {
+			p++;
+			continue;
+		}
+		if (strchr("MmLlhv", *p) != nullptr) {
+			cmd = *p++;
+			continue;
+		}
+		// A number: optional sign, digits, at most one decimal point
+		const char* start = p;
+		if (*p == '-') { p++; }
+		bool hasPoint = false;
+		while (p < end && (isdigit((unsigned char)*p) || (*p == '.' && !hasPoint))) {
+			hasPoint = hasPoint || *p == '.';
+			p++;
+		}
+		if (p == start || cmd == '\0') {
+			return false;
+		}
+		args.push_back(strtod(std::string(start, p).c_str(), nullptr));
+		size_t nArgs = (cmd == 'h' || cmd == 'v') ? 1 : 2;
+		if (args.size() < nArgs) {
+			continue;
+		}
+		double nx = x, ny = y;
+		switch (cmd) {
+		case 'M': case 'L': nx = args[0]; ny = args[1]; break;
+		case 'm': case 'l': nx += args[0]; ny += args[1]; break;
+		case 'h': nx += args[0]; break;
+		case 'v': ny += args[0]; break;
+		}
+		if (cmd == 'M' || cmd == 'm') {
+			// Implicit successors of a move are lines
+			cmd = (cmd == 'M') ? 'L' : 'l';
+		}
+		else {
+			lines.push_back(Line{ x, y, nx, ny, rgb });
+		}
+		x = nx;
+		y = ny;
+		args.clear();
+	}
+	return args.empty();
+}
+
+// Extracts all lines from an SVG document of either mode; returns false on unexpected content
+static bool parseSvg(const std::string& svg, std::vector<Line>& lines)
+{
+	// Colour classes of the compact mode
+	std::unordered_map<unsigned long, uint32_t> classes;
+	size_t pos = svg.find("<style>");
+	while (pos != std::string::npos && (pos = svg.find("    .c", pos)) != std::string::npos) {
+		char* after = nullptr;
+		unsigned long ix = strtoul(svg.c_str() + pos + 6, &after, 10);
+		if (strncmp(after, "{stroke:#", 9) != 0) {
+			return false;
+		}
+		classes[ix] = parseHex6(after + 9);
+		pos = after - svg.c_str();
+	}
+	pos = 0;
+	while ((pos = svg.find("<path", pos)) != std::string::npos) {
+		size_t end = svg.find("/>", pos);
+		size_t dStart = svg.find(" d=\"", pos);
+		if (end == std::string::npos || dStart == std::string::npos || dStart > end) {
+			return false;
+		}
+		dStart += 4;
+		size_t dEnd = svg.find('"', dStart);
+		uint32_t rgb = 0;
+		size_t style = svg.find("stroke:#", pos);
+		size_t cls = svg.find("class=\"c", pos);
+		if (style < dStart) {
+			rgb = parseHex6(svg.c_str() + style + 8);
+		}
+		else if (cls < dStart) {
+			auto it = classes.find(strtoul(svg.c_str() + cls + 8, nullptr, 10));
+			if (it == classes.end()) {
+				return false;
+			}
+			rgb = it->second;
+		}
+		else {
+			return false;
+		}
+		if (!parsePathData(svg.c_str() + dStart, svg.c_str() + dEnd, rgb, lines)) {
+			return false;
+		}
+		pos = end;
+	}
+	return true;
+}
+
+// Compatible mode: byte-identical to the former export, for integral scales
+static void testCompatibleIdentity()
+{
+	std::vector<std::vector<Segment>> turtles = { makeWalk(5000, 11), {}, makeWalk(3000, 12) };
+	// Some special values
+	turtles[1].push_back(Segment{ -0.0f, 0.0f, 1e-7f, -123456.78f, 0xFFFFFFFF });
+	turtles[1].push_back(Segment{ 1e-7f, -123456.78f, 0.1f, 3.0e20f, 0x00123456 });
+	for (unsigned short scale : { (unsigned short)1, (unsigned short)3 }) {
+		std::ostringstream former, current;
+		writeFormerSvg(former, turtles, 1234.5f, 987.25f, scale, 123.25f, -77.5f, "test.svg", 0xFFEEDD);
+		writeSvg(current, turtles, 1234.5f, 987.25f, scale, 123.25f, -77.5f, "test.svg", 0xFFEEDD);
+		CHECK_MSG(former.str() == current.str(), "scale %u", scale);
+	}
+}
+
+// Compatible mode: the parsed paths reproduce the (exactly representable) segments
+static void testCompatibleRoundTrip()
+{
+	std::vector<Segment> segs = makeWalk(20000, 13, true);
+	for (float scale : { 1.0f, 2.0f }) {
+		std::ostringstream out;
+		writeSvg(out, { segs }, 9500.0f, 9500.0f, scale, 100.25f, 50.5f, "a < b & c", 0x102030);
+		std::string svg = out.str();
+		CHECK(svg.find("<title>a &lt; b &amp; c</title>") != std::string::npos);
+		CHECK(svg.find("fill:rgb(16,32,48)") != std::string::npos);
+		CHECK(svg.size() > 7 && svg.compare(svg.size() - 7, 7, "</svg>\n") == 0);
+		std::vector<Line> lines;
+		CHECK(parseSvg(svg, lines));
+		CHECK(lines.size() == segs.size());
+		size_t nBad = 0;
+		for (size_t i = 0; i < std::min(lines.size(), segs.size()); i++) {
+			const Segment& s = segs[i];
+			const Line& l = lines[i];
+			if (l.x1 != (s.x1 + 100.25f) * scale || l.y1 != (s.y1 + 50.5f) * scale
+				|| l.x2 != (s.x2 + 100.25f) * scale || l.y2 != (s.y2 + 50.5f) * scale
+				|| l.rgb != (s.argb & 0xFFFFFF)) {
+				nBad++;
+			}
+		}
+		CHECK_MSG(nBad == 0, "scale %g: %zu of %zu lines differ", scale, nBad, segs.size());
+	}
+}
+
+// Compact mode: all end points within half a unit of the last decimal
+static void testCompactRoundTrip()
+{
+	std::vector<Segment> segs = makeWalk(20000, 14);
+	for (int precision = 0; precision <= SvgWriter::MAX_PRECISION; precision++) {
+		std::ostringstream out;
+		writeSvg(out, { segs }, 9500.0f, 9500.0f, 0.5f, -3.5f, 7.25f, "compact", 0xFFFFFF, precision);
+		std::string svg = out.str();
+		CHECK(svg.find("viewBox=\"0 0 9500 9500\"") != std::string::npos);
+		std::vector<Line> lines;
+		CHECK(parseSvg(svg, lines));
+		CHECK_MSG(lines.size() == segs.size(), "precision %d: %zu lines", precision, lines.size());
+		double tolerance = 0.5 * pow(10.0, -precision) + 1e-6;
+		double maxError = 0.0;
+		size_t nColours = 0;
+		for (size_t i = 0; i < std::min(lines.size(), segs.size()); i++) {
+			const Segment& s = segs[i];
+			const Line& l = lines[i];
+			double errors[] = { l.x1 - ((double)s.x1 - 3.5), l.y1 - ((double)s.y1 + 7.25),
+				l.x2 - ((double)s.x2 - 3.5), l.y2 - ((double)s.y2 + 7.25) };
+			for (double e : errors) {
+				maxError = std::max(maxError, fabs(e));
+			}
+			nColours += l.rgb == (s.argb & 0xFFFFFF);
+		}
+		CHECK_MSG(maxError <= tolerance, "precision %d: deviation %g", precision, maxError);
+		CHECK(nColours == segs.size());
+	}
+}
+
+// Stream buffer taking at most capacity bytes, like a file on a disk running full
+class LimitedBuffer : public std::streambuf
+{
+public:
+	explicit LimitedBuffer(size_t capacity) : capacity(capacity), size(0) {}
+protected:
+	virtual int_type overflow(int_type ch)
+	{
+		if (traits_type::eq_int_type(ch, traits_type::eof()) || size >= capacity) {
+			return traits_type::eof();
+		}
+		size++;
+		return ch;
+	}
+	virtual std::streamsize xsputn(const char*, std::streamsize count)
+	{
+		std::streamsize n = std::min<std::streamsize>(count, capacity - size);
+		size += (size_t)n;
+		return n;
+	}
+private:
+	const size_t capacity;
+	size_t size;
+};
+
+// Writes a document into a stream of the given capacity, returns the result of writeDocumentEnd()
+static bool writeLimited(const std::vector<Segment>& segs, int precision, int compression, size_t capacity)
+{
+	LimitedBuffer buffer(capacity);
+	std::ostream out(&buffer);
+	SvgWriter svg(out, precision, compression);
+	svg.writeDocumentStart(9000.0f, 9000.0f, 1.0f, "full.svg", 0xFFFFFF);
+	svg.beginPaths(0.0f, 0.0f, MAX_POINTS_PER_PATH);
+	svg.addSegments(segs.data(), segs.size());
+	svg.endPaths();
+	return svg.writeDocumentEnd();
+}
+
+// A failing stream is reported, including a failure at the very end (gzip trailer)
+static void testStreamFailure()
+{
+	const std::vector<Segment> small = makeWalk(2000, 15), large = makeWalk(200000, 16);
+	for (int compression : { SvgWriter::NO_COMPRESSION, 6 }) {
+		for (const std::vector<Segment>* pSegs : { &small, &large }) {
+			std::ostringstream out;
+			{
+				SvgWriter svg(out, 2, compression);
+				svg.writeDocumentStart(9000.0f, 9000.0f, 1.0f, "full.svg", 0xFFFFFF);
+				svg.beginPaths(0.0f, 0.0f, MAX_POINTS_PER_PATH);
+				svg.addSegments(pSegs->data(), pSegs->size());
+				svg.endPaths();
+				CHECK(svg.writeDocumentEnd());
+			}
+			const size_t size = out.str().size();
+			CHECK(writeLimited(*pSegs, 2, compression, size));
+			if (compression == SvgWriter::NO_COMPRESSION) {
+				// Without stream buffer, the bytes are only counted (size report of the export)
+				std::ostream nowhere(nullptr);
+				SvgWriter counter(nowhere, 2);
+				counter.writeDocumentStart(9000.0f, 9000.0f, 1.0f, "full.svg", 0xFFFFFF);
+				counter.beginPaths(0.0f, 0.0f, MAX_POINTS_PER_PATH);
+				counter.addSegments(pSegs->data(), pSegs->size());
+				counter.endPaths();
+				CHECK(!counter.writeDocumentEnd() && counter.getBytesWritten() == size);
+			}
+			for (size_t capacity : { size - 1, size / 2, (size_t)0 }) {
+				CHECK_MSG(!writeLimited(*pSegs, 2, compression, capacity),
+					"compression %d: failure at %zu of %zu bytes unnoticed", compression, capacity, size);
+			}
+		}
+	}
+}
+
+/* Writes the chunks of the turtles as Turtle::writeChunksSVG() does: serially, or
+ * by fragment writers via the pipeline, which resume the paths of the preceding
+ * chunk (replicated here since Turtle needs GDI+) */
+static void writeChunks(SvgWriter& svg, const std::vector<SegmentChunkView>& chunks, const ExportPipeline* pPipeline)
+{
+	const float offsetX = 123.25f, offsetY = -77.5f;
+	svg.beginPaths(offsetX, offsetY, MAX_POINTS_PER_PATH);
+	if (pPipeline == nullptr || chunks.size() < 2) {
+		for (const SegmentChunkView& chunk : chunks) {
+			svg.addSegments(chunk.segments, chunk.count);
+		}
+		svg.endPaths();
+		return;
+	}
+	for (const SegmentChunkView& chunk : chunks) {
+		svg.registerColours(chunk.segments, chunk.count);
+	}
+	pPipeline->run(chunks.size(),
+		[&](size_t ix, std::string& text) {
+			const SegmentChunkView& chunk = chunks[ix];
+			const Segment* pPrevious = nullptr;
+			if (ix > 0) {
+				pPrevious = &chunks[ix - 1].segments[chunks[ix - 1].count - 1];
+			}
+			SvgWriter fragment(text, svg);
+			fragment.resumePaths(offsetX, offsetY, MAX_POINTS_PER_PATH, chunk.firstIndex, pPrevious);
+			fragment.addSegments(chunk.segments, chunk.count);
+			if (ix + 1 == chunks.size()) {
+				fragment.endPaths();
+			}
+		},
+		[&](const char* text, size_t length) {
+			svg.writeText(text, length);
+			return true;
+		});
+}
+
+static std::string writeChunkedSvg(const std::vector<std::vector<SegmentChunkView>>& turtles, int precision,
+	const ExportPipeline* pPipeline)
+{
+	std::ostringstream out;
+	SvgWriter svg(out, precision);
+	svg.writeDocumentStart(9500.0f, 9500.0f, 1.0f, "chunks.svg", 0xFFFFFF);
+	for (const std::vector<SegmentChunkView>& chunks : turtles) {
+		writeChunks(svg, chunks, pPipeline);
+	}
+	svg.writeDocumentEnd();
+	return out.str();
+}
+
+/* Returns a connected walk with colour runs longer than a path (1000 segments),
+ * every 37th segment too short for the grid, and a gap every 3001 segments */
+static std::vector<Segment> makeLongPaths(size_t count, uint32_t seed)
+{
+	std::vector<Segment> segs = makeWalk(count, seed);
+	for (size_t i = 0; i < segs.size(); i++) {
+		Segment& seg = segs[i];
+		if (i > 0 && i % 3001 != 0) {
+			seg.x1 = segs[i - 1].x2;
+			seg.y1 = segs[i - 1].y2;
+		}
+		if (i % 37 == 0) {
+			seg.x2 = seg.x1 + 0.1f;
+			seg.y2 = seg.y1;
+		}
+		seg.argb = 0xFF000000 | (uint32_t)(i / 1000 * 0x0F0F0F);
+	}
+	return segs;
+}
+
+// Returns contiguous views of segs with the given sizes (repeated cyclically)
+static std::vector<SegmentChunkView> makeViews(const std::vector<Segment>& segs, const std::vector<size_t>& sizes)
+{
+	std::vector<SegmentChunkView> views;
+	for (size_t ix = 0, k = 0; ix < segs.size(); k++) {
+		size_t count = std::min(sizes[k % sizes.size()], segs.size() - ix);
+		SegmentChunkView view = { segs.data() + ix, count, ix, SegmentBounds::empty() };
+		views.push_back(view);
+		ix += count;
+	}
+	return views;
+}
+
+// Fragment writers via the pipeline yield the serial output (both modes)
+static void testChunkedIdentity()
+{
+	std::vector<Segment> walk = makeWalk(5 * SegmentStore::CHUNK_SIZE + 123, 17);
+	std::vector<Segment> longPaths = makeLongPaths(4 * SegmentStore::CHUNK_SIZE, 18);
+	std::vector<Segment> exact = makeWalk(2 * SegmentStore::CHUNK_SIZE, 19);
+	SegmentStore walkStore, longStore, exactStore;
+	walkStore.append(walk.data(), walk.size());
+	longStore.append(longPaths.data(), longPaths.size());
+	exactStore.append(exact.data(), exact.size());
+	SegmentStore::ReadLock lock1(walkStore), lock2(longStore), lock3(exactStore);
+	std::vector<SegmentChunkView> walkChunks, longChunks, exactChunks;
+	walkStore.getChunks(walkChunks);
+	longStore.getChunks(longChunks);
+	exactStore.getChunks(exactChunks);
+	// Views ending just before, at, and after path splits and colour changes
+	std::vector<SegmentChunkView> oddChunks = makeViews(longPaths, { 1, 799, 800, 801, 2, 1000, 37, 999, 1 });
+	const std::vector<std::vector<std::vector<SegmentChunkView>>> drawings = {
+		{ walkChunks, longChunks }, { oddChunks }, { exactChunks, oddChunks, walkChunks }
+	};
+	ExportPipeline single(1), several(4);
+	for (int precision : { SvgWriter::PRECISION_COMPATIBLE, 0, 2 }) {
+		for (size_t ix = 0; ix < drawings.size(); ix++) {
+			std::string serial = writeChunkedSvg(drawings[ix], precision, nullptr);
+			for (const ExportPipeline* pPipeline : { &single, &several }) {
+				std::string concurrent = writeChunkedSvg(drawings[ix], precision, pPipeline);
+				size_t diff = std::mismatch(serial.begin(), serial.end(), concurrent.begin(), concurrent.end()).first
+					- serial.begin();
+				CHECK_MSG(serial == concurrent, "precision %d, drawing %zu, %u threads: differs at byte %zu of %zu",
+					precision, ix, pPipeline->getThreadCount(), diff, serial.size());
+			}
+			CHECK(serial.size() > 7 && serial.compare(serial.size() - 7, 7, "</svg>\n") == 0);
+		}
+	}
+}
+
+static void benchmark(size_t n)
+{
+	std::vector<std::vector<Segment>> turtles = { makeWalk(n / 2, 42), makeWalk(n - n / 2, 43) };
+	printf("SVG export, 2 turtles, %zu segments (best of 3 runs)\n", n);
+	for (unsigned short scale : { (unsigned short)1, (unsigned short)3 }) {
+		std::string former, current;
+		double tFormer = bestOf(3, [&]() {
+			std::ostringstream out;
+			writeFormerSvg(out, turtles, 1234.5f, 987.25f, scale, 123.25f, -77.5f, "test.svg", 0xFFEEDD);
+			former = out.str();
+		});
+		double tCurrent = bestOf(3, [&]() {
+			std::ostringstream out;
+			writeSvg(out, turtles, 1234.5f, 987.25f, scale, 123.25f, -77.5f, "test.svg", 0xFFEEDD);
+			current = out.str();
+		});
+		printf("  scale %u: %.1f MB, identical: %s\n", scale, current.size() / 1e6, former == current ? "yes" : "NO");
+		printf("    former iostream export %7.1f MB/s  %6.2f M seg/s\n", former.size() / 1e6 / tFormer, n / 1e6 / tFormer);
+		printf("    SvgWriter              %7.1f MB/s  %6.2f M seg/s\n", current.size() / 1e6 / tCurrent, n / 1e6 / tCurrent);
+	}
+	for (int precision : { 0, 2 }) {
+		std::string compact;
+		double t = bestOf(3, [&]() {
+			std::ostringstream out;
+			writeSvg(out, turtles, 1234.5f, 987.25f, 1.0f, 123.25f, -77.5f, "test.svg", 0xFFEEDD, precision);
+			compact = out.str();
+		});
+		printf("  compact, %d decimals: %.1f MB, %7.1f MB/s  %6.2f M seg/s\n", precision,
+			compact.size() / 1e6, compact.size() / 1e6 / t, n / 1e6 / t);
+	}
+	// Chunks formatted serially and concurrently (as the export of a Turtle)
+	SegmentStore store;
+	store.append(turtles[0].data(), turtles[0].size());
+	store.append(turtles[1].data(), turtles[1].size());
+	SegmentStore::ReadLock lock(store);
+	std::vector<std::vector<SegmentChunkView>> chunks(1);
+	store.getChunks(chunks[0]);
+	ExportPipeline pipeline;
+	printf("  chunks of %u segments, %u worker thread(s):\n", SegmentStore::CHUNK_SIZE, pipeline.getThreadCount());
+	for (int precision : { SvgWriter::PRECISION_COMPATIBLE, 2 }) {
+		std::string serial, concurrent;
+		double tSerial = bestOf(3, [&]() { serial = writeChunkedSvg(chunks, precision, nullptr); });
+		double tConcurrent = bestOf(3, [&]() { concurrent = writeChunkedSvg(chunks, precision, &pipeline); });
+		printf("    %-10s serial %6.1f ms, pipeline %6.1f ms, speed-up %.2f, identical: %s\n",
+			precision == SvgWriter::PRECISION_COMPATIBLE ? "compatible" : "compact",
+			tSerial * 1e3, tConcurrent * 1e3, tSerial / tConcurrent, serial == concurrent ? "yes" : "NO");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 2000000;
+	if (isBenchmark(argc, argv, size)) {
+		benchmark(size);
+		return 0;
+	}
+	testCompatibleIdentity();
+	testCompatibleRoundTrip();
+	testCompactRoundTrip();
+	testStreamFailure();
+	testChunkedIdentity();
+	return report("SvgWriter");
+}
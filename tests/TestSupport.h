@@ -0,0 +1,511 @@
+#pragma once
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Minimal support for the tests and benchmarks of the portable modules: check
+ * macros counting failures, a stopwatch, deterministic test drawings, and an
+ * independent decoder for DEFLATE streams (zlib and gzip framing) with its own
+ * checksums, such that compressed exports can be verified without the module
+ * that produced them.
+ * Each test program runs its checks when called without arguments (as ctest
+ * does) and its benchmark when called with "--bench" (optionally followed by a
+ * size), see tests/CMakeLists.txt.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../SegmentStore.h"
+
+namespace TestSupport {
+
+	inline int& failureCount()
+	{
+		static int nFailures = 0;
+		return nFailures;
+	}
+
+	inline void fail(const char* file, int line, const char* what)
+	{
+		fprintf(stderr, "%s(%d): check failed: %s\n", file, line, what);
+		failureCount()++;
+	}
+
+	// Prints the outcome of the checks, returns the exit code for ctest
+	inline int report(const char* name)
+	{
+		if (failureCount() == 0) {
+			printf("%s: all checks passed\n", name);
+			return EXIT_SUCCESS;
+		}
+		printf("%s: %d check(s) failed\n", name, failureCount());
+		return EXIT_FAILURE;
+	}
+
+	/* Returns true if the benchmark is requested (first argument "--bench"), then
+	 * sets size to the second argument if given */
+	inline bool isBenchmark(int argc, char** argv, size_t& size)
+	{
+		if (argc < 2 || strcmp(argv[1], "--bench") != 0) {
+			return false;
+		}
+		if (argc > 2) {
+			size = (size_t)strtoull(argv[2], nullptr, 10);
+		}
+		return true;
+	}
+
+	// Measures the elapsed wall clock time
+	class Stopwatch
+	{
+	public:
+		Stopwatch() : start(std::chrono::steady_clock::now()) {}
+		// Returns the seconds since construction or the last restart()
+		inline double seconds() const
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+		inline void restart() { start = std::chrono::steady_clock::now(); }
+	private:
+		std::chrono::steady_clock::time_point start;
+	};
+
+	// Returns the least time in seconds of nRuns calls of action
+	template<typename Action>
+	double bestOf(int nRuns, Action action)
+	{
+		double best = 1e300;
+		for (int run = 0; run < nRuns; run++) {
+			Stopwatch watch;
+			action();
+			double t = watch.seconds();
+			if (t < best) {
+				best = t;
+			}
+		}
+		return best;
+	}
+
+	// Small deterministic pseudo random generator (xorshift32), same on every platform
+	class Random
+	{
+	public:
+		explicit Random(uint32_t seed) : state(seed != 0 ? seed : 1) {}
+		inline uint32_t next()
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+		// Returns a value in [0, bound)
+		inline uint32_t below(uint32_t bound) { return next() % bound; }
+	private:
+		uint32_t state;
+	};
+
+	/* Produces count segments of a turtle-like walk: connected lines of random
+	 * direction and a length of 2 ... 100 units, with occasional colour changes
+	 * and gaps (pen up moves). With onGrid set, all coordinates are multiples of
+	 * 1/4 (exactly representable in a 6-digit "%g" output up to 9999.75) */
+	inline std::vector<Segment> makeWalk(size_t count, uint32_t seed, bool onGrid = false)
+	{
+		std::vector<Segment> segs;
+		segs.reserve(count);
+		Random rnd(seed);
+		float x = 1000.0f, y = 1000.0f;
+		uint32_t argb = 0xFF000000;
+		for (size_t i = 0; i < count; i++) {
+			if (rnd.below(50) == 0) {
+				argb = 0xFF000000 | (rnd.next() & 0xFFFFFF);
+			}
+			if (rnd.below(100) == 0) {
+				// Pen up move
+				x += (float)rnd.below(40) - 20.0f;
+				y += (float)rnd.below(40) - 20.0f;
+			}
+			double angle = rnd.below(3600) * 3.14159265358979 / 1800.0;
+			double length = 2.0 + rnd.below(9800) / 100.0;
+			float x2 = x + (float)(length * sin(angle));
+			float y2 = y - (float)(length * cos(angle));
+			if (onGrid) {
+				x2 = std::round(x2 * 4.0f) / 4.0f;
+				y2 = std::round(y2 * 4.0f) / 4.0f;
+			}
+			// Keep the walk within a bounded area
+			if (x2 < 0.0f || x2 > 9000.0f) { x2 = x - (x2 - x); }
+			if (y2 < 0.0f || y2 > 9000.0f) { y2 = y - (y2 - y); }
+			segs.push_back(Segment{ x, y, x2, y2, argb });
+			x = x2;
+			y = y2;
+		}
+		return segs;
+	}
+
+	// Reference CRC-32 (bitwise, polynomial 0xEDB88320) for the verification of outputs
+	inline uint32_t crc32(uint32_t crc, const void* data, size_t length)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		crc = ~crc;
+		for (size_t i = 0; i < length; i++) {
+			crc ^= bytes[i];
+			for (int k = 0; k < 8; k++) {
+				crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+			}
+		}
+		return ~crc;
+	}
+
+	// Reference Adler-32 (without any deferred modulo tricks)
+	inline uint32_t adler32(uint32_t adler, const void* data, size_t length)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		uint32_t a = adler & 0xFFFF, b = adler >> 16;
+		for (size_t i = 0; i < length; i++) {
+			a = (a + bytes[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		return (b << 16) | a;
+	}
+
+	/* Straightforward DEFLATE decoder (RFC 1951) after the pattern of zlib's
+	 * "puff": stored, fixed and dynamic Huffman blocks, canonical codes decoded
+	 * bit by bit. Slow, but short enough to be obviously correct */
+	class Inflater
+	{
+	public:
+		/* Decodes the raw DEFLATE stream in data[0 ... size) and appends the result to
+		 * out; returns false if the stream is malformed or incomplete. Sets *pUsed to
+		 * the number of bytes consumed (up to the byte boundary after the last block) */
+		static bool inflate(const unsigned char* data, size_t size, std::string& out, size_t* pUsed = nullptr)
+		{
+			Inflater inf(data, size, out);
+			bool ok = inf.run();
+			if (pUsed != nullptr) {
+				*pUsed = inf.pos;
+			}
+			return ok;
+		}
+
+		// Decodes a zlib stream (RFC 1950) including the check of its Adler-32 trailer
+		static bool zlibDecode(const std::string& in, std::string& out)
+		{
+			const unsigned char* data = reinterpret_cast<const unsigned char*>(in.data());
+			if (in.size() < 6 || (data[0] & 0x0F) != 8 || ((data[0] << 8) | data[1]) % 31 != 0
+				|| (data[1] & 0x20) != 0) {
+				return false;
+			}
+			size_t used = 0;
+			size_t start = out.size();
+			if (!inflate(data + 2, in.size() - 2, out, &used) || 2 + used + 4 != in.size()) {
+				return false;
+			}
+			const unsigned char* p = data + 2 + used;
+			uint32_t adler = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+			return adler == adler32(1, out.data() + start, out.size() - start);
+		}
+
+		// Decodes a single-member gzip stream (RFC 1952) including the check of CRC and size
+		static bool gzipDecode(const std::string& in, std::string& out)
+		{
+			const unsigned char* data = reinterpret_cast<const unsigned char*>(in.data());
+			if (in.size() < 18 || data[0] != 0x1F || data[1] != 0x8B || data[2] != 8) {
+				return false;
+			}
+			size_t pos = 10;
+			unsigned char flags = data[3];
+			if (flags & 0x04) {	// FEXTRA
+				pos += 2 + (data[pos] | (data[pos + 1] << 8));
+			}
+			for (unsigned char mask = 0x08; mask <= 0x10; mask <<= 1) {	// FNAME, FCOMMENT
+				if (flags & mask) {
+					while (pos < in.size() && data[pos] != 0) { pos++; }
+					pos++;
+				}
+			}
+			if (flags & 0x02) {	// FHCRC
+				pos += 2;
+			}
+			size_t used = 0;
+			size_t start = out.size();
+			if (pos >= in.size() || !inflate(data + pos, in.size() - pos, out, &used)
+				|| pos + used + 8 != in.size()) {
+				return false;
+			}
+			const unsigned char* p = data + pos + used;
+			uint32_t crc = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+			uint32_t isize = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+			return crc == crc32(0, out.data() + start, out.size() - start)
+				&& isize == (uint32_t)(out.size() - start);
+		}
+
+	private:
+		static const int MAX_BITS = 15;
+		struct Huffman {
+			short counts[MAX_BITS + 1];	// Number of codes per length
+			short symbols[288];			// Symbols ordered by code
+		};
+
+		const unsigned char* data;
+		size_t size;
+		size_t pos;
+		uint32_t bitBuf;
+		int bitCount;
+		bool overrun;
+		std::string& out;
+
+		Inflater(const unsigned char* data, size_t size, std::string& out)
+			: data(data), size(size), pos(0), bitBuf(0), bitCount(0), overrun(false), out(out) {}
+
+		int bits(int n)
+		{
+			uint32_t value = this->bitBuf;
+			while (this->bitCount < n) {
+				if (this->pos >= this->size) {
+					this->overrun = true;
+					return 0;
+				}
+				value |= (uint32_t)this->data[this->pos++] << this->bitCount;
+				this->bitCount += 8;
+			}
+			this->bitBuf = value >> n;
+			this->bitCount -= n;
+			return (int)(value & ((1u << n) - 1));
+		}
+
+		// Returns false if the lengths over- or (except for single codes) undersubscribe
+		static bool build(Huffman& h, const short* lengths, int n)
+		{
+			short offsets[MAX_BITS + 1];
+			memset(h.counts, 0, sizeof(h.counts));
+			for (int sym = 0; sym < n; sym++) {
+				h.counts[lengths[sym]]++;
+			}
+			if (h.counts[0] == n) {
+				return true;
+			}
+			int left = 1;
+			for (int len = 1; len <= MAX_BITS; len++) {
+				left <<= 1;
+				left -= h.counts[len];
+				if (left < 0) {
+					return false;
+				}
+			}
+			offsets[1] = 0;
+			for (int len = 1; len < MAX_BITS; len++) {
+				offsets[len + 1] = offsets[len] + h.counts[len];
+			}
+			for (int sym = 0; sym < n; sym++) {
+				if (lengths[sym] != 0) {
+					h.symbols[offsets[lengths[sym]]++] = (short)sym;
+				}
+			}
+			return left == 0 || n - h.counts[0] == 1;
+		}
+
+		int decode(const Huffman& h)
+		{
+			int code = 0, first = 0, index = 0;
+			for (int len = 1; len <= MAX_BITS; len++) {
+				code |= this->bits(1);
+				int count = h.counts[len];
+				if (code - count < first) {
+					return h.symbols[index + (code - first)];
+				}
+				index += count;
+				first += count;
+				first <<= 1;
+				code <<= 1;
+			}
+			return -1;
+		}
+
+		bool stored()
+		{
+			this->bitBuf = 0;
+			this->bitCount = 0;
+			if (this->pos + 4 > this->size) {
+				return false;
+			}
+			unsigned len = this->data[this->pos] | (this->data[this->pos + 1] << 8);
+			unsigned nlen = this->data[this->pos + 2] | (this->data[this->pos + 3] << 8);
+			this->pos += 4;
+			if (len != (~nlen & 0xFFFF) || this->pos + len > this->size) {
+				return false;
+			}
+			this->out.append(reinterpret_cast<const char*>(this->data + this->pos), len);
+			this->pos += len;
+			return true;
+		}
+
+		bool codes(const Huffman& lencode, const Huffman& distcode)
+		{
+			static const short LBASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+				35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+			static const short LEXT[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+				3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+			static const short DBASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+				257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+			static const short DEXT[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+				7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+			for (;;) {
+				int sym = this->decode(lencode);
+				if (sym < 0 || this->overrun) {
+					return false;
+				}
+				if (sym < 256) {
+					this->out.push_back((char)sym);
+				}
+				else if (sym == 256) {
+					return true;
+				}
+				else {
+					sym -= 257;
+					if (sym >= 29) {
+						return false;
+					}
+					int len = LBASE[sym] + this->bits(LEXT[sym]);
+					int dsym = this->decode(distcode);
+					if (dsym < 0 || dsym >= 30) {
+						return false;
+					}
+					size_t dist = DBASE[dsym] + this->bits(DEXT[dsym]);
+					if (this->overrun || dist > this->out.size()) {
+						return false;
+					}
+					size_t from = this->out.size() - dist;
+					for (int i = 0; i < len; i++) {
+						this->out.push_back(this->out[from + i]);
+					}
+				}
+			}
+		}
+
+		bool fixed()
+		{
+			static Huffman lencode, distcode;
+			static bool built = false;
+			if (!built) {
+				short lengths[288];
+				int sym = 0;
+				for (; sym < 144; sym++) { lengths[sym] = 8; }
+				for (; sym < 256; sym++) { lengths[sym] = 9; }
+				for (; sym < 280; sym++) { lengths[sym] = 7; }
+				for (; sym < 288; sym++) { lengths[sym] = 8; }
+				build(lencode, lengths, 288);
+				for (sym = 0; sym < 30; sym++) { lengths[sym] = 5; }
+				build(distcode, lengths, 30);
+				built = true;
+			}
+			return this->codes(lencode, distcode);
+		}
+
+		bool dynamic()
+		{
+			static const short ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+			short lengths[320];
+			int nlen = this->bits(5) + 257;
+			int ndist = this->bits(5) + 1;
+			int ncode = this->bits(4) + 4;
+			if (nlen > 286 || ndist > 30) {
+				return false;
+			}
+			int index = 0;
+			for (; index < ncode; index++) { lengths[ORDER[index]] = (short)this->bits(3); }
+			for (; index < 19; index++) { lengths[ORDER[index]] = 0; }
+			Huffman lencode, distcode;
+			if (!build(lencode, lengths, 19)) {
+				return false;
+			}
+			index = 0;
+			while (index < nlen + ndist) {
+				int sym = this->decode(lencode);
+				if (sym < 0 || this->overrun) {
+					return false;
+				}
+				if (sym < 16) {
+					lengths[index++] = (short)sym;
+					continue;
+				}
+				short len = 0;
+				int repeat = 0;
+				if (sym == 16) {
+					if (index == 0) {
+						return false;
+					}
+					len = lengths[index - 1];
+					repeat = 3 + this->bits(2);
+				}
+				else if (sym == 17) {
+					repeat = 3 + this->bits(3);
+				}
+				else {
+					repeat = 11 + this->bits(7);
+				}
+				if (index + repeat > nlen + ndist) {
+					return false;
+				}
+				while (repeat-- > 0) {
+					lengths[index++] = len;
+				}
+			}
+			if (lengths[256] == 0
+				|| !build(lencode, lengths, nlen)
+				|| !build(distcode, lengths + nlen, ndist)) {
+				return false;
+			}
+			return this->codes(lencode, distcode);
+		}
+
+		bool run()
+		{
+			bool last = false;
+			do {
+				last = this->bits(1) != 0;
+				int type = this->bits(2);
+				bool ok = false;
+				switch (type) {
+				case 0: ok = this->stored(); break;
+				case 1: ok = this->fixed(); break;
+				case 2: ok = this->dynamic(); break;
+				default: ok = false;
+				}
+				if (!ok || this->overrun) {
+					return false;
+				}
+			} while (!last);
+			return true;
+		}
+	};
+
+}
+
+// Checks a condition, counting and reporting failures without aborting the test
+#define CHECK(cond) \
+	do { if (!(cond)) { TestSupport::fail(__FILE__, __LINE__, #cond); } } while (0)
+
+// Checks a condition, reports it with an additional message (printf-style) if it fails
+#define CHECK_MSG(cond, ...) \
+	do { if (!(cond)) { TestSupport::fail(__FILE__, __LINE__, #cond); \
+		fprintf(stderr, "    "); fprintf(stderr, __VA_ARGS__); fprintf(stderr, "\n"); } } while (0)
+
+#endif /*TESTSUPPORT_H*/
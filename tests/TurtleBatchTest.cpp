@@ -0,0 +1,184 @@
+/*
+ * Fachhochschule Erfurt https://ai.fh-erfurt.de
+ * Fachrichtung Angewandte Informatik
+ * Project: Turtleizer_CPP (static C++ library for Windows)
+ *
+ * Test and benchmark of the batch command API (Turtle::execute()): a random
+ * command sequence is executed by one turtle via single calls and by another
+ * one in batches, lines, position, orientation and bounds must coincide; the
+ * benchmark compares the commands per second of both ways with the main turtle.
+ * Needs WinAPI and GDI+ (opens a Turtleizer window), so it is only built on
+ * Windows.
+ *
+ * Author: Kay Gürtzig
+ * Version: 11.1.0
+ *
+ * History (add on top):
+ * --------------------------------------------------------
+ * 2026-10-18   Created for VERSION 11.1.0 (reproducible tests and benchmarks)
+ */
+
+#include "TestSupport.h"
+#include "Turtleizer.h"
+
+using namespace TestSupport;
+
+// Returns a random mix of moves in both coordinate models, turns, pen and colour changes
+static std::vector<Turtle::Command> makeCommands(size_t count, uint32_t seed)
+{
+	std::vector<Turtle::Command> cmds;
+	cmds.reserve(count);
+	Random rnd(seed);
+	bool isDown = true;
+	while (cmds.size() < count) {
+		uint32_t r = rnd.below(100);
+		if (r < 40) {
+			cmds.push_back({ Turtle::CMD_FORWARD, 1.0 + rnd.below(4000) / 100.0, 0 });
+		}
+		else if (r < 60) {
+			cmds.push_back({ Turtle::CMD_FD, (double)(1 + rnd.below(30)), 0 });
+		}
+		else if (r < 95) {
+			cmds.push_back({ Turtle::CMD_LEFT, (double)rnd.below(7200) / 20.0 - 180.0, 0 });
+		}
+		else if (r < 97) {
+			cmds.push_back({ isDown ? Turtle::CMD_PEN_UP : Turtle::CMD_PEN_DOWN, 0, 0 });
+			isDown = !isDown;
+		}
+		else {
+			cmds.push_back({ Turtle::CMD_PEN_COLOUR, 0, 0xFF000000 | (rnd.next() & 0xFFFFFF) });
+		}
+	}
+	return cmds;
+}
+
+// Performs cmds by the respective single calls to turtle
+static void performSingly(Turtle* turtle, const std::vector<Turtle::Command>& cmds)
+{
+	for (const Turtle::Command& cmd : cmds) {
+		switch (cmd.opcode) {
+		case Turtle::CMD_FORWARD: turtle->forward(cmd.value); break;
+		case Turtle::CMD_FD: turtle->fd((int)cmd.value); break;
+		case Turtle::CMD_LEFT: turtle->left(cmd.value); break;
+		case Turtle::CMD_PEN_UP: turtle->penUp(); break;
+		case Turtle::CMD_PEN_DOWN: turtle->penDown(); break;
+		case Turtle::CMD_PEN_COLOUR:
+			turtle->setPenColor((unsigned char)(cmd.argb >> 16), (unsigned char)(cmd.argb >> 8),
+				(unsigned char)cmd.argb);
+			break;
+		}
+	}
+}
+
+// Returns a copy of all lines of turtle
+static std::vector<Segment> getLines(const Turtle* turtle)
+{
+	std::vector<Segment> lines;
+	std::vector<SegmentChunkView> chunks;
+	std::unique_ptr<SegmentStore::ReadLock> lock = turtle->lockChunks(chunks);
+	for (const SegmentChunkView& chunk : chunks) {
+		lines.insert(lines.end(), chunk.segments, chunk.segments + chunk.count);
+	}
+	return lines;
+}
+
+static bool equalLines(const std::vector<Segment>& a, const std::vector<Segment>& b)
+{
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a[i].x1 != b[i].x1 || a[i].y1 != b[i].y1 || a[i].x2 != b[i].x2 || a[i].y2 != b[i].y2
+			|| a[i].argb != b[i].argb) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void testEquivalence()
+{
+	// More commands than a store chunk holds, in batches of different sizes
+	std::vector<Turtle::Command> cmds = makeCommands(3 * SegmentStore::CHUNK_SIZE + 123, 61);
+	Turtle* single = addNewTurtle(200, 200);
+	Turtle* batched = addNewTurtle(200, 200);
+	single->showTurtle(false);
+	batched->showTurtle(false);
+	performSingly(single, cmds);
+	size_t done = 0;
+	for (size_t batchSize : { (size_t)0, (size_t)1, (size_t)7, (size_t)1000, cmds.size() }) {
+		size_t count = std::min(batchSize, cmds.size() - done);
+		batched->execute(cmds.data() + done, count);
+		done += count;
+	}
+	CHECK(done == cmds.size());
+	CHECK(single->getX() == batched->getX() && single->getY() == batched->getY());
+	CHECK(single->getOrientation() == batched->getOrientation());
+	RectF b1 = single->getBounds(), b2 = batched->getBounds();
+	CHECK(b1.X == b2.X && b1.Y == b2.Y && b1.Width == b2.Width && b1.Height == b2.Height);
+	std::vector<Segment> lines = getLines(single);
+	CHECK(!lines.empty());
+	CHECK_MSG(equalLines(lines, getLines(batched)), "lines differ (%zu single)", lines.size());
+
+	// The global function works on the main turtle
+	Turtle::Command square[8];
+	for (int i = 0; i < 8; i += 2) {
+		square[i] = { Turtle::CMD_FD, 100, 0 };
+		square[i + 1] = { Turtle::CMD_LEFT, 90, 0 };
+	}
+	double x = getX(), y = getY(), orientation = getOrientation();
+	execute(square, 8);
+	CHECK(getX() == x && getY() == y && getOrientation() == orientation);
+}
+
+static void benchmark(size_t n)
+{
+	std::vector<Turtle::Command> cmds = makeCommands(n, 42);
+	const size_t batchSize = 10000;
+	printf("Turtle commands, %zu (forward, fd, left, pen and colour changes), main turtle, no automatic window updates\n", n);
+	for (bool shown : { false, true }) {
+		if (shown) {
+			showTurtle();
+		}
+		else {
+			hideTurtle();
+		}
+		clear();
+		Stopwatch watch;
+		for (const Turtle::Command& cmd : cmds) {
+			switch (cmd.opcode) {
+			case Turtle::CMD_FORWARD: forward(cmd.value); break;
+			case Turtle::CMD_FD: fd((int)cmd.value); break;
+			case Turtle::CMD_LEFT: left(cmd.value); break;
+			case Turtle::CMD_PEN_UP: penUp(); break;
+			case Turtle::CMD_PEN_DOWN: penDown(); break;
+			case Turtle::CMD_PEN_COLOUR:
+				setPenColor((unsigned char)(cmd.argb >> 16), (unsigned char)(cmd.argb >> 8), (unsigned char)cmd.argb);
+				break;
+			}
+		}
+		double tSingle = watch.seconds();
+		clear();
+		watch.restart();
+		for (size_t i = 0; i < cmds.size(); i += batchSize) {
+			execute(cmds.data() + i, std::min(batchSize, cmds.size() - i));
+		}
+		double tBatch = watch.seconds();
+		printf("  turtle %s: single calls %6.1f M cmd/s, batches of %zu %6.1f M cmd/s (%.1fx)\n",
+			shown ? "shown " : "hidden", n / 1e6 / tSingle, batchSize, n / 1e6 / tBatch, tSingle / tBatch);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t size = 2000000;
+	bool bench = isBenchmark(argc, argv, size);
+	Turtleizer::startUp();
+	updateTurtleWindow(false);
+	if (bench) {
+		benchmark(size);
+		return 0;
+	}
+	testEquivalence();
+	return report("Turtle batches");
+}